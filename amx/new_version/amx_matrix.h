@@ -32,6 +32,8 @@ static int amx_initialized = 0;
 int amx_multiply_small_uint8_int8_to_int32(const uint8_t* A, const int8_t* B, int32_t* C, int M, int K, int N);
 int amx_multiply_large_uint8_int8_to_int32(const uint8_t* A, const int8_t* B, int32_t* C, int M, int K, int N);
 int amx_multiply_small_uint16_int16_to_int32(const uint16_t* A, const int16_t* B, int32_t* C, int M, int K, int N);
+int amx_multiply_small_int8_int8_to_int32(const int8_t* A, const int8_t* B, int32_t* C, int M, int K, int N);
+int amx_multiply_large_int8_int8_to_int32(const int8_t* A, const int8_t* B, int32_t* C, int M, int K, int N);
 //int amx_multiply_large_uint16_int16_to_int32(const uint16_t* A, const int16_t* B, int32_t* C, int M, int K, int N);
 
 // Initialize Intel AMX
@@ -234,6 +236,80 @@ int amx_multiply_small_int8_int8_to_int32(const int8_t* A, const int8_t* B, int3
     return AMX_SUCCESS;
 }
 
+/**
+ * Computes C = A × B where:
+ * - A is M×K matrix of signed 8-bit integers
+ * - B is K×N matrix of signed 8-bit integers
+ * - C is M×N matrix of 32-bit integers (output)
+ *
+ * Signed × signed products (_tile_dpbssd) are what centered RNS residues
+ * in (-m/2, m/2] need: both operands fit in int8 for moduli up to 255.
+ */
+int amx_multiply_int8_int8_to_int32(const int8_t* A, const int8_t* B, int32_t* C, int M, int K, int N) {
+    if (!amx_initialized) return AMX_ERROR_NOT_INITIALIZED;
+    if (!A || !B || !C || M <= 0 || K <= 0 || N <= 0) return AMX_ERROR_INVALID_PARAMS;
+
+    // The blocked kernel packs B in the VNNI layout, which is exact for any K;
+    // the single-tile kernel above only handles K <= 4
+    return amx_multiply_large_int8_int8_to_int32(A, B, C, M, K, N);
+}
+
+// Block-based signed multiplication, one 16×16 C tile at a time.
+// B is repacked in the VNNI layout expected by the tile instructions: tile
+// row r holds the 4 consecutive k values of all 16 columns, i.e.
+// B_tile[r][4*j + t] = B[k0 + 4*r + t][j0 + j].
+int amx_multiply_large_int8_int8_to_int32(const int8_t* A, const int8_t* B, int32_t* C, int M, int K, int N) {
+    if (!amx_initialized) return AMX_ERROR_NOT_INITIALIZED;
+
+    int8_t A_block[16 * 64];
+    int8_t B_block[16 * 64];
+    int32_t C_tile[16 * 16];
+
+    __tilecfg cfg = {0};
+    cfg.palette_id = 1;
+    cfg.colsb[0] = 64;    cfg.rows[0] = 16;   // C: 16 × 16 int32
+    cfg.colsb[1] = 64;    cfg.rows[1] = 16;   // A: 16 × 64 int8
+    cfg.colsb[2] = 64;    cfg.rows[2] = 16;   // B: 16 k-quads × 16 columns
+    _tile_loadconfig(&cfg);
+
+    for (int i0 = 0; i0 < M; i0 += 16) {
+        int mb = (M - i0 >= 16) ? 16 : M - i0;
+
+        for (int j0 = 0; j0 < N; j0 += 16) {
+            int nb = (N - j0 >= 16) ? 16 : N - j0;
+            _tile_zero(0);
+
+            for (int k0 = 0; k0 < K; k0 += 64) {
+                int kb = (K - k0 >= 64) ? 64 : K - k0;
+
+                memset(A_block, 0, sizeof(A_block));
+                memset(B_block, 0, sizeof(B_block));
+
+                for (int i = 0; i < mb; i++) {
+                    memcpy(&A_block[i * 64], &A[(i0 + i) * K + k0], kb);
+                }
+                for (int k = 0; k < kb; k++) {
+                    for (int j = 0; j < nb; j++) {
+                        B_block[(k / 4) * 64 + j * 4 + (k % 4)] = B[(k0 + k) * N + (j0 + j)];
+                    }
+                }
+
+                _tile_loadd(1, A_block, 64);
+                _tile_loadd(2, B_block, 64);
+                _tile_dpbssd(0, 1, 2);  // signed × signed → signed
+            }
+
+            _tile_stored(0, C_tile, 64);
+            for (int i = 0; i < mb; i++) {
+                memcpy(&C[(i0 + i) * N + j0], &C_tile[i * 16], nb * sizeof(int32_t));
+            }
+        }
+    }
+
+    _tile_release();
+    return AMX_SUCCESS;
+}
+
 // Block-based multiplication for large matrices - SIMPLIFICADA
 int amx_multiply_large_uint8_int8_to_int32(const uint8_t* A, const int8_t* B, int32_t* C, int M, int K, int N) {
     if (!amx_initialized) return AMX_ERROR_NOT_INITIALIZED;
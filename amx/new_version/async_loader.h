@@ -0,0 +1,386 @@
+#ifndef ASYNC_LOADER_H
+#define ASYNC_LOADER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/*
+Asynchronous whole-file reads into a fixed set of slots, so that the operand
+files of the next products are read while the current one runs.
+
+    AsyncLoader loader;
+    async_loader_init(&loader, slots, capacity);
+    async_loader_submit(&loader, s, path);      // returns at once
+    ...
+    long bytes = async_loader_wait(&loader, s); // loader.slots[s].buf holds the file
+    ...                                         // the slot can be submitted again
+
+Reads go through io_uring (raw syscalls, no liburing) when the kernel allows
+it and supports IORING_OP_READ, otherwise through a few worker threads doing
+pread. ASYNC_LOADER=threads in the environment forces the fallback.
+*/
+
+#define ASYNC_LOADER_ALIGN 4096
+#define ASYNC_LOADER_THREADS 2
+
+#define SLOT_IDLE 0
+#define SLOT_PENDING 1
+#define SLOT_READY 2
+#define SLOT_FAILED 3
+
+typedef struct {
+    char path[256];
+    char* buf;          // ASYNC_LOADER_ALIGN-aligned, NUL-terminated after the data once ready
+    size_t capacity;    // bytes available in buf, not counting the terminator
+    size_t length;      // file size
+    size_t done;        // bytes read so far
+    int fd;
+    int state;          // SLOT_*
+} LoaderSlot;
+
+typedef struct {
+    int ring_fd;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_ring;
+    void* cq_ring;
+    size_t sq_ring_bytes, cq_ring_bytes, sqes_bytes;
+} UringQueue;
+
+typedef struct {
+    int count;
+    LoaderSlot* slots;
+    int use_uring;
+    UringQueue ring;
+    // Thread fallback: FIFO of submitted slot indices
+    pthread_t threads[ASYNC_LOADER_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int* queue;
+    int queue_head, queue_len;
+    int stop;
+} AsyncLoader;
+
+static const char* async_loader_backend(const AsyncLoader* loader) {
+    return loader->use_uring ? "io_uring" : "threads";
+}
+
+///////////////////////////////////////
+////////////   io_uring    ////////////
+///////////////////////////////////////
+
+static int uring_setup(UringQueue* q, unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    q->ring_fd = (int) syscall(__NR_io_uring_setup, entries, &p);
+    if (q->ring_fd < 0) return -1;
+
+    q->sq_ring_bytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    q->cq_ring_bytes = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (q->cq_ring_bytes > q->sq_ring_bytes) q->sq_ring_bytes = q->cq_ring_bytes;
+        q->cq_ring_bytes = q->sq_ring_bytes;
+    }
+    q->sq_ring = mmap(NULL, q->sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      q->ring_fd, IORING_OFF_SQ_RING);
+    if (q->sq_ring == MAP_FAILED) {
+        close(q->ring_fd);
+        return -1;
+    }
+    q->cq_ring = q->sq_ring;
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP)) {
+        q->cq_ring = mmap(NULL, q->cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          q->ring_fd, IORING_OFF_CQ_RING);
+    }
+    q->sqes_bytes = p.sq_entries * sizeof(struct io_uring_sqe);
+    q->sqes = mmap(NULL, q->sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   q->ring_fd, IORING_OFF_SQES);
+    if (q->cq_ring == MAP_FAILED || q->sqes == MAP_FAILED) {
+        if (q->cq_ring != MAP_FAILED && q->cq_ring != q->sq_ring) munmap(q->cq_ring, q->cq_ring_bytes);
+        if (q->sqes != MAP_FAILED) munmap(q->sqes, q->sqes_bytes);
+        munmap(q->sq_ring, q->sq_ring_bytes);
+        close(q->ring_fd);
+        return -1;
+    }
+
+    char* sq = (char*) q->sq_ring;
+    char* cq = (char*) q->cq_ring;
+    q->sq_head = (unsigned*) (sq + p.sq_off.head);
+    q->sq_tail = (unsigned*) (sq + p.sq_off.tail);
+    q->sq_mask = (unsigned*) (sq + p.sq_off.ring_mask);
+    q->sq_array = (unsigned*) (sq + p.sq_off.array);
+    q->cq_head = (unsigned*) (cq + p.cq_off.head);
+    q->cq_tail = (unsigned*) (cq + p.cq_off.tail);
+    q->cq_mask = (unsigned*) (cq + p.cq_off.ring_mask);
+    q->cqes = (struct io_uring_cqe*) (cq + p.cq_off.cqes);
+    return 0;
+}
+
+// Non-zero if the ring supports IORING_OP_READ (io_uring_setup alone
+// succeeds on kernels that only have the readv opcodes)
+static int uring_has_read(const UringQueue* q) {
+    size_t bytes = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = calloc(1, bytes);
+    if (!probe) return 0;
+    int ok = syscall(__NR_io_uring_register, q->ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0
+          && probe->last_op >= IORING_OP_READ
+          && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    return ok;
+}
+
+static void uring_teardown(UringQueue* q) {
+    munmap(q->sqes, q->sqes_bytes);
+    if (q->cq_ring != q->sq_ring) munmap(q->cq_ring, q->cq_ring_bytes);
+    munmap(q->sq_ring, q->sq_ring_bytes);
+    close(q->ring_fd);
+}
+
+// Queues a read of the rest of slot s and hands it to the kernel
+static int uring_submit_read(AsyncLoader* loader, int s) {
+    UringQueue* q = &loader->ring;
+    LoaderSlot* slot = &loader->slots[s];
+    unsigned tail = *q->sq_tail;
+    unsigned idx = tail & *q->sq_mask;
+    struct io_uring_sqe* sqe = &q->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot->fd;
+    sqe->addr = (uint64_t) (uintptr_t) (slot->buf + slot->done);
+    sqe->len = (unsigned) (slot->length - slot->done);
+    sqe->off = slot->done;
+    sqe->user_data = (uint64_t) s;
+    q->sq_array[idx] = idx;
+    __atomic_store_n(q->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return syscall(__NR_io_uring_enter, q->ring_fd, 1, 0, 0, NULL, 0) == 1 ? 0 : -1;
+}
+
+static void slot_finish(LoaderSlot* slot, int ok) {
+    close(slot->fd);
+    slot->fd = -1;
+    if (ok) slot->buf[slot->length] = '\0';
+    slot->state = ok ? SLOT_READY : SLOT_FAILED;
+}
+
+static int threads_start(AsyncLoader* loader);
+
+// Waits for at least one completion and applies all available ones. If the
+// ring cannot be waited on any more, the pending slots fail and the loader
+// moves on to the thread fallback
+static void uring_reap(AsyncLoader* loader) {
+    UringQueue* q = &loader->ring;
+    unsigned head = *q->cq_head;
+    while (head == __atomic_load_n(q->cq_tail, __ATOMIC_ACQUIRE)) {
+        if (syscall(__NR_io_uring_enter, q->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0
+            && errno != EINTR && errno != EAGAIN) {
+            fprintf(stderr, "io_uring_enter failed (%s), falling back to threads\n", strerror(errno));
+            uring_teardown(q);
+            loader->use_uring = 0;
+            for (int s = 0; s < loader->count; s++) {
+                if (loader->slots[s].state == SLOT_PENDING) slot_finish(&loader->slots[s], 0);
+            }
+            if (threads_start(loader) != 0) {
+                fprintf(stderr, "Failed to start the loader threads\n");
+                exit(EXIT_FAILURE);
+            }
+            return;
+        }
+    }
+    while (head != __atomic_load_n(q->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe* cqe = &q->cqes[head & *q->cq_mask];
+        LoaderSlot* slot = &loader->slots[cqe->user_data];
+        int res = cqe->res;
+        head++;
+        __atomic_store_n(q->cq_head, head, __ATOMIC_RELEASE);
+
+        if (res <= 0) {
+            slot_finish(slot, 0);
+        } else {
+            slot->done += (size_t) res;
+            // Short read: queue the remainder
+            if (slot->done < slot->length) {
+                if (uring_submit_read(loader, (int) cqe->user_data) != 0) slot_finish(slot, 0);
+            } else {
+                slot_finish(slot, 1);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////
+////////////    Threads    ////////////
+///////////////////////////////////////
+
+static void* loader_thread(void* arg) {
+    AsyncLoader* loader = (AsyncLoader*) arg;
+    for (;;) {
+        pthread_mutex_lock(&loader->lock);
+        while (loader->queue_len == 0 && !loader->stop) pthread_cond_wait(&loader->changed, &loader->lock);
+        if (loader->stop) {
+            pthread_mutex_unlock(&loader->lock);
+            return NULL;
+        }
+        int s = loader->queue[loader->queue_head];
+        loader->queue_head = (loader->queue_head + 1) % loader->count;
+        loader->queue_len--;
+        pthread_mutex_unlock(&loader->lock);
+
+        LoaderSlot* slot = &loader->slots[s];
+        int ok = 1;
+        while (ok && slot->done < slot->length) {
+            ssize_t got = pread(slot->fd, slot->buf + slot->done, slot->length - slot->done, (off_t) slot->done);
+            if (got > 0) {
+                slot->done += (size_t) got;
+            } else if (got == 0 || errno != EINTR) {
+                ok = 0;
+            }
+        }
+
+        pthread_mutex_lock(&loader->lock);
+        slot_finish(slot, ok);
+        pthread_cond_broadcast(&loader->changed);
+        pthread_mutex_unlock(&loader->lock);
+    }
+}
+
+// Switches the loader to the worker threads. Returns 0, or -1 if the queue cannot be allocated
+static int threads_start(AsyncLoader* loader) {
+    loader->queue = calloc(loader->count, sizeof(int));
+    if (!loader->queue) return -1;
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->changed, NULL);
+    for (int t = 0; t < ASYNC_LOADER_THREADS; t++) {
+        if (pthread_create(&loader->threads[t], NULL, loader_thread, loader) != 0) {
+            fprintf(stderr, "Failed to create loader thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return 0;
+}
+
+///////////////////////////////////////
+////////////      API      ////////////
+///////////////////////////////////////
+
+// Prepares count slots of capacity bytes each. Returns 0, or -1 if the buffers cannot be allocated
+int async_loader_init(AsyncLoader* loader, int count, size_t capacity) {
+    memset(loader, 0, sizeof(*loader));
+    loader->count = count;
+    loader->slots = calloc(count, sizeof(LoaderSlot));
+    if (!loader->slots) return -1;
+    for (int s = 0; s < count; s++) {
+        LoaderSlot* slot = &loader->slots[s];
+        slot->fd = -1;
+        slot->capacity = capacity;
+        if (posix_memalign((void**) &slot->buf, ASYNC_LOADER_ALIGN, capacity + 1) != 0) {
+            slot->buf = NULL;
+            return -1;
+        }
+    }
+
+    const char* env = getenv("ASYNC_LOADER");
+    int want_uring = !(env && strcmp(env, "threads") == 0);
+    if (want_uring && uring_setup(&loader->ring, (unsigned) count) == 0) {
+        if (uring_has_read(&loader->ring)) {
+            loader->use_uring = 1;
+            return 0;
+        }
+        uring_teardown(&loader->ring);
+    }
+    return threads_start(loader);
+}
+
+// Starts reading path into slot s (which must not be pending). Returns 0, or -1 if the file cannot be opened
+int async_loader_submit(AsyncLoader* loader, int s, const char* path) {
+    LoaderSlot* slot = &loader->slots[s];
+    snprintf(slot->path, sizeof(slot->path), "%s", path);
+    slot->done = 0;
+    slot->state = SLOT_FAILED;
+
+    slot->fd = open(path, O_RDONLY);
+    struct stat st;
+    if (slot->fd < 0 || fstat(slot->fd, &st) != 0) {
+        if (slot->fd >= 0) close(slot->fd);
+        slot->fd = -1;
+        return -1;
+    }
+    slot->length = (size_t) st.st_size;
+
+    // Larger than the preallocated buffer: grow it once for this and later files
+    if (slot->length > slot->capacity) {
+        char* buf;
+        if (posix_memalign((void**) &buf, ASYNC_LOADER_ALIGN, slot->length + 1) != 0) {
+            close(slot->fd);
+            slot->fd = -1;
+            return -1;
+        }
+        free(slot->buf);
+        slot->buf = buf;
+        slot->capacity = slot->length;
+    }
+
+    if (slot->length == 0) {
+        slot_finish(slot, 1);
+        return 0;
+    }
+    slot->state = SLOT_PENDING;
+    if (loader->use_uring) {
+        if (uring_submit_read(loader, s) != 0) {
+            slot_finish(slot, 0);
+            return -1;
+        }
+        return 0;
+    }
+    pthread_mutex_lock(&loader->lock);
+    loader->queue[(loader->queue_head + loader->queue_len) % loader->count] = s;
+    loader->queue_len++;
+    pthread_cond_signal(&loader->changed);
+    pthread_mutex_unlock(&loader->lock);
+    return 0;
+}
+
+// Blocks until slot s is read. Returns the file size, or -1 if the read failed
+long async_loader_wait(AsyncLoader* loader, int s) {
+    LoaderSlot* slot = &loader->slots[s];
+    if (loader->use_uring) {
+        while (slot->state == SLOT_PENDING) uring_reap(loader);
+    } else {
+        pthread_mutex_lock(&loader->lock);
+        while (slot->state == SLOT_PENDING) pthread_cond_wait(&loader->changed, &loader->lock);
+        pthread_mutex_unlock(&loader->lock);
+    }
+    return slot->state == SLOT_READY ? (long) slot->length : -1;
+}
+
+// Waits for the reads in flight and releases everything
+void async_loader_destroy(AsyncLoader* loader) {
+    for (int s = 0; s < loader->count && loader->slots; s++) async_loader_wait(loader, s);
+    if (loader->use_uring) {
+        uring_teardown(&loader->ring);
+    } else if (loader->queue) {
+        pthread_mutex_lock(&loader->lock);
+        loader->stop = 1;
+        pthread_cond_broadcast(&loader->changed);
+        pthread_mutex_unlock(&loader->lock);
+        for (int t = 0; t < ASYNC_LOADER_THREADS; t++) pthread_join(loader->threads[t], NULL);
+        pthread_cond_destroy(&loader->changed);
+        pthread_mutex_destroy(&loader->lock);
+    }
+    for (int s = 0; s < loader->count && loader->slots; s++) free(loader->slots[s].buf);
+    free(loader->slots);
+    free(loader->queue);
+}
+
+#endif // ASYNC_LOADER_H
@@ -0,0 +1,229 @@
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "amx_matrix.h"
+#include "bench_harness.h"
+
+/*
+Matrix product backends on the shared timing harness (naive/include/bench_harness.h:
+warmup, sampling to a 95% CI target, TSC timer, JSON output).
+
+Results are written as JSON (see bench_write_json) for plot.py.
+*/
+
+///////////////////////////////////////
+////////////   Backends    ////////////
+///////////////////////////////////////
+
+typedef int (*MatmulFn)(const void* A, const void* B, int32_t* C, int M, int K, int N);
+
+typedef struct {
+    const char* name;    // implementation: "amx" or "scalar"
+    const char* a_type;  // element types of A and B
+    const char* b_type;
+    int a_size, b_size;  // bytes per element
+    MatmulFn run;
+} MatmulBackend;
+
+// Same dispatch as amx_multiply_uint8_int8_to_int32 without its per-call printf
+static int bench_amx_u8i8(const void* A, const void* B, int32_t* C, int M, int K, int N) {
+    if (M <= 16 && K <= 64) return amx_multiply_small_uint8_int8_to_int32(A, B, C, M, K, N);
+    return amx_multiply_large_uint8_int8_to_int32(A, B, C, M, K, N);
+}
+
+static int bench_amx_i8i8(const void* A, const void* B, int32_t* C, int M, int K, int N) {
+    return amx_multiply_int8_int8_to_int32(A, B, C, M, K, N);
+}
+
+#define BENCH_SCALAR(NAME, TA, TB)                                                         \
+static int NAME(const void* Av, const void* Bv, int32_t* C, int M, int K, int N) {         \
+    const TA* A = Av;                                                                      \
+    const TB* B = Bv;                                                                      \
+    memset(C, 0, (size_t) M * N * sizeof(int32_t));                                        \
+    for (int i = 0; i < M; i++)                                                            \
+        for (int k = 0; k < K; k++) {                                                      \
+            int32_t a = A[(size_t) i * K + k];                                             \
+            for (int j = 0; j < N; j++) C[(size_t) i * N + j] += a * B[(size_t) k * N + j]; \
+        }                                                                                  \
+    return 0;                                                                              \
+}
+
+BENCH_SCALAR(bench_scalar_u8i8, uint8_t, int8_t)
+BENCH_SCALAR(bench_scalar_i8i8, int8_t, int8_t)
+BENCH_SCALAR(bench_scalar_u16i16, uint16_t, int16_t)
+
+// The uint16 × int16 AMX path of amx_matrix.h is a stub, so that type pair only has the scalar backend
+static const MatmulBackend bench_backends[] = {
+    { "amx", "uint8", "int8", 1, 1, bench_amx_u8i8 },
+    { "amx", "int8", "int8", 1, 1, bench_amx_i8i8 },
+    { "scalar", "uint8", "int8", 1, 1, bench_scalar_u8i8 },
+    { "scalar", "int8", "int8", 1, 1, bench_scalar_i8i8 },
+    { "scalar", "uint16", "int16", 2, 2, bench_scalar_u16i16 },
+};
+#define BENCH_NUM_BACKENDS ((int) (sizeof(bench_backends) / sizeof(bench_backends[0])))
+
+// Scalar backend of the same type pair, used as the reference
+static const MatmulBackend* bench_reference(const MatmulBackend* b) {
+    for (int i = 0; i < BENCH_NUM_BACKENDS; i++) {
+        const MatmulBackend* r = &bench_backends[i];
+        if (!strcmp(r->name, "scalar") && !strcmp(r->a_type, b->a_type) && !strcmp(r->b_type, b->b_type)) return r;
+    }
+    return NULL;
+}
+
+// Deterministic operands; 16-bit values are kept to 10 bits so int32 sums cannot overflow
+static void bench_fill(void* X, const char* type, size_t count, uint32_t seed) {
+    for (size_t e = 0; e < count; e++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t r = seed >> 16;
+        if (!strcmp(type, "uint8")) ((uint8_t*) X)[e] = (uint8_t) r;
+        else if (!strcmp(type, "int8")) ((int8_t*) X)[e] = (int8_t) r;
+        else if (!strcmp(type, "uint16")) ((uint16_t*) X)[e] = (uint16_t) (r & 1023);
+        else ((int16_t*) X)[e] = (int16_t) ((int) (r & 1023) - 512);
+    }
+}
+
+///////////////////////////////////////
+////////////     JSON      ////////////
+///////////////////////////////////////
+
+typedef struct {
+    const MatmulBackend* backend;
+    int M, K, N;
+    int pair;            // operand pair index for file-driven runs, -1 for generated operands
+    const char* status;  // "ok", "failed" (error code, not timed) or "mismatch" (differs from the scalar product)
+    BenchStats stats;
+} BenchRecord;
+
+// Writes {"timer": ..., "config": {...}, "results": [...]}; returns 0 or -1
+int bench_write_json(const char* path, const BenchConfig* cfg, const BenchRecord* recs, int count) {
+    FILE* f = bench_json_open(path, cfg);
+    if (!f) return -1;
+    for (int r = 0; r < count; r++) {
+        const BenchRecord* rec = &recs[r];
+        bench_json_record(f, r);
+        fprintf(f, "\"backend\": \"%s\", \"a_type\": \"%s\", \"b_type\": \"%s\", "
+                   "\"M\": %d, \"K\": %d, \"N\": %d, \"pair\": %d, \"status\": \"%s\"",
+                rec->backend->name, rec->backend->a_type, rec->backend->b_type,
+                rec->M, rec->K, rec->N, rec->pair, rec->status);
+        if (rec->stats.reps > 0) {
+            fprintf(f, ", \"gops\": %.6g", 2.0 * rec->M * rec->K * rec->N / (rec->stats.median_ms * 1e6));
+        }
+        bench_json_stats(f, &rec->stats);
+        fprintf(f, "}");
+    }
+    return bench_json_close(f);
+}
+
+///////////////////////////////////////
+////////////    Drivers    ////////////
+///////////////////////////////////////
+
+typedef struct {
+    const MatmulBackend* backend;
+    const void* A;
+    const void* B;
+    int32_t* C;
+    int M, K, N;
+} BenchMatmulCtx;
+
+static int bench_matmul_call(void* arg) {
+    BenchMatmulCtx* c = (BenchMatmulCtx*) arg;
+    return c->backend->run(c->A, c->B, c->C, c->M, c->K, c->N);
+}
+
+// Checks the backend against the scalar one on the same operands, measures it, and fills rec
+void bench_matmul_record(const MatmulBackend* backend, const void* A, const void* B, int M, int K, int N,
+                         int pair, const BenchConfig* cfg, BenchRecord* rec) {
+    memset(rec, 0, sizeof(*rec));
+    rec->backend = backend;
+    rec->M = M;
+    rec->K = K;
+    rec->N = N;
+    rec->pair = pair;
+    rec->status = "ok";
+
+    int32_t* C = calloc((size_t) M * N, sizeof(int32_t));
+    int32_t* R = calloc((size_t) M * N, sizeof(int32_t));
+    if (!C || !R) {
+        fprintf(stderr, "Failed to allocate result matrices\n");
+        exit(EXIT_FAILURE);
+    }
+    const MatmulBackend* ref = bench_reference(backend);
+    if (backend->run(A, B, C, M, K, N) != 0) {
+        rec->status = "failed";
+    } else if (ref && ref != backend) {
+        ref->run(A, B, R, M, K, N);
+        if (memcmp(C, R, (size_t) M * N * sizeof(int32_t)) != 0) rec->status = "mismatch";
+    }
+
+    // A mismatching kernel is still timed, the status flags its numbers
+    if (strcmp(rec->status, "failed") != 0) {
+        BenchMatmulCtx ctx = { backend, A, B, C, M, K, N };
+        if (bench_measure(bench_matmul_call, &ctx, cfg, &rec->stats) != 0) {
+            bench_free_stats(&rec->stats);
+            memset(&rec->stats, 0, sizeof(rec->stats));
+            rec->status = "failed";
+        }
+    }
+    free(C);
+    free(R);
+}
+
+void bench_print_record(const BenchRecord* rec) {
+    const BenchStats* s = &rec->stats;
+    printf("%-7s %6s x %-6s %5dx%dx%-5d ", rec->backend->name, rec->backend->a_type, rec->backend->b_type,
+           rec->M, rec->K, rec->N);
+    if (s->reps == 0) {
+        printf("%s\n", rec->status);
+        return;
+    }
+    printf("median %11.6f ms  p10 %11.6f  p90 %11.6f  %8.2f GOPS  (%d x %d calls, CI ±%.2f%%%s)%s\n",
+           s->median_ms, s->p10_ms, s->p90_ms, 2.0 * rec->M * rec->K * rec->N / (s->median_ms * 1e6),
+           s->reps, s->batch, s->ci95_pct, s->converged ? "" : ", not converged",
+           strcmp(rec->status, "ok") ? "  MISMATCH" : "");
+}
+
+// Square products of every size for every backend on generated operands, written to json_path
+int benchmark_matmul_all_backends(const int* sizes, int count, const BenchConfig* cfg, const char* json_path) {
+    BenchRecord* recs = calloc((size_t) count * BENCH_NUM_BACKENDS, sizeof(BenchRecord));
+    if (!recs) {
+        fprintf(stderr, "Failed to allocate benchmark records\n");
+        exit(EXIT_FAILURE);
+    }
+    bench_timer_init();
+    printf("Benchmarking %d backends, timer %s\n", BENCH_NUM_BACKENDS, bench_timer_name());
+
+    int total = 0;
+    for (int s = 0; s < count; s++) {
+        int n = sizes[s];
+        for (int b = 0; b < BENCH_NUM_BACKENDS; b++) {
+            const MatmulBackend* backend = &bench_backends[b];
+            void* A = malloc((size_t) n * n * backend->a_size);
+            void* B = malloc((size_t) n * n * backend->b_size);
+            if (!A || !B) {
+                fprintf(stderr, "Failed to allocate operands\n");
+                exit(EXIT_FAILURE);
+            }
+            bench_fill(A, backend->a_type, (size_t) n * n, 12345u + n);
+            bench_fill(B, backend->b_type, (size_t) n * n, 67890u + n);
+            bench_matmul_record(backend, A, B, n, n, n, -1, cfg, &recs[total]);
+            bench_print_record(&recs[total]);
+            total++;
+            free(A);
+            free(B);
+        }
+    }
+
+    int rc = bench_write_json(json_path, cfg, recs, total);
+    if (rc == 0) printf("Results saved in: %s\n", json_path);
+    for (int r = 0; r < total; r++) bench_free_stats(&recs[r].stats);
+    free(recs);
+    return rc;
+}
+
+#endif // BENCHMARK_HARNESS_H
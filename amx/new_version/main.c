@@ -4,7 +4,7 @@
 #include <time.h>
 #include <sys/time.h>
 
-int main() {
+int main(int argc, char** argv) {
 
     //////////////////////////
     // INITIALIZE INTEL AMX //
@@ -17,6 +17,18 @@ int main() {
     }
     printf("AMX initialized successfully\n\n");
     
+    ///////////////////////////////////////////
+    // ./main bench: EVERY BACKEND AND TYPE  //
+    ///////////////////////////////////////////
+    
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        int sizes[] = { 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+        BenchConfig cfg = BENCH_CONFIG_DEFAULT;
+        mkdir("results", 0700);
+        return benchmark_matmul_all_backends(sizes, sizeof(sizes) / sizeof(sizes[0]), &cfg,
+                                             "results/benchmark_backends.json") == 0 ? 0 : -1;
+    }
+    
     /*
     //////////////////////////////////////////////////////////////////
     // GENERATE RANDOM i8 AND u8 MATRICES WITH DIFFERENT DIMENSIONS //
@@ -126,6 +138,7 @@ int main() {
     test_uint8_int8_completo(); // Testa uint8_int8 com dimensoes variadas (pode ter k > 64)
     debug_teste5();
     test_int8_int8_incompleto(); // Testa int8_int* com dimensoes menores (k < 64)
+    test_int8_int8_completo(); // Testa int8_int8 (dpbssd) com dimensoes variadas
     test_amx_16int(); // Testa uint16_int16 com dimensoes menores (k < 64)
 
     return 0;
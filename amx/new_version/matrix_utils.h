@@ -10,6 +10,8 @@
 #include <sys/time.h>
 #include <time.h>
 #include "amx_matrix.h"
+#include "async_loader.h"
+#include "benchmark_harness.h"
 #include <dirent.h>
 
 ///////////////////////////////////////
@@ -297,9 +299,54 @@ uint8_t* load_matrix_u8_from_file(const char* filename, int* rows, int* cols) {
     return matrix;
 }
 
-// Benchmark multiple matrix pairs from 0 to number in the folders matrices/int8/MxK and matrices/uint8/KxN
+// Parse a "rows cols" header and rows*cols integers in [lo, hi] from a NUL-terminated buffer.
+// Returns 0, or -1 if the text is malformed or holds more than max_entries values
+static int parse_matrix_from_buffer(const char* text, int lo, int hi, uint8_t* matrix, long max_entries,
+                                    int* rows, int* cols) {
+    char* end;
+    long r = strtol(text, &end, 10);
+    long c = (end != text) ? strtol(text = end, &end, 10) : -1;
+    if (end == text || r < 0 || c < 0 || r * c > max_entries) {
+        fprintf(stderr, "Invalid matrix dimensions in buffer\n");
+        return -1;
+    }
+    *rows = (int) r;
+    *cols = (int) c;
+
+    for (long e = 0; e < r * c; e++) {
+        text = end;
+        long val = strtol(text, &end, 10);
+        if (end == text || val < lo || val > hi) {
+            fprintf(stderr, "Invalid or missing matrix value at (%ld,%ld)\n", e / c, e % c);
+            return -1;
+        }
+        matrix[e] = (uint8_t) val;
+    }
+    return 0;
+}
+
+// Parse an int8_t matrix from the contents of a .ssv or .txt file
+int parse_matrix_i8_from_buffer(const char* text, int8_t* matrix, long max_entries, int* rows, int* cols) {
+    return parse_matrix_from_buffer(text, INT8_MIN, INT8_MAX, (uint8_t*) matrix, max_entries, rows, cols);
+}
+
+// Parse an uint8_t matrix from the contents of a .ssv or .txt file
+int parse_matrix_u8_from_buffer(const char* text, uint8_t* matrix, long max_entries, int* rows, int* cols) {
+    return parse_matrix_from_buffer(text, 0, UINT8_MAX, matrix, max_entries, rows, cols);
+}
+
+#ifndef BENCHMARK_PREFETCH_DEPTH
+#define BENCHMARK_PREFETCH_DEPTH 2  // matrix pairs read ahead of the one being multiplied
+#endif
+
+// Benchmark multiple matrix pairs from 0 to number in the folders matrices/int8/MxK and matrices/uint8/KxN.
+// The files of the next BENCHMARK_PREFETCH_DEPTH pairs are read asynchronously while the current pair
+// is multiplied. Each pair is measured with the benchmark harness: the median per pair goes to
+// results/times_MxKxN.ssv and the full statistics to results/times_MxKxN.json. A pair whose
+// result differs from the scalar product is only in the JSON, with status "mismatch".
 void benchmark_uint8_int8_matmul_one_pair(int M, int K, int N) {
     int number = 10;  // Número de matrizes para testar (0 a 9)
+    int depth = BENCHMARK_PREFETCH_DEPTH < number ? BENCHMARK_PREFETCH_DEPTH : number;
     
     // Cria pasta results/ se não existir
     struct stat st = {0};
@@ -308,8 +355,12 @@ void benchmark_uint8_int8_matmul_one_pair(int M, int K, int N) {
     }
     
     // Abre o arquivo de resultados UMA VEZ
-    char result_path[256];
+    char result_path[256], json_path[256];
     snprintf(result_path, sizeof(result_path), "results/times_%dx%dx%d.ssv", M, K, N);
+    snprintf(json_path, sizeof(json_path), "results/times_%dx%dx%d.json", M, K, N);
+    BenchConfig cfg = BENCH_CONFIG_DEFAULT;
+    BenchRecord records[number];
+    int recorded = 0;
     
     FILE* file = fopen(result_path, "w");
     if (!file) {
@@ -317,31 +368,71 @@ void benchmark_uint8_int8_matmul_one_pair(int M, int K, int N) {
         return;
     }
     
-    // Escreve cabeçalho
-    //fprintf(file, "%d %d %d\n", M, K, N);
+    // Buffers for the pair being multiplied and for the files in flight, allocated once
+    // (a value takes at most 4 characters plus a separator in the .ssv files)
+    uint8_t* A = malloc((size_t) M * K);
+    int8_t* B = malloc((size_t) K * N);
+    int32_t* C = malloc((size_t) M * N * sizeof(int32_t));
+    size_t larger = (size_t) (M * K > K * N ? M * K : K * N);
+    AsyncLoader loader;
+    if (!A || !B || !C || async_loader_init(&loader, 2 * depth, 5 * larger + 64) != 0) {
+        fprintf(stderr, "Failed to allocate benchmark buffers\n");
+        free(A); 
+        free(B); 
+        free(C);
+        fclose(file);
+        return;
+    }
+    
+    printf("Benchmarking %dx%dx%d matrices (0 to %d), reading %d pairs ahead with %s...\n",
+           M, K, N, number-1, depth, async_loader_backend(&loader));
     
-    printf("Benchmarking %dx%dx%d matrices (0 to %d)...\n", M, K, N, number-1);
+    // Pair i lives in slots 2*(i % depth) (A) and 2*(i % depth) + 1 (B)
+    for (int i = 0; i < depth; i++) {
+        char path_A[256], path_B[256];
+        snprintf(path_A, sizeof(path_A), "matrices/uint8/%dx%d/matrix_%d.ssv", M, K, i);
+        snprintf(path_B, sizeof(path_B), "matrices/int8/%dx%d/matrix_%d.ssv", K, N, i);
+        async_loader_submit(&loader, 2 * i, path_A);
+        async_loader_submit(&loader, 2 * i + 1, path_B);
+    }
     
     int successful = 0;
     int failed = 0;
+    int mismatched = 0;
+    double wait_total = 0, parse_total = 0, compute_total = 0;  // compute_total: sum of the medians
+    double bench_start = get_time();
     
     // Loop de 0 até number-1
     for (int i = 0; i < number; i++) {
-        char path_A[256], path_B[256];
-        snprintf(path_A, sizeof(path_A), "matrices/uint8/%dx%d/matrix_%d.ssv", M, K, i);
-        snprintf(path_B, sizeof(path_B), "matrices/int8/%dx%d/matrix_%d.ssv", K, N, i);
-        
+        int slot = 2 * (i % depth);
         printf("Testing matrix_%d... ", i);
         
-        // Carrega as matrizes
-        int rowsA, colsA, rowsB, colsB;
-        uint8_t* A = load_matrix_u8_from_file(path_A, &rowsA, &colsA);
-        int8_t* B = load_matrix_i8_from_file(path_B, &rowsB, &colsB);
+        // Espera as leituras e converte o texto
+        double wait_start = get_time();
+        int loaded = async_loader_wait(&loader, slot) >= 0;
+        loaded = async_loader_wait(&loader, slot + 1) >= 0 && loaded;
+        double parse_start = get_time();
+        
+        int rowsA = 0, colsA = 0, rowsB = 0, colsB = 0;
+        if (loaded) {
+            loaded = parse_matrix_u8_from_buffer(loader.slots[slot].buf, A, (long) M * K, &rowsA, &colsA) == 0
+                  && parse_matrix_i8_from_buffer(loader.slots[slot + 1].buf, B, (long) K * N, &rowsB, &colsB) == 0;
+        }
+        double parse_end = get_time();
+        wait_total += parse_start - wait_start;
+        parse_total += parse_end - parse_start;
+        
+        // The slots are free again: start reading the pair depth steps ahead
+        if (i + depth < number) {
+            char path_A[256], path_B[256];
+            snprintf(path_A, sizeof(path_A), "matrices/uint8/%dx%d/matrix_%d.ssv", M, K, i + depth);
+            snprintf(path_B, sizeof(path_B), "matrices/int8/%dx%d/matrix_%d.ssv", K, N, i + depth);
+            async_loader_submit(&loader, slot, path_A);
+            async_loader_submit(&loader, slot + 1, path_B);
+        }
         
-        if (!A || !B) {
+        if (!loaded) {
             fprintf(stderr, "Failed to load matrix_%d\n", i);
-            if (A) free(A);
-            if (B) free(B);
             failed++;
             continue;
         }
@@ -350,46 +441,40 @@ void benchmark_uint8_int8_matmul_one_pair(int M, int K, int N) {
         if (rowsA != M || colsA != K || rowsB != K || colsB != N) {
             fprintf(stderr, "Dimension mismatch in matrix_%d! A=%dx%d, B=%dx%d, expected A=%dx%d, B=%dx%d\n", 
                     i, rowsA, colsA, rowsB, colsB, M, K, K, N);
-            free(A); 
-            free(B);
             failed++;
             continue;
         }
         
-        int32_t* C = calloc(M * N, sizeof(int32_t));
-        if (!C) {
-            fprintf(stderr, "Failed to allocate result matrix for matrix_%d\n", i);
-            free(A); 
-            free(B);
+        // Warmup, repeats until the CI converges, verified against the scalar product
+        BenchRecord* rec = &records[recorded];
+        bench_matmul_record(&bench_backends[0], A, B, M, K, N, i, &cfg, rec);
+        if (!strcmp(rec->status, "failed")) {
+            fprintf(stderr, "Matrix multiplication failed for matrix_%d\n", i);
             failed++;
             continue;
         }
-        
-        // Measure time
-        double start = get_time();
-        int result = amx_multiply_uint8_int8_to_int32(A, B, C, M, K, N);
-        double end = get_time();
-        
-        if (result != 0) {
-            fprintf(stderr, "Matrix multiplication failed for matrix_%d (code %d)\n", i, result);
-            free(A); 
-            free(B); 
-            free(C);
-            failed++;
+        recorded++;   // the JSON keeps mismatching records, flagged by their status
+        if (!strcmp(rec->status, "mismatch")) {
+            fprintf(stderr, "Result of matrix_%d differs from the scalar product, left out of %s\n", i, result_path);
+            mismatched++;
             continue;
         }
         
-        // Salva o tempo no arquivo (em milissegundos)
-        double time_ms = (end - start) * 1000;
-        fprintf(file, "%.8f\n", time_ms);
-        
-        printf("%.8f ms\n", time_ms);
+        // Salva a mediana no arquivo (em milissegundos)
+        compute_total += rec->stats.median_ms / 1000;
+        fprintf(file, "%.8f\n", rec->stats.median_ms);
         
-        free(A); 
-        free(B); 
-        free(C);
+        printf("median %.8f ms, p10 %.8f, p90 %.8f over %d samples (waited %.3f ms for reads, parsed in %.3f ms)\n",
+               rec->stats.median_ms, rec->stats.p10_ms, rec->stats.p90_ms, rec->stats.reps,
+               (parse_start - wait_start) * 1000, (parse_end - parse_start) * 1000);
         successful++;
     }
+    double bench_end = get_time();
+    
+    async_loader_destroy(&loader);
+    free(A); 
+    free(B); 
+    free(C);
     
     // Fecha o arquivo
     fclose(file);
@@ -397,13 +482,17 @@ void benchmark_uint8_int8_matmul_one_pair(int M, int K, int N) {
     printf("\nBenchmark completed!\n");
     printf("Successful: %d/%d\n", successful, number);
     printf("Failed: %d/%d\n", failed, number);
+    printf("Mismatched: %d/%d\n", mismatched, number);
+    printf("Wall time: %.3f ms (one multiplication per pair: %.3f ms), read stalls %.3f ms, parsing %.3f ms\n",
+           (bench_end - bench_start) * 1000, compute_total * 1000, wait_total * 1000, parse_total * 1000);
     printf("Results saved in: %s\n", result_path);
     
-    if (successful > 0) {
-        printf("Average performance: Ready for analysis!\n");
+    if (recorded > 0) {
+        if (bench_write_json(json_path, &cfg, records, recorded) == 0) printf("Statistics saved in: %s\n", json_path);
     } else {
         fprintf(stderr, "No successful tests - check your matrix files!\n");
     }
+    for (int r = 0; r < recorded; r++) bench_free_stats(&records[r].stats);
 }
 
 void test_uint8_int8_completo() {
@@ -662,6 +751,47 @@ void test_int8_int8_incompleto() {
     printf("Status: %d/4 corretos - %s\n\n", corretos, (corretos==4) ? "✓ CORRETO" : "✗ INCORRETO");
 }
 
+void test_int8_int8_completo() {
+    printf("=====================================\n");
+    printf("==== TESTE INT8 x INT8 COMPLETO  ====\n");
+    printf("=====================================\n");
+
+    // Dimensions that are not multiples of the tile sizes, signed values in [-127, 127]
+    int dims[][3] = { {1, 2, 1}, {2, 3, 2}, {13, 24, 12}, {20, 100, 5}, {33, 130, 47}, {64, 512, 64} };
+    int total = sizeof(dims) / sizeof(dims[0]);
+    int ok_count = 0;
+
+    for (int t = 0; t < total; t++) {
+        int M = dims[t][0], K = dims[t][1], N = dims[t][2];
+        int8_t* A = malloc(M * K * sizeof(int8_t));
+        int8_t* B = malloc(K * N * sizeof(int8_t));
+        int32_t* C = malloc(M * N * sizeof(int32_t));
+
+        for (int i = 0; i < M * K; i++) A[i] = (int8_t) ((i * 37) % 255 - 127);
+        for (int i = 0; i < K * N; i++) B[i] = (int8_t) ((i * 53) % 255 - 127);
+
+        int result = amx_multiply_int8_int8_to_int32(A, B, C, M, K, N);
+
+        bool ok = (result == AMX_SUCCESS);
+        for (int i = 0; i < M && ok; i++) {
+            for (int j = 0; j < N && ok; j++) {
+                int32_t ref = 0;
+                for (int k = 0; k < K; k++) ref += A[i * K + k] * B[k * N + j];
+                if (C[i * N + j] != ref) {
+                    printf("Primeira diferença em (%d,%d): AMX=%d, CPU=%d\n", i, j, C[i * N + j], ref);
+                    ok = false;
+                }
+            }
+        }
+        printf("Teste %d: %dx%d × %dx%d - %s\n", t + 1, M, K, K, N, ok ? "✓ CORRETO" : "✗ INCORRETO");
+        ok_count += ok;
+
+        free(A); free(B); free(C);
+    }
+
+    printf("Status: %d/%d corretos\n\n", ok_count, total);
+}
+
 ///////////////////////////////////////
 ////////////  16uint e 16int //////////
 ///////////////////////////////////////
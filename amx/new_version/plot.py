@@ -7,6 +7,7 @@ Generates comprehensive performance analysis with matplotlib visualizations.
 
 import os
 import re
+import json
 import numpy as np
 import matplotlib.pyplot as plt
 from typing import List, Tuple, Dict
@@ -88,6 +89,88 @@ def collect_all_results(results_dir: str = "results") -> List[Tuple[int, int, in
     print(f"Successfully parsed {len(results)} result files")
     return results
 
+def parse_json_results(filepath: str) -> List[Dict]:
+    """
+    Parse a JSON file written by the benchmark harness (benchmark_harness.h).
+    Records without timings (status "failed") are skipped.
+    
+    Returns:
+        list: Result records (backend, a_type, b_type, M, K, N, median_ms, p10_ms, p90_ms, gops, ...)
+    """
+    try:
+        with open(filepath, 'r') as f:
+            data = json.load(f)
+    except Exception as e:
+        print(f"Error reading {filepath}: {e}")
+        return []
+    
+    records = [r for r in data.get("results", []) if "median_ms" in r]
+    mismatches = sum(1 for r in records if r.get("status") != "ok")
+    unconverged = sum(1 for r in records if not r.get("converged", False))
+    print(f" {os.path.basename(filepath)}: {len(records)} measurements (timer {data.get('timer', '?')}), "
+          f"{unconverged} not converged, {mismatches} with wrong results")
+    return records
+
+def collect_json_results(results_dir: str = "results") -> List[Dict]:
+    """
+    Collect the records of every .json file in the results directory.
+    """
+    if not os.path.exists(results_dir):
+        return []
+    
+    files = sorted(f for f in os.listdir(results_dir) if f.endswith('.json'))
+    print(f"🔍 Found {len(files)} .json files in {results_dir}/")
+    
+    records = []
+    for filename in files:
+        records.extend(parse_json_results(os.path.join(results_dir, filename)))
+    return records
+
+def json_results_to_tuples(records: List[Dict], backend: str = "amx", a_type: str = "uint8",
+                           b_type: str = "int8") -> List[Tuple[int, int, int, float]]:
+    """
+    Reduce the records of one backend and type pair to (M, K, N, median_time_ms)
+    tuples, taking the median over the pairs measured at each size.
+    """
+    by_size: Dict[Tuple[int, int, int], List[float]] = {}
+    for r in records:
+        if (r["backend"], r["a_type"], r["b_type"]) == (backend, a_type, b_type):
+            by_size.setdefault((r["M"], r["K"], r["N"]), []).append(r["median_ms"])
+    return [(M, K, N, float(np.median(t))) for (M, K, N), t in sorted(by_size.items())]
+
+def plot_backend_comparison(records: List[Dict]):
+    """
+    GOPS (at the median time) against problem size for every backend and type
+    pair, with p10-p90 error bars. Hollow markers flag wrong results.
+    """
+    series: Dict[Tuple[str, str, str], List[Dict]] = {}
+    for r in records:
+        series.setdefault((r["backend"], r["a_type"], r["b_type"]), []).append(r)
+    
+    fig, ax = plt.subplots(figsize=(12, 8))
+    for (backend, a_type, b_type), recs in sorted(series.items()):
+        recs.sort(key=lambda r: r["M"] * r["K"] * r["N"])
+        ops = np.array([2.0 * r["M"] * r["K"] * r["N"] for r in recs])
+        gops = ops / (np.array([r["median_ms"] for r in recs]) * 1e6)
+        low = gops - ops / (np.array([r["p90_ms"] for r in recs]) * 1e6)
+        high = ops / (np.array([r["p10_ms"] for r in recs]) * 1e6) - gops
+        wrong = any(r.get("status") != "ok" for r in recs)
+        ax.errorbar(ops / 2, gops, yerr=[low, high], marker='o', capsize=4, linewidth=2,
+                    markerfacecolor='none' if wrong else None,
+                    label=f"{backend} {a_type}×{b_type}" + (" (wrong results)" if wrong else ""))
+    
+    ax.set_xlabel('Matrix Size (MxKxN elements)', fontweight='bold')
+    ax.set_ylabel('Performance (GOPS, median)', fontweight='bold')
+    ax.set_title('Backends and Element Types (p10-p90 error bars)', fontweight='bold', pad=20)
+    ax.set_xscale('log')
+    ax.set_yscale('log')
+    ax.grid(True, alpha=0.3, linestyle='--')
+    ax.legend()
+    
+    plt.tight_layout()
+    plt.savefig('amx_backend_comparison.png', dpi=300, bbox_inches='tight', facecolor='white')
+    print("Backend comparison saved as amx_backend_comparison.png")
+
 def plot_performance_analysis(results: List[Tuple[int, int, int, float]]):
     """
     Create comprehensive performance plots with beautiful visualizations.
@@ -303,14 +386,18 @@ def main():
     print("Analyzing Intel AMX benchmark results...")
     print("Generating comprehensive performance analysis with plots...")
     
-    # Collect all results
-    results = collect_all_results("results")
+    # Collect all results: the harness JSON files, or the plain .ssv times of older runs
+    records = collect_json_results("results")
+    results = json_results_to_tuples(records) if records else collect_all_results("results")
     
     if not results:
         print("No valid results found!")
-        print("Make sure you have .ssv files in the 'results/' directory")
+        print("Make sure you have .json or .ssv files in the 'results/' directory")
         return
     
+    if records:
+        plot_backend_comparison(records)
+    
     # Print detailed results
     print_detailed_results(results)
     
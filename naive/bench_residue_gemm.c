@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bench_harness.h"
+#include "residue_gemm.h"
+#include "residue_gemm_int8.h"
+#include "residue_gemm_fp64.h"
+#include "rns_basis.h"
+#include "thread_pool.h"
+
+// Residue GEMM throughput at equal result range: k8 8-bit moduli on the int8
+// kernels against k64 26-bit moduli on the fp64 kernels (and 28-bit moduli on
+// the generic uint64 kernel as the baseline).
+// Every product is measured with bench_harness.h; the samples go to
+// BENCH_RESIDUE_JSON.
+// Usage: ./bench_residue [dim bits]...   (defaults: 512 32, 512 64, 512 128, 512 160)
+
+#define BENCH_RESIDUE_JSON "results/bench_residue.json"
+
+// k contiguous rows × cols planes of random residues, as int or as centered int8
+static int*** int_planes(int k, int rows, int cols, const int* moduli) {
+    int*** X = malloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) {
+        X[idx] = malloc(rows * sizeof(int*));
+        int* data = malloc((size_t) rows * cols * sizeof(int));
+        for (int i = 0; i < rows; i++) {
+            X[idx][i] = data + (size_t) i * cols;
+            for (int j = 0; j < cols; j++) X[idx][i][j] = rand() % moduli[idx];
+        }
+    }
+    return X;
+}
+
+static int8_t*** int8_planes(int k, int rows, int cols, const int* moduli) {
+    int8_t*** X = malloc(k * sizeof(int8_t**));
+    for (int idx = 0; idx < k; idx++) {
+        int h = moduli[idx] / 2;
+        X[idx] = malloc(rows * sizeof(int8_t*));
+        int8_t* data = malloc((size_t) rows * cols);
+        for (int i = 0; i < rows; i++) {
+            X[idx][i] = data + (size_t) i * cols;
+            for (int j = 0; j < cols; j++) X[idx][i][j] = (int8_t) (rand() % (2 * h + 1) - h);
+        }
+    }
+    return X;
+}
+
+static void free_planes(void* planes_ptr, int k) {
+    void*** planes = (void***) planes_ptr;
+    for (int idx = 0; idx < k; idx++) {
+        free(planes[idx][0]);
+        free(planes[idx]);
+    }
+    free(planes);
+}
+
+typedef struct {
+    int backend;        // 0: int8, 1: fp64, 2: uint64
+    int dim, k;
+    const int* moduli;
+    void* A;
+    void* B;
+    int*** C;
+    ThreadPool* pool;
+} ResidueCase;
+
+static const char* backend_names[] = {"int8", "fp64", "uint64"};
+static const int backend_modulus_bits[] = {8, 26, 28};
+
+static int residue_call(void* arg) {
+    ResidueCase* c = (ResidueCase*) arg;
+    if (c->backend == 0) {
+        residue_gemm_int8_rns((int8_t***) c->A, (int8_t***) c->B, c->C, c->moduli, c->k, c->dim, c->dim, c->dim,
+                              residue_gemm_int8_default_kernel(), c->pool);
+    } else if (c->backend == 1) {
+        residue_gemm_fp64_rns((int***) c->A, (int***) c->B, c->C, c->moduli, c->k, c->dim, c->dim, c->dim,
+                              residue_gemm_fp64_default_kernel(), c->pool);
+    } else {
+        residue_gemm_rns((int***) c->A, (int***) c->B, c->C, c->moduli, c->k, c->dim, c->dim, c->dim, c->pool);
+    }
+    return 0;
+}
+
+// Measures one backend on random residues of a bits-bit range; returns the number of moduli
+static int measure_backend(int backend, int dim, int bits, ThreadPool* pool, const BenchConfig* cfg,
+                           BenchStats* stats) {
+    int k;
+    int* moduli = rns_basis_select(bits, backend_modulus_bits[backend], &k);
+    ResidueCase c = { backend, dim, k, moduli, NULL, NULL, int_planes(k, dim, dim, moduli), pool };
+    if (backend == 0) {
+        c.A = int8_planes(k, dim, dim, moduli);
+        c.B = int8_planes(k, dim, dim, moduli);
+    } else {
+        c.A = int_planes(k, dim, dim, moduli);
+        c.B = int_planes(k, dim, dim, moduli);
+    }
+    bench_measure(residue_call, &c, cfg, stats);
+    free_planes(c.A, k);
+    free_planes(c.B, k);
+    free_planes(c.C, k);
+    free(moduli);
+    return k;
+}
+
+int main(int argc, char** argv) {
+    int default_cases[] = {512, 32, 512, 64, 512, 128, 512, 160};
+    int num_cases = (argc > 2) ? (argc - 1) / 2 : 4;
+    ThreadPool* pool = thread_pool_get_default();
+    BenchConfig cfg = BENCH_CONFIG_DEFAULT;
+    srand(1);
+
+    FILE* json = bench_json_open(BENCH_RESIDUE_JSON, &cfg);
+    if (!json) return 1;
+    printf("int8 kernel %s, fp64 kernel %s, %d threads, timer %s (median, 95%% CI)\n",
+           residue_gemm_int8_kernel_name(residue_gemm_int8_default_kernel()),
+           residue_gemm_fp64_kernel_name(residue_gemm_fp64_default_kernel()), thread_pool_size(pool),
+           bench_timer_name());
+    int records = 0;
+    for (int c = 0; c < num_cases; c++) {
+        int dim = (argc > 2) ? atoi(argv[1 + 2 * c]) : default_cases[2 * c];
+        int bits = (argc > 2) ? atoi(argv[2 + 2 * c]) : default_cases[2 * c + 1];
+        BenchStats stats[3];
+        int k[3];
+        printf("%5d^3 %4d-bit range", dim, bits);
+        for (int b = 0; b < 3; b++) {
+            k[b] = measure_backend(b, dim, bits, pool, &cfg, &stats[b]);
+            printf("  %s %2d moduli", backend_names[b], k[b]);
+            bench_print_stats(&stats[b]);
+
+            bench_json_record(json, records++);
+            fprintf(json, "\"backend\": \"%s\", \"dim\": %d, \"bits\": %d, \"moduli\": %d, "
+                          "\"threads\": %d, \"ns_per_mac_modulus\": %.6g",
+                    backend_names[b], dim, bits, k[b], thread_pool_size(pool),
+                    stats[b].median_ms * 1e6 / ((double) dim * dim * dim * k[b]));
+            bench_json_stats(json, &stats[b]);
+            fprintf(json, "}");
+        }
+        printf("  fp64/int8 %5.2fx\n", stats[1].median_ms / stats[0].median_ms);
+        for (int b = 0; b < 3; b++) bench_free_stats(&stats[b]);
+    }
+    if (bench_json_close(json) != 0) return 1;
+    printf("Results saved in: %s\n", BENCH_RESIDUE_JSON);
+    return 0;
+}
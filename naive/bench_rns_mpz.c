@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "bench_harness.h"
+#include "file_io_gmp.h"
+#include "matrix_utils_gmp.h"
+#include "matrix_rns_mul_gmp.h"
+#include "rns_conversion_gmp.h"
+#include "rns_basis.h"
+#include "crt_reconstruct_gmp.h"
+#include "mixed_radix_gmp.h"
+
+// Benchmark multiply_matrix_rns_mpz against the classical mpz triple loop,
+// and the CRT and mixed-radix reconstruction backends on the same product.
+// Every call is measured with bench_harness.h, with a single warmup call since
+// the classical products take seconds; the samples go to BENCH_GMP_JSON.
+// Usage: ./bench_gmp [dim bits]...   (defaults: 32 256, 64 1024, 128 1024)
+
+#define BENCH_GMP_JSON "results/bench_gmp.json"
+
+static const BenchConfig bench_config = { 1, 5, 50, 0.02, 2.0 };
+static FILE* json;
+static int json_records;
+
+// Appends a record {"case", "method", "n", "m", "p", "moduli", "status", stats...}
+static void json_record(const char* label, const char* method, int n, int m, int p, int moduli, int ok,
+                        const BenchStats* stats) {
+    bench_json_record(json, json_records++);
+    fprintf(json, "\"case\": \"%s\", \"method\": \"%s\", \"n\": %d, \"m\": %d, \"p\": %d, "
+                  "\"moduli\": %d, \"status\": \"%s\"", label, method, n, m, p, moduli, ok ? "ok" : "mismatch");
+    bench_json_stats(json, stats);
+    fprintf(json, "}");
+}
+
+static int same_matrix(mpz_t** X, mpz_t** Y, int n, int m) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            if (mpz_cmp(X[i][j], Y[i][j]) != 0) return 0;
+    return 1;
+}
+
+typedef struct {
+    mpz_t** A;
+    mpz_t** B;
+    int n, m, p;
+    int rns;            // multiply_matrix_rns_mpz instead of the classical loop
+} ProductCall;
+
+static int product_call(void* arg) {
+    ProductCall* c = (ProductCall*) arg;
+    mpz_t** C = c->rns ? multiply_matrix_rns_mpz(c->A, c->B, c->n, c->m, c->p)
+                       : multiply_matrix_mpz_classical(c->A, c->B, c->n, c->m, c->p);
+    free_mpz_matrix(C, c->n, c->p);
+    return 0;
+}
+
+typedef struct {
+    RNSMatrix* R;
+    const CRTBasisMpz* crt;
+    const MRBasis* mr;  // used instead of crt when not NULL
+    const int** rows;
+    int k, n, p;
+    mpz_t** C;
+} ReconstructCall;
+
+// Sequential, one row at a time
+static int reconstruct_call(void* arg) {
+    ReconstructCall* c = (ReconstructCall*) arg;
+    for (int i = 0; i < c->n; i++) {
+        for (int idx = 0; idx < c->k; idx++) c->rows[idx] = c->R->residues[idx][i];
+        if (c->mr) {
+            mixed_radix_reconstruct_centered_mpz(c->mr, c->rows, c->p, c->C[i]);
+        } else {
+            crt_reconstruct_centered_mpz(c->crt, c->rows, c->p, c->C[i]);
+        }
+    }
+    return 0;
+}
+
+// Reconstruct the residues of C with both backends
+static void bench_reconstruction(const char* label, mpz_t** C, int n, int p) {
+    long bits = mpz_matrix_max_bits(C, n, p) + 2;
+    int k;
+    int* moduli = rns_basis_select(bits, RNS_MPZ_MODULUS_BITS, &k);
+    RNSMatrix* R = mpz_matrix_to_rns(C, n, p, moduli, k);
+    CRTBasisMpz* crt = crt_basis_mpz_create(moduli, k);
+    MRBasis* mr = mr_basis_create(moduli, k);
+    mpz_t** C_crt = allocate_mpz_matrix(n, p);
+    mpz_t** C_mr = allocate_mpz_matrix(n, p);
+    const int** rows = malloc(k * sizeof(int*));
+
+    ReconstructCall crt_call = { R, crt, NULL, rows, k, n, p, C_crt };
+    ReconstructCall mr_call = { R, crt, mr, rows, k, n, p, C_mr };
+    BenchStats t_crt, t_mr;
+    bench_measure(reconstruct_call, &crt_call, &bench_config, &t_crt);
+    bench_measure(reconstruct_call, &mr_call, &bench_config, &t_mr);
+    int ok = same_matrix(C_crt, C, n, p) && same_matrix(C_mr, C, n, p);
+
+    printf("%-22s %5d moduli             crt", "  reconstruction", k);
+    bench_print_stats(&t_crt);
+    printf("  mixed radix");
+    bench_print_stats(&t_mr);
+    printf("  ratio %6.2fx  %s\n", t_mr.median_ms / t_crt.median_ms, ok ? "OK" : "MISMATCH");
+    json_record(label, "crt", n, 0, p, k, ok, &t_crt);
+    json_record(label, "mixed_radix", n, 0, p, k, ok, &t_mr);
+
+    bench_free_stats(&t_crt);
+    bench_free_stats(&t_mr);
+    free(rows);
+    free_mpz_matrix(C_crt, n, p);
+    free_mpz_matrix(C_mr, n, p);
+    crt_basis_mpz_free(crt);
+    mr_basis_free(mr);
+    free_rns_matrix(R);
+    free(moduli);
+}
+
+static void bench_pair(const char* label, mpz_t** A, mpz_t** B, int n, int m, int p) {
+    mpz_t** C_ref = multiply_matrix_mpz_classical(A, B, n, m, p);
+    mpz_t** C_rns = multiply_matrix_rns_mpz(A, B, n, m, p);
+    int ok = same_matrix(C_ref, C_rns, n, p);
+
+    ProductCall classical = { A, B, n, m, p, 0 };
+    ProductCall rns = { A, B, n, m, p, 1 };
+    BenchStats t_classical, t_rns;
+    bench_measure(product_call, &classical, &bench_config, &t_classical);
+    bench_measure(product_call, &rns, &bench_config, &t_rns);
+
+    printf("%-22s %5dx%-5dx%5d  classical", label, n, m, p);
+    bench_print_stats(&t_classical);
+    printf("  rns");
+    bench_print_stats(&t_rns);
+    printf("  speedup %6.2fx  %s\n", t_classical.median_ms / t_rns.median_ms, ok ? "OK" : "MISMATCH");
+    json_record(label, "classical", n, m, p, 0, 1, &t_classical);
+    json_record(label, "rns", n, m, p, 0, ok, &t_rns);
+    bench_reconstruction(label, C_ref, n, p);
+
+    bench_free_stats(&t_classical);
+    bench_free_stats(&t_rns);
+    free_mpz_matrix(C_ref, n, p);
+    free_mpz_matrix(C_rns, n, p);
+}
+
+int main(int argc, char** argv) {
+    json = bench_json_open(BENCH_GMP_JSON, &bench_config);
+    if (!json) return 1;
+    printf("timer %s (median, 95%% CI)\n", bench_timer_name());
+
+    // Matrices shipped in data/: A · A^T
+    const char* files[] = {"data/small_matrix.txt", "data/big_matrix.txt"};
+    for (int f = 0; f < 2; f++) {
+        int n, m;
+        mpz_t** A = read_mpz_matrix_from_file(files[f], &n, &m);
+        mpz_t** At = allocate_mpz_matrix(m, n);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < m; j++)
+                mpz_set(At[j][i], A[i][j]);
+        bench_pair(files[f], A, At, n, m, n);
+        free_mpz_matrix(A, n, m);
+        free_mpz_matrix(At, m, n);
+    }
+
+    // Random signed square matrices
+    int default_cases[] = {32, 256, 64, 1024, 128, 1024};
+    int num_cases = (argc > 2) ? (argc - 1) / 2 : 3;
+
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 12345);
+
+    for (int c = 0; c < num_cases; c++) {
+        int dim = (argc > 2) ? atoi(argv[1 + 2 * c]) : default_cases[2 * c];
+        int bits = (argc > 2) ? atoi(argv[2 + 2 * c]) : default_cases[2 * c + 1];
+
+        mpz_t** A = allocate_mpz_matrix(dim, dim);
+        mpz_t** B = allocate_mpz_matrix(dim, dim);
+        for (int i = 0; i < dim; i++) {
+            for (int j = 0; j < dim; j++) {
+                mpz_urandomb(A[i][j], state, bits);
+                mpz_urandomb(B[i][j], state, bits);
+                if ((i + j) & 1) mpz_neg(B[i][j], B[i][j]);
+            }
+        }
+
+        char label[64];
+        snprintf(label, sizeof(label), "random %d-bit", bits);
+        bench_pair(label, A, B, dim, dim, dim);
+
+        free_mpz_matrix(A, dim, dim);
+        free_mpz_matrix(B, dim, dim);
+    }
+
+    gmp_randclear(state);
+    if (bench_json_close(json) != 0) return 1;
+    printf("Results saved in: %s\n", BENCH_GMP_JSON);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bench_harness.h"
+#include "matrix_utils_wide.h"
+#include "matrix_rns_mul_wide.h"
+#include "matrix_digit_mul_wide.h"
+#include "thread_pool.h"
+
+// WideMatrix products by RNS and by digit slicing, against the cost model
+// that multiply_matrix_wide uses to choose between them.
+// Every product is measured with bench_harness.h; the samples go to
+// BENCH_WIDE_JSON.
+// Usage: ./bench_wide [dim bits]...   (defaults: 256 60, 256 250, 256 500, 128 1000)
+
+#define BENCH_WIDE_JSON "results/bench_wide.json"
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// dim × dim matrix of random signed entries with |x| < 2^bits
+static WideMatrix* random_wide(int dim, long bits, uint64_t* state) {
+    WideMatrix* W = allocate_wide_matrix(dim, dim, bits);
+    size_t count = (size_t) dim * dim;
+    for (size_t e = 0; e < count; e++) {
+        int neg = (int) (next_random(state) & 1);
+        uint64_t carry = 1;
+        for (int l = 0; l < W->limbs; l++) {
+            uint64_t w = 64L * l < bits ? next_random(state) : 0;
+            if (64L * l < bits && bits - 64L * l < 64) w &= (1ULL << (bits - 64L * l)) - 1;
+            if (neg) {
+                w = ~w + carry;
+                carry = carry && w == 0;
+            }
+            W->data[l * count + e] = w;
+        }
+    }
+    return W;
+}
+
+static int same_wide(const WideMatrix* X, const WideMatrix* Y) {
+    size_t count = (size_t) X->n * X->m;
+    if (X->limbs != Y->limbs) return 0;
+    for (size_t x = 0; x < count * X->limbs; x++) {
+        if (X->data[x] != Y->data[x]) return 0;
+    }
+    return 1;
+}
+
+typedef struct {
+    const WideMatrix* A;
+    const WideMatrix* B;
+    WideProductMethod method;
+    ResidueInt8Kernel kernel;
+    ThreadPool* pool;
+} WideCall;
+
+static WideMatrix* wide_product(const WideCall* c) {
+    return c->method == WIDE_PRODUCT_RNS ? multiply_matrix_rns_wide(c->A, c->B, c->pool)
+                                         : multiply_matrix_digits_wide(c->A, c->B, c->kernel, c->pool);
+}
+
+static int wide_call(void* arg) {
+    free_wide_matrix(wide_product((const WideCall*) arg));
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int default_cases[] = {256, 60, 256, 250, 256, 500, 128, 1000};
+    int num_cases = (argc > 2) ? (argc - 1) / 2 : 4;
+    ThreadPool* pool = thread_pool_get_default();
+    ResidueInt8Kernel kernel = residue_gemm_int8_default_kernel();
+    BenchConfig cfg = BENCH_CONFIG_DEFAULT;
+    const char* method_names[] = {"rns", "digits"};
+    uint64_t state = 12345;
+
+    FILE* json = bench_json_open(BENCH_WIDE_JSON, &cfg);
+    if (!json) return 1;
+    printf("int8 kernel %s, %d threads, timer %s (median, 95%% CI; model times are single-thread)\n",
+           residue_gemm_int8_kernel_name(kernel), thread_pool_size(pool), bench_timer_name());
+    int records = 0;
+    for (int c = 0; c < num_cases; c++) {
+        int dim = (argc > 2) ? atoi(argv[1 + 2 * c]) : default_cases[2 * c];
+        long bits = (argc > 2) ? atol(argv[2 + 2 * c]) : default_cases[2 * c + 1];
+        WideMatrix* A = random_wide(dim, bits, &state);
+        WideMatrix* B = random_wide(dim, bits, &state);
+        WideCall calls[2] = { { A, B, WIDE_PRODUCT_RNS, kernel, pool }, { A, B, WIDE_PRODUCT_DIGITS, kernel, pool } };
+
+        WideMatrix* C_rns = wide_product(&calls[0]);
+        WideMatrix* C_digits = wide_product(&calls[1]);
+        int ok = same_wide(C_rns, C_digits);
+        free_wide_matrix(C_rns);
+        free_wide_matrix(C_digits);
+
+        printf("%5d^3 %5ld-bit", dim, bits);
+        for (int t = 0; t < 2; t++) {
+            BenchStats stats;
+            bench_measure(wide_call, &calls[t], &cfg, &stats);
+            double model_ms = wide_product_cost(calls[t].method, bits, bits, dim, dim, dim, kernel) * 1e3;
+            printf("  %s", method_names[t]);
+            bench_print_stats(&stats);
+            printf(" (model %9.3f)", model_ms);
+
+            bench_json_record(json, records++);
+            fprintf(json, "\"method\": \"%s\", \"dim\": %d, \"bits\": %ld, \"threads\": %d, "
+                          "\"model_ms\": %.6g, \"status\": \"%s\"",
+                    method_names[t], dim, bits, thread_pool_size(pool), model_ms, ok ? "ok" : "mismatch");
+            bench_json_stats(json, &stats);
+            fprintf(json, "}");
+            bench_free_stats(&stats);
+        }
+        printf("  auto %-6s  %s\n",
+               wide_product_choose(bits, bits, dim, dim, dim, kernel) == WIDE_PRODUCT_DIGITS ? "digits" : "rns",
+               ok ? "OK" : "MISMATCH");
+
+        free_wide_matrix(A);
+        free_wide_matrix(B);
+    }
+    if (bench_json_close(json) != 0) return 1;
+    printf("Results saved in: %s\n", BENCH_WIDE_JSON);
+    return 0;
+}
@@ -0,0 +1,264 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <cpuid.h>
+#include <x86intrin.h>
+#include "xalloc.h"
+
+/**
+ * Timing harness shared by the benchmarks of naive/ and amx/new_version/.
+ *
+ * Every measurement runs untimed warmup calls, then takes samples until the
+ * 95% confidence interval of the mean is within target_ci of it (or the
+ * sample or time budget runs out). A sample times a batch of back-to-back
+ * calls, sized during warmup to last at least BENCH_MIN_SAMPLE_MS, so tiny
+ * calls are not lost in the timer overhead. Time comes from the TSC (rdtscp)
+ * when it is invariant, calibrated against CLOCK_MONOTONIC_RAW, and from
+ * CLOCK_MONOTONIC_RAW otherwise.
+ *
+ * Results are written as JSON: bench_json_open writes the timer and the
+ * configuration, the caller writes one object per record with its own
+ * fields followed by bench_json_stats, and bench_json_close ends the file.
+ */
+
+#define BENCH_MIN_SAMPLE_MS 0.05
+
+typedef struct {
+    int warmup;          // untimed calls before sampling
+    int min_reps;        // samples taken before convergence is tested
+    int max_reps;
+    double target_ci;    // stop when the 95% CI half-width is below this fraction of the mean
+    double max_seconds;  // sampling budget of one measurement
+} BenchConfig;
+
+#define BENCH_CONFIG_DEFAULT { 3, 10, 200, 0.01, 2.0 }
+
+typedef struct {
+    int reps;            // samples taken
+    int batch;           // calls per sample
+    int converged;       // CI target reached
+    double median_ms, p10_ms, p90_ms;
+    double mean_ms, stddev_ms, min_ms;
+    double ci95_pct;     // 95% CI half-width of the mean, in percent of the mean
+    double* samples_ms;  // reps per-call times, released by bench_free_stats
+} BenchStats;
+
+/////////////////////////////
+//          Timer          //
+/////////////////////////////
+
+static double bench_ticks_per_ns = 0;  // 0: CLOCK_MONOTONIC_RAW nanoseconds are the ticks
+
+static inline uint64_t bench_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint64_t bench_ticks(void) {
+    if (bench_ticks_per_ns > 0) {
+        unsigned aux;
+        return __rdtscp(&aux);
+    }
+    return bench_clock_ns();
+}
+
+static inline double bench_ticks_to_ms(uint64_t ticks) {
+    return bench_ticks_per_ns > 0 ? ticks / bench_ticks_per_ns * 1e-6 : ticks * 1e-6;
+}
+
+/**
+ * Uses the TSC if CPUID reports it invariant; calibrates it over ~20 ms.
+ */
+static inline void bench_timer_init(void) {
+    static int done = 0;
+    if (done) return;
+    done = 1;
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return;
+    unsigned aux;
+    uint64_t c0 = bench_clock_ns(), t0 = __rdtscp(&aux);
+    while (bench_clock_ns() - c0 < 20000000ULL) {}
+    uint64_t c1 = bench_clock_ns(), t1 = __rdtscp(&aux);
+    bench_ticks_per_ns = (double) (t1 - t0) / (double) (c1 - c0);
+}
+
+static inline const char* bench_timer_name(void) {
+    return bench_ticks_per_ns > 0 ? "tsc" : "clock_monotonic_raw";
+}
+
+/////////////////////////////
+//        Statistics       //
+/////////////////////////////
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+static inline double bench_t95(int df) {
+    static const double t[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    if (df < 1) return INFINITY;
+    return df <= 30 ? t[df - 1] : 1.96;
+}
+
+static inline int bench_compare_double(const void* a, const void* b) {
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Linear interpolation between the closest ranks of a sorted array
+static inline double bench_percentile(const double* sorted, int n, double q) {
+    double pos = q * (n - 1);
+    int lo = (int) pos;
+    if (lo + 1 >= n) return sorted[n - 1];
+    return sorted[lo] + (pos - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+static inline void bench_mean_ci(const double* x, int n, double* mean, double* stddev, double* ci_pct) {
+    double s = 0, ss = 0;
+    for (int i = 0; i < n; i++) s += x[i];
+    *mean = s / n;
+    for (int i = 0; i < n; i++) ss += (x[i] - *mean) * (x[i] - *mean);
+    *stddev = n > 1 ? sqrt(ss / (n - 1)) : 0;
+    *ci_pct = n > 1 && *mean > 0 ? 100.0 * bench_t95(n - 1) * *stddev / sqrt((double) n) / *mean : INFINITY;
+}
+
+/////////////////////////////
+//       Measurement       //
+/////////////////////////////
+
+typedef int (*BenchFn)(void* ctx);
+
+/**
+ * Measures fn(ctx), which returns 0 on success.
+ *
+ * @return 0, or the first non-zero code of fn (out is then left empty)
+ */
+static inline int bench_measure(BenchFn fn, void* ctx, const BenchConfig* cfg, BenchStats* out) {
+    bench_timer_init();
+    memset(out, 0, sizeof(*out));
+
+    // Warmup, and the batch size that makes a sample last BENCH_MIN_SAMPLE_MS
+    double single_ms = 0;
+    for (int w = 0; w < (cfg->warmup > 1 ? cfg->warmup : 1); w++) {
+        uint64_t t0 = bench_ticks();
+        int rc = fn(ctx);
+        single_ms = bench_ticks_to_ms(bench_ticks() - t0);
+        if (rc != 0) return rc;
+    }
+    int batch = 1;
+    if (single_ms < BENCH_MIN_SAMPLE_MS) {
+        batch = single_ms > 0 ? (int) ceil(BENCH_MIN_SAMPLE_MS / single_ms) : 1000;
+        if (batch > 1000000) batch = 1000000;
+    }
+
+    out->samples_ms = xmalloc((size_t) cfg->max_reps * sizeof(double));
+    out->batch = batch;
+    uint64_t budget_start = bench_clock_ns();
+    int n = 0;
+    while (n < cfg->max_reps) {
+        uint64_t t0 = bench_ticks();
+        for (int b = 0; b < batch; b++) {
+            int rc = fn(ctx);
+            if (rc != 0) {
+                free(out->samples_ms);
+                memset(out, 0, sizeof(*out));
+                return rc;
+            }
+        }
+        out->samples_ms[n++] = bench_ticks_to_ms(bench_ticks() - t0) / batch;
+
+        double mean, stddev, ci;
+        bench_mean_ci(out->samples_ms, n, &mean, &stddev, &ci);
+        if (n >= cfg->min_reps && ci <= 100.0 * cfg->target_ci) {
+            out->converged = 1;
+            break;
+        }
+        if (n >= 3 && (bench_clock_ns() - budget_start) * 1e-9 >= cfg->max_seconds) break;
+    }
+
+    out->reps = n;
+    bench_mean_ci(out->samples_ms, n, &out->mean_ms, &out->stddev_ms, &out->ci95_pct);
+    double* sorted = xmalloc((size_t) n * sizeof(double));
+    memcpy(sorted, out->samples_ms, (size_t) n * sizeof(double));
+    qsort(sorted, n, sizeof(double), bench_compare_double);
+    out->min_ms = sorted[0];
+    out->median_ms = bench_percentile(sorted, n, 0.5);
+    out->p10_ms = bench_percentile(sorted, n, 0.1);
+    out->p90_ms = bench_percentile(sorted, n, 0.9);
+    free(sorted);
+    return 0;
+}
+
+static inline void bench_free_stats(BenchStats* stats) {
+    free(stats->samples_ms);
+    stats->samples_ms = NULL;
+}
+
+/**
+ * Prints the median and the CI half-width, with a trailing * if the CI
+ * target was not reached, without a newline.
+ */
+static inline void bench_print_stats(const BenchStats* s) {
+    printf("%10.4g ms ±%5.2f%%%s", s->median_ms, s->ci95_pct, s->converged ? "" : "*");
+}
+
+/////////////////////////////
+//           JSON          //
+/////////////////////////////
+
+/**
+ * Creates path and writes {"timer": ..., "config": {...}, "results": [
+ *
+ * @return The file, or NULL (with a message on stderr)
+ */
+static inline FILE* bench_json_open(const char* path, const BenchConfig* cfg) {
+    bench_timer_init();
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror("Failed to create JSON results file");
+        return NULL;
+    }
+    fprintf(f, "{\n  \"timer\": \"%s\",\n", bench_timer_name());
+    fprintf(f, "  \"config\": {\"warmup\": %d, \"min_reps\": %d, \"max_reps\": %d, \"target_ci\": %g, "
+               "\"max_seconds\": %g},\n", cfg->warmup, cfg->min_reps, cfg->max_reps, cfg->target_ci, cfg->max_seconds);
+    fprintf(f, "  \"results\": [");
+    return f;
+}
+
+/**
+ * Starts record number index (from 0): the caller then writes its own
+ * "key": value fields, bench_json_stats and the closing brace.
+ */
+static inline void bench_json_record(FILE* f, int index) {
+    fprintf(f, "%s\n    {", index ? "," : "");
+}
+
+/**
+ * Writes the fields of s, each preceded by ", " (nothing if s holds no samples).
+ */
+static inline void bench_json_stats(FILE* f, const BenchStats* s) {
+    if (s->reps == 0) return;
+    fprintf(f, ", \"reps\": %d, \"batch\": %d, \"converged\": %s, \"median_ms\": %.9g, \"p10_ms\": %.9g, "
+               "\"p90_ms\": %.9g, \"mean_ms\": %.9g, \"stddev_ms\": %.9g, \"min_ms\": %.9g, "
+               "\"ci95_pct\": %.4g, \"samples_ms\": [",
+            s->reps, s->batch, s->converged ? "true" : "false", s->median_ms, s->p10_ms, s->p90_ms,
+            s->mean_ms, s->stddev_ms, s->min_ms, s->ci95_pct);
+    for (int i = 0; i < s->reps; i++) fprintf(f, "%s%.9g", i ? ", " : "", s->samples_ms[i]);
+    fprintf(f, "]");
+}
+
+/**
+ * Ends the results array and closes f. Returns 0, or -1 if the file could not be written.
+ */
+static inline int bench_json_close(FILE* f) {
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,90 @@
+#ifndef CRT_RECONSTRUCT_H
+#define CRT_RECONSTRUCT_H
+
+#include <stdint.h>
+
+/**
+ * Centered CRT reconstruction based on the approximate CRT sum.
+ *
+ * For residues r_i of x modulo m_i, let t_i = r_i * y_i mod m_i with
+ * y_i = (M/m_i)^-1 mod m_i. Then
+ *
+ *     x ≡ sum_i t_i * (M/m_i)   and   sum_i t_i * (M/m_i) = M * sum_i t_i/m_i,
+ *
+ * so the centered value in (-M/2, M/2] is
+ *
+ *     v = sum_i t_i * (M/m_i) - q * M,   q = round(sum_i t_i/m_i).
+ *
+ * The sum of fractions is evaluated in 64.64 fixed point (t_i times
+ * ceil(2^64/m_i), split in 32-bit halves so every product is a 32×32→64
+ * multiply), which gives the sign of v and q without any bignum comparison.
+ * Entries are processed in structure-of-arrays chunks so the loops over the
+ * output matrix vectorize.
+ *
+ * The fixed-point sum overestimates by less than E = sum_i m_i units of 2^-64.
+ * Values whose fraction lies within E of 1/2 (i.e. |v| within E·M/2^64 of M/2)
+ * are reported as ambiguous: a basis with at least one spare bit over the
+ * result bound never produces them.
+ */
+typedef struct {
+    int k;
+    int* moduli;
+    uint32_t* inv;          // y_i = (M/m_i)^-1 mod m_i
+    uint32_t* inv_shoup;    // floor(y_i * 2^32 / m_i), for Shoup's modular multiplication
+    uint32_t* frac_hi;      // ceil(2^64/m_i) split in two 32-bit halves
+    uint32_t* frac_lo;
+    uint64_t* Mi_lo;        // (M/m_i) mod 2^64
+    uint64_t M_lo;          // M mod 2^64
+    uint64_t error_bound;   // E = sum_i m_i
+    uint64_t int64_limit;   // |fraction| (units of 2^-64) above which |v| >= 2^63
+} CRTBasis;
+
+#define CRT_NEGATIVE  1     // v < 0
+#define CRT_AMBIGUOUS 2     // |v| too close to M/2 to be decided by the fixed-point sum
+#define CRT_EXCEEDS_INT64 4 // |v| >= 2^63 (up to the E·M/2^64 resolution of the sum)
+#define CRT_NEAR_ZERO 8     // |v| within E·M/2^64 of 0: CRT_NEGATIVE may be wrong (q is not)
+
+/**
+ * Inverse of a modulo m (m < 2^31), or 0 if a and m are not coprime. Shared
+ * by the CRT, mixed-radix and streaming reconstructions.
+ */
+uint32_t crt_modinv(uint64_t a, uint64_t m);
+
+/**
+ * Precompute the reconstruction constants of a basis of k pairwise coprime
+ * moduli (2 <= m_i < 2^31). Returns NULL if the moduli are not pairwise coprime.
+ */
+CRTBasis* crt_basis_create(const int* moduli, int k);
+
+/**
+ * Free a CRTBasis.
+ */
+void crt_basis_free(CRTBasis* basis);
+
+/**
+ * Approximate CRT on count entries.
+ *
+ * @param basis Reconstruction constants
+ * @param residues residues[i][e] is the residue in [0, m_i) of entry e modulo m_i
+ * @param count Number of entries
+ * @param t If not NULL, t[i][e] receives t_i = r_i * y_i mod m_i
+ * @param q Receives the rounded quotient round(sum_i t_i/m_i) of each entry
+ * @param flags Receives CRT_NEGATIVE / CRT_AMBIGUOUS / CRT_EXCEEDS_INT64 / CRT_NEAR_ZERO for each entry
+ */
+void crt_centered_quotients(const CRTBasis* basis, const int* const* residues, long count,
+                            uint32_t* const* t, int32_t* q, uint8_t* flags);
+
+/**
+ * Centered reconstruction into int64_t.
+ *
+ * out[e] receives v mod 2^64, which is the exact value whenever |v| < 2^63.
+ * Every entry with |v| >= 2^63 + E·M/2^64 is counted as out of range, so the
+ * check is complete for bases with M < 2^127 / E; beyond that only entries
+ * whose wrapped value has the wrong sign are caught.
+ *
+ * @return Number of entries that are ambiguous or do not fit in an int64_t
+ */
+long crt_reconstruct_centered_int64(const CRTBasis* basis, const int* const* residues, long count,
+                                    int64_t* out);
+
+#endif // CRT_RECONSTRUCT_H
@@ -0,0 +1,45 @@
+#ifndef CRT_RECONSTRUCT_GMP_H
+#define CRT_RECONSTRUCT_GMP_H
+
+#include <gmp.h>
+#include "crt_reconstruct.h"
+
+/**
+ * CRTBasis together with the multiprecision constants M/m_i and M needed to
+ * reconstruct into mpz_t.
+ */
+typedef struct {
+    CRTBasis* basis;
+    mpz_t* Mi;      // M/m_i
+    mpz_t M;
+} CRTBasisMpz;
+
+/**
+ * Precompute the reconstruction constants of a basis of k pairwise coprime
+ * moduli (2 <= m_i < 2^31). Returns NULL if the moduli are not pairwise coprime.
+ */
+CRTBasisMpz* crt_basis_mpz_create(const int* moduli, int k);
+
+/**
+ * Free a CRTBasisMpz.
+ */
+void crt_basis_mpz_free(CRTBasisMpz* basis);
+
+/**
+ * Centered reconstruction into mpz_t.
+ *
+ * Each entry is v = sum_i t_i * (M/m_i) - q * M with t_i and q from
+ * crt_centered_quotients, i.e. k + 1 multiply-accumulates by a word and no
+ * reduction or comparison against M. Ambiguous entries (|v| within the
+ * fixed-point error of M/2) fall back to an exact reduction.
+ *
+ * @param basis Reconstruction constants
+ * @param residues residues[i][e] is the residue in [0, m_i) of entry e modulo m_i
+ * @param count Number of entries
+ * @param out count initialized mpz_t receiving the centered values in (-M/2, M/2]
+ * @return Number of entries that needed the exact fallback
+ */
+long crt_reconstruct_centered_mpz(const CRTBasisMpz* basis, const int* const* residues, long count,
+                                  mpz_t* out);
+
+#endif // CRT_RECONSTRUCT_GMP_H
@@ -0,0 +1,58 @@
+#ifndef DGEMM_INT8_H
+#define DGEMM_INT8_H
+
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+
+/**
+ * Emulated double-precision GEMM on the int8 kernels (Ozaki scheme II).
+ *
+ * Row i of A is scaled by 2^sa_i and column j of B by 2^sb_j so that its
+ * largest entry lies just below 2^bits, and rounded to integers A', B'. The
+ * integer product A'·B' is computed exactly in RNS over k 8-bit primes, one
+ * signed int8 residue GEMM per prime (residue_gemm_int8_rns, same kernels and
+ * dispatch as the integer pipelines), reconstructed with the approximate CRT
+ * into fixed-width integers and rounded once to double:
+ *
+ *     C_ij = round(sum_r A'_ir·B'_rj · 2^-(sa_i + sb_j))
+ *
+ * The number of moduli is the accuracy knob: each one adds about 3.8 bits to
+ * both scaled operands, with bits = floor((log2 M - ceil(log2 m) - 2) / 2)
+ * for the product M of the primes and inner dimension m, capped at 62. The
+ * only error is the rounding of A and B to bits-bit integers, so with bits >=
+ * 53 + (spread of binades within each row of A and column of B) the result is
+ * the correctly rounded product (except for subnormal results, which are
+ * rounded twice). Smaller entries of a row lose their low bits first.
+ */
+
+/**
+ * Number of 8-bit primes available, the largest usable moduli count.
+ */
+int dgemm_int8_max_moduli(void);
+
+/**
+ * Bits of the scaled operands with the given number of moduli and inner
+ * dimension m (< 1 if the basis is too small).
+ */
+int dgemm_int8_bits(int moduli, int m);
+
+/**
+ * Smallest number of moduli giving at least bits bits (53 for inputs
+ * represented exactly when they share a binade), or 0 if bits is out of reach.
+ */
+int dgemm_int8_moduli_for_bits(int bits, int m);
+
+/**
+ * C = A·B for row-major A (n × m), B (m × p) and C (n × p) with leading
+ * dimensions lda, ldb and ldc.
+ *
+ * @param moduli Number of 8-bit primes, 1 <= moduli <= dgemm_int8_max_moduli()
+ * @param kernel int8 kernel for the residue GEMMs (falls back to scalar if not available)
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ * @return 0 on success, -1 if the basis leaves less than one bit per operand
+ *         or an input is not finite (C is then left untouched)
+ */
+int dgemm_int8(const double* A, int lda, const double* B, int ldb, double* C, int ldc, int n, int m, int p,
+               int moduli, ResidueInt8Kernel kernel, ThreadPool* pool);
+
+#endif // DGEMM_INT8_H
@@ -2,6 +2,7 @@
 #define FILE_IO_GMP_H
 
 #include <gmp.h>
+#include "thread_pool.h"
 
 /**
  * Reads a matrix of mpz_t from a text file.
@@ -23,4 +24,43 @@ mpz_t** read_mpz_matrix_from_file(const char* filename, int* n, int* m);
  */
 void write_mpz_matrix_to_file(const char* filename, mpz_t** mat, int n, int m);
 
+typedef enum {
+    MPZ_FILE_DECIMAL,   // "n m" then base-10 entries, as write_mpz_matrix_to_file
+    MPZ_FILE_HEX,       // "n m" then base-16 entries (either case, optional '-', no prefix)
+    MPZ_FILE_RAW_LIMBS  // binary: MPZ_RAW_MAGIC, n, m, then per entry a signed
+                        // 64-bit word count and the magnitude in 64-bit words,
+                        // least significant first, all little-endian
+} MpzFileFormat;
+
+#define MPZ_RAW_MAGIC "MPZRAW1"
+
+/**
+ * Parallel reader for the formats above. The file is mapped and split into
+ * chunks that workers convert independently (mpn_set_str for text, which is
+ * subquadratic in the digit count, and mpz_import for raw limbs) into an
+ * arena matrix sized from the longest entry. Entries are counted before the
+ * matrix is allocated, so a header that does not match the body is rejected
+ * without allocating n·m entries.
+ *
+ * Text is parsed strictly: entries are an optional '-' and digits of the
+ * base, separated by whitespace, exactly n·m of them.
+ *
+ * @param pool Thread pool to use, or NULL to run on the calling thread
+ * @return The matrix, or NULL (with a message on stderr) if the file cannot
+ *         be read or is malformed
+ */
+mpz_t** read_mpz_matrix_from_file_pool(const char* filename, int* n, int* m, MpzFileFormat format,
+                                       ThreadPool* pool);
+
+/**
+ * Parallel writer for the formats above: blocks of rows are converted
+ * (mpz_get_str / mpz_export) into per-task buffers, which are then written
+ * in order with writev. Text output matches write_mpz_matrix_to_file.
+ *
+ * @param pool Thread pool to use, or NULL to run on the calling thread
+ * @return 0 on success, -1 (with a message on stderr) on an I/O error
+ */
+int write_mpz_matrix_to_file_pool(const char* filename, mpz_t** mat, int n, int m, MpzFileFormat format,
+                                  ThreadPool* pool);
+
 #endif // FILE_IO_GMP_H
@@ -0,0 +1,39 @@
+#ifndef FILE_IO_TEXT_H
+#define FILE_IO_TEXT_H
+
+#include "matrix_file.h"
+#include "thread_pool.h"
+
+/**
+ * Parallel loader for text matrices (.ssv / .txt: "n m" followed by n·m
+ * integers separated by spaces, tabs or newlines, as written by the
+ * save_matrix_* functions).
+ *
+ * The file is mapped, the body split at line boundaries into chunks, and
+ * each chunk scanned twice: a first pass classifies 64 bytes at a time with
+ * AVX2 and counts the values in the chunk, and after a prefix sum over the
+ * chunks a second pass parses its values (up to 8 digits in one SWAR step)
+ * straight into their place in the destination. Parsing is strict: anything
+ * other than an optionally signed decimal integer in range of the element
+ * type, or a value count other than n·m, is an error.
+ */
+
+typedef struct {
+    long line;          // 1-based line of the offending token (0 if the file could not be read)
+    long column;        // 1-based byte column within that line
+    char message[128];
+} TextMatrixError;
+
+/**
+ * Loads a text matrix into a contiguous n × m buffer of the given integer
+ * element type (MATRIX_FILE_INT8, UINT8, INT16, INT32 or INT64), aligned to
+ * MATRIX_FILE_ALIGN bytes and released with free().
+ *
+ * @param pool Thread pool to use, or NULL to parse on the calling thread
+ * @param err Receives the location and reason of a failure, may be NULL
+ * @return The buffer, or NULL on error
+ */
+void* load_text_matrix(const char* filename, MatrixFileType type, int* n, int* m, ThreadPool* pool,
+                       TextMatrixError* err);
+
+#endif // FILE_IO_TEXT_H
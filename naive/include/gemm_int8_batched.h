@@ -0,0 +1,68 @@
+#ifndef GEMM_INT8_BATCHED_H
+#define GEMM_INT8_BATCHED_H
+
+#include <stdint.h>
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+
+/**
+ * Batched products of many small int8 matrices of the same shape:
+ *
+ *     C_b = A_b · B_b (mod mod),   0 <= b < batch_count
+ *
+ * with A_b n × m, B_b m × p (signed int8) and C_b n × p (int32). When mod > 0
+ * the results are reduced to [0, mod), which gives the residue products of an
+ * RNS batch directly from centered residues; the int32 sums are reduced every
+ * GEMM_INT8_BATCHED_WINDOW steps of K, so m is not limited. With mod == 0
+ * they are the exact int32 products, which needs m <=
+ * GEMM_INT8_BATCHED_EXACT_MAX_M (larger m is rejected).
+ *
+ * The tile configuration is loaded once per worker for the whole batch, not
+ * once per product. With the AMX kernel, problems with n, p <= 16 and
+ * m <= 64 are packed block-diagonally so that several of them share one
+ * 16 × 16 tile product: problem s of a group occupies rows [s·n, (s+1)·n) and
+ * K range [s·m4, (s+1)·m4) of the A tile (m4 = m rounded up to 4) and the
+ * matching K range and columns [s·p, (s+1)·p) of the B tile, so the diagonal
+ * blocks of C are the individual products (4 problems of 4 × 4 or 2 of 8 × 8
+ * per tile op). Larger shapes go through 16 × 16 × 64 tiles one problem at a
+ * time. The other kernels run a plain loop per problem, vectorized for their
+ * instruction set. The batch is split into contiguous ranges, one per worker.
+ */
+
+/**
+ * Steps of K summed in int32 between reductions: 2^16 products of at most
+ * 128^2 stay below 2^30. A multiple of the AMX K step (64).
+ */
+#define GEMM_INT8_BATCHED_WINDOW 65536
+
+/**
+ * Largest m for exact (mod == 0) products: m·128^2 < 2^31.
+ */
+#define GEMM_INT8_BATCHED_EXACT_MAX_M 131071
+
+/**
+ * Pointer-array batch: A[b], B[b] and C[b] point to the b-th problem.
+ *
+ * @param lda, ldb, ldc Leading dimensions (elements) shared by all problems
+ * @param mod Modulus for the results, or 0 for exact int32 products
+ * @param kernel Kernel to use; an unavailable one falls back to the scalar kernel
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void gemm_int8_batched(const int8_t* const* A, int lda, const int8_t* const* B, int ldb,
+                       int32_t* const* C, int ldc, int n, int m, int p, int batch_count, int mod,
+                       ResidueInt8Kernel kernel, ThreadPool* pool);
+
+/**
+ * Strided batch: problem b starts at A + b*stride_a, B + b*stride_b and C + b*stride_c.
+ */
+void gemm_int8_batched_strided(const int8_t* A, int lda, long stride_a, const int8_t* B, int ldb, long stride_b,
+                               int32_t* C, int ldc, long stride_c, int n, int m, int p, int batch_count,
+                               int mod, ResidueInt8Kernel kernel, ThreadPool* pool);
+
+/**
+ * Number of problems of shape n × m · m × p that the AMX kernel packs into
+ * one tile product (0 if the shape needs full tiles).
+ */
+int gemm_int8_batched_group_size(int n, int m, int p);
+
+#endif // GEMM_INT8_BATCHED_H
@@ -0,0 +1,68 @@
+#ifndef MATRIX_DIGIT_MUL_WIDE_H
+#define MATRIX_DIGIT_MUL_WIDE_H
+
+#include "matrix_utils_wide.h"
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+
+/**
+ * Product methods for WideMatrix.
+ *
+ * RNS converts both operands to residues modulo 8-bit or 26-bit primes, runs
+ * one residue GEMM per prime and reconstructs (multiply_matrix_rns_wide). DIGITS
+ * slices every entry into signed 8-bit digits and runs one int8 GEMM per
+ * diagonal of digit pairs (multiply_matrix_digits_wide): quadratic in the
+ * number of digits, but on the int8 kernels and with no conversion beyond
+ * the digit split and the carry propagation.
+ */
+typedef enum {
+    WIDE_PRODUCT_AUTO = 0,   // cheaper of the two by wide_product_cost
+    WIDE_PRODUCT_RNS,
+    WIDE_PRODUCT_DIGITS
+} WideProductMethod;
+
+/**
+ * Number of balanced 8-bit digits d_s in [-128, 127] for entries with
+ * |x| < 2^bits: x = sum_s d_s·2^(8s).
+ */
+int wide_digit_count(long bits);
+
+/**
+ * Multiply two WideMatrix A (n × m) and B (m × p) by digit slicing.
+ *
+ * @param kernel int8 kernel for the digit GEMMs (falls back to scalar if not available)
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ * @return Newly allocated n × p matrix, to be released with free_wide_matrix
+ *         (NULL if the inner dimensions differ)
+ */
+WideMatrix* multiply_matrix_digits_wide(const WideMatrix* A, const WideMatrix* B, ResidueInt8Kernel kernel,
+                                        ThreadPool* pool);
+
+/**
+ * Estimated single-thread time in seconds of one method on an n × m · m × p
+ * product of entries below 2^bits_a and 2^bits_b.
+ *
+ * The model counts multiply-accumulates of each GEMM kernel, plus the
+ * conversion, reconstruction, digit split and carry passes, with per-operation
+ * costs measured on an AVX-512 / AMX machine. It only needs to rank the two
+ * methods; the absolute times are rough.
+ */
+double wide_product_cost(WideProductMethod method, long bits_a, long bits_b, int n, int m, int p,
+                         ResidueInt8Kernel kernel);
+
+/**
+ * Method picked for WIDE_PRODUCT_AUTO: the WIDE_PRODUCT environment variable
+ * ("rns" or "digits") if set, otherwise the cheaper one by wide_product_cost.
+ */
+WideProductMethod wide_product_choose(long bits_a, long bits_b, int n, int m, int p, ResidueInt8Kernel kernel);
+
+/**
+ * Multiply two WideMatrix with the given method, using the default int8 kernel.
+ *
+ * @return Newly allocated n × p matrix, to be released with free_wide_matrix
+ *         (NULL if the inner dimensions differ)
+ */
+WideMatrix* multiply_matrix_wide(const WideMatrix* A, const WideMatrix* B, WideProductMethod method,
+                                 ThreadPool* pool);
+
+#endif // MATRIX_DIGIT_MUL_WIDE_H
@@ -0,0 +1,134 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Binary matrix files, read back through mmap without copies.
+ *
+ * Layout (little-endian):
+ *
+ *     MatrixFileHeader                       80 bytes
+ *     moduli[planes]  (int32, if has_basis)
+ *     zero padding up to payload_offset      multiple of MATRIX_FILE_ALIGN
+ *     plane 0, plane 1, ...                  each rows × row_stride elements,
+ *                                            starting at a multiple of MATRIX_FILE_ALIGN
+ *
+ * A file holds one plane for an ordinary matrix, one plane per modulus for
+ * residue planes (with the basis stored after the header), or one plane per
+ * limb for a WideMatrix (its limb-sliced layout, MATRIX_FILE_LIMB64). The
+ * checksum covers everything from payload_offset to the end of the file.
+ */
+
+#define MATRIX_FILE_MAGIC "RNSMATF"
+#define MATRIX_FILE_VERSION 1
+#define MATRIX_FILE_ALIGN 64
+
+typedef enum {
+    MATRIX_FILE_INT8 = 1,
+    MATRIX_FILE_UINT8 = 2,
+    MATRIX_FILE_INT16 = 3,
+    MATRIX_FILE_INT32 = 4,
+    MATRIX_FILE_INT64 = 5,
+    MATRIX_FILE_FLOAT64 = 6,
+    MATRIX_FILE_LIMB64 = 7     // uint64 limbs of two's complement integers, one plane per limb
+} MatrixFileType;
+
+typedef struct {
+    char magic[8];            // MATRIX_FILE_MAGIC with its terminating zero
+    uint32_t version;
+    uint32_t type;            // MatrixFileType
+    uint32_t elem_size;       // bytes per element
+    uint32_t alignment;       // payload and plane alignment in bytes
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t row_stride;      // elements from one row to the next, >= cols
+    uint64_t plane_stride;    // bytes from one plane to the next
+    uint32_t planes;
+    uint32_t has_basis;       // 1 if planes int32 moduli follow the header
+    uint64_t payload_offset;  // bytes from the start of the file to plane 0
+    uint64_t checksum;        // matrix_file_checksum of the payload
+} MatrixFileHeader;
+
+typedef struct {
+    MatrixFileType type;
+    int rows;
+    int cols;
+    int planes;
+    long row_stride;          // elements between rows
+    size_t elem_size;
+    size_t plane_stride;      // bytes between planes
+    const int* moduli;        // basis of residue planes, or NULL
+    const void* data;         // plane 0, MATRIX_FILE_ALIGN-aligned
+    uint64_t checksum;
+    void* map;
+    size_t map_bytes;
+    int writable;             // created by matrix_file_create
+} MatrixFile;
+
+/**
+ * Size in bytes of one element of the given type, or 0 for an unknown type.
+ */
+size_t matrix_file_elem_size(MatrixFileType type);
+
+/**
+ * 64-bit checksum of a byte range (four-lane multiply-rotate hash over
+ * 8-byte words, tail zero-padded).
+ */
+uint64_t matrix_file_checksum(const void* data, size_t bytes);
+
+/**
+ * Writes a matrix file. Plane l is read from data[l], rows × cols elements
+ * ld elements apart; the file stores them densely (row_stride = cols).
+ *
+ * @param moduli planes moduli stored as the basis, or NULL
+ * @return 0 on success, -1 on an invalid argument or an I/O error
+ */
+int matrix_file_write(const char* filename, MatrixFileType type, int rows, int cols, int planes,
+                      const void* const* data, long ld, const int* moduli);
+
+/**
+ * Maps a matrix file read-only. The header is validated against the file
+ * size; with verify set the checksum is recomputed as well (touching every
+ * page). Returns NULL, with a message on stderr, if the file is missing,
+ * malformed, truncated or fails the checksum.
+ */
+MatrixFile* matrix_file_open(const char* filename, int verify);
+
+/**
+ * Start of plane l (row i at element i · row_stride).
+ */
+const void* matrix_file_plane(const MatrixFile* file, int plane);
+
+/**
+ * Creates a matrix file with a zero payload and maps it read-write, so that
+ * its planes can be filled in place, piece by piece, by code that never holds
+ * the whole matrix (the file is sized up front and stays sparse until
+ * written). The checksum is only valid after matrix_file_finish.
+ *
+ * @param moduli planes moduli stored as the basis, or NULL
+ * @return The handle, or NULL on an invalid argument or an I/O error
+ */
+MatrixFile* matrix_file_create(const char* filename, MatrixFileType type, int rows, int cols, int planes,
+                               const int* moduli);
+
+/**
+ * Writable start of plane l of a file from matrix_file_create, NULL for a
+ * file opened read-only.
+ */
+void* matrix_file_plane_writable(MatrixFile* file, int plane);
+
+/**
+ * Computes and stores the checksum of a created file and flushes it to disk.
+ *
+ * @return 0 on success, -1 if the file is read-only or the flush failed
+ */
+int matrix_file_finish(MatrixFile* file);
+
+/**
+ * Unmaps the file; pointers into it become invalid.
+ */
+void matrix_file_close(MatrixFile* file);
+
+#endif // MATRIX_FILE_H
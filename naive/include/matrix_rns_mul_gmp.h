@@ -0,0 +1,109 @@
+#ifndef MATRIX_RNS_MUL_GMP_H
+#define MATRIX_RNS_MUL_GMP_H
+
+#include <gmp.h>
+#include "thread_pool.h"
+#include "rns_residue_product.h"
+
+/**
+ * Size in bits of the primes used by multiply_matrix_rns_mpz_adaptive, which
+ * adds one modulus per step and so wants as few and as large moduli as the
+ * fp64 residue GEMM takes.
+ */
+#define RNS_MPZ_MODULUS_BITS RNS_PRODUCT_FP64_MODULUS_BITS
+
+/**
+ * Multiply two mpz_t matrices A[n][m] and B[m][p] using RNS.
+ *
+ * The basis is chosen from the largest entries of A and B so that every
+ * (possibly negative) entry of A·B is recovered exactly, with the primes of
+ * the residue GEMM backend rns_product_backend_choose picks for that bound
+ * (8-bit primes on the AMX int8 kernel, 26-bit primes on the fp64 kernel).
+ * The residue products run on the shared pool from thread_pool_get_default()
+ * and the result is reconstructed with the Chinese Remainder Theorem into the
+ * centered range.
+ *
+ * @param A First input matrix (mpz_t)
+ * @param B Second input matrix (mpz_t)
+ * @param n Number of rows in A
+ * @param m Number of columns in A and rows in B
+ * @param p Number of columns in B
+ * @return Newly allocated n × p matrix, to be released with free_mpz_matrix
+ */
+mpz_t** multiply_matrix_rns_mpz(mpz_t** A, mpz_t** B, int n, int m, int p);
+
+/**
+ * Same as multiply_matrix_rns_mpz, running the residue products and the
+ * reconstruction on the given pool.
+ *
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+mpz_t** multiply_matrix_rns_mpz_pool(mpz_t** A, mpz_t** B, int n, int m, int p, ThreadPool* pool);
+
+/**
+ * Stabilization test of multiply_matrix_rns_mpz_adaptive.
+ */
+typedef enum {
+    RNS_EARLY_CHECK_ALL = 0,     // mixed-radix digit of every entry
+    RNS_EARLY_CHECK_PROJECTION   // digit of one random linear combination of the entries
+} RNSEarlyCheck;
+
+/**
+ * Output-sensitive variant of multiply_matrix_rns_mpz_pool.
+ *
+ * Moduli (RNS_MPZ_MODULUS_BITS primes on the fp64 residue GEMM) are added one
+ * at a time (one residue GEMM each) instead of all the moduli the worst-case
+ * bound asks for. Once the product is determined by the moduli so far, every
+ * further modulus only appends a mixed-radix digit of 0 (or m_j - 1 for a
+ * negative value) and leaves the centered values unchanged;
+ * the loop stops after rns_early_confirmations(confidence_bits, check)
+ * consecutive such moduli, or at the bound. A value that is not yet
+ * determined produces such a digit with probability about 2/m_j, so the
+ * result is wrong with probability below 2^-confidence_bits for inputs
+ * unrelated to the primes.
+ *
+ * RNS_EARLY_CHECK_ALL computes the new digit of every entry (k word
+ * operations per entry for the k-th modulus). RNS_EARLY_CHECK_PROJECTION
+ * only follows y = sum_e w_e·C_e, an O(n·p) pass per modulus. The weights
+ * have rns_projection_weight_bits(confidence_bits) bits and are drawn from
+ * a fresh getrandom seed on every call, so a wrong entry goes unnoticed only
+ * if its error cancels in the combination, with probability below
+ * 2^-(confidence_bits + 1) whatever the inputs. y is that many bits plus
+ * log2(n·p) wider than the entries, so it needs a few more moduli.
+ *
+ * @param confidence_bits Target failure probability 2^-confidence_bits
+ * @param check Stabilization test
+ * @param out_k Receives the number of moduli used (may be NULL)
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ * @return Newly allocated n × p matrix, to be released with free_mpz_matrix
+ */
+mpz_t** multiply_matrix_rns_mpz_adaptive(mpz_t** A, mpz_t** B, int n, int m, int p, int confidence_bits,
+                                         RNSEarlyCheck check, int* out_k, ThreadPool* pool);
+
+/**
+ * Number of consecutive unchanged moduli multiply_matrix_rns_mpz_adaptive
+ * waits for to reach a failure probability of 2^-confidence_bits (at least 1).
+ * With RNS_EARLY_CHECK_PROJECTION half of that probability goes to the
+ * cancellation of an error in the projection, so the confirmations aim at
+ * 2^-(confidence_bits + 1).
+ */
+int rns_early_confirmations(int confidence_bits, RNSEarlyCheck check);
+
+/**
+ * Size in bits of the random weights of RNS_EARLY_CHECK_PROJECTION for a
+ * failure probability of 2^-confidence_bits (at least 31).
+ */
+int rns_projection_weight_bits(int confidence_bits);
+
+/**
+ * Classical triple loop product of two mpz_t matrices, used as the reference
+ * for multiply_matrix_rns_mpz.
+ */
+mpz_t** multiply_matrix_mpz_classical(mpz_t** A, mpz_t** B, int n, int m, int p);
+
+/**
+ * Largest size in bits of the absolute value of an entry of A.
+ */
+long mpz_matrix_max_bits(mpz_t** A, int n, int m);
+
+#endif // MATRIX_RNS_MUL_GMP_H
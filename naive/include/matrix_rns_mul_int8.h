@@ -2,10 +2,22 @@
 #define MATRIX_RNS_MUL_INT8_H
 
 #include <stdint.h>
+#include "thread_pool.h"
+
+/**
+ * Representation of the operand residues inside the RNS product.
+ */
+typedef enum {
+    RNS_RESIDUES_UNSIGNED = 0,  // [0, m_i) as int, generic residue_gemm kernel, any modulus < 2^31
+    RNS_RESIDUES_CENTERED       // (-m_i/2, m_i/2] as int8_t, signed int8 kernels, 3 <= m_i <= 255
+} RNSResidueRepr;
 
 /**
  * Multiply two int8_t matrices A[n][m] and B[m][p] using RNS.
- * Resulting matrix is reconstructed using the Chinese Remainder Theorem.
+ * Resulting matrix is reconstructed using the Chinese Remainder Theorem into
+ * the centered range (-M/2, M/2], M being the product of the moduli, so
+ * negative entries come back negative (see crt_reconstruct.h).
+ * The k residue products run on the shared pool from thread_pool_get_default().
  * 
  * @param A First input matrix (int8_t)
  * @param B Second input matrix (int8_t)
@@ -18,4 +30,49 @@
  */
 int64_t** multiply_matrix_rns_int8(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k);
 
+/**
+ * Same as multiply_matrix_rns_int8, running the residue products on the given pool.
+ * Each modulus is one unit of work; when k is smaller than the pool size every
+ * residue product is additionally split into row blocks.
+ *
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+int64_t** multiply_matrix_rns_int8_pool(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                        ThreadPool* pool);
+
+/**
+ * Same as multiply_matrix_rns_int8_pool with a choice of residue representation.
+ *
+ * RNS_RESIDUES_CENTERED stores both operands as signed int8 residues and runs
+ * the signed int8 kernels (AMX _tile_dpbssd, AVX-512 VNNI or AVX2 emulation,
+ * selected by residue_gemm_int8_default_kernel). Since every residue fits in a
+ * signed byte for moduli up to 255, a basis needs about half as many moduli as
+ * one restricted to 7-bit residues for a signed × unsigned kernel.
+ *
+ * @param repr Residue representation
+ * @return Reconstructed matrix, or NULL if the moduli do not fit the representation
+ */
+int64_t** multiply_matrix_rns_int8_repr(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                        RNSResidueRepr repr, ThreadPool* pool);
+
+/**
+ * Same result as multiply_matrix_rns_int8_repr with bounded memory.
+ *
+ * The residue products are computed one modulus at a time and folded straight
+ * into the result by incremental CRT (x += M_j·((r_j - x)·M_j^{-1} mod m_j),
+ * M_j the product of the moduli already folded), so only the operand residues
+ * for the current modulus exist at any time instead of k planes of A, B and C.
+ * The running value is kept in 128 bits (the low half lives in the output
+ * matrix). With RNS_RESIDUES_UNSIGNED each worker computes a block of rows and
+ * folds it while it is still in cache, so no residue plane of C is
+ * materialized; with RNS_RESIDUES_CENTERED the int8 kernels write one plane
+ * per modulus that is folded in a second pass.
+ *
+ * Bases whose product exceeds 2^128 fall back to multiply_matrix_rns_int8_repr.
+ *
+ * @return Reconstructed matrix, or NULL if the moduli do not fit the representation
+ */
+int64_t** multiply_matrix_rns_int8_streaming(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                             RNSResidueRepr repr, ThreadPool* pool);
+
 #endif // MATRIX_RNS_MUL_INT8_H
@@ -0,0 +1,22 @@
+#ifndef MATRIX_RNS_MUL_WIDE_H
+#define MATRIX_RNS_MUL_WIDE_H
+
+#include "matrix_utils_wide.h"
+#include "thread_pool.h"
+
+/**
+ * Multiply two WideMatrix A (n × m) and B (m × p) using RNS, without GMP.
+ *
+ * The basis is chosen from the largest entries of A and B, with the primes of
+ * the residue GEMM backend rns_product_backend_choose picks for that bound
+ * (same as the mpz product); the residues come from wide_matrix_to_rns_planes
+ * and the product is reconstructed with wide_matrix_from_rns_planes into a
+ * matrix wide enough for every entry of A·B.
+ *
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ * @return Newly allocated n × p matrix, to be released with free_wide_matrix
+ *         (NULL if the inner dimensions differ)
+ */
+WideMatrix* multiply_matrix_rns_wide(const WideMatrix* A, const WideMatrix* B, ThreadPool* pool);
+
+#endif // MATRIX_RNS_MUL_WIDE_H
@@ -13,9 +13,40 @@
  */
 mpz_t** allocate_mpz_matrix(int n, int m);
 
+/**
+ * Allocates an n × m mpz_t matrix in flat arena storage: one array of n·m
+ * mpz_t, one array of row pointers and one block of limbs that gives every
+ * entry room for `bits` bits, all initialized to 0 with no per-entry call
+ * into the allocator. Entries that outgrow their slot spill to the heap.
+ *
+ * The entries are ordinary mpz_t for every GMP function. The first arena
+ * matrix wraps GMP's reallocate and free functions (mp_set_memory_functions,
+ * once per process) so that a slot is never passed to free; every other
+ * pointer is forwarded to the previous functions after a lock-free check of
+ * the live arenas' slot ranges. An entry may be mpz_swap'ed
+ * with an mpz_t outside the matrix (another arena matrix included) only if
+ * it is swapped back before the matrix is freed.
+ *
+ * @param bits Capacity of each entry in bits (at least one limb)
+ * @return Pointer to the matrix, freed by free_mpz_matrix
+ */
+mpz_t** allocate_mpz_matrix_arena(int n, int m, long bits);
+
+/**
+ * Non-zero if mat was allocated by allocate_mpz_matrix_arena and not yet freed.
+ */
+int mpz_matrix_is_arena(mpz_t** mat);
+
+/**
+ * Number of entries of an arena matrix whose limbs have spilled out of their
+ * slot (0 for a matrix that is not an arena matrix).
+ */
+long mpz_matrix_arena_spills(mpz_t** mat);
+
 /**
  * Frees a dynamically allocated 2D matrix of mpz_t elements.
- * Calls mpz_clear on each element before freeing memory.
+ * Calls mpz_clear on each element before freeing memory; an arena matrix is
+ * released in bulk, clearing only the spilled entries.
  * 
  * @param mat Pointer to the matrix
  * @param n Number of rows
@@ -0,0 +1,53 @@
+#ifndef MATRIX_UTILS_WIDE_H
+#define MATRIX_UTILS_WIDE_H
+
+#include <stdint.h>
+
+/**
+ * Matrix of fixed-width signed integers stored limb-sliced.
+ *
+ * Every entry is a two's complement integer of `limbs` 64-bit limbs. Limb l
+ * of all n × m entries is one contiguous array (structure of arrays), so the
+ * loops over entries read consecutive words and vectorize, with no per-entry
+ * header, allocation or size branch as with mpz_t.
+ */
+typedef struct {
+    int n, m;
+    int limbs;        // 64-bit limbs per entry, least significant first
+    uint64_t* data;   // data[l·n·m + i·m + j] is limb l of entry (i, j)
+} WideMatrix;
+
+/**
+ * Allocate a zero n × m matrix with room for every |x| < 2^bits
+ * (bits/64 + 1 limbs).
+ */
+WideMatrix* allocate_wide_matrix(int n, int m, long bits);
+
+/**
+ * Free a WideMatrix.
+ */
+void free_wide_matrix(WideMatrix* W);
+
+/**
+ * Set entry (i, j) to v (sign-extended to every limb).
+ */
+void wide_matrix_set_int64(WideMatrix* W, int i, int j, int64_t v);
+
+/**
+ * Read entry (i, j) into *v. Returns 0 (and v mod 2^64) if it does not fit
+ * in an int64_t, 1 otherwise.
+ */
+int wide_matrix_get_int64(const WideMatrix* W, int i, int j, int64_t* v);
+
+/**
+ * Entry (i, j) rounded to the nearest double (ties to even); ±inf beyond
+ * the double range.
+ */
+double wide_matrix_get_double(const WideMatrix* W, int i, int j);
+
+/**
+ * Number of bits of |x| for the largest magnitude entry (0 for a zero matrix).
+ */
+long wide_matrix_max_bits(const WideMatrix* W);
+
+#endif // MATRIX_UTILS_WIDE_H
@@ -0,0 +1,103 @@
+#ifndef MIXED_RADIX_H
+#define MIXED_RADIX_H
+
+#include <stdint.h>
+
+/**
+ * Centered reconstruction through mixed-radix (Garner) digits.
+ *
+ * Every x in [0, M) has a unique representation
+ *
+ *     x = d_0 + d_1·m_0 + d_2·m_0·m_1 + ... + d_{k-1}·m_0···m_{k-2},   0 <= d_i < m_i,
+ *
+ * and the digits follow from the residues by small modular operations only:
+ *
+ *     d_i = (...((r_i - d_0)·c_{0,i} - d_1)·c_{1,i} - ... - d_{i-1})·c_{i-1,i} mod m_i,
+ *
+ * with c_{j,i} = m_j^-1 mod m_i. That is k(k-1)/2 word-sized multiply-reduce
+ * steps per entry and no product by M/m_i. Each step runs over a chunk of
+ * entries in structure-of-arrays layout with Shoup's modular multiplication,
+ * so it vectorizes across the output matrix.
+ *
+ * Digits compare lexicographically from d_{k-1} down, which makes the sign
+ * (x > floor(M/2)) and the int64 range test exact, unlike the fixed-point CRT
+ * sum of crt_reconstruct.h. The value itself is evaluated by Horner's rule
+ * from the top digit, one word multiplication per digit.
+ */
+typedef struct {
+    int k;
+    int* moduli;
+    uint32_t* inv;          // inv[i*k + j] = c_{j,i} = m_j^-1 mod m_i, j < i
+    uint32_t* inv_shoup;    // floor(c_{j,i} * 2^32 / m_i)
+    uint32_t* offset;       // offset[i*k + j] = m_i·ceil(m_j/m_i), or 0 if m_i + offset >= 2^32
+    uint32_t* red_shoup;    // floor(2^32 / m_i), to reduce d_j modulo m_i when offset is 0
+    uint32_t* half;         // digits of floor(M/2)
+    uint32_t* pos_limit;    // digits of 2^63 - 1 (when check_int64)
+    uint32_t* neg_limit;    // digits of M - 2^63 (when check_int64)
+    uint64_t M_lo;          // M mod 2^64
+    int check_int64;        // M > 2^63, so centered values may leave the int64_t range
+} MRBasis;
+
+/**
+ * Reconstruction backends of the RNS pipelines.
+ */
+typedef enum {
+    RNS_RECONSTRUCT_CRT = 0,        // approximate CRT sum, crt_reconstruct.h
+    RNS_RECONSTRUCT_MIXED_RADIX     // Garner digits, this file
+} RNSReconstruction;
+
+/**
+ * Backend selected by the RNS_RECONSTRUCT environment variable ("crt" or
+ * "mixed_radix"), RNS_RECONSTRUCT_CRT by default.
+ */
+RNSReconstruction rns_reconstruction_default(void);
+
+/**
+ * Precompute the digit constants of a basis of k pairwise coprime moduli
+ * (2 <= m_i < 2^31). Returns NULL if the moduli are not pairwise coprime.
+ */
+MRBasis* mr_basis_create(const int* moduli, int k);
+
+/**
+ * Free an MRBasis.
+ */
+void mr_basis_free(MRBasis* basis);
+
+/**
+ * Mixed-radix digits of count entries.
+ *
+ * @param basis Digit constants
+ * @param residues residues[i][e] is the residue in [0, m_i) of entry e modulo m_i
+ * @param count Number of entries
+ * @param digits digits[i][e] receives d_i of entry e
+ */
+void mixed_radix_digits(const MRBasis* basis, const int* const* residues, long count,
+                        uint32_t* const* digits);
+
+/**
+ * Digit i alone, from the residues modulo m_i and the digits 0 .. i-1 already
+ * computed, for adding moduli one at a time.
+ *
+ * @param residues residues[e] is the residue in [0, m_i) of entry e modulo m_i
+ * @param digits digits[j][e] is d_j of entry e, j < i
+ * @param out out[e] receives d_i of entry e
+ */
+void mixed_radix_next_digit(const MRBasis* basis, int i, const int* residues, const uint32_t* const* digits,
+                            long count, uint32_t* out);
+
+/**
+ * Signs of centered values from their digits: negative[e] = 1 if entry e
+ * lies above floor(M/2), i.e. its centered value is x - M.
+ */
+void mixed_radix_signs(const MRBasis* basis, const uint32_t* const* digits, long count, uint8_t* negative);
+
+/**
+ * Centered reconstruction into int64_t: out[e] is the value in (-M/2, M/2]
+ * congruent to the residues, reduced modulo 2^64 if it does not fit.
+ *
+ * @return Number of entries outside the int64_t range (exact count)
+ */
+long mixed_radix_reconstruct_centered_int64(const MRBasis* basis, const int* const* residues, long count,
+                                            int64_t* out);
+
+#endif // MIXED_RADIX_H
@@ -0,0 +1,24 @@
+#ifndef MIXED_RADIX_GMP_H
+#define MIXED_RADIX_GMP_H
+
+#include <gmp.h>
+#include "mixed_radix.h"
+
+/**
+ * Centered reconstruction into mpz_t through mixed-radix digits.
+ *
+ * The value is evaluated by Horner's rule from the top digit, two digits per
+ * step (one mpz_mul_ui by m_{i+1}·m_i and one mpz_add_ui), so every bignum
+ * operation has a word-sized operand. Negative entries are built from the
+ * complemented digits m_i - 1 - d_i, which represent M - 1 - x, so M itself
+ * is never needed.
+ *
+ * @param basis Digit constants
+ * @param residues residues[i][e] is the residue in [0, m_i) of entry e modulo m_i
+ * @param count Number of entries
+ * @param out count initialized mpz_t receiving the centered values in (-M/2, M/2]
+ */
+void mixed_radix_reconstruct_centered_mpz(const MRBasis* basis, const int* const* residues, long count,
+                                          mpz_t* out);
+
+#endif // MIXED_RADIX_GMP_H
@@ -0,0 +1,49 @@
+#ifndef RESIDUE_GEMM_H
+#define RESIDUE_GEMM_H
+
+#include "thread_pool.h"
+
+/**
+ * Modular matrix product on one residue plane:
+ *   C[i][j] = (sum_r A[i][r] * B[r][j]) mod mod,   row_begin <= i < row_end
+ *
+ * Planes are contiguous row-major blocks addressed through a leading
+ * dimension, so the kernel also works on sub-blocks of a larger plane.
+ * Residues must lie in [0, mod). Products are accumulated in uint64_t and only
+ * reduced once every residue_gemm_reduction_window(mod) steps of r.
+ *
+ * @param A Residues of the left operand (row i starts at A + i*lda)
+ * @param lda Leading dimension of A
+ * @param B Residues of the right operand (row r starts at B + r*ldb)
+ * @param ldb Leading dimension of B
+ * @param C Output residues (row i starts at C + i*ldc)
+ * @param ldc Leading dimension of C
+ * @param m Inner dimension
+ * @param p Number of columns of B and C
+ * @param mod Modulus (2 <= mod < 2^31)
+ * @param row_begin First row of C to compute
+ * @param row_end One past the last row of C to compute
+ */
+void residue_gemm_rows(const int* A, int lda, const int* B, int ldb, int* C, int ldc,
+                       int m, int p, int mod, int row_begin, int row_end);
+
+/**
+ * Number of products (mod-1)^2 that can be summed in a uint64_t accumulator
+ * already holding a reduced value without overflowing.
+ */
+long residue_gemm_reduction_window(int mod);
+
+/**
+ * Compute all k residue products Cres[idx] = Ares[idx] · Bres[idx] mod moduli[idx].
+ *
+ * Each residue matrix must be a contiguous plane starting at X[idx][0]
+ * (n × m for A, m × p for B, n × p for C). Moduli are the unit of
+ * parallelism; when k is smaller than the pool size each product is also
+ * split into row blocks so that every worker has work.
+ *
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void residue_gemm_rns(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                      int n, int m, int p, ThreadPool* pool);
+
+#endif // RESIDUE_GEMM_H
@@ -0,0 +1,63 @@
+#ifndef RESIDUE_GEMM_FP64_H
+#define RESIDUE_GEMM_FP64_H
+
+#include "thread_pool.h"
+
+/**
+ * Residue GEMM in IEEE double precision.
+ *
+ * Residues are held as centered doubles in (-mod/2, mod/2]. Every product and
+ * every partial sum is an integer of magnitude below 2^53, so FMA accumulation
+ * is exact as long as window · (mod/2)^2 + 2·mod <= 2^53; the accumulators are
+ * reduced in registers (c - mod·round(c/mod), one FMA) once per window steps
+ * of K. Moduli up to RESIDUE_FP64_MAX_MODULUS keep a window of at least 7,
+ * so a basis needs about three times fewer moduli than one of 8-bit moduli
+ * for the int8 kernels, at the cost of 8-byte operands.
+ */
+typedef enum {
+    RESIDUE_FP64_SCALAR = 0,   // portable C loop
+    RESIDUE_FP64_AVX2,         // 4 × 8 register tile, vfmadd231pd on ymm
+    RESIDUE_FP64_AVX512,       // 8 × 16 register tile, vfmadd231pd on zmm
+    RESIDUE_FP64_NUM_KERNELS
+} ResidueFp64Kernel;
+
+/**
+ * Largest modulus accepted by residue_gemm_fp64_rns.
+ */
+#define RESIDUE_FP64_MAX_MODULUS (1 << 26)
+
+/**
+ * Human readable name of a kernel ("scalar", "avx2", "avx512").
+ */
+const char* residue_gemm_fp64_kernel_name(ResidueFp64Kernel kernel);
+
+/**
+ * Non-zero if the kernel can run on this CPU.
+ */
+int residue_gemm_fp64_kernel_available(ResidueFp64Kernel kernel);
+
+/**
+ * Kernel selected by the RNS_FP64_KERNEL environment variable if it names an
+ * available kernel, otherwise the fastest available one.
+ */
+ResidueFp64Kernel residue_gemm_fp64_default_kernel(void);
+
+/**
+ * Number of steps of K accumulated exactly in double before reducing.
+ */
+long residue_gemm_fp64_window(int mod);
+
+/**
+ * Compute all k residue products Cres[idx] = Ares[idx] · Bres[idx] mod moduli[idx].
+ *
+ * Same interface as residue_gemm_rns: residues in [0, mod) in contiguous int
+ * planes starting at X[idx][0] (n × m for A, m × p for B, n × p for C). Moduli
+ * must satisfy 2 <= mod <= RESIDUE_FP64_MAX_MODULUS.
+ *
+ * @param kernel Kernel to use; must be available
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void residue_gemm_fp64_rns(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                           int n, int m, int p, ResidueFp64Kernel kernel, ThreadPool* pool);
+
+#endif // RESIDUE_GEMM_FP64_H
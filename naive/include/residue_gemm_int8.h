@@ -0,0 +1,98 @@
+#ifndef RESIDUE_GEMM_INT8_H
+#define RESIDUE_GEMM_INT8_H
+
+#include <stdint.h>
+#include "thread_pool.h"
+
+/**
+ * Residue GEMM on signed 8-bit residues.
+ *
+ * Operands hold centered residues in (-mod/2, mod/2] stored as int8_t, which
+ * lets both sides use signed × signed products (AMX _tile_dpbssd, or its
+ * emulation on AVX2 / AVX-512 VNNI). Each product is bounded by (mod/2)^2
+ * instead of (mod-1)^2, so the int32 accumulators can run over much longer
+ * stretches of K before a reduction is needed. Moduli must satisfy
+ * 3 <= mod <= 255 so that every centered residue fits in an int8_t.
+ */
+typedef enum {
+    RESIDUE_INT8_SCALAR = 0,   // portable C loop
+    RESIDUE_INT8_AVX2,         // sign-extend to int16 + vpmaddwd (vpdpbssd emulation)
+    RESIDUE_INT8_AVX512,       // vpdpbusd on biased A + column-sum correction
+    RESIDUE_INT8_AMX,          // _tile_dpbssd on 16x64 tiles
+    RESIDUE_INT8_NUM_KERNELS
+} ResidueInt8Kernel;
+
+/**
+ * Human readable name of a kernel ("scalar", "avx2", "avx512", "amx").
+ */
+const char* residue_gemm_int8_kernel_name(ResidueInt8Kernel kernel);
+
+/**
+ * Non-zero if the kernel can run on this CPU (and, for AMX, if the kernel
+ * granted tile data permission to the process).
+ */
+int residue_gemm_int8_kernel_available(ResidueInt8Kernel kernel);
+
+/**
+ * Kernel selected by the RNS_INT8_KERNEL environment variable if it names an
+ * available kernel, otherwise the fastest available one.
+ */
+ResidueInt8Kernel residue_gemm_int8_default_kernel(void);
+
+/**
+ * Number of steps of K the kernel accumulates in int32 before reducing.
+ */
+long residue_gemm_int8_window(int mod, ResidueInt8Kernel kernel);
+
+/**
+ * Compute all k residue products Cres[idx] = Ares[idx] · Bres[idx] mod moduli[idx].
+ *
+ * Ares and Bres hold centered int8 residues in contiguous planes starting at
+ * X[idx][0] (n × m for A, m × p for B). Cres receives residues in [0, mod)
+ * in contiguous n × p int planes, as produced by residue_gemm_rns.
+ *
+ * @param kernel Kernel to use; must be available
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void residue_gemm_int8_rns(int8_t*** Ares, int8_t*** Bres, int*** Cres, const int* moduli, int k,
+                           int n, int m, int p, ResidueInt8Kernel kernel, ThreadPool* pool);
+
+/**
+ * Producer of centered int8 operand rows: writes rows [row_begin,
+ * row_begin + rows) of the plane for modulus index plane to dst, ld elements
+ * apart.
+ */
+typedef void (*ResidueInt8RowSource)(const void* arg, int plane, int row_begin, int rows, int8_t* dst, long ld);
+
+/**
+ * Same as residue_gemm_int8_rns with the operands produced on demand: the
+ * rows of each A row block are written straight into the kernel's panel and
+ * B is fetched in blocks of rows as it is repacked, so operands kept in
+ * another format (residue_packed.h) never exist as whole int8 planes.
+ */
+void residue_gemm_int8_rns_source(ResidueInt8RowSource a_rows, const void* a_arg, ResidueInt8RowSource b_rows,
+                                  const void* b_arg, int*** Cres, const int* moduli, int k, int n, int m, int p,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool);
+
+/**
+ * Exact product of two digit-sliced integer matrices:
+ *
+ *     A = sum_s 2^(8s)·A_s,   B = sum_t 2^(8t)·B_t,   A·B = sum_g 2^(8g) sum_{s+t=g} A_s·B_t
+ *
+ * with int8 digit planes A_s (n × m) and B_t (m × p). A holds its da planes
+ * side by side, A[i·da·m + s·m + r]; B holds its db planes stacked,
+ * B[(t·m + r)·p + j]. Every diagonal sum_{s+t=g} A_s·B_t is a single GEMM
+ * with K = (pairs on the diagonal)·m, because B is packed with its planes in
+ * reverse order so that both operands of a diagonal are contiguous. The
+ * diagonals are accumulated in int64 across int32 windows and folded into C
+ * with a running carry, 8 bits per diagonal.
+ *
+ * @param C Receives A·B in two's complement, limbs 64-bit limbs per entry:
+ *          limb l of entry (i, j) at C[l·n·p + i·p + j]; every entry must fit
+ * @param kernel Kernel to use; must be available
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void residue_gemm_int8_digits(const int8_t* A, const int8_t* B, int da, int db, int n, int m, int p,
+                              uint64_t* C, int limbs, ResidueInt8Kernel kernel, ThreadPool* pool);
+
+#endif // RESIDUE_GEMM_INT8_H
@@ -0,0 +1,58 @@
+#ifndef RESIDUE_GEMM_OUT_OF_CORE_H
+#define RESIDUE_GEMM_OUT_OF_CORE_H
+
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+
+/**
+ * Out-of-core residue products for operands larger than memory:
+ *
+ *     C_l = A · B (mod moduli[l]),   0 <= l < k
+ *
+ * with A (n × m) and B (m × p) read from memory-mapped matrix files
+ * (matrix_file.h) and the k residue planes of C written to a new one.
+ *
+ * C is computed one tile_n × tile_p block at a time, the inner dimension
+ * in steps of tile_m. A loader thread gathers the A and B tiles of the next
+ * step (page faults included) into the second of two resident buffers while
+ * residue_gemm_int8_rns runs on the first, so reading the operands overlaps
+ * compute. The partial products of a block are folded modulo each modulus in
+ * memory and the finished block is stored straight into the mapped output,
+ * from where the kernel writes it back while later blocks are computed.
+ * Blocks are visited row band by row band, so the A band of tile_n rows is
+ * reused from the page cache for every column block and B is read once per
+ * band.
+ *
+ * Resident memory is about 2 · k · tile_m · (tile_n + tile_p) bytes of
+ * operand tiles plus 2 · k · tile_n · tile_p · 4 bytes of partial and
+ * accumulated products, independent of n, m and p.
+ */
+
+typedef struct {
+    int tile_n;   // rows of A and C per block (default 512)
+    int tile_m;   // inner dimension per step (default 4096)
+    int tile_p;   // columns of B and C per block (default 512)
+} OutOfCoreTiles;
+
+/**
+ * Residue planes of A · B from operand files to an output file.
+ *
+ * Each operand is a MATRIX_FILE_INT8 file holding either one plane of plain
+ * int8 entries without a basis (converted to centered residues as its tiles
+ * are loaded) or k planes of centered residues in (-m_i/2, m_i/2] whose
+ * basis equals moduli. The output is a MATRIX_FILE_INT32 file of k planes
+ * with residues in [0, m_i) and moduli as its basis, checksummed once
+ * complete.
+ *
+ * @param moduli k moduli, each 3 <= m_i <= 255
+ * @param tiles Block sizes, or NULL for the defaults; zero fields take their default
+ * @param kernel Kernel to use; falls back to the scalar one if not available
+ * @param pool Thread pool for the residue products, or NULL to run them on the calling thread
+ * @return 0 on success, -1 (with a message on stderr) if a file cannot be
+ *         read or written or the operands do not match
+ */
+int residue_gemm_int8_out_of_core(const char* a_path, const char* b_path, const char* c_path,
+                                  const int* moduli, int k, const OutOfCoreTiles* tiles,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool);
+
+#endif // RESIDUE_GEMM_OUT_OF_CORE_H
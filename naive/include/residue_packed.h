@@ -0,0 +1,117 @@
+#ifndef RESIDUE_PACKED_H
+#define RESIDUE_PACKED_H
+
+#include <stdint.h>
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+
+/**
+ * Bit-packed residue planes for moduli up to 256.
+ *
+ * A residue modulo m_i takes b_i = ceil(log2 m_i) bits instead of the 32 of
+ * an int plane or the 8 of a centered int8 plane (4x to 32x and 1x to 8x
+ * less storage and traffic). Each row is cut into blocks of 64 residues and a
+ * block is stored bit-sliced as b_i 64-bit words, word t holding bit t of
+ * the 64 residues (lane e = residue e of the block, the tail of the last
+ * block zero). Packing a block is b_i byte-mask extractions and unpacking
+ * b_i mask expansions, so there is no shifting across word boundaries
+ * whatever b_i is, and every row starts on a word of its own.
+ *
+ * Residues are stored unsigned in [0, m_i); the centered unpack returns the
+ * (-m_i/2, m_i/2] representatives the signed int8 GEMM kernels take.
+ */
+
+typedef struct {
+    uint64_t** planes;   // k planes; row i of plane l starts at planes[l] + i · row_words[l]
+    int* bits;           // bits per residue in plane l
+    long* row_words;     // 64-bit words per row of plane l: bits[l] · ceil(m / 64)
+    int* moduli;         // array of k moduli, each 2 <= m_i <= 256
+    int k;               // number of moduli
+    int n, m;            // dimensions of the original matrix
+} PackedResidueMatrix;
+
+typedef enum {
+    RESIDUE_PACK_SCALAR = 0,   // bit by bit
+    RESIDUE_PACK_AVX2,         // vpmovmskb / byte-mask expansion, 32 residues per step
+    RESIDUE_PACK_AVX512,       // vptestmb / masked moves (AVX-512 BW), 64 residues per step
+    RESIDUE_PACK_NUM_KERNELS
+} ResiduePackKernel;
+
+/**
+ * Human readable name of a kernel ("scalar", "avx2", "avx512").
+ */
+const char* residue_pack_kernel_name(ResiduePackKernel kernel);
+
+/**
+ * Non-zero if the kernel can run on this CPU.
+ */
+int residue_pack_kernel_available(ResiduePackKernel kernel);
+
+/**
+ * Kernel selected by the RESIDUE_PACK_KERNEL environment variable if it
+ * names an available kernel, otherwise the fastest available one.
+ */
+ResiduePackKernel residue_pack_default_kernel(void);
+
+/**
+ * Bits per residue for a modulus, or 0 if it is outside [2, 256].
+ */
+int residue_packed_bits(int mod);
+
+/**
+ * Packs count residues in [0, 2^bits) into ceil(count / 64) · bits words.
+ */
+void residue_pack_row(const uint8_t* src, int count, int bits, uint64_t* dst, ResiduePackKernel kernel);
+
+/**
+ * Unpacks count residues. With mod > 0 they come out centered modulo mod
+ * (as int8_t bytes), with mod == 0 as stored.
+ */
+void residue_unpack_row(const uint64_t* src, int count, int bits, int mod, uint8_t* dst, ResiduePackKernel kernel);
+
+/**
+ * Allocates a zero n × m packed matrix for the moduli.
+ *
+ * @return The matrix, or NULL if a modulus is outside [2, 256]
+ */
+PackedResidueMatrix* allocate_packed_residues(int n, int m, const int* moduli, int k);
+
+/**
+ * Packs residue planes in [0, m_i) (the layout of RNSMatrix: residues[l][0]
+ * is the start of a contiguous n × m plane).
+ *
+ * @return The packed matrix, or NULL if a modulus is outside [2, 256]
+ */
+PackedResidueMatrix* pack_residues(int*** residues, int n, int m, const int* moduli, int k);
+
+/**
+ * Packs centered int8 residue planes (the layout of RNSMatrixCentered).
+ */
+PackedResidueMatrix* pack_residues_centered(int8_t*** residues, int n, int m, const int* moduli, int k);
+
+/**
+ * Unpacks rows [row_begin, row_begin + rows) of plane l as residues in
+ * [0, m_l), ld elements apart.
+ */
+void unpack_residues(const PackedResidueMatrix* P, int l, int row_begin, int rows, int* dst, long ld);
+
+/**
+ * Same as unpack_residues with centered int8 residues.
+ */
+void unpack_residues_centered(const PackedResidueMatrix* P, int l, int row_begin, int rows, int8_t* dst, long ld);
+
+/**
+ * Free the PackedResidueMatrix.
+ */
+void free_packed_residues(PackedResidueMatrix* P);
+
+/**
+ * residue_gemm_int8_rns on packed operands with the same moduli. Rows of A
+ * are unpacked straight into the kernel's A panels and B a block of rows at
+ * a time into its packed layout, so no int8 plane of either operand is ever
+ * materialized.
+ */
+void residue_gemm_int8_rns_packed(const PackedResidueMatrix* A, const PackedResidueMatrix* B, int*** Cres,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool);
+
+#endif // RESIDUE_PACKED_H
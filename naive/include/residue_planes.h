@@ -0,0 +1,45 @@
+#ifndef RESIDUE_PLANES_H
+#define RESIDUE_PLANES_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "xalloc.h"
+
+/**
+ * Contiguous residue planes as the residue GEMMs take them: a plane is an
+ * array of row pointers into one rows × cols block, X[0] is the start of the
+ * block (also when rows == 0), so free_residue_plane does not need the row
+ * count. Entries are elem bytes and start at zero; the result converts to
+ * int**, int8_t**, ...
+ */
+
+static inline void* allocate_residue_plane(int rows, int cols, size_t elem) {
+    char** X = xmalloc((rows > 0 ? rows : 1) * sizeof(char*));
+    char* block = xcalloc((size_t) rows * cols, elem);
+    X[0] = block;
+    for (int i = 1; i < rows; i++) X[i] = block + (size_t) i * cols * elem;
+    return X;
+}
+
+static inline void free_residue_plane(void* X) {
+    if (X == NULL) return;
+    free(((char**) X)[0]);
+    free(X);
+}
+
+/**
+ * k planes of rows × cols entries, X[idx] being plane idx.
+ */
+static inline void* allocate_residue_planes(int k, int rows, int cols, size_t elem) {
+    void** X = xmalloc((k > 0 ? k : 1) * sizeof(void*));
+    for (int idx = 0; idx < k; idx++) X[idx] = allocate_residue_plane(rows, cols, elem);
+    return X;
+}
+
+static inline void free_residue_planes(void* X, int k) {
+    if (X == NULL) return;
+    for (int idx = 0; idx < k; idx++) free_residue_plane(((void**) X)[idx]);
+    free(X);
+}
+
+#endif // RESIDUE_PLANES_H
@@ -0,0 +1,46 @@
+#ifndef RESIDUE_STRASSEN_H
+#define RESIDUE_STRASSEN_H
+
+#include "thread_pool.h"
+
+/**
+ * Crossover used when none is given: RNS_STRASSEN_CROSSOVER if set, else 256
+ * (best measured for 1024–2048 products with 28-bit moduli).
+ */
+int residue_strassen_default_crossover(void);
+
+/**
+ * Strassen–Winograd product on one residue plane: C = A · B mod mod.
+ *
+ * Each level splits the operands into quadrants addressed as views through
+ * the leading dimensions (no quadrant is copied) and performs 7 half-size
+ * products and 15 additions, with the three-temporary schedule of Douglas et
+ * al. Odd dimensions are peeled off and handled by residue_gemm_rows on views.
+ * Recursion stops once a dimension drops below crossover, and the base case
+ * is residue_gemm_rows. Every intermediate sum is reduced back to [0, mod)
+ * with a conditional subtraction, so the base case always sees residues and
+ * keeps its full lazy-reduction window.
+ *
+ * @param A Residues in [0, mod) of the left operand (row i starts at A + i*lda)
+ * @param B Residues in [0, mod) of the right operand (row r starts at B + r*ldb)
+ * @param C Output residues (row i starts at C + i*ldc)
+ * @param n Number of rows of A and C
+ * @param m Inner dimension
+ * @param p Number of columns of B and C
+ * @param mod Modulus (2 <= mod < 2^31)
+ * @param crossover Dimension below which the classical kernel is used (at least 2)
+ */
+void residue_gemm_strassen(const int* A, int lda, const int* B, int ldb, int* C, int ldc,
+                           int n, int m, int p, int mod, int crossover);
+
+/**
+ * Same as residue_gemm_rns with residue_gemm_strassen on every plane, one
+ * modulus per task.
+ *
+ * @param crossover Crossover size, or 0 for residue_strassen_default_crossover()
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void residue_gemm_rns_strassen(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                               int n, int m, int p, int crossover, ThreadPool* pool);
+
+#endif // RESIDUE_STRASSEN_H
@@ -0,0 +1,30 @@
+#ifndef RNS_BASIS_H
+#define RNS_BASIS_H
+
+/**
+ * Select an RNS basis of distinct primes just below 2^modulus_bits whose
+ * product exceeds 2^bound_bits.
+ *
+ * Every selected prime is larger than 2^(modulus_bits-1), so
+ * ceil(bound_bits / (modulus_bits-1)) primes are always enough.
+ *
+ * @param bound_bits Number of bits the product of the moduli must exceed
+ * @param modulus_bits Size of each modulus in bits (3 <= modulus_bits <= 31)
+ * @param out_k Pointer to store the number of moduli
+ * @return Newly allocated array of *out_k moduli, in decreasing order
+ */
+int* rns_basis_select(long bound_bits, int modulus_bits, int* out_k);
+
+/**
+ * Return the count largest primes below 2^modulus_bits in decreasing order,
+ * or NULL if there are not enough primes above 2^(modulus_bits-1).
+ */
+int* rns_basis_primes(int modulus_bits, int count);
+
+/**
+ * Number of bits of |x| for the largest magnitude entry of an RNS product
+ * bound: bits(K) + bits_a + bits_b + 1 (sign).
+ */
+long rns_product_bound_bits(long bits_a, long bits_b, int inner_dim);
+
+#endif // RNS_BASIS_H
@@ -2,22 +2,56 @@
 #define RNS_CONVERSION_GMP_H
 
 #include <gmp.h>
+#include "thread_pool.h"
 
 /**
  * Structure to hold a matrix represented in the Residue Number System (RNS).
  */
 typedef struct {
-    int*** residues;
+    int*** residues;   // k contiguous n × m planes, residues[i][0] is the start of plane i
     int* moduli;
     int k;
     int n, m;
 } RNSMatrix;
 
+/**
+ * How entries are reduced modulo the k moduli.
+ *
+ * The direct loop calls mpz_fdiv_ui once per entry and modulus, O(k · size)
+ * limb operations per entry. The remainder tree multiplies the moduli
+ * pairwise into a subproduct tree once per basis, reduces each entry modulo
+ * the root and then each remainder modulo the two children, down to small
+ * groups of moduli. Every level costs about one division of the entry's size
+ * by a node of the same size, which GMP performs in quasi-linear time once
+ * the operands are large enough.
+ */
+typedef enum {
+    RNS_MPZ_CONVERT_AUTO = 0,   // tree when rns_remainder_tree_profitable says so
+    RNS_MPZ_CONVERT_DIRECT,     // mpz_fdiv_ui per entry and modulus
+    RNS_MPZ_CONVERT_TREE        // subproduct (remainder) tree over the moduli
+} RNSMpzConversion;
+
+/**
+ * Non-zero if the remainder tree is expected to beat the direct loop for k
+ * moduli and entries of about `bits` bits.
+ */
+int rns_remainder_tree_profitable(int k, long bits);
+
 /**
  * Convert a matrix of mpz_t to its RNS representation.
  */
 RNSMatrix* mpz_matrix_to_rns(mpz_t** A, int n, int m, int* moduli, int k);
 
+/**
+ * Same conversion with an explicit mode, one row of A per task. The tree is
+ * built once and shared read-only by all tasks.
+ *
+ * @param mode RNS_MPZ_CONVERT_AUTO picks the tree from k and the largest entry of A
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+RNSMatrix* mpz_matrix_to_rns_pool(mpz_t** A, int n, int m, int* moduli, int k, RNSMpzConversion mode,
+                                  ThreadPool* pool);
+
 /**
  * Free the RNSMatrix structure.
  */
@@ -2,16 +2,29 @@
 #define RNS_CONVERSION_INT16_H
 
 #include <stdint.h>
+#include "rns_convert_kernel.h"
 
 typedef struct {
-    int*** residues;  // k matrices of size n × m, one for each modulus (residues[i][row][col])
+    int*** residues;  // k matrices of size n × m, one for each modulus (residues[i][row][col]);
+                      // each one is a contiguous plane starting at residues[i][0]
     int* moduli;      // array of k moduli: [m1, m2, ..., mk]
     int k;            // number of moduli
     int n, m;         // dimensions of the original matrix
 } RNSMatrix;
 
 /**
- * Convert an int16_t matrix to RNSMatrix.
+ * Residues in [0, m_i) of an int16_t matrix, all moduli in one pass over A,
+ * written into caller-owned planes.
+ *
+ * @param planes planes[i] is a contiguous n × m plane (row-major) for modulus i
+ * @param kernel Kernel to use (RNS_CONVERT_AVX512 runs the AVX2 one); falls
+ *               back to the scalar one if not available
+ */
+void int16_matrix_to_rns_planes(int16_t** A, int n, int m, const int* moduli, int k, int* const* planes,
+                                RNSConvertKernel kernel);
+
+/**
+ * Convert an int16_t matrix to RNSMatrix on rns_convert_default_kernel.
  */
 RNSMatrix* int16_matrix_to_rns(int16_t** A, int n, int m, int* moduli, int k);
 
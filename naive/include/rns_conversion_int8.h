@@ -2,14 +2,44 @@
 #define RNS_CONVERSION_INT8_H
 
 #include <stdint.h>
+#include "rns_convert_kernel.h"
 
 typedef struct {
-    int*** residues;  // k matrices of size n × m, one for each modulus (residues[i][row][col])
+    int*** residues;  // k matrices of size n × m, one for each modulus (residues[i][row][col]);
+                      // each one is a contiguous plane starting at residues[i][0]
     int* moduli;      // array of k moduli: [m1, m2, ..., mk]
     int k;            // number of moduli
     int n, m;         // dimensions of the original matrix
 } RNSMatrix;
 
+/**
+ * Same layout with centered residues in (-m_i/2, m_i/2] stored as int8_t,
+ * the operand format of the signed int8 residue kernels (residue_gemm_int8.h).
+ */
+typedef struct {
+    int8_t*** residues;  // k contiguous n × m planes, residues[i][0] is the start of plane i
+    int* moduli;         // array of k moduli, each 3 <= m_i <= 255
+    int k;               // number of moduli
+    int n, m;            // dimensions of the original matrix
+} RNSMatrixCentered;
+
+/**
+ * Residues in [0, m_i) of an int8_t matrix, written into caller-owned planes.
+ *
+ * @param planes planes[i] is a contiguous n × m plane (row-major) for modulus i
+ * @param kernel Kernel to use; falls back to the scalar one if not available
+ */
+void int8_matrix_to_rns_planes(int8_t** A, int n, int m, const int* moduli, int k, int* const* planes,
+                               RNSConvertKernel kernel);
+
+/**
+ * Centered int8 residues of an int8_t matrix, written into caller-owned
+ * planes in the operand layout of residue_gemm_int8_rns. Moduli must satisfy
+ * 3 <= m_i <= 255.
+ */
+void int8_matrix_to_rns_centered_planes(int8_t** A, int n, int m, const int* moduli, int k,
+                                        int8_t* const* planes, RNSConvertKernel kernel);
+
 /**
  * Convert an int8_t matrix to RNSMatrix.
  */
@@ -20,4 +50,15 @@ RNSMatrix* int8_matrix_to_rns(int8_t** A, int n, int m, int* moduli, int k);
  */
 void free_rns_matrix(RNSMatrix* rns);
 
+/**
+ * Convert an int8_t matrix to centered residues.
+ * Returns NULL if a modulus is outside [3, 255].
+ */
+RNSMatrixCentered* int8_matrix_to_rns_centered(int8_t** A, int n, int m, int* moduli, int k);
+
+/**
+ * Free the RNSMatrixCentered.
+ */
+void free_rns_matrix_centered(RNSMatrixCentered* rns);
+
 #endif // RNS_CONVERSION_INT8_H
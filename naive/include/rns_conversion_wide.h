@@ -0,0 +1,36 @@
+#ifndef RNS_CONVERSION_WIDE_H
+#define RNS_CONVERSION_WIDE_H
+
+#include "matrix_utils_wide.h"
+#include "crt_reconstruct.h"
+#include "thread_pool.h"
+
+/**
+ * Residues in [0, m_i) of every entry of W, written into caller-owned planes.
+ *
+ * Each limb is split in 16-bit pieces and summed against 2^(16j) mod m_i in
+ * a uint64 accumulator, then reduced once with a floating-point quotient;
+ * the loops run over structure-of-arrays chunks of entries and vectorize.
+ *
+ * @param planes planes[i] is a contiguous n × m plane for modulus i (2 <= m_i < 2^31)
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void wide_matrix_to_rns_planes(const WideMatrix* W, const int* moduli, int k, int* const* planes,
+                               ThreadPool* pool);
+
+/**
+ * Centered CRT reconstruction straight into W (W->n × W->m entries).
+ *
+ * The CRT sum sum_i t_i·(M/m_i) - q·M is evaluated modulo 2^(64·limbs), in
+ * 32-bit digit columns, which is exact whenever the centered value fits in
+ * the width of W; q and the sign come from crt_centered_quotients.
+ *
+ * @param residues residues[i] is the contiguous n × m plane of residues modulo m_i
+ * @return Number of entries that are ambiguous or whose value does not fit in
+ *         W. The count is complete when M <= 2^(64·limbs); beyond that only
+ *         wraps that change the sign of a value past E·M/2^64 are caught.
+ */
+long wide_matrix_from_rns_planes(WideMatrix* W, const CRTBasis* basis, const int* const* residues,
+                                 ThreadPool* pool);
+
+#endif // RNS_CONVERSION_WIDE_H
@@ -0,0 +1,37 @@
+#ifndef RNS_CONVERT_KERNEL_H
+#define RNS_CONVERT_KERNEL_H
+
+/**
+ * Forward conversion kernels, shared by the int8 and int16 conversions. Each
+ * reads a row of A once and writes the row of every residue plane, so the
+ * input is traversed in a single pass for all moduli.
+ *
+ * int8: an entry has only 256 possible values, so the scalar and AVX-512
+ * kernels look its residue up in a 256-entry table per modulus.
+ * int16: the scalar kernel divides, AVX2 reduces through a single precision
+ * quotient; there is no AVX-512 kernel, which runs as AVX2.
+ */
+typedef enum {
+    RNS_CONVERT_SCALAR = 0,   // int8: table lookup, one entry at a time
+    RNS_CONVERT_AVX2,         // int8: int16 Barrett reduction (vpmulhrsw), 16 entries per step
+    RNS_CONVERT_AVX512,       // int8: table lookup with vpermi2b (AVX-512 VBMI), 64 entries per step
+    RNS_CONVERT_NUM_KERNELS
+} RNSConvertKernel;
+
+/**
+ * Human readable name of a kernel ("scalar", "avx2", "avx512").
+ */
+const char* rns_convert_kernel_name(RNSConvertKernel kernel);
+
+/**
+ * Non-zero if the kernel can run on this CPU.
+ */
+int rns_convert_kernel_available(RNSConvertKernel kernel);
+
+/**
+ * Kernel selected by the RNS_CONVERT_KERNEL environment variable if it names
+ * an available kernel, otherwise the fastest available one.
+ */
+RNSConvertKernel rns_convert_default_kernel(void);
+
+#endif // RNS_CONVERT_KERNEL_H
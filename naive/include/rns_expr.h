@@ -0,0 +1,78 @@
+#ifndef RNS_EXPR_H
+#define RNS_EXPR_H
+
+#include <stdint.h>
+#include "rns_handle.h"
+
+/**
+ * Lazy expressions over RNSHandle matrices.
+ *
+ * Nodes are built in an RNSExprGraph and nothing is computed until
+ * rns_expr_eval. Shapes and bounds are inferred when a node is built, so the
+ * number of moduli of the whole evaluation is known before anything runs.
+ *
+ * Evaluation fuses every tree of add / sub / scale nodes into a single pass
+ * that accumulates its products and plain terms in the GEMM accumulators
+ * (the elementwise work happens in the GEMM epilogue and intermediate sums
+ * are never written out). Only the root, GEMM operands and nodes used more
+ * than once are materialized. The whole graph is evaluated one modulus at a
+ * time, one modulus per pool task, so each residue plane of the inputs is
+ * read by a single task and intermediates live only as long as that task.
+ */
+typedef struct RNSExpr RNSExpr;
+typedef struct RNSExprGraph RNSExprGraph;
+
+/**
+ * Create an empty expression graph.
+ */
+RNSExprGraph* rns_expr_graph_create(void);
+
+/**
+ * Free a graph and all its nodes. Leaf handles are not freed.
+ */
+void rns_expr_graph_free(RNSExprGraph* g);
+
+/**
+ * Leaf node referring to an existing handle. The handle must outlive the
+ * graph; it is extended in place if the evaluation needs more moduli.
+ */
+RNSExpr* rns_expr_leaf(RNSExprGraph* g, RNSHandle* H);
+
+/**
+ * a · b. Returns NULL if an operand is NULL or the inner dimensions differ.
+ */
+RNSExpr* rns_expr_mul(RNSExprGraph* g, RNSExpr* a, RNSExpr* b);
+
+/**
+ * a + b. Returns NULL if an operand is NULL or the shapes differ.
+ */
+RNSExpr* rns_expr_add(RNSExprGraph* g, RNSExpr* a, RNSExpr* b);
+
+/**
+ * a - b. Returns NULL if an operand is NULL or the shapes differ.
+ */
+RNSExpr* rns_expr_sub(RNSExprGraph* g, RNSExpr* a, RNSExpr* b);
+
+/**
+ * s · a. Returns NULL if a is NULL.
+ */
+RNSExpr* rns_expr_scale(RNSExprGraph* g, RNSExpr* a, int64_t s);
+
+/**
+ * Bound |x| < 2^bits on every entry of the node, inferred from its operands.
+ */
+long rns_expr_bound_bits(const RNSExpr* e);
+
+/**
+ * Number of moduli rns_expr_eval will use for this node.
+ */
+int rns_expr_moduli_needed(const RNSExpr* e);
+
+/**
+ * Evaluate a node into a new handle with rns_expr_moduli_needed(e) moduli.
+ *
+ * @return New handle, or NULL if e is NULL or the bound needs more primes than available
+ */
+RNSHandle* rns_expr_eval(RNSExprGraph* g, RNSExpr* e);
+
+#endif // RNS_EXPR_H
@@ -0,0 +1,104 @@
+#ifndef RNS_HANDLE_H
+#define RNS_HANDLE_H
+
+#include <stdint.h>
+#include "rns_residue_product.h"
+
+/**
+ * Size in bits of the primes of an RNSHandle basis: those of the fp64 product
+ * basis, so that rns_handle_mul runs on the handle's planes directly.
+ */
+#define RNS_HANDLE_MODULUS_BITS RNS_PRODUCT_FP64_MODULUS_BITS
+
+/**
+ * Matrix kept in the RNS domain across operations.
+ *
+ * Every handle uses a prefix of the same prime sequence (the largest
+ * RNS_HANDLE_MODULUS_BITS-bit primes in decreasing order), so two handles
+ * always share their first moduli and a handle can be extended with more
+ * primes without touching the ones it already has.
+ *
+ * bound_bits tracks a bound |x| < 2^bound_bits on every entry. Operations
+ * derive the bound of their result from the bounds of their operands and
+ * extend the operands' basis (rns_handle_extend) whenever M would no longer
+ * hold the result with a sign bit and one spare bit, so a chain of
+ * operations never wraps around M. Values only leave the RNS domain through
+ * the explicit rns_handle_to_* conversions.
+ */
+typedef struct {
+    int*** residues;  // k contiguous n × m planes of residues in [0, m_i), residues[i][0] is the start of plane i
+    int* moduli;      // the k largest RNS_HANDLE_MODULUS_BITS-bit primes, decreasing
+    int k;            // number of moduli
+    int n, m;         // dimensions of the matrix
+    long bound_bits;  // |x| < 2^bound_bits for every entry
+} RNSHandle;
+
+/**
+ * Number of moduli a handle needs to hold entries bounded by 2^bound_bits.
+ */
+int rns_handle_moduli_needed(long bound_bits);
+
+/**
+ * Allocate an n × m handle over the first k moduli with uninitialized residues.
+ */
+RNSHandle* allocate_rns_handle(int n, int m, int k, long bound_bits);
+
+/**
+ * Convert an int64_t matrix to an RNSHandle with just enough moduli for its entries.
+ */
+RNSHandle* int64_matrix_to_rns_handle(int64_t** A, int n, int m);
+
+/**
+ * Convert an int8_t matrix to an RNSHandle with just enough moduli for its entries.
+ */
+RNSHandle* int8_matrix_to_rns_handle(int8_t** A, int n, int m);
+
+/**
+ * Reconstruct the centered values of a handle into a newly allocated int64_t matrix.
+ *
+ * @return n × m matrix (free each row, then the row array), or NULL if
+ *         bound_bits > 63 and the entries may not fit in an int64_t
+ */
+int64_t** rns_handle_to_int64_matrix(const RNSHandle* H);
+
+/**
+ * Extend the basis of H to k moduli, computing the new residues from the
+ * existing ones (approximate-CRT basis extension, no reconstruction).
+ * Does nothing if H already has k moduli or more.
+ */
+void rns_handle_extend(RNSHandle* H, int k);
+
+/**
+ * C = A · B in the RNS domain. A and B are extended if the product needs more moduli.
+ * The residue products run on rns_residue_product, on the backend
+ * rns_product_backend_choose picks for the bound of C.
+ *
+ * @return New handle, or NULL if the dimensions do not match
+ */
+RNSHandle* rns_handle_mul(RNSHandle* A, RNSHandle* B);
+
+/**
+ * C = A + B in the RNS domain. A and B are extended if the sum needs more moduli.
+ *
+ * @return New handle, or NULL if the dimensions do not match
+ */
+RNSHandle* rns_handle_add(RNSHandle* A, RNSHandle* B);
+
+/**
+ * C = A - B in the RNS domain. A and B are extended if the difference needs more moduli.
+ *
+ * @return New handle, or NULL if the dimensions do not match
+ */
+RNSHandle* rns_handle_sub(RNSHandle* A, RNSHandle* B);
+
+/**
+ * C = s · A in the RNS domain. A is extended if the result needs more moduli.
+ */
+RNSHandle* rns_handle_scale(RNSHandle* A, int64_t s);
+
+/**
+ * Free an RNSHandle.
+ */
+void free_rns_handle(RNSHandle* H);
+
+#endif // RNS_HANDLE_H
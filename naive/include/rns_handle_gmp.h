@@ -0,0 +1,18 @@
+#ifndef RNS_HANDLE_GMP_H
+#define RNS_HANDLE_GMP_H
+
+#include <gmp.h>
+#include "rns_handle.h"
+
+/**
+ * Convert an mpz_t matrix to an RNSHandle with just enough moduli for its entries.
+ */
+RNSHandle* mpz_matrix_to_rns_handle(mpz_t** A, int n, int m);
+
+/**
+ * Reconstruct the centered values of a handle into a newly allocated mpz_t
+ * matrix, to be released with free_mpz_matrix.
+ */
+mpz_t** rns_handle_to_mpz_matrix(const RNSHandle* H);
+
+#endif // RNS_HANDLE_GMP_H
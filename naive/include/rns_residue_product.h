@@ -0,0 +1,68 @@
+#ifndef RNS_RESIDUE_PRODUCT_H
+#define RNS_RESIDUE_PRODUCT_H
+
+#include "thread_pool.h"
+
+/**
+ * Residue GEMM backend of the big-integer products (multiply_matrix_rns_mpz,
+ * multiply_matrix_rns_wide).
+ *
+ * Both backends run on the vectorized kernels: 8-bit primes on
+ * residue_gemm_int8_rns (AMX / AVX-512 / AVX2) or 26-bit primes on
+ * residue_gemm_fp64_rns. At equal range the fp64 basis has about three times
+ * fewer moduli, and the conversions and the CRT scale with the basis size:
+ * even on AMX, where the int8 GEMM is faster per modulus, the whole product
+ * runs slower on the 8-bit primes, which also run out at
+ * RNS_PRODUCT_INT8_MAX_BITS.
+ */
+typedef enum {
+    RNS_PRODUCT_INT8 = 0,   // 8-bit primes, centered int8 residues
+    RNS_PRODUCT_FP64,       // 26-bit primes, centered double residues
+    RNS_PRODUCT_NUM_BACKENDS
+} RNSProductBackend;
+
+#define RNS_PRODUCT_INT8_MODULUS_BITS 8
+#define RNS_PRODUCT_FP64_MODULUS_BITS 26
+
+/**
+ * Largest bound (in bits) the 8-bit primes can cover.
+ */
+#define RNS_PRODUCT_INT8_MAX_BITS 161
+
+/**
+ * Human readable name of a backend ("int8", "fp64").
+ */
+const char* rns_product_backend_name(RNSProductBackend backend);
+
+/**
+ * Size in bits of the primes of a backend.
+ */
+int rns_product_modulus_bits(RNSProductBackend backend);
+
+/**
+ * Backend for a product whose entries need bound_bits bits: the one named by
+ * the RNS_PRODUCT_BACKEND environment variable if it can cover the bound,
+ * otherwise fp64.
+ */
+RNSProductBackend rns_product_backend_choose(long bound_bits);
+
+/**
+ * Basis of the backend for bound_bits (see rns_basis_select).
+ */
+int* rns_product_basis(long bound_bits, RNSProductBackend backend, int* out_k);
+
+/**
+ * Compute all k residue products Cres[idx] = Ares[idx] · Bres[idx] mod moduli[idx]
+ * on the default kernel of the backend.
+ *
+ * Same interface as residue_gemm_rns: residues in [0, mod) in contiguous int
+ * planes starting at X[idx][0]. The int8 backend centers the operand rows
+ * as the kernel packs them, without int8 copies of the planes.
+ *
+ * @param moduli Moduli of the backend's basis
+ * @param pool Thread pool to use, or NULL to run sequentially on the calling thread
+ */
+void rns_residue_product(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                         int n, int m, int p, RNSProductBackend backend, ThreadPool* pool);
+
+#endif // RNS_RESIDUE_PRODUCT_H
@@ -0,0 +1,70 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/**
+ * Fixed-size pool of worker threads used to run the independent residue
+ * computations of the RNS pipeline in parallel.
+ *
+ * Tasks are numbered 0 .. num_tasks-1 and distributed statically: worker w
+ * always receives the contiguous range [w*num_tasks/T, (w+1)*num_tasks/T).
+ * With pinned workers this keeps every modulus (and its operands) on the
+ * same core from one call to the next.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Task callback.
+ *
+ * @param arg User data passed to thread_pool_run
+ * @param task_idx Index of the task to execute
+ * @param worker_idx Index of the worker executing it (0 .. T-1)
+ */
+typedef void (*thread_pool_task_fn)(void* arg, int task_idx, int worker_idx);
+
+/**
+ * Create a pool with num_threads workers (including the calling thread).
+ *
+ * @param num_threads Number of workers; values <= 0 select thread_pool_default_threads()
+ * @param pin_threads If non-zero, worker w is pinned to CPU number w (modulo their
+ *                    count) of the process affinity mask; the calling thread, worker 0,
+ *                    is pinned to the first of them for the duration of each run
+ * @return Pointer to the pool
+ */
+ThreadPool* thread_pool_create(int num_threads, int pin_threads);
+
+/**
+ * Run num_tasks tasks on the pool and wait for all of them to finish.
+ * The calling thread acts as worker 0. With a NULL pool the tasks run
+ * sequentially on the calling thread.
+ *
+ * Thread safe: concurrent callers are serialized, each waiting for the
+ * pool to finish the previous job. A task that runs the same pool again
+ * executes the nested tasks sequentially on its own thread.
+ */
+void thread_pool_run(ThreadPool* pool, int num_tasks, thread_pool_task_fn fn, void* arg);
+
+/**
+ * Number of workers of the pool (1 for a NULL pool).
+ */
+int thread_pool_size(const ThreadPool* pool);
+
+/**
+ * Stop the workers and free the pool.
+ */
+void thread_pool_destroy(ThreadPool* pool);
+
+/**
+ * Default number of workers: the RNS_NUM_THREADS environment variable if set,
+ * otherwise the number of CPUs the process may run on (its affinity mask).
+ */
+int thread_pool_default_threads(void);
+
+/**
+ * Process-wide pinned pool with thread_pool_default_threads() workers,
+ * created on first use and shared by all RNS routines. Routines called
+ * from several application threads at once take turns on it; pass each
+ * thread its own pool where the API accepts one to run them side by side.
+ */
+ThreadPool* thread_pool_get_default(void);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,53 @@
+#ifndef XALLOC_H
+#define XALLOC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Checked allocation for internal buffers: on failure the process reports
+ * the request on stderr and exits, like the matrix allocators do. Zero-byte
+ * requests return a valid pointer.
+ */
+
+static inline void* xmalloc(size_t bytes) {
+    void* ptr = malloc(bytes > 0 ? bytes : 1);
+    if (ptr == NULL) {
+        fprintf(stderr, "Error: failed to allocate %zu bytes.\n", bytes);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+static inline void* xcalloc(size_t count, size_t size) {
+    void* ptr = calloc(count > 0 ? count : 1, size > 0 ? size : 1);
+    if (ptr == NULL) {
+        fprintf(stderr, "Error: failed to allocate %zu × %zu bytes.\n", count, size);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+static inline void* xrealloc(void* ptr, size_t bytes) {
+    ptr = realloc(ptr, bytes > 0 ? bytes : 1);
+    if (ptr == NULL) {
+        fprintf(stderr, "Error: failed to allocate %zu bytes.\n", bytes);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+/**
+ * aligned_alloc with the size rounded up to a multiple of align.
+ */
+static inline void* xaligned_alloc(size_t align, size_t bytes) {
+    size_t rounded = (bytes + align - 1) / align * align;
+    void* ptr = aligned_alloc(align, rounded > 0 ? rounded : align);
+    if (ptr == NULL) {
+        fprintf(stderr, "Error: failed to allocate %zu aligned bytes.\n", bytes);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+#endif // XALLOC_H
@@ -50,7 +50,7 @@ run_test "test_matrix_utils" "tests/test_matrix_utils.c" \
 "gcc -Iinclude tests/test_matrix_utils.c src/matrix_utils.c"
 
 run_test "test_matrix_utils_gmp" "tests/test_matrix_utils_gmp.c" \
-"gcc -Iinclude tests/test_matrix_utils_gmp.c src/matrix_utils_gmp.c -lgmp"
+"gcc -Iinclude tests/test_matrix_utils_gmp.c src/matrix_utils_gmp.c -lgmp -lpthread"
 
 run_test "test_matrix_utils_int8" "tests/test_matrix_utils_int8.c" \
 "gcc -Iinclude tests/test_matrix_utils_int8.c src/matrix_utils_int8.c"
@@ -64,7 +64,10 @@ run_test "test_file_io" "tests/test_file_io.c" \
 "gcc -Iinclude tests/test_file_io.c src/file_io.c src/matrix_utils.c"
 
 run_test "test_file_io_gmp" "tests/test_file_io_gmp.c" \
-"gcc -Iinclude tests/test_file_io_gmp.c src/file_io_gmp.c src/matrix_utils_gmp.c -lgmp"
+"gcc -Iinclude tests/test_file_io_gmp.c src/file_io_gmp.c src/matrix_utils_gmp.c src/thread_pool.c -lgmp -lpthread"
+
+run_test "test_file_io_gmp_parallel" "tests/test_file_io_gmp_parallel.c" \
+"gcc -Iinclude tests/test_file_io_gmp_parallel.c src/file_io_gmp.c src/matrix_utils_gmp.c src/thread_pool.c -lgmp -lpthread"
 
 run_test "test_file_io_int8" "tests/test_file_io_int8.c" \
 "gcc -Iinclude tests/test_file_io_int8.c src/file_io_int8.c src/matrix_utils_int8.c"
@@ -72,26 +75,81 @@ run_test "test_file_io_int8" "tests/test_file_io_int8.c" \
 run_test "test_file_io_int16" "tests/test_file_io_int16.c" \
 "gcc -Iinclude tests/test_file_io_int16.c src/file_io_int16.c src/matrix_utils_int16.c"
 
+run_test "test_matrix_file" "tests/test_matrix_file.c" \
+"gcc -Iinclude tests/test_matrix_file.c src/matrix_file.c src/matrix_utils_wide.c -lm"
+
+run_test "test_file_io_text" "tests/test_file_io_text.c" \
+"gcc -Iinclude tests/test_file_io_text.c src/file_io_text.c src/matrix_file.c src/file_io_int8.c src/matrix_utils_int8.c src/thread_pool.c -lpthread"
+
+run_test "test_residue_gemm_out_of_core" "tests/test_residue_gemm_out_of_core.c" \
+"gcc -Iinclude tests/test_residue_gemm_out_of_core.c src/residue_gemm_out_of_core.c src/matrix_file.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/residue_gemm_int8.c src/thread_pool.c -lpthread"
+
 #############
 
 run_test "test_rns_conversion" "tests/test_rns_conversion.c" \
 "gcc -Iinclude tests/test_rns_conversion.c src/rns_conversion_int.c src/matrix_utils.c"
 
 run_test "test_rns_conversion_gmp" "tests/test_rns_conversion_gmp.c" \
-"gcc -Iinclude tests/test_rns_conversion_gmp.c src/rns_conversion_gmp.c src/matrix_utils_gmp.c -lgmp"
+"gcc -Iinclude tests/test_rns_conversion_gmp.c src/rns_conversion_gmp.c src/matrix_utils_gmp.c src/rns_basis.c src/thread_pool.c -lgmp -lpthread"
 
 run_test "test_rns_conversion_int8" "tests/test_rns_conversion_int8.c" \
-"gcc -Iinclude tests/test_rns_conversion_int8.c src/rns_conversion_int8.c src/matrix_utils_int8.c"
+"gcc -Iinclude tests/test_rns_conversion_int8.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/matrix_utils_int8.c"
+
+run_test "test_residue_packed" "tests/test_residue_packed.c" \
+"gcc -Iinclude tests/test_residue_packed.c src/residue_packed.c src/residue_gemm_int8.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/matrix_utils_int8.c src/thread_pool.c -lpthread"
 
 run_test "test_rns_conversion_int16" "tests/test_rns_conversion_int16.c" \
-"gcc -Iinclude tests/test_rns_conversion_int16.c src/rns_conversion_int16.c src/matrix_utils_int16.c"
+"gcc -Iinclude tests/test_rns_conversion_int16.c src/rns_conversion_int16.c src/rns_convert_kernel.c src/matrix_utils_int16.c"
 
 #############
 
 run_test "test_matrix_rns_mul_int8" "tests/test_matrix_rns_mul_int8.c" \
-"gcc -Iinclude tests/test_matrix_rns_mul_int8.c src/matrix_rns_mul_int8.c src/rns_conversion_int8.c src/matrix_utils_int8.c"
+"gcc -Iinclude tests/test_matrix_rns_mul_int8.c src/matrix_rns_mul_int8.c src/crt_reconstruct.c src/mixed_radix.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/matrix_utils_int8.c src/residue_gemm.c src/residue_gemm_int8.c src/thread_pool.c -lpthread"
+
+run_test "test_thread_pool" "tests/test_thread_pool.c" \
+"gcc -Iinclude tests/test_thread_pool.c src/thread_pool.c -lpthread"
+
+run_test "test_residue_gemm" "tests/test_residue_gemm.c" \
+"gcc -Iinclude tests/test_residue_gemm.c src/residue_gemm.c src/residue_gemm_int8.c src/matrix_rns_mul_int8.c src/crt_reconstruct.c src/mixed_radix.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/matrix_utils_int8.c src/thread_pool.c -lpthread"
+
+
+run_test "test_matrix_rns_mul_gmp" "tests/test_matrix_rns_mul_gmp.c" \
+"gcc -Iinclude tests/test_matrix_rns_mul_gmp.c src/matrix_rns_mul_gmp.c src/rns_residue_product.c src/residue_gemm_int8.c src/residue_gemm_fp64.c src/crt_reconstruct.c src/crt_reconstruct_gmp.c src/mixed_radix.c src/mixed_radix_gmp.c src/rns_conversion_gmp.c src/matrix_utils_gmp.c src/residue_gemm.c src/rns_basis.c src/thread_pool.c -lgmp -lpthread -lm"
+run_test "test_residue_gemm_int8" "tests/test_residue_gemm_int8.c" \
+"gcc -Iinclude tests/test_residue_gemm_int8.c src/residue_gemm_int8.c src/residue_gemm.c src/matrix_rns_mul_int8.c src/crt_reconstruct.c src/mixed_radix.c src/rns_conversion_int8.c src/rns_convert_kernel.c src/matrix_utils_int8.c src/thread_pool.c -lpthread"
+
+run_test "test_crt_reconstruct" "tests/test_crt_reconstruct.c" \
+"gcc -Iinclude tests/test_crt_reconstruct.c src/crt_reconstruct.c src/crt_reconstruct_gmp.c src/rns_basis.c -lgmp"
+
+run_test "test_rns_handle" "tests/test_rns_handle.c" \
+"gcc -Iinclude tests/test_rns_handle.c src/rns_handle.c src/rns_handle_gmp.c src/rns_residue_product.c src/residue_gemm_int8.c src/residue_gemm_fp64.c src/crt_reconstruct.c src/crt_reconstruct_gmp.c src/residue_gemm.c src/rns_basis.c src/matrix_utils_gmp.c src/thread_pool.c -lgmp -lpthread -lm"
+
+run_test "test_rns_expr" "tests/test_rns_expr.c" \
+"gcc -Iinclude tests/test_rns_expr.c src/rns_expr.c src/rns_handle.c src/rns_handle_gmp.c src/rns_residue_product.c src/residue_gemm_int8.c src/residue_gemm_fp64.c src/crt_reconstruct.c src/crt_reconstruct_gmp.c src/residue_gemm.c src/rns_basis.c src/matrix_utils_gmp.c src/thread_pool.c -lgmp -lpthread -lm"
+
+run_test "test_residue_strassen" "tests/test_residue_strassen.c" \
+"gcc -Iinclude tests/test_residue_strassen.c src/residue_strassen.c src/residue_gemm.c src/thread_pool.c -lpthread"
+
+run_test "test_gemm_int8_batched" "tests/test_gemm_int8_batched.c" \
+"gcc -Iinclude tests/test_gemm_int8_batched.c src/gemm_int8_batched.c src/residue_gemm_int8.c src/thread_pool.c -lpthread"
+
+run_test "test_mixed_radix" "tests/test_mixed_radix.c" \
+"gcc -Iinclude tests/test_mixed_radix.c src/mixed_radix.c src/mixed_radix_gmp.c src/crt_reconstruct.c src/rns_basis.c -lgmp"
+
+run_test "test_residue_gemm_fp64" "tests/test_residue_gemm_fp64.c" \
+"gcc -Iinclude tests/test_residue_gemm_fp64.c src/residue_gemm_fp64.c src/thread_pool.c -lpthread -lm"
+
+run_test "test_rns_residue_product" "tests/test_rns_residue_product.c" \
+"gcc -Iinclude tests/test_rns_residue_product.c src/rns_residue_product.c src/residue_gemm_int8.c src/residue_gemm_fp64.c src/residue_gemm.c src/rns_basis.c src/thread_pool.c -lpthread -lm"
+
+run_test "test_rns_conversion_wide" "tests/test_rns_conversion_wide.c" \
+"gcc -Iinclude tests/test_rns_conversion_wide.c src/rns_conversion_wide.c src/matrix_rns_mul_wide.c src/rns_residue_product.c src/residue_gemm_int8.c src/residue_gemm_fp64.c src/matrix_utils_wide.c src/crt_reconstruct.c src/residue_gemm.c src/rns_basis.c src/thread_pool.c -lgmp -lpthread -lm"
 
+run_test "test_matrix_digit_mul_wide" "tests/test_matrix_digit_mul_wide.c" \
+"gcc -Iinclude tests/test_matrix_digit_mul_wide.c src/matrix_digit_mul_wide.c src/rns_residue_product.c src/residue_gemm_fp64.c src/matrix_rns_mul_wide.c src/rns_conversion_wide.c src/matrix_utils_wide.c src/crt_reconstruct.c src/residue_gemm.c src/residue_gemm_int8.c src/rns_basis.c src/thread_pool.c -lpthread -lm"
 
+run_test "test_dgemm_int8" "tests/test_dgemm_int8.c" \
+"gcc -Iinclude tests/test_dgemm_int8.c src/dgemm_int8.c src/rns_conversion_wide.c src/matrix_utils_wide.c src/crt_reconstruct.c src/residue_gemm_int8.c src/rns_basis.c src/thread_pool.c -lpthread -lm"
 
 # ==== Summary ====
 echo ""
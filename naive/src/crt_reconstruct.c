@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "crt_reconstruct.h"
+
+// Entries processed together; the per-modulus loops run over one chunk
+#define CRT_CHUNK 256
+
+#define HALF_UNIT (1ULL << 63)
+
+uint32_t crt_modinv(uint64_t a, uint64_t m) {
+    int64_t old_r = (int64_t) (a % m), r = (int64_t) m;
+    int64_t old_s = 1, s = 0;
+    while (r != 0) {
+        int64_t q = old_r / r, tmp;
+        tmp = old_r - q * r; old_r = r; r = tmp;
+        tmp = old_s - q * s; old_s = s; s = tmp;
+    }
+    if (old_r != 1) return 0;
+    return (uint32_t) ((old_s % (int64_t) m + (int64_t) m) % (int64_t) m);
+}
+
+// r * y mod m for r, y < m < 2^31, with y_shoup = floor(y * 2^32 / m)
+static inline uint32_t shoup_mulmod(uint32_t r, uint32_t y, uint32_t y_shoup, uint32_t m) {
+    uint64_t q = ((uint64_t) r * y_shoup) >> 32;
+    uint64_t t = (uint64_t) r * y - q * m;
+    return (uint32_t) (t >= m ? t - m : t);
+}
+
+CRTBasis* crt_basis_create(const int* moduli, int k) {
+    CRTBasis* b = malloc(sizeof(CRTBasis));
+    b->k = k;
+    b->moduli = malloc(k * sizeof(int));
+    b->inv = malloc(k * sizeof(uint32_t));
+    b->inv_shoup = malloc(k * sizeof(uint32_t));
+    b->frac_hi = malloc(k * sizeof(uint32_t));
+    b->frac_lo = malloc(k * sizeof(uint32_t));
+    b->Mi_lo = malloc(k * sizeof(uint64_t));
+    b->M_lo = 1;
+    b->error_bound = 0;
+
+    double M_approx = 1.0;
+    for (int i = 0; i < k; i++) {
+        uint64_t mi = (uint64_t) moduli[i];
+        b->moduli[i] = moduli[i];
+        b->M_lo *= mi;
+        b->error_bound += mi;
+        M_approx *= (double) mi;
+
+        // M/m_i modulo m_i and modulo 2^64, without forming M
+        uint64_t Mi_mod = 1 % mi, Mi_lo = 1;
+        for (int j = 0; j < k; j++) {
+            if (j == i) continue;
+            Mi_mod = Mi_mod * ((uint64_t) moduli[j] % mi) % mi;
+            Mi_lo *= (uint64_t) moduli[j];
+        }
+        uint32_t y = crt_modinv(Mi_mod, mi);
+        if (y == 0 && mi > 1) {
+            crt_basis_free(b);
+            return NULL;
+        }
+        b->inv[i] = y;
+        b->inv_shoup[i] = (uint32_t) (((uint64_t) y << 32) / mi);
+        b->Mi_lo[i] = Mi_lo;
+
+        uint64_t c = UINT64_MAX / mi + 1;   // ceil(2^64 / m_i)
+        b->frac_hi[i] = (uint32_t) (c >> 32);
+        b->frac_lo[i] = (uint32_t) c;
+    }
+
+    // |v| = |fraction| * M >= 2^63 once |fraction| >= 2^127 / M (units of 2^-64);
+    // the fixed-point fraction may exceed the true one by up to error_bound
+    double limit = (M_approx <= 0x1p63) ? 0x1p64 : 0x1p127 / M_approx + (double) b->error_bound;
+    b->int64_limit = (limit >= 0x1p64) ? UINT64_MAX : (uint64_t) limit;
+    return b;
+}
+
+void crt_basis_free(CRTBasis* basis) {
+    if (basis == NULL) return;
+    free(basis->moduli);
+    free(basis->inv);
+    free(basis->inv_shoup);
+    free(basis->frac_hi);
+    free(basis->frac_lo);
+    free(basis->Mi_lo);
+    free(basis);
+}
+
+/*
+ * Fixed-point CRT sum on entries [base, base + len) of one chunk.
+ *
+ * The 64.64 sum sum_i t_i * ceil(2^64/m_i) is kept as acc_hi (units of 2^-32)
+ * plus acc_lo (units of 2^-64, low halves only) so that every product is a
+ * 32×32→64 multiply and the loops over e vectorize. If v_lo is not NULL it
+ * receives sum_i t_i * (M/m_i) mod 2^64.
+ */
+static void crt_chunk(const CRTBasis* b, const int* const* residues, long base, int len,
+                      uint32_t* const* t_out, uint64_t* v_lo, int32_t* q, uint8_t* flags) {
+    uint64_t acc_hi[CRT_CHUNK], acc_lo[CRT_CHUNK];
+    uint32_t t[CRT_CHUNK];
+
+    for (int e = 0; e < len; e++) {
+        acc_hi[e] = 0;
+        acc_lo[e] = 0;
+    }
+    if (v_lo) {
+        for (int e = 0; e < len; e++) v_lo[e] = 0;
+    }
+
+    for (int i = 0; i < b->k; i++) {
+        const int* r = residues[i] + base;
+        uint32_t m = (uint32_t) b->moduli[i];
+        uint32_t y = b->inv[i], y_shoup = b->inv_shoup[i];
+        uint64_t c_hi = b->frac_hi[i], c_lo = b->frac_lo[i];
+
+        for (int e = 0; e < len; e++) {
+            t[e] = shoup_mulmod((uint32_t) r[e], y, y_shoup, m);
+        }
+        for (int e = 0; e < len; e++) {
+            uint64_t lo = (uint64_t) t[e] * c_lo;
+            acc_hi[e] += (uint64_t) t[e] * c_hi + (lo >> 32);
+            acc_lo[e] += lo & 0xffffffffULL;
+        }
+        if (v_lo) {
+            uint64_t Mi = b->Mi_lo[i];
+            for (int e = 0; e < len; e++) v_lo[e] += (uint64_t) t[e] * Mi;
+        }
+        if (t_out) {
+            uint32_t* dst = t_out[i] + base;
+            for (int e = 0; e < len; e++) dst[e] = t[e];
+        }
+    }
+
+    for (int e = 0; e < len; e++) {
+        uint64_t hi = acc_hi[e] + (acc_lo[e] >> 32);
+        uint64_t frac = (hi << 32) | (acc_lo[e] & 0xffffffffULL);
+        int neg = frac >= HALF_UNIT;
+        uint64_t dist = neg ? frac - HALF_UNIT : HALF_UNIT - frac;
+        uint64_t mag = neg ? 0 - frac : frac;
+        q[e] = (int32_t) (hi >> 32) + neg;
+        flags[e] = (uint8_t) ((neg ? CRT_NEGATIVE : 0)
+                              | (dist <= b->error_bound ? CRT_AMBIGUOUS : 0)
+                              | (mag > b->int64_limit ? CRT_EXCEEDS_INT64 : 0)
+                              | (mag <= b->error_bound ? CRT_NEAR_ZERO : 0));
+    }
+}
+
+void crt_centered_quotients(const CRTBasis* basis, const int* const* residues, long count,
+                            uint32_t* const* t, int32_t* q, uint8_t* flags) {
+    for (long base = 0; base < count; base += CRT_CHUNK) {
+        int len = (int) (count - base < CRT_CHUNK ? count - base : CRT_CHUNK);
+        crt_chunk(basis, residues, base, len, t, NULL, q + base, flags + base);
+    }
+}
+
+long crt_reconstruct_centered_int64(const CRTBasis* basis, const int* const* residues, long count,
+                                    int64_t* out) {
+    uint64_t v_lo[CRT_CHUNK];
+    int32_t q[CRT_CHUNK];
+    uint8_t flags[CRT_CHUNK];
+    long out_of_range = 0;
+
+    for (long base = 0; base < count; base += CRT_CHUNK) {
+        int len = (int) (count - base < CRT_CHUNK ? count - base : CRT_CHUNK);
+        crt_chunk(basis, residues, base, len, NULL, v_lo, q, flags);
+
+        for (int e = 0; e < len; e++) {
+            int64_t v = (int64_t) (v_lo[e] - (uint64_t) (int64_t) q[e] * basis->M_lo);
+            out[base + e] = v;
+            // A wrapped value also shows up as a sign that disagrees with the fixed-point sign
+            int neg = (flags[e] & CRT_NEGATIVE) != 0;
+            int sign_known = !(flags[e] & CRT_NEAR_ZERO);
+            if ((flags[e] & (CRT_AMBIGUOUS | CRT_EXCEEDS_INT64)) || (sign_known && neg != (v < 0))) {
+                out_of_range++;
+            }
+        }
+    }
+    return out_of_range;
+}
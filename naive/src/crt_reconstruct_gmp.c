@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include "crt_reconstruct_gmp.h"
+#include "xalloc.h"
+
+CRTBasisMpz* crt_basis_mpz_create(const int* moduli, int k) {
+    CRTBasis* basis = crt_basis_create(moduli, k);
+    if (basis == NULL) return NULL;
+
+    CRTBasisMpz* b = malloc(sizeof(CRTBasisMpz));
+    b->basis = basis;
+    b->Mi = malloc(k * sizeof(mpz_t));
+    mpz_init_set_ui(b->M, 1);
+    for (int i = 0; i < k; i++) mpz_mul_ui(b->M, b->M, (unsigned long) moduli[i]);
+    for (int i = 0; i < k; i++) {
+        mpz_init(b->Mi[i]);
+        mpz_divexact_ui(b->Mi[i], b->M, (unsigned long) moduli[i]);
+    }
+    return b;
+}
+
+void crt_basis_mpz_free(CRTBasisMpz* basis) {
+    if (basis == NULL) return;
+    for (int i = 0; i < basis->basis->k; i++) mpz_clear(basis->Mi[i]);
+    free(basis->Mi);
+    mpz_clear(basis->M);
+    crt_basis_free(basis->basis);
+    free(basis);
+}
+
+long crt_reconstruct_centered_mpz(const CRTBasisMpz* basis, const int* const* residues, long count,
+                                  mpz_t* out) {
+    int k = basis->basis->k;
+    if (count <= 0) return 0;
+
+    uint32_t** t = xmalloc(k * sizeof(uint32_t*));
+    uint32_t* t_data = xmalloc((size_t) k * count * sizeof(uint32_t));
+    for (int i = 0; i < k; i++) t[i] = t_data + (size_t) i * count;
+    int32_t* q = xmalloc(count * sizeof(int32_t));
+    uint8_t* flags = xmalloc(count * sizeof(uint8_t));
+
+    crt_centered_quotients(basis->basis, residues, count, t, q, flags);
+
+    long fallbacks = 0;
+    for (long e = 0; e < count; e++) {
+        mpz_set_ui(out[e], 0);
+        for (int i = 0; i < k; i++) {
+            mpz_addmul_ui(out[e], basis->Mi[i], t[i][e]);
+        }
+
+        if (flags[e] & CRT_AMBIGUOUS) {
+            // Too close to ±M/2 for the fixed-point sum: reduce exactly
+            mpz_mod(out[e], out[e], basis->M);
+            mpz_mul_2exp(out[e], out[e], 1);
+            int above_half = mpz_cmp(out[e], basis->M) > 0;
+            mpz_fdiv_q_2exp(out[e], out[e], 1);
+            if (above_half) mpz_sub(out[e], out[e], basis->M);
+            fallbacks++;
+        } else if (q[e] > 0) {
+            mpz_submul_ui(out[e], basis->M, (unsigned long) q[e]);
+        }
+    }
+
+    free(t_data);
+    free(t);
+    free(q);
+    free(flags);
+    return fallbacks;
+}
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "dgemm_int8.h"
+#include "matrix_utils_wide.h"
+#include "rns_conversion_wide.h"
+#include "crt_reconstruct.h"
+#include "rns_basis.h"
+#include "residue_planes.h"
+#include "xalloc.h"
+
+// Moduli are the largest primes below 2^DGEMM_MODULUS_BITS, so that every
+// centered residue is a signed byte
+#define DGEMM_MODULUS_BITS 8
+// Scaled operands stay exact integers in double and in int64
+#define DGEMM_MAX_BITS 62
+
+int dgemm_int8_max_moduli(void) {
+    int count = 0;
+    for (int c = (1 << DGEMM_MODULUS_BITS) - 1; c > (1 << (DGEMM_MODULUS_BITS - 1)); c -= 2) {
+        int prime = 1;
+        for (int d = 3; d * d <= c; d += 2) {
+            if (c % d == 0) prime = 0;
+        }
+        count += prime;
+    }
+    return count;
+}
+
+int dgemm_int8_bits(int moduli, int m) {
+    if (moduli < 1 || moduli > dgemm_int8_max_moduli()) return 0;
+    int* primes = rns_basis_primes(DGEMM_MODULUS_BITS, moduli);
+    double log2_M = 0.0;
+    for (int i = 0; i < moduli; i++) log2_M += log2((double) primes[i]);
+    free(primes);
+
+    // |A'·B'| <= m·2^(2·bits) must stay below M/4, clear of the ambiguous range near M/2
+    int log2_m = 0;
+    while ((1L << log2_m) < m) log2_m++;
+    int bits = (int) floor((log2_M - log2_m - 2) / 2);
+    return bits > DGEMM_MAX_BITS ? DGEMM_MAX_BITS : bits;
+}
+
+int dgemm_int8_moduli_for_bits(int bits, int m) {
+    int max = dgemm_int8_max_moduli();
+    for (int k = 1; k <= max; k++) {
+        if (dgemm_int8_bits(k, m) >= bits) return k;
+    }
+    return 0;
+}
+
+// 2^e as a double factor, or 0 when it is outside the normal range and
+// entries go through ldexp instead
+static double scale_factor(int e) {
+    return (e > -1022 && e < 1023) ? ldexp(1.0, e) : 0.0;
+}
+
+// Exponent that scales a row or column with largest magnitude amax to just below 2^bits
+static int scale_exponent(double amax, int bits) {
+    if (amax == 0.0) return 0;
+    int e;
+    frexp(amax, &e);   // amax < 2^e
+    return bits - e;
+}
+
+typedef struct {
+    const double* X;
+    int ld;
+    int cols;
+    const int* shift;      // per row (A) or per column (B) exponent
+    const double* factor;  // scale_factor of each shift
+    int per_row;
+    const int* primes;
+    int k;
+    int8_t*** planes;
+} ResidueJob;
+
+// Task i writes the centered residues of scaled row i for every prime
+static void residue_row_task(void* arg, int i, int worker_idx) {
+    ResidueJob* job = (ResidueJob*) arg;
+    (void) worker_idx;
+    const double* x = job->X + (size_t) i * job->ld;
+    double* v = xmalloc(job->cols * sizeof(double));
+
+    for (int j = 0; j < job->cols; j++) {
+        int s = job->per_row ? i : j;
+        v[j] = rint(job->factor[s] != 0.0 ? x[j] * job->factor[s] : ldexp(x[j], job->shift[s]));
+    }
+
+    // v - q·mod is exact in one fma for any q near v/mod; two rounds bring it
+    // within one modulus of zero, the fixups center it
+    for (int idx = 0; idx < job->k; idx++) {
+        double mod = job->primes[idx], inv = 1.0 / mod;
+        int half = job->primes[idx] / 2;
+        int8_t* out = job->planes[idx][i];
+        for (int j = 0; j < job->cols; j++) {
+            double y = fma(-rint(v[j] * inv), mod, v[j]);
+            y = fma(-rint(y * inv), mod, y);
+            int r = (int) y;
+            r -= r > half ? job->primes[idx] : 0;
+            r += r < -half ? job->primes[idx] : 0;
+            out[j] = (int8_t) r;
+        }
+    }
+    free(v);
+}
+
+typedef struct {
+    const WideMatrix* W;
+    const int* sa;
+    const int* sb;
+    double* C;
+    int ldc;
+} ScaleBackJob;
+
+static void scale_back_task(void* arg, int i, int worker_idx) {
+    ScaleBackJob* job = (ScaleBackJob*) arg;
+    (void) worker_idx;
+    for (int j = 0; j < job->W->m; j++) {
+        job->C[(size_t) i * job->ldc + j] = ldexp(wide_matrix_get_double(job->W, i, j), -(job->sa[i] + job->sb[j]));
+    }
+}
+
+int dgemm_int8(const double* A, int lda, const double* B, int ldb, double* C, int ldc, int n, int m, int p,
+               int moduli, ResidueInt8Kernel kernel, ThreadPool* pool) {
+    int bits = dgemm_int8_bits(moduli, m);
+    if (bits < 1) return -1;
+
+    // Row exponents of A and column exponents of B
+    int* sa = xmalloc(n * sizeof(int));
+    int* sb = xmalloc(p * sizeof(int));
+    double* fa = xmalloc(n * sizeof(double));
+    double* fb = xmalloc(p * sizeof(double));
+    double* col_max = xmalloc(p * sizeof(double));
+    int finite = 1;
+    for (int i = 0; i < n; i++) {
+        double amax = 0.0;
+        for (int r = 0; r < m; r++) {
+            double x = A[(size_t) i * lda + r];
+            finite &= isfinite(x) != 0;
+            amax = fmax(amax, fabs(x));
+        }
+        sa[i] = scale_exponent(amax, bits);
+        fa[i] = scale_factor(sa[i]);
+    }
+    for (int j = 0; j < p; j++) col_max[j] = 0.0;
+    for (int r = 0; r < m; r++) {
+        for (int j = 0; j < p; j++) {
+            double x = B[(size_t) r * ldb + j];
+            finite &= isfinite(x) != 0;
+            col_max[j] = fmax(col_max[j], fabs(x));
+        }
+    }
+    for (int j = 0; j < p; j++) {
+        sb[j] = scale_exponent(col_max[j], bits);
+        fb[j] = scale_factor(sb[j]);
+    }
+    free(col_max);
+    if (!finite) {
+        free(sa);
+        free(sb);
+        free(fa);
+        free(fb);
+        return -1;
+    }
+
+    // Centered residues of the scaled operands, one int8 plane per prime
+    int* primes = rns_basis_primes(DGEMM_MODULUS_BITS, moduli);
+    int8_t*** Ares = allocate_residue_planes(moduli, n, m, sizeof(int8_t));
+    int8_t*** Bres = allocate_residue_planes(moduli, m, p, sizeof(int8_t));
+    ResidueJob ajob = { A, lda, m, sa, fa, 1, primes, moduli, Ares };
+    ResidueJob bjob = { B, ldb, p, sb, fb, 0, primes, moduli, Bres };
+    thread_pool_run(pool, n, residue_row_task, &ajob);
+    thread_pool_run(pool, m, residue_row_task, &bjob);
+
+    int*** Cres = allocate_residue_planes(moduli, n, p, sizeof(int));
+    residue_gemm_int8_rns(Ares, Bres, Cres, primes, moduli, n, m, p, kernel, pool);
+    free_residue_planes(Ares, moduli);
+    free_residue_planes(Bres, moduli);
+
+    // Exact integer product, then one rounding to double per entry
+    CRTBasis* basis = crt_basis_create(primes, moduli);
+    WideMatrix* W = allocate_wide_matrix(n, p, (long) moduli * DGEMM_MODULUS_BITS);
+    const int** starts = xmalloc(moduli * sizeof(int*));
+    for (int idx = 0; idx < moduli; idx++) starts[idx] = Cres[idx][0];
+    wide_matrix_from_rns_planes(W, basis, starts, pool);
+    free(starts);
+    free_residue_planes(Cres, moduli);
+    crt_basis_free(basis);
+    free(primes);
+
+    ScaleBackJob sjob = { W, sa, sb, C, ldc };
+    thread_pool_run(pool, n, scale_back_task, &sjob);
+
+    free_wide_matrix(W);
+    free(sa);
+    free(sb);
+    free(fa);
+    free(fb);
+    return 0;
+}
@@ -1,8 +1,45 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <gmp.h>
 #include "file_io_gmp.h"
 #include "matrix_utils_gmp.h"
+#include "xalloc.h"
+
+// Chunks (reader) and row blocks (writer) per pool worker
+#define MPZ_IO_TASKS_PER_THREAD 4
+// Smaller bodies are not worth splitting further
+#define MPZ_IO_MIN_CHUNK_BYTES (64 * 1024)
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+static inline int is_separator(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// Limbs for a value of len digits in base (room for mpn_set_str's extra limb included)
+static long limbs_for_digits(size_t len, int base) {
+    double bits = (double) len * (base == 16 ? 4.0 : 3.3219280948873626);
+    return (long) (bits / GMP_NUMB_BITS) + 2;
+}
+
+// Arena slot for count entries of at most max_len and sum_len digits in all:
+// slots fit the longest entry unless it is far above the average; the few
+// longer ones then spill to the heap
+static long arena_slot_bits(size_t max_len, size_t sum_len, long count, int base) {
+    size_t slot_len = max_len;
+    if (count > 0 && slot_len > 2 * (sum_len / count + 1)) slot_len = 2 * (sum_len / count + 1);
+    return limbs_for_digits(slot_len, base) * GMP_NUMB_BITS;
+}
 
 /**
  * Reads a matrix of mpz_t from a text file.
@@ -26,7 +63,33 @@ mpz_t** read_mpz_matrix_from_file(const char* filename, int* n, int* m) {
     }
 
     fscanf(file, "%d %d", n, m);
-    mpz_t** mat = allocate_mpz_matrix(*n, *m);
+
+    // Arena slots are sized by a first pass over the entries (lengths only);
+    // a stream that cannot be rewound gets one-limb slots and spills
+    long body = ftell(file), count = 0;
+    size_t max_len = 0, sum_len = 0;
+    if (body >= 0) {
+        size_t len = 0;
+        for (int c = getc(file);; c = getc(file)) {
+            if (c != EOF && !is_separator((unsigned char) c)) {
+                len++;
+                continue;
+            }
+            if (len > 0) {
+                count++;
+                sum_len += len;
+                if (len > max_len) max_len = len;
+                len = 0;
+            }
+            if (c == EOF) break;
+        }
+        if (fseek(file, body, SEEK_SET) != 0) {
+            fprintf(stderr, "Error: could not rewind file '%s'.\n", filename);
+            exit(EXIT_FAILURE);
+        }
+    }
+    mpz_t** mat = allocate_mpz_matrix_arena(*n, *m, count > 0 ? arena_slot_bits(max_len, sum_len, count, 10)
+                                                                : GMP_NUMB_BITS);
 
     for (int i = 0; i < *n; i++) {
         for (int j = 0; j < *m; j++) {
@@ -68,3 +131,468 @@ void write_mpz_matrix_to_file(const char* filename, mpz_t** mat, int n, int m) {
     fclose(file);
 }
 
+
+/////////////////////////////
+//   Parallel I/O helpers  //
+/////////////////////////////
+
+static int io_tasks(ThreadPool* pool, size_t bytes) {
+    int tasks = pool ? MPZ_IO_TASKS_PER_THREAD * thread_pool_size(pool) : 1;
+    if ((size_t) tasks > bytes / MPZ_IO_MIN_CHUNK_BYTES + 1) tasks = (int) (bytes / MPZ_IO_MIN_CHUNK_BYTES + 1);
+    return tasks;
+}
+
+// Value of digit c, at least 36 if c is not an ASCII letter or digit
+// (branch-free, hex digits alternate between the two ranges)
+static inline unsigned digit_value(unsigned char c) {
+    unsigned d = (unsigned) c - '0';
+    unsigned l = (unsigned) (c | 0x20) - 'a';
+    unsigned is_digit = 0u - (d < 10), is_letter = 0u - (l < 26);
+    return (d & is_digit) | ((l + 10) & is_letter) | (255 & ~(is_digit | is_letter));
+}
+
+/////////////////////////////
+//       Text reader       //
+/////////////////////////////
+
+typedef struct {
+    const unsigned char* const* bound;   // chunk c is [bound[c], bound[c + 1])
+    int base;
+    long* count;                         // entries per chunk, then their offsets
+    size_t* longest;                     // longest entry of each chunk
+    size_t* digits;                      // characters in the entries of each chunk
+    mpz_t** mat;
+    int m;
+    long total;
+    const unsigned char** error_at;      // first error of each chunk, or NULL
+    const char** error;                  // and its reason
+} MpzTextJob;
+
+static void text_count_task(void* arg, int c, int worker_idx) {
+    MpzTextJob* job = (MpzTextJob*) arg;
+    (void) worker_idx;
+    const unsigned char* p = job->bound[c];
+    const unsigned char* limit = job->bound[c + 1];
+    long count = 0;
+    size_t longest = 0, digits = 0;
+    while (p < limit) {
+        while (p < limit && is_separator(*p)) p++;
+        const unsigned char* start = p;
+        while (p < limit && !is_separator(*p)) p++;
+        if (p > start) {
+            count++;
+            digits += p - start;
+            if ((size_t) (p - start) > longest) longest = p - start;
+        }
+    }
+    job->count[c] = count;
+    job->longest[c] = longest;
+    job->digits[c] = digits;
+}
+
+// Digits go to a per-chunk buffer as values and straight into the limbs with
+// mpn_set_str; the arena slots were sized for the longest entry
+static void text_parse_task(void* arg, int c, int worker_idx) {
+    MpzTextJob* job = (MpzTextJob*) arg;
+    (void) worker_idx;
+    const unsigned char* p = job->bound[c];
+    const unsigned char* limit = job->bound[c + 1];
+    long e = job->count[c];
+    unsigned char* digits = xmalloc(job->longest[c] + 1);
+    job->error_at[c] = NULL;
+
+    while (p < limit) {
+        while (p < limit && is_separator(*p)) p++;
+        if (p == limit) break;
+        const unsigned char* start = p;
+        int neg = *p == '-';
+        p += neg;
+        size_t len = 0;
+        for (; p < limit && !is_separator(*p); p++) {
+            unsigned d = digit_value(*p);
+            if (d >= (unsigned) job->base) break;
+            if (len > 0 || d != 0) digits[len++] = (unsigned char) d;
+        }
+        if (p < limit && !is_separator(*p)) {
+            job->error_at[c] = p;
+            job->error[c] = "unexpected character in an entry";
+            break;
+        }
+        if (p == start + neg) {
+            job->error_at[c] = start;
+            job->error[c] = "sign without digits";
+            break;
+        }
+
+        mpz_ptr x = job->mat[e / job->m][e % job->m];
+        if (len == 0) {
+            mpz_set_ui(x, 0);
+        } else {
+            mp_limb_t* rp = mpz_limbs_write(x, limbs_for_digits(len, job->base));
+            mp_size_t rn = mpn_set_str(rp, digits, len, job->base);
+            mpz_limbs_finish(x, neg ? -rn : rn);
+        }
+        e++;
+    }
+    free(digits);
+}
+
+// Start of entry k (from 0) of [p, limit), which holds more than k entries
+static const unsigned char* nth_entry(const unsigned char* p, const unsigned char* limit, long k) {
+    for (;;) {
+        while (p < limit && is_separator(*p)) p++;
+        if (k-- == 0) return p;
+        while (p < limit && !is_separator(*p)) p++;
+    }
+}
+
+// "n m" at the start of text; returns the position after it, or NULL
+static const unsigned char* parse_header(const unsigned char* p, const unsigned char* limit, int* n, int* m) {
+    long dims[2];
+    for (int d = 0; d < 2; d++) {
+        while (p < limit && is_separator(*p)) p++;
+        const unsigned char* start = p;
+        long v = 0;
+        while (p < limit && *p >= '0' && *p <= '9' && v <= INT_MAX) v = 10 * v + (*p++ - '0');
+        if (p == start || v > INT_MAX || (p < limit && !is_separator(*p))) return NULL;
+        dims[d] = v;
+    }
+    *n = (int) dims[0];
+    *m = (int) dims[1];
+    return p;
+}
+
+static void report_position(const char* filename, const unsigned char* text, const unsigned char* at,
+                            const char* reason) {
+    long line = 1;
+    const unsigned char* line_start = text;
+    for (const unsigned char* q = text; q < at; q++) {
+        if (*q == '\n') {
+            line++;
+            line_start = q + 1;
+        }
+    }
+    fprintf(stderr, "Error: '%s' line %ld, column %ld: %s.\n", filename, line, (long) (at - line_start) + 1, reason);
+}
+
+static mpz_t** read_text(const char* filename, const unsigned char* text, size_t bytes, int base, int* n, int* m,
+                         ThreadPool* pool) {
+    const unsigned char* limit = text + bytes;
+    int rows, cols;
+    const unsigned char* body = parse_header(text, limit, &rows, &cols);
+    if (body == NULL) {
+        fprintf(stderr, "Error: '%s' does not start with the dimensions \"n m\".\n", filename);
+        return NULL;
+    }
+
+    // Chunks end at a separator, so no entry straddles two of them
+    size_t body_bytes = limit - body;
+    int chunks = io_tasks(pool, body_bytes);
+    const unsigned char** bound = xmalloc((chunks + 1) * sizeof(unsigned char*));
+    long* count = xmalloc(chunks * sizeof(long));
+    size_t* longest = xmalloc(chunks * sizeof(size_t));
+    size_t* digits = xmalloc(chunks * sizeof(size_t));
+    const unsigned char** error_at = xmalloc(chunks * sizeof(unsigned char*));
+    const char** error = xmalloc(chunks * sizeof(char*));
+    bound[0] = body;
+    bound[chunks] = limit;
+    for (int c = 1; c < chunks; c++) {
+        const unsigned char* q = body + body_bytes * c / chunks;
+        if (q < bound[c - 1]) q = bound[c - 1];
+        while (q < limit && !is_separator(*q)) q++;
+        bound[c] = q;
+    }
+
+    MpzTextJob job = { bound, base, count, longest, digits, NULL, cols, (long) rows * cols, error_at, error };
+    thread_pool_run(pool, chunks, text_count_task, &job);
+    long found = 0;
+    size_t max_len = 0, sum_len = 0;
+    for (int c = 0; c < chunks; c++) {
+        long k = count[c];
+        count[c] = found;
+        found += k;
+        sum_len += digits[c];
+        if (longest[c] > max_len) max_len = longest[c];
+    }
+
+    // A wrong count is rejected before the header's n·m slots are allocated
+    mpz_t** mat = NULL;
+    if (found != job.total) {
+        const unsigned char* at = limit;
+        if (found > job.total) {
+            int c = 0;
+            while (c + 1 < chunks && count[c + 1] <= job.total) c++;
+            at = nth_entry(bound[c], bound[c + 1], job.total - count[c]);
+        }
+        report_position(filename, text, at, found > job.total ? "more entries than n*m" : "fewer entries than n*m");
+    } else {
+        mat = allocate_mpz_matrix_arena(rows, cols, arena_slot_bits(max_len, sum_len, found, base));
+        job.mat = mat;
+        thread_pool_run(pool, chunks, text_parse_task, &job);
+
+        // The first error in file order wins
+        int c = 0;
+        while (c < chunks && error_at[c] == NULL) c++;
+        if (c < chunks) {
+            report_position(filename, text, error_at[c], error[c]);
+            free_mpz_matrix(mat, rows, cols);
+            mat = NULL;
+        }
+    }
+    free(bound);
+    free(count);
+    free(longest);
+    free(digits);
+    free(error_at);
+    free(error);
+    if (mat) {
+        *n = rows;
+        *m = cols;
+    }
+    return mat;
+}
+
+/////////////////////////////
+//     Raw limb reader     //
+/////////////////////////////
+
+#define RAW_HEADER_BYTES 24   // magic, n, m
+
+typedef struct {
+    const unsigned char* data;
+    const size_t* row_start;   // byte offset of each row, n + 1 of them
+    mpz_t** mat;
+    int n;
+    int m;
+    int tasks;
+} MpzRawJob;
+
+static inline uint64_t load_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Task t imports a contiguous block of rows
+static void raw_read_task(void* arg, int t, int worker_idx) {
+    MpzRawJob* job = (MpzRawJob*) arg;
+    (void) worker_idx;
+    int r0 = (int) ((long) job->n * t / job->tasks), r1 = (int) ((long) job->n * (t + 1) / job->tasks);
+    for (int i = r0; i < r1; i++) {
+        const unsigned char* p = job->data + job->row_start[i];
+        for (int j = 0; j < job->m; j++) {
+            int64_t size = (int64_t) load_u64(p);
+            size_t words = (size_t) (size < 0 ? -size : size);
+            mpz_import(job->mat[i][j], words, -1, 8, -1, 0, p + 8);
+            if (size < 0) mpz_neg(job->mat[i][j], job->mat[i][j]);
+            p += 8 * (words + 1);
+        }
+    }
+}
+
+static mpz_t** read_raw(const char* filename, const unsigned char* data, size_t bytes, int* n, int* m,
+                        ThreadPool* pool) {
+    if (bytes < RAW_HEADER_BYTES || memcmp(data, MPZ_RAW_MAGIC, sizeof(MPZ_RAW_MAGIC)) != 0) {
+        fprintf(stderr, "Error: '%s' is not a raw mpz matrix file.\n", filename);
+        return NULL;
+    }
+    uint64_t rows = load_u64(data + 8), cols = load_u64(data + 16);
+    if (rows > INT_MAX || cols > INT_MAX) {
+        fprintf(stderr, "Error: '%s' has a bad shape.\n", filename);
+        return NULL;
+    }
+
+    // Entry sizes chain the offsets, so rows are located in one sequential pass
+    size_t* row_start = xmalloc((rows + 1) * sizeof(size_t));
+    size_t offset = RAW_HEADER_BYTES, max_words = 0, sum_words = 0;
+    for (uint64_t i = 0; i < rows; i++) {
+        row_start[i] = offset;
+        for (uint64_t j = 0; j < cols; j++) {
+            if (bytes - offset < 8) {
+                fprintf(stderr, "Error: '%s' is truncated at entry (%lu, %lu).\n", filename,
+                        (unsigned long) i, (unsigned long) j);
+                free(row_start);
+                return NULL;
+            }
+            int64_t size = (int64_t) load_u64(data + offset);
+            uint64_t words = size < 0 ? 0 - (uint64_t) size : (uint64_t) size;
+            if (words > (bytes - offset) / 8 - 1) {
+                fprintf(stderr, "Error: '%s' is truncated at entry (%lu, %lu).\n", filename,
+                        (unsigned long) i, (unsigned long) j);
+                free(row_start);
+                return NULL;
+            }
+            offset += 8 * (words + 1);
+            sum_words += words;
+            if (words > max_words) max_words = words;
+        }
+    }
+    row_start[rows] = offset;
+    if (offset != bytes) {
+        fprintf(stderr, "Error: '%s' has %zu trailing bytes.\n", filename, bytes - offset);
+        free(row_start);
+        return NULL;
+    }
+
+    size_t count = (size_t) rows * cols;
+    size_t slot_words = max_words;
+    if (count > 0 && slot_words > 2 * (sum_words / count + 1)) slot_words = 2 * (sum_words / count + 1);
+    mpz_t** mat = allocate_mpz_matrix_arena((int) rows, (int) cols, (long) slot_words * 64);
+    MpzRawJob job = { data, row_start, mat, (int) rows, (int) cols, io_tasks(pool, bytes) };
+    if (job.tasks > (int) rows) job.tasks = rows > 0 ? (int) rows : 1;
+    thread_pool_run(pool, job.tasks, raw_read_task, &job);
+    free(row_start);
+    *n = (int) rows;
+    *m = (int) cols;
+    return mat;
+}
+
+mpz_t** read_mpz_matrix_from_file_pool(const char* filename, int* n, int* m, MpzFileFormat format,
+                                       ThreadPool* pool) {
+    int fd = open(filename, O_RDONLY);
+    struct stat sb;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+        if (fd >= 0) close(fd);
+        fprintf(stderr, "Error: could not open file '%s' for reading.\n", filename);
+        return NULL;
+    }
+    size_t bytes = (size_t) sb.st_size;
+    const unsigned char* data = (const unsigned char*) "";
+    void* map = NULL;
+    if (bytes > 0) {
+        map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            fprintf(stderr, "Error: could not map file '%s'.\n", filename);
+            return NULL;
+        }
+        data = (const unsigned char*) map;
+    }
+    close(fd);
+
+    mpz_t** mat;
+    if (format == MPZ_FILE_RAW_LIMBS) {
+        mat = read_raw(filename, data, bytes, n, m, pool);
+    } else {
+        mat = read_text(filename, data, bytes, format == MPZ_FILE_HEX ? 16 : 10, n, m, pool);
+    }
+    if (map) munmap(map, bytes);
+    return mat;
+}
+
+/////////////////////////////
+//         Writer          //
+/////////////////////////////
+
+typedef struct {
+    mpz_t** mat;
+    int n;
+    int m;
+    int tasks;
+    MpzFileFormat format;
+    char** buf;       // output of each task
+    size_t* len;
+} MpzWriteJob;
+
+// Task t formats a contiguous block of rows into its own buffer
+static void write_task(void* arg, int t, int worker_idx) {
+    MpzWriteJob* job = (MpzWriteJob*) arg;
+    (void) worker_idx;
+    int r0 = (int) ((long) job->n * t / job->tasks), r1 = (int) ((long) job->n * (t + 1) / job->tasks);
+    int base = job->format == MPZ_FILE_HEX ? 16 : 10;
+
+    size_t cap = 0;
+    for (int i = r0; i < r1; i++) {
+        for (int j = 0; j < job->m; j++) {
+            if (job->format == MPZ_FILE_RAW_LIMBS) {
+                cap += 8 * (mpz_size(job->mat[i][j]) + 1);
+            } else {
+                cap += mpz_sizeinbase(job->mat[i][j], base) + 2;   // sign and separator
+            }
+        }
+        cap += 1;
+    }
+    char* out = xmalloc(cap);
+    size_t pos = 0;
+    for (int i = r0; i < r1; i++) {
+        for (int j = 0; j < job->m; j++) {
+            mpz_srcptr x = job->mat[i][j];
+            if (job->format == MPZ_FILE_RAW_LIMBS) {
+                size_t words = 0;
+                mpz_export(out + pos + 8, &words, -1, 8, -1, 0, x);
+                int64_t size = mpz_sgn(x) < 0 ? -(int64_t) words : (int64_t) words;
+                memcpy(out + pos, &size, 8);
+                pos += 8 * (words + 1);
+            } else {
+                mpz_get_str(out + pos, base, x);
+                pos += strlen(out + pos);
+                out[pos++] = ' ';
+            }
+        }
+        if (job->format != MPZ_FILE_RAW_LIMBS) out[pos++] = '\n';
+    }
+    job->buf[t] = out;
+    job->len[t] = pos;
+}
+
+// Writes all of iov[0..count), IOV_MAX at a time and resuming after short writes
+static int writev_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        int batch = count < IOV_MAX ? count : IOV_MAX;
+        ssize_t written = writev(fd, iov, batch);
+        if (written < 0) return -1;
+        while (count > 0 && (size_t) written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return 0;
+}
+
+int write_mpz_matrix_to_file_pool(const char* filename, mpz_t** mat, int n, int m, MpzFileFormat format,
+                                  ThreadPool* pool) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: could not open file '%s' for writing.\n", filename);
+        return -1;
+    }
+
+    char header[RAW_HEADER_BYTES + 32];
+    size_t header_len;
+    if (format == MPZ_FILE_RAW_LIMBS) {
+        uint64_t dims[2] = { (uint64_t) n, (uint64_t) m };
+        memcpy(header, MPZ_RAW_MAGIC, sizeof(MPZ_RAW_MAGIC));
+        memcpy(header + 8, dims, sizeof(dims));
+        header_len = RAW_HEADER_BYTES;
+    } else {
+        header_len = (size_t) snprintf(header, sizeof(header), "%d %d\n", n, m);
+    }
+
+    MpzWriteJob job = { mat, n, m, io_tasks(pool, (size_t) n * m * 64), format, NULL, NULL };
+    if (job.tasks > n) job.tasks = n > 0 ? n : 1;
+    job.buf = xmalloc(job.tasks * sizeof(char*));
+    job.len = xmalloc(job.tasks * sizeof(size_t));
+    thread_pool_run(pool, job.tasks, write_task, &job);
+
+    struct iovec* iov = xmalloc((job.tasks + 1) * sizeof(struct iovec));
+    iov[0].iov_base = header;
+    iov[0].iov_len = header_len;
+    for (int t = 0; t < job.tasks; t++) {
+        iov[t + 1].iov_base = job.buf[t];
+        iov[t + 1].iov_len = job.len[t];
+    }
+    int status = writev_all(fd, iov, job.tasks + 1);
+    if (close(fd) != 0) status = -1;
+    if (status != 0) fprintf(stderr, "Error: failed to write '%s'.\n", filename);
+
+    for (int t = 0; t < job.tasks; t++) free(job.buf[t]);
+    free(job.buf);
+    free(job.len);
+    free(iov);
+    return status;
+}
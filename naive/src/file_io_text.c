@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <immintrin.h>
+#include "file_io_text.h"
+#include "xalloc.h"
+
+// Chunks per worker, for balance when lines differ in length
+#define CHUNKS_PER_THREAD 4
+// Smaller bodies are not worth splitting further
+#define MIN_CHUNK_BYTES (64 * 1024)
+
+typedef enum {
+    PARSE_OK = 0,
+    PARSE_BAD_CHAR,
+    PARSE_NO_DIGITS,
+    PARSE_RANGE,
+    PARSE_TOO_MANY
+} ParseStatus;
+
+static inline int is_space(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// Bit b set if p[b] is a separator
+static uint64_t space_mask_scalar(const unsigned char* p) {
+    uint64_t mask = 0;
+    for (int b = 0; b < 64; b++) mask |= (uint64_t) is_space(p[b]) << b;
+    return mask;
+}
+
+__attribute__((target("avx2")))
+static uint64_t space_mask_avx2(const unsigned char* p) {
+    const __m256i sp = _mm256_set1_epi8(' '), nl = _mm256_set1_epi8('\n');
+    const __m256i tab = _mm256_set1_epi8('\t'), cr = _mm256_set1_epi8('\r');
+    uint64_t mask = 0;
+    for (int h = 0; h < 2; h++) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) (p + 32 * h));
+        __m256i s = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, sp), _mm256_cmpeq_epi8(x, nl)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(x, tab), _mm256_cmpeq_epi8(x, cr)));
+        mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(s) << (32 * h);
+    }
+    return mask;
+}
+
+// Separator mask of the 64 bytes at p, the part past limit reading as separators
+static inline uint64_t block_mask(const unsigned char* p, const unsigned char* limit, int simd) {
+    if (limit - p >= 64) return simd ? space_mask_avx2(p) : space_mask_scalar(p);
+    unsigned char tail[64];
+    memset(tail, ' ', sizeof(tail));
+    memcpy(tail, p, limit - p);
+    return simd ? space_mask_avx2(tail) : space_mask_scalar(tail);
+}
+
+typedef struct {
+    const unsigned char* const* bound;   // chunk c is [bound[c], bound[c + 1])
+    int simd;
+    long* count;                         // values per chunk, then their offsets
+    // Parse pass
+    MatrixFileType type;
+    int64_t lo, hi;
+    long total;
+    void* out;
+    ParseStatus* status;                 // first error per chunk
+    const unsigned char** error_at;
+} TextJob;
+
+static void count_task(void* arg, int c, int worker_idx) {
+    TextJob* job = (TextJob*) arg;
+    (void) worker_idx;
+    const unsigned char* limit = job->bound[c + 1];
+    long count = 0;
+    uint64_t carry = 0;
+    for (const unsigned char* p = job->bound[c]; p < limit; p += 64) {
+        uint64_t value = ~block_mask(p, limit, job->simd);
+        count += __builtin_popcountll(value & ~((value << 1) | carry));
+        carry = value >> 63;
+    }
+    job->count[c] = count;
+}
+
+// Parses the value starting at p; *end is the first separator after it (or limit)
+static ParseStatus parse_value(const unsigned char* p, const unsigned char* limit, int64_t lo, int64_t hi,
+                               int64_t* value, const unsigned char** end) {
+    int neg = 0;
+    if (p < limit && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    const unsigned char* digits = p;
+    uint64_t acc = 0;
+    int overflow = 0;
+    for (; p < limit && !is_space(*p); p++) {
+        unsigned d = (unsigned) *p - '0';
+        if (d > 9) {
+            *end = p;
+            return PARSE_BAD_CHAR;
+        }
+        overflow |= acc > (UINT64_MAX - d) / 10;
+        acc = acc * 10 + d;
+    }
+    *end = p;
+    if (p == digits) return PARSE_NO_DIGITS;
+    if (overflow || (neg ? acc > (uint64_t) 0 - (uint64_t) lo : acc > (uint64_t) hi)) return PARSE_RANGE;
+    *value = neg ? (int64_t) (0 - acc) : (int64_t) acc;
+    return PARSE_OK;
+}
+
+static inline void store_value(void* out, MatrixFileType type, long idx, int64_t v) {
+    switch (type) {
+        case MATRIX_FILE_INT8: ((int8_t*) out)[idx] = (int8_t) v; break;
+        case MATRIX_FILE_UINT8: ((uint8_t*) out)[idx] = (uint8_t) v; break;
+        case MATRIX_FILE_INT16: ((int16_t*) out)[idx] = (int16_t) v; break;
+        case MATRIX_FILE_INT32: ((int32_t*) out)[idx] = (int32_t) v; break;
+        default: ((int64_t*) out)[idx] = v; break;
+    }
+}
+
+// Digits of a value of 1 to 8 digits starting at p (8 bytes readable), or -1
+// if one of them is not a digit. Each byte is checked to be in '0'..'9' and
+// the digits combined pairwise, 2, 4 then 8 at a time.
+static inline int64_t parse_digits8(const unsigned char* p, int len) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+    uint64_t keep = UINT64_MAX >> (64 - 8 * len);
+    uint64_t high = 0xf0f0f0f0f0f0f0f0ULL & keep, zeros = 0x3030303030303030ULL & keep;
+    if ((w & high) != zeros || ((w + 0x0606060606060606ULL) & high) != zeros) return -1;
+    w = ((w & keep) - zeros) << (64 - 8 * len);   // leading zeros in the low bytes
+    w = (w * 2561) >> 8;
+    w = ((w & 0x00ff00ff00ff00ffULL) * 6553601) >> 16;
+    w = ((w & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32;
+    return (int64_t) w;
+}
+
+// Value starts and lengths come from the separator masks. Values inside the
+// block with at most 8 digits take the branch-free digit parser; the others
+// (and any error) go through parse_value.
+static void parse_task(void* arg, int c, int worker_idx) {
+    TextJob* job = (TextJob*) arg;
+    (void) worker_idx;
+    const unsigned char* limit = job->bound[c + 1];
+    long idx = job->count[c];
+    uint64_t carry = 0;
+    unsigned char buf[64 + 16];
+    memset(buf, ' ', sizeof(buf));
+    job->status[c] = PARSE_OK;
+    for (const unsigned char* p = job->bound[c]; p < limit; p += 64) {
+        // Values are read in place while 8 bytes past the block are mapped;
+        // only the last block goes through the padded copy
+        const unsigned char* src = p;
+        if (limit - p < 64 + 8) {
+            size_t len = limit - p < 64 ? (size_t) (limit - p) : 64;
+            memcpy(buf, p, len);
+            memset(buf + len, ' ', 64 - len);
+            src = buf;
+        }
+        uint64_t space = job->simd ? space_mask_avx2(src) : space_mask_scalar(src);
+        uint64_t value = ~space;
+        uint64_t starts = value & ~((value << 1) | carry);
+        carry = value >> 63;
+        while (starts) {
+            int s = __builtin_ctzll(starts);
+            starts &= starts - 1;
+            if (idx >= job->total) {
+                job->status[c] = PARSE_TOO_MANY;
+                job->error_at[c] = p + s;
+                return;
+            }
+            uint64_t rest = space >> s;
+            int sign = src[s] == '-' || src[s] == '+';
+            int64_t neg = src[s] == '-';
+            int digits = rest ? __builtin_ctzll(rest) - sign : 0;
+            int64_t v = (digits >= 1 && digits <= 8) ? parse_digits8(src + s + sign, digits) : -1;
+            int fast = v >= 0;
+            if (fast) {
+                v = (v ^ -neg) + neg;
+                fast = v >= job->lo && v <= job->hi;
+            }
+            if (!fast) {
+                const unsigned char* end;
+                ParseStatus st = parse_value(p + s, limit, job->lo, job->hi, &v, &end);
+                if (st != PARSE_OK) {
+                    job->status[c] = st;
+                    job->error_at[c] = (st == PARSE_BAD_CHAR) ? end : p + s;
+                    return;
+                }
+            }
+            store_value(job->out, job->type, idx++, v);
+        }
+    }
+}
+
+// Line and column of position at in text
+static void locate(TextMatrixError* err, const unsigned char* text, const unsigned char* at) {
+    err->line = 1;
+    const unsigned char* line_start = text;
+    for (const unsigned char* q = text; q < at; q++) {
+        if (*q == '\n') {
+            err->line++;
+            line_start = q + 1;
+        }
+    }
+    err->column = (long) (at - line_start) + 1;
+}
+
+static const char* type_name(MatrixFileType type) {
+    switch (type) {
+        case MATRIX_FILE_INT8: return "int8";
+        case MATRIX_FILE_UINT8: return "uint8";
+        case MATRIX_FILE_INT16: return "int16";
+        case MATRIX_FILE_INT32: return "int32";
+        default: return "int64";
+    }
+}
+
+// Reads one header dimension; returns 0 and sets *end past it, or -1
+static int parse_dimension(const unsigned char* p, const unsigned char* limit, long* dim, const unsigned char** end) {
+    while (p < limit && is_space(*p)) p++;
+    int64_t v;
+    ParseStatus st = parse_value(p, limit, 0, INT_MAX, &v, end);
+    if (st != PARSE_OK || *p == '+' || *p == '-') {
+        *end = p;
+        return -1;
+    }
+    *dim = (long) v;
+    return 0;
+}
+
+// Splits the body into chunks, counts and parses them; returns the matrix or NULL
+static void* parse_body(const unsigned char* text, const unsigned char* body, const unsigned char* limit,
+                        long rows, long cols, MatrixFileType type, int64_t lo, int64_t hi, ThreadPool* pool,
+                        TextMatrixError* err) {
+    // Chunks end right after a newline, so no value straddles two of them
+    int chunks = pool ? CHUNKS_PER_THREAD * thread_pool_size(pool) : 1;
+    size_t body_bytes = limit - body;
+    if ((size_t) chunks > body_bytes / MIN_CHUNK_BYTES + 1) chunks = (int) (body_bytes / MIN_CHUNK_BYTES + 1);
+    const unsigned char** bound = xmalloc((chunks + 1) * sizeof(unsigned char*));
+    long* count = xmalloc(chunks * sizeof(long));
+    ParseStatus* status = xmalloc(chunks * sizeof(ParseStatus));
+    const unsigned char** error_at = xmalloc(chunks * sizeof(unsigned char*));
+    bound[0] = body;
+    bound[chunks] = limit;
+    for (int c = 1; c < chunks; c++) {
+        const unsigned char* q = body + body_bytes * c / chunks;
+        if (q < bound[c - 1]) q = bound[c - 1];
+        const unsigned char* nl = memchr(q, '\n', limit - q);
+        bound[c] = nl ? nl + 1 : limit;
+    }
+
+    long total = rows * cols;
+    TextJob job = { bound, __builtin_cpu_supports("avx2"), count, type, lo, hi, total, NULL, status, error_at };
+    thread_pool_run(pool, chunks, count_task, &job);
+    long found = 0;
+    for (int c = 0; c < chunks; c++) {
+        long k = count[c];
+        count[c] = found;
+        found += k;
+    }
+
+    // A short file still gets parsed, so that a bad value before its end is reported first
+    long capacity = found < total ? found : total;
+    void* out = xaligned_alloc(MATRIX_FILE_ALIGN, (size_t) capacity * matrix_file_elem_size(type));
+    job.out = out;
+    thread_pool_run(pool, chunks, parse_task, &job);
+
+    // The first error in file order wins
+    int c = 0;
+    while (c < chunks && status[c] == PARSE_OK) c++;
+    int failed = c < chunks || found < total;
+    if (failed && err) {
+        const unsigned char* at = c < chunks ? error_at[c] : limit;
+        locate(err, text, at);
+        switch (c < chunks ? status[c] : PARSE_OK) {
+            case PARSE_BAD_CHAR:
+                snprintf(err->message, sizeof(err->message), "unexpected character (byte 0x%02x) in a value", *at);
+                break;
+            case PARSE_NO_DIGITS:
+                snprintf(err->message, sizeof(err->message), "sign without digits");
+                break;
+            case PARSE_RANGE:
+                snprintf(err->message, sizeof(err->message), "value out of range for %s", type_name(type));
+                break;
+            case PARSE_TOO_MANY:
+                snprintf(err->message, sizeof(err->message), "more than %ld values for a %ld x %ld matrix",
+                         total, rows, cols);
+                break;
+            default:
+                snprintf(err->message, sizeof(err->message), "expected %ld values, found %ld", total, found);
+                break;
+        }
+    }
+    free(bound);
+    free(count);
+    free(status);
+    free(error_at);
+    if (failed) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+void* load_text_matrix(const char* filename, MatrixFileType type, int* n, int* m, ThreadPool* pool,
+                       TextMatrixError* err) {
+    int64_t lo, hi;
+    switch (type) {
+        case MATRIX_FILE_INT8: lo = INT8_MIN; hi = INT8_MAX; break;
+        case MATRIX_FILE_UINT8: lo = 0; hi = UINT8_MAX; break;
+        case MATRIX_FILE_INT16: lo = INT16_MIN; hi = INT16_MAX; break;
+        case MATRIX_FILE_INT32: lo = INT32_MIN; hi = INT32_MAX; break;
+        case MATRIX_FILE_INT64: lo = INT64_MIN; hi = INT64_MAX; break;
+        default:
+            if (err) {
+                err->line = err->column = 0;
+                snprintf(err->message, sizeof(err->message), "unsupported element type %d", (int) type);
+            }
+            return NULL;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    struct stat sb;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+        if (fd >= 0) close(fd);
+        if (err) {
+            err->line = err->column = 0;
+            snprintf(err->message, sizeof(err->message), "could not open file '%s' for reading", filename);
+        }
+        return NULL;
+    }
+    size_t bytes = (size_t) sb.st_size;
+    const unsigned char* text = (const unsigned char*) "";
+    void* map = NULL;
+    if (bytes > 0) {
+        map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            if (err) {
+                err->line = err->column = 0;
+                snprintf(err->message, sizeof(err->message), "could not map file '%s'", filename);
+            }
+            return NULL;
+        }
+        text = (const unsigned char*) map;
+    }
+    close(fd);
+
+    long rows, cols;
+    const unsigned char* body;
+    void* out = NULL;
+    if (parse_dimension(text, text + bytes, &rows, &body) != 0 || parse_dimension(body, text + bytes, &cols, &body) != 0) {
+        if (err) {
+            locate(err, text, body);
+            snprintf(err->message, sizeof(err->message), "expected the dimensions \"n m\"");
+        }
+    } else {
+        out = parse_body(text, body, text + bytes, rows, cols, type, lo, hi, pool, err);
+        if (out) {
+            *n = (int) rows;
+            *m = (int) cols;
+        }
+    }
+    if (map) munmap(map, bytes);
+    return out;
+}
@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "gemm_int8_batched.h"
+#include "xalloc.h"
+
+typedef struct {
+    uint8_t palette_id;
+    uint8_t start_row;
+    uint8_t reserved_0[14];
+    uint16_t colsb[16];
+    uint8_t rows[16];
+} AmxTileConfig;
+
+typedef struct {
+    const int8_t* const* a_ptrs;   // pointer-array batch, or NULL for a strided one
+    const int8_t* const* b_ptrs;
+    int32_t* const* c_ptrs;
+    const int8_t* a_base;
+    const int8_t* b_base;
+    int32_t* c_base;
+    long stride_a, stride_b, stride_c;
+    int lda, ldb, ldc;
+    int n, m, p;
+    int batch_count;
+    int mod;
+    ResidueInt8Kernel kernel;
+    int tasks;
+} BatchJob;
+
+static inline const int8_t* batch_a(const BatchJob* job, int b) {
+    return job->a_ptrs ? job->a_ptrs[b] : job->a_base + (size_t) b * job->stride_a;
+}
+
+static inline const int8_t* batch_b(const BatchJob* job, int b) {
+    return job->b_ptrs ? job->b_ptrs[b] : job->b_base + (size_t) b * job->stride_b;
+}
+
+static inline int32_t* batch_c(const BatchJob* job, int b) {
+    return job->c_ptrs ? job->c_ptrs[b] : job->c_base + (size_t) b * job->stride_c;
+}
+
+static inline int32_t reduce(int32_t x, int mod) {
+    if (mod <= 0) return x;
+    int32_t r = x % mod;
+    return r < 0 ? r + mod : r;
+}
+
+// Residue c in [0, mod) plus the sum of one more window of K, reduced
+static inline int32_t fold(int32_t c, int32_t window_sum, int mod) {
+    int64_t r = ((int64_t) c + window_sum) % mod;
+    return (int32_t) (r < 0 ? r + mod : r);
+}
+
+// Steps of K summed in int32 before the results are reduced (mod > 0)
+static inline int window_of(int m, int mod) {
+    return mod > 0 && m > GEMM_INT8_BATCHED_WINDOW ? GEMM_INT8_BATCHED_WINDOW : m;
+}
+
+int gemm_int8_batched_group_size(int n, int m, int p) {
+    int m4 = (m + 3) & ~3;
+    if (n <= 0 || p <= 0 || n > 16 || p > 16 || m4 > 64) return 0;
+    int g = 16 / n;
+    if (16 / p < g) g = 16 / p;
+    if (m4 > 0 && 64 / m4 < g) g = 64 / m4;
+    return g;
+}
+
+/////////////////////////////
+//   Loop kernels          //
+/////////////////////////////
+
+// i-r-j loop over one problem, K in windows of `window` steps; the j loop
+// vectorizes for the caller's target. tmp (p entries) holds the sums of the
+// windows after the first one
+static inline __attribute__((always_inline))
+void loop_problem(const int8_t* A, int lda, const int8_t* B, int ldb, int32_t* C, int ldc,
+                  int n, int m, int p, int mod, int window, int32_t* tmp) {
+    for (int i = 0; i < n; i++) {
+        int32_t* c_row = C + (size_t) i * ldc;
+        for (int r0 = 0; r0 < m || r0 == 0; r0 += window) {
+            int r1 = (m - r0 < window) ? m : r0 + window;
+            int32_t* acc = r0 == 0 ? c_row : tmp;
+            for (int j = 0; j < p; j++) acc[j] = 0;
+            for (int r = r0; r < r1; r++) {
+                int32_t a = A[(size_t) i * lda + r];
+                const int8_t* b_row = B + (size_t) r * ldb;
+                for (int j = 0; j < p; j++) acc[j] += a * (int32_t) b_row[j];
+            }
+            if (mod > 0 && r0 == 0) {
+                for (int j = 0; j < p; j++) c_row[j] = reduce(c_row[j], mod);
+            } else if (mod > 0) {
+                for (int j = 0; j < p; j++) c_row[j] = fold(c_row[j], tmp[j], mod);
+            }
+            if (window <= 0) break;
+        }
+    }
+}
+
+#define LOOP_RANGE(job, b0, b1)                                                                          \
+    do {                                                                                                 \
+        int window = window_of((job)->m, (job)->mod);                                                    \
+        int32_t* tmp = window < (job)->m ? xmalloc((size_t) (job)->p * sizeof(int32_t)) : NULL;          \
+        for (int b = (b0); b < (b1); b++) {                                                              \
+            loop_problem(batch_a(job, b), (job)->lda, batch_b(job, b), (job)->ldb, batch_c(job, b),      \
+                         (job)->ldc, (job)->n, (job)->m, (job)->p, (job)->mod, window, tmp);             \
+        }                                                                                                \
+        free(tmp);                                                                                       \
+    } while (0)
+
+static void loop_range_scalar(const BatchJob* job, int b0, int b1) {
+    LOOP_RANGE(job, b0, b1);
+}
+
+__attribute__((target("avx2")))
+static void loop_range_avx2(const BatchJob* job, int b0, int b1) {
+    LOOP_RANGE(job, b0, b1);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void loop_range_avx512(const BatchJob* job, int b0, int b1) {
+    LOOP_RANGE(job, b0, b1);
+}
+
+/////////////////////////////
+//   AMX kernels           //
+/////////////////////////////
+
+// Groups of g problems packed block-diagonally into one tile product
+__attribute__((target("amx-tile,amx-int8")))
+static void amx_range_grouped(const BatchJob* job, int b0, int b1, int g) {
+    int n = job->n, m = job->m, p = job->p;
+    int m4 = (m + 3) & ~3;
+    int rows = g * n, k = g * m4, cols = g * p;
+
+    // One configuration for the whole range: every group has the same shape
+    AmxTileConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.palette_id = 1;
+    cfg.rows[0] = (uint8_t) rows;       // C: rows × cols int32
+    cfg.colsb[0] = (uint16_t) (cols * 4);
+    cfg.rows[1] = (uint8_t) rows;       // A: rows × k int8
+    cfg.colsb[1] = (uint16_t) k;
+    cfg.rows[2] = (uint8_t) (k / 4);    // B: k/4 quads × cols × 4 int8
+    cfg.colsb[2] = (uint16_t) (cols * 4);
+    _tile_loadconfig(&cfg);
+
+    int8_t a_tile[16 * 64] __attribute__((aligned(64)));
+    int8_t b_tile[16 * 64] __attribute__((aligned(64)));
+    int32_t c_tile[16 * 16] __attribute__((aligned(64)));
+    memset(a_tile, 0, sizeof(a_tile));
+    memset(b_tile, 0, sizeof(b_tile));
+
+    for (int first = b0; first < b1; first += g) {
+        int count = (b1 - first < g) ? b1 - first : g;
+
+        // A slot only meets its own K range of B, so stale slots of a short
+        // last group never reach the diagonal blocks that are read back
+        for (int s = 0; s < count; s++) {
+            const int8_t* A = batch_a(job, first + s);
+            const int8_t* B = batch_b(job, first + s);
+            for (int i = 0; i < n; i++) {
+                memcpy(a_tile + (size_t) (s * n + i) * 64 + s * m4, A + (size_t) i * job->lda, m);
+            }
+            for (int r = 0; r < m; r++) {
+                int kk = s * m4 + r;
+                int8_t* quad_row = b_tile + (size_t) (kk / 4) * 64;
+                const int8_t* b_row = B + (size_t) r * job->ldb;
+                for (int j = 0; j < p; j++) quad_row[(s * p + j) * 4 + kk % 4] = b_row[j];
+            }
+        }
+
+        _tile_zero(0);
+        _tile_loadd(1, a_tile, 64);
+        _tile_loadd(2, b_tile, 64);
+        _tile_dpbssd(0, 1, 2);
+        _tile_stored(0, c_tile, 16 * (int) sizeof(int32_t));
+
+        for (int s = 0; s < count; s++) {
+            int32_t* C = batch_c(job, first + s);
+            for (int i = 0; i < n; i++) {
+                const int32_t* src = c_tile + (size_t) (s * n + i) * 16 + s * p;
+                int32_t* dst = C + (size_t) i * job->ldc;
+                for (int j = 0; j < p; j++) dst[j] = reduce(src[j], job->mod);
+            }
+        }
+    }
+
+    _tile_release();
+}
+
+// Shapes too large to group: 16 × 16 output tiles with K in steps of 64, one problem at a time
+__attribute__((target("amx-tile,amx-int8")))
+static void amx_range_tiled(const BatchJob* job, int b0, int b1) {
+    int n = job->n, m = job->m, p = job->p;
+    int n_pad = (n + 15) & ~15, p_pad = (p + 15) & ~15, k_pad = (m + 63) & ~63;
+    int window = window_of(k_pad, job->mod);   // GEMM_INT8_BATCHED_WINDOW is a multiple of 64
+    int32_t c_tile[16 * 16] __attribute__((aligned(64)));
+
+    AmxTileConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.palette_id = 1;
+    for (int t = 0; t < 3; t++) {
+        cfg.colsb[t] = 64;
+        cfg.rows[t] = 16;
+    }
+    _tile_loadconfig(&cfg);
+
+    // Panels are reused for every problem of the range
+    int8_t* a_panel = xaligned_alloc(64, (size_t) n_pad * k_pad);
+    int8_t* quads = xaligned_alloc(64, (size_t) k_pad * p_pad);
+    int32_t* c_panel = xaligned_alloc(64, (size_t) n_pad * p_pad * sizeof(int32_t));
+    memset(a_panel, 0, (size_t) n_pad * k_pad);
+    memset(quads, 0, (size_t) k_pad * p_pad);
+
+    for (int b = b0; b < b1; b++) {
+        const int8_t* A = batch_a(job, b);
+        const int8_t* B = batch_b(job, b);
+        for (int i = 0; i < n; i++) memcpy(a_panel + (size_t) i * k_pad, A + (size_t) i * job->lda, m);
+        for (int r = 0; r < m; r++) {
+            int8_t* quad_row = quads + (size_t) (r / 4) * 4 * p_pad;
+            const int8_t* b_row = B + (size_t) r * job->ldb;
+            for (int j = 0; j < p; j++) quad_row[j * 4 + r % 4] = b_row[j];
+        }
+
+        for (int i0 = 0; i0 < n_pad; i0 += 16) {
+            for (int j0 = 0; j0 < p_pad; j0 += 16) {
+                int32_t* c_block = c_panel + (size_t) i0 * p_pad + j0;
+                for (int r0 = 0; r0 < k_pad; r0 += window) {
+                    int r1 = (k_pad - r0 < window) ? k_pad : r0 + window;
+                    _tile_zero(0);
+                    for (int r = r0; r < r1; r += 64) {
+                        _tile_loadd(1, a_panel + (size_t) i0 * k_pad + r, k_pad);
+                        _tile_loadd(2, quads + (size_t) (r / 4) * 4 * p_pad + 4 * j0, 4 * p_pad);
+                        _tile_dpbssd(0, 1, 2);
+                    }
+                    if (r0 == 0) {
+                        _tile_stored(0, c_block, p_pad * (int) sizeof(int32_t));
+                        for (int i = 0; i < 16; i++)
+                            for (int j = 0; j < 16; j++) c_block[(size_t) i * p_pad + j] = reduce(c_block[(size_t) i * p_pad + j], job->mod);
+                    } else {
+                        _tile_stored(0, c_tile, 16 * (int) sizeof(int32_t));
+                        for (int i = 0; i < 16; i++)
+                            for (int j = 0; j < 16; j++) {
+                                int32_t* c = &c_block[(size_t) i * p_pad + j];
+                                *c = fold(*c, c_tile[i * 16 + j], job->mod);
+                            }
+                    }
+                }
+            }
+        }
+
+        int32_t* C = batch_c(job, b);
+        for (int i = 0; i < n; i++) {
+            memcpy(C + (size_t) i * job->ldc, c_panel + (size_t) i * p_pad, (size_t) p * sizeof(int32_t));
+        }
+    }
+
+    free(a_panel);
+    free(quads);
+    free(c_panel);
+    _tile_release();
+}
+
+/////////////////////////////
+//   Batch scheduling      //
+/////////////////////////////
+
+// Task t handles a contiguous range of problems, aligned to whole groups
+static void batch_task(void* arg, int t, int worker_idx) {
+    BatchJob* job = (BatchJob*) arg;
+    (void) worker_idx;
+
+    int g = (job->kernel == RESIDUE_INT8_AMX) ? gemm_int8_batched_group_size(job->n, job->m, job->p) : 1;
+    if (g < 1) g = 1;
+    long groups = (job->batch_count + g - 1) / g;
+    int b0 = (int) ((groups * t / job->tasks) * g);
+    int b1 = (int) ((groups * (t + 1) / job->tasks) * g);
+    if (b1 > job->batch_count) b1 = job->batch_count;
+    if (b0 >= b1) return;
+
+    switch (job->kernel) {
+        case RESIDUE_INT8_AMX:
+            if (gemm_int8_batched_group_size(job->n, job->m, job->p) > 0) {
+                amx_range_grouped(job, b0, b1, g);
+            } else {
+                amx_range_tiled(job, b0, b1);
+            }
+            break;
+        case RESIDUE_INT8_AVX512:
+            loop_range_avx512(job, b0, b1);
+            break;
+        case RESIDUE_INT8_AVX2:
+            loop_range_avx2(job, b0, b1);
+            break;
+        default:
+            loop_range_scalar(job, b0, b1);
+            break;
+    }
+}
+
+static void run_batch(BatchJob* job, ThreadPool* pool) {
+    if (job->batch_count <= 0 || job->n <= 0 || job->p <= 0) return;
+    if (job->mod == 0 && job->m > GEMM_INT8_BATCHED_EXACT_MAX_M) {
+        fprintf(stderr, "Error: exact int8 batched products need m <= %d (m = %d).\n",
+                GEMM_INT8_BATCHED_EXACT_MAX_M, job->m);
+        exit(EXIT_FAILURE);
+    }
+    if (!residue_gemm_int8_kernel_available(job->kernel)) job->kernel = RESIDUE_INT8_SCALAR;
+    if (job->m <= 0) job->kernel = RESIDUE_INT8_SCALAR;   // all-zero results, no tile shape for K = 0
+
+    int T = thread_pool_size(pool);
+    job->tasks = (job->batch_count < T) ? job->batch_count : T;
+    thread_pool_run(pool, job->tasks, batch_task, job);
+}
+
+void gemm_int8_batched(const int8_t* const* A, int lda, const int8_t* const* B, int ldb,
+                       int32_t* const* C, int ldc, int n, int m, int p, int batch_count, int mod,
+                       ResidueInt8Kernel kernel, ThreadPool* pool) {
+    BatchJob job;
+    memset(&job, 0, sizeof(job));
+    job.a_ptrs = A;
+    job.b_ptrs = B;
+    job.c_ptrs = C;
+    job.lda = lda;
+    job.ldb = ldb;
+    job.ldc = ldc;
+    job.n = n;
+    job.m = m;
+    job.p = p;
+    job.batch_count = batch_count;
+    job.mod = mod;
+    job.kernel = kernel;
+    run_batch(&job, pool);
+}
+
+void gemm_int8_batched_strided(const int8_t* A, int lda, long stride_a, const int8_t* B, int ldb, long stride_b,
+                               int32_t* C, int ldc, long stride_c, int n, int m, int p, int batch_count,
+                               int mod, ResidueInt8Kernel kernel, ThreadPool* pool) {
+    BatchJob job;
+    memset(&job, 0, sizeof(job));
+    job.a_base = A;
+    job.b_base = B;
+    job.c_base = C;
+    job.stride_a = stride_a;
+    job.stride_b = stride_b;
+    job.stride_c = stride_c;
+    job.lda = lda;
+    job.ldb = ldb;
+    job.ldc = ldc;
+    job.n = n;
+    job.m = m;
+    job.p = p;
+    job.batch_count = batch_count;
+    job.mod = mod;
+    job.kernel = kernel;
+    run_batch(&job, pool);
+}
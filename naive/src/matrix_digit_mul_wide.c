@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrix_digit_mul_wide.h"
+#include "matrix_rns_mul_wide.h"
+#include "rns_residue_product.h"
+#include "residue_gemm_fp64.h"
+#include "rns_basis.h"
+#include "xalloc.h"
+
+// Per-operation costs in nanoseconds, single thread, fitted to -O3
+// -march=native runs at 32-256 dimensions and 60-1000 bits on an AVX-512 /
+// AMX machine: multiply-accumulates of the int8 digit kernels (scalar, avx2,
+// avx512, amx), multiply-accumulates per modulus of the RNS residue GEMM
+// backends (int8 on AMX, when RNS_PRODUCT_BACKEND asks for it; fp64 scalar,
+// avx2, avx512), then the passes over entries
+static const double int8_mac_ns[RESIDUE_INT8_NUM_KERNELS] = {0.15, 0.068, 0.019, 0.0047};
+static const double fp64_mac_ns[RESIDUE_FP64_NUM_KERNELS] = {0.53, 0.33, 0.29};
+#define RNS_INT8_MAC_NS 0.1
+#define RNS_CONVERT_NS 1.2     // per entry, modulus and limb of wide_matrix_to_rns_planes
+#define RNS_CRT_NS 1.5         // per entry, modulus and limb of wide_matrix_from_rns_planes
+#define DIGIT_SPLIT_NS 0.5     // per entry and digit of the split
+#define DIGIT_CARRY_NS 3.0     // per entry and diagonal of the accumulation and carry passes
+
+int wide_digit_count(long bits) {
+    // Balanced digits reach 127·(2^(8D) - 1)/255 > 2^(8D-1), so 8D >= bits + 2 suffices
+    long digits = (bits + 2 + 7) / 8;
+    return (int) (digits < 1 ? 1 : digits);
+}
+
+typedef struct {
+    const WideMatrix* W;
+    int digits;
+    int8_t* out;
+    size_t row_stride;     // out elements between the digits of two consecutive rows
+    size_t digit_stride;   // out elements between two digit planes of one row
+} SplitJob;
+
+// Task i writes the balanced digits of row i of W, low digit first
+static void split_row_task(void* arg, int i, int worker_idx) {
+    SplitJob* job = (SplitJob*) arg;
+    const WideMatrix* W = job->W;
+    (void) worker_idx;
+    int m = W->m;
+    size_t count = (size_t) W->n * m;
+    const uint64_t* top = W->data + (size_t) (W->limbs - 1) * count + (size_t) i * m;
+
+    uint8_t* carry = xcalloc(m, 1);
+    for (int s = 0; s < job->digits; s++) {
+        int8_t* dst = job->out + (size_t) i * job->row_stride + (size_t) s * job->digit_stride;
+        int l = s / 8, shift = 8 * (s % 8);
+        if (l < W->limbs) {
+            const uint64_t* src = W->data + (size_t) l * count + (size_t) i * m;
+            for (int j = 0; j < m; j++) {
+                int v = (int) ((src[j] >> shift) & 0xff) + carry[j];
+                carry[j] = v >= 128;
+                dst[j] = (int8_t) (v - 256 * carry[j]);
+            }
+        } else {
+            // Sign extension beyond the top limb
+            for (int j = 0; j < m; j++) {
+                int v = ((int64_t) top[j] < 0 ? 0xff : 0) + carry[j];
+                carry[j] = v >= 128;
+                dst[j] = (int8_t) (v - 256 * carry[j]);
+            }
+        }
+    }
+    free(carry);
+}
+
+static int8_t* split_digits(const WideMatrix* W, int digits, size_t row_stride, size_t digit_stride,
+                            ThreadPool* pool) {
+    size_t total = (size_t) W->n * W->m * digits;
+    int8_t* out = xmalloc(total);
+    SplitJob job = { W, digits, out, row_stride, digit_stride };
+    thread_pool_run(pool, W->n, split_row_task, &job);
+    return out;
+}
+
+WideMatrix* multiply_matrix_digits_wide(const WideMatrix* A, const WideMatrix* B, ResidueInt8Kernel kernel,
+                                        ThreadPool* pool) {
+    if (A->m != B->n) return NULL;
+    int n = A->n, m = A->m, p = B->m;
+    long bits_a = wide_matrix_max_bits(A), bits_b = wide_matrix_max_bits(B);
+    int da = wide_digit_count(bits_a), db = wide_digit_count(bits_b);
+
+    // A: the da digits of a row side by side; B: its db digit planes stacked
+    int8_t* Ad = split_digits(A, da, (size_t) da * m, (size_t) m, pool);
+    int8_t* Bd = split_digits(B, db, (size_t) p, (size_t) m * p, pool);
+
+    WideMatrix* C = allocate_wide_matrix(n, p, rns_product_bound_bits(bits_a, bits_b, m));
+    residue_gemm_int8_digits(Ad, Bd, da, db, n, m, p, C->data, C->limbs, kernel, pool);
+    free(Ad);
+    free(Bd);
+    return C;
+}
+
+/////////////////////////////
+//       Cost model        //
+/////////////////////////////
+
+static double limbs_of(long bits) {
+    return (double) (bits / 64 + 1);
+}
+
+double wide_product_cost(WideProductMethod method, long bits_a, long bits_b, int n, int m, int p,
+                         ResidueInt8Kernel kernel) {
+    double nm = (double) n * m, mp = (double) m * p, np = (double) n * p;
+    long bound = rns_product_bound_bits(bits_a, bits_b, m);
+
+    if (method == WIDE_PRODUCT_DIGITS) {
+        double da = wide_digit_count(bits_a), db = wide_digit_count(bits_b);
+        if (kernel < 0 || kernel >= RESIDUE_INT8_NUM_KERNELS) kernel = RESIDUE_INT8_SCALAR;
+        double diagonals = da + db - 1 > 8 * limbs_of(bound) ? da + db - 1 : 8 * limbs_of(bound);
+        return (da * db * nm * p * int8_mac_ns[kernel]
+                + (nm * da + mp * db) * DIGIT_SPLIT_NS
+                + np * diagonals * DIGIT_CARRY_NS) * 1e-9;
+    }
+
+    // The basis and backend of multiply_matrix_rns_wide: primes above 2^(bits-1)
+    RNSProductBackend backend = rns_product_backend_choose(bound);
+    int modulus_bits = rns_product_modulus_bits(backend);
+    double k = (double) ((bound + modulus_bits - 2) / (modulus_bits - 1));
+    double mac_ns = backend == RNS_PRODUCT_INT8 ? RNS_INT8_MAC_NS
+                                                : fp64_mac_ns[residue_gemm_fp64_default_kernel()];
+    return (k * nm * p * mac_ns
+            + k * (nm * limbs_of(bits_a) + mp * limbs_of(bits_b)) * RNS_CONVERT_NS
+            + k * np * limbs_of(bound) * RNS_CRT_NS) * 1e-9;
+}
+
+WideProductMethod wide_product_choose(long bits_a, long bits_b, int n, int m, int p, ResidueInt8Kernel kernel) {
+    const char* env = getenv("WIDE_PRODUCT");
+    if (env && strcmp(env, "rns") == 0) return WIDE_PRODUCT_RNS;
+    if (env && strcmp(env, "digits") == 0) return WIDE_PRODUCT_DIGITS;
+    double digits = wide_product_cost(WIDE_PRODUCT_DIGITS, bits_a, bits_b, n, m, p, kernel);
+    double rns = wide_product_cost(WIDE_PRODUCT_RNS, bits_a, bits_b, n, m, p, kernel);
+    return digits <= rns ? WIDE_PRODUCT_DIGITS : WIDE_PRODUCT_RNS;
+}
+
+WideMatrix* multiply_matrix_wide(const WideMatrix* A, const WideMatrix* B, WideProductMethod method,
+                                 ThreadPool* pool) {
+    if (A->m != B->n) return NULL;
+    ResidueInt8Kernel kernel = residue_gemm_int8_default_kernel();
+    if (method == WIDE_PRODUCT_AUTO) {
+        method = wide_product_choose(wide_matrix_max_bits(A), wide_matrix_max_bits(B), A->n, A->m, B->m, kernel);
+    }
+    if (method == WIDE_PRODUCT_DIGITS) return multiply_matrix_digits_wide(A, B, kernel, pool);
+    return multiply_matrix_rns_wide(A, B, pool);
+}
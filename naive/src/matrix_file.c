@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "matrix_file.h"
+#include "xalloc.h"
+
+_Static_assert(sizeof(MatrixFileHeader) == 80, "MatrixFileHeader layout changed");
+_Static_assert(sizeof(int) == sizeof(int32_t), "moduli are stored as int32");
+
+#define PRIME1 0x9e3779b185ebca87ULL
+#define PRIME2 0xc2b2ae3d27d4eb4fULL
+#define PRIME3 0x165667b19e3779f9ULL
+
+// Four independent lanes over 32-byte blocks
+typedef struct {
+    uint64_t v[4];
+    uint64_t bytes;
+} ChecksumState;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static void checksum_init(ChecksumState* st) {
+    st->v[0] = PRIME1 + PRIME2;
+    st->v[1] = PRIME2;
+    st->v[2] = 0;
+    st->v[3] = 0 - PRIME1;
+    st->bytes = 0;
+}
+
+// bytes must be a multiple of 32 except on the last call
+static void checksum_update(ChecksumState* st, const unsigned char* p, size_t bytes) {
+    size_t full = bytes & ~(size_t) 31;
+    for (size_t off = 0; off < full; off += 32) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t w;
+            memcpy(&w, p + off + 8 * l, 8);
+            st->v[l] = rotl64(st->v[l] + w * PRIME2, 31) * PRIME1;
+        }
+    }
+    if (full < bytes) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, p + full, bytes - full);
+        checksum_update(st, tail, 32);
+    }
+    st->bytes += bytes;
+}
+
+static uint64_t checksum_final(const ChecksumState* st) {
+    uint64_t h = rotl64(st->v[0], 1) + rotl64(st->v[1], 7) + rotl64(st->v[2], 12) + rotl64(st->v[3], 18);
+    h ^= st->bytes * PRIME3;
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t matrix_file_checksum(const void* data, size_t bytes) {
+    ChecksumState st;
+    checksum_init(&st);
+    checksum_update(&st, (const unsigned char*) data, bytes);
+    return checksum_final(&st);
+}
+
+size_t matrix_file_elem_size(MatrixFileType type) {
+    switch (type) {
+        case MATRIX_FILE_INT8:
+        case MATRIX_FILE_UINT8: return 1;
+        case MATRIX_FILE_INT16: return 2;
+        case MATRIX_FILE_INT32: return 4;
+        case MATRIX_FILE_INT64:
+        case MATRIX_FILE_FLOAT64:
+        case MATRIX_FILE_LIMB64: return 8;
+    }
+    return 0;
+}
+
+static uint64_t align_up(uint64_t x) {
+    return (x + MATRIX_FILE_ALIGN - 1) & ~(uint64_t) (MATRIX_FILE_ALIGN - 1);
+}
+
+static void fill_header(MatrixFileHeader* h, MatrixFileType type, int rows, int cols, int planes,
+                        const int* moduli) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, MATRIX_FILE_MAGIC, sizeof(MATRIX_FILE_MAGIC));
+    h->version = MATRIX_FILE_VERSION;
+    h->type = (uint32_t) type;
+    h->elem_size = (uint32_t) matrix_file_elem_size(type);
+    h->alignment = MATRIX_FILE_ALIGN;
+    h->rows = (uint64_t) rows;
+    h->cols = (uint64_t) cols;
+    h->row_stride = (uint64_t) cols;
+    h->plane_stride = align_up((uint64_t) rows * cols * h->elem_size);
+    h->planes = (uint32_t) planes;
+    h->has_basis = moduli != NULL;
+    h->payload_offset = align_up(sizeof(*h) + (moduli ? (uint64_t) planes * sizeof(int32_t) : 0));
+}
+
+int matrix_file_write(const char* filename, MatrixFileType type, int rows, int cols, int planes,
+                      const void* const* data, long ld, const int* moduli) {
+    size_t elem = matrix_file_elem_size(type);
+    if (elem == 0 || rows < 0 || cols < 0 || planes < 1 || ld < cols) return -1;
+    if (moduli && type == MATRIX_FILE_LIMB64) return -1;
+
+    MatrixFileHeader h;
+    fill_header(&h, type, rows, cols, planes, moduli);
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) return -1;
+    unsigned char* plane = xcalloc(h.plane_stride, 1);
+
+    // Header is rewritten with the checksum once the payload is out
+    static const unsigned char zeros[MATRIX_FILE_ALIGN];
+    int ok = fwrite(&h, sizeof(h), 1, file) == 1;
+    size_t head = sizeof(h);
+    if (ok && moduli) {
+        ok = fwrite(moduli, sizeof(int32_t), planes, file) == (size_t) planes;
+        head += (size_t) planes * sizeof(int32_t);
+    }
+    if (ok && h.payload_offset > head) ok = fwrite(zeros, 1, h.payload_offset - head, file) == h.payload_offset - head;
+
+    ChecksumState st;
+    checksum_init(&st);
+    size_t row_bytes = (size_t) cols * elem;
+    for (int l = 0; l < planes && ok; l++) {
+        const unsigned char* src = (const unsigned char*) data[l];
+        for (int i = 0; i < rows; i++) memcpy(plane + (size_t) i * row_bytes, src + (size_t) i * ld * elem, row_bytes);
+        checksum_update(&st, plane, h.plane_stride);
+        ok = h.plane_stride == 0 || fwrite(plane, 1, h.plane_stride, file) == h.plane_stride;
+    }
+    free(plane);
+
+    h.checksum = checksum_final(&st);
+    if (ok) ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, file) == 1;
+    if (fclose(file) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+// Returns the reason the header does not describe a file of the given size, or NULL
+static const char* header_error(const MatrixFileHeader* h, uint64_t size) {
+    if (memcmp(h->magic, MATRIX_FILE_MAGIC, sizeof(MATRIX_FILE_MAGIC)) != 0) return "not a matrix file";
+    if (h->version != MATRIX_FILE_VERSION) return "unsupported version";
+    if (h->elem_size == 0 || h->elem_size != matrix_file_elem_size((MatrixFileType) h->type)) return "bad element type";
+    if (h->alignment == 0 || (h->alignment & (h->alignment - 1)) != 0) return "bad alignment";
+    if (h->rows > INT_MAX || h->cols > INT_MAX || h->row_stride < h->cols || h->row_stride > LONG_MAX) return "bad shape";
+    if (h->planes < 1 || h->planes > INT_MAX || h->has_basis > 1) return "bad plane count";
+    if (h->has_basis && h->type == MATRIX_FILE_LIMB64) return "basis on limb planes";
+
+    // Sizes are checked against the file before they are multiplied out
+    uint64_t plane_bytes;
+    if (__builtin_mul_overflow(h->rows, h->row_stride, &plane_bytes)
+        || __builtin_mul_overflow(plane_bytes, (uint64_t) h->elem_size, &plane_bytes)) return "bad shape";
+    if (h->rows > 0 && plane_bytes - (h->row_stride - h->cols) * h->elem_size > h->plane_stride) return "planes overlap";
+    uint64_t basis_end = sizeof(MatrixFileHeader) + (h->has_basis ? (uint64_t) h->planes * sizeof(int32_t) : 0);
+    if (h->payload_offset < basis_end || h->payload_offset % h->alignment || h->plane_stride % h->alignment) {
+        return "misaligned payload";
+    }
+    uint64_t payload;
+    if (__builtin_mul_overflow(h->plane_stride, (uint64_t) h->planes, &payload)
+        || h->payload_offset > size || payload != size - h->payload_offset) return "truncated or oversized file";
+    return NULL;
+}
+
+// Handle over a mapping whose header has been validated or just written
+static MatrixFile* make_handle(void* map, size_t bytes, int writable) {
+    const MatrixFileHeader* h = (const MatrixFileHeader*) map;
+    MatrixFile* file = xmalloc(sizeof(MatrixFile));
+    file->type = (MatrixFileType) h->type;
+    file->rows = (int) h->rows;
+    file->cols = (int) h->cols;
+    file->planes = (int) h->planes;
+    file->row_stride = (long) h->row_stride;
+    file->elem_size = h->elem_size;
+    file->plane_stride = (size_t) h->plane_stride;
+    file->moduli = h->has_basis ? (const int*) ((const unsigned char*) map + sizeof(MatrixFileHeader)) : NULL;
+    file->data = (const unsigned char*) map + h->payload_offset;
+    file->checksum = h->checksum;
+    file->map = map;
+    file->map_bytes = bytes;
+    file->writable = writable;
+    return file;
+}
+
+MatrixFile* matrix_file_open(const char* filename, int verify) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: could not open file '%s' for reading.\n", filename);
+        return NULL;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || (uint64_t) sb.st_size < sizeof(MatrixFileHeader)) {
+        fprintf(stderr, "Error: '%s' is too short for a matrix file.\n", filename);
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t) sb.st_size;
+    void* map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: could not map '%s'.\n", filename);
+        return NULL;
+    }
+
+    const MatrixFileHeader* h = (const MatrixFileHeader*) map;
+    const char* reason = header_error(h, bytes);
+    const unsigned char* payload = (const unsigned char*) map + (reason ? 0 : h->payload_offset);
+    if (reason == NULL && verify && matrix_file_checksum(payload, bytes - h->payload_offset) != h->checksum) {
+        reason = "checksum mismatch";
+    }
+    if (reason) {
+        fprintf(stderr, "Error: '%s': %s.\n", filename, reason);
+        munmap(map, bytes);
+        return NULL;
+    }
+
+    return make_handle(map, bytes, 0);
+}
+
+const void* matrix_file_plane(const MatrixFile* file, int plane) {
+    return (const unsigned char*) file->data + (size_t) plane * file->plane_stride;
+}
+
+MatrixFile* matrix_file_create(const char* filename, MatrixFileType type, int rows, int cols, int planes,
+                               const int* moduli) {
+    if (matrix_file_elem_size(type) == 0 || rows < 0 || cols < 0 || planes < 1) return NULL;
+    if (moduli && type == MATRIX_FILE_LIMB64) return NULL;
+
+    MatrixFileHeader h;
+    fill_header(&h, type, rows, cols, planes, moduli);
+    uint64_t size;
+    if (__builtin_mul_overflow(h.plane_stride, (uint64_t) planes, &size) || size > (uint64_t) LONG_MAX - h.payload_offset) {
+        return NULL;
+    }
+    size += h.payload_offset;
+
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: could not open file '%s' for writing.\n", filename);
+        return NULL;
+    }
+    void* map = MAP_FAILED;
+    if (ftruncate(fd, (off_t) size) == 0) map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: could not size or map '%s'.\n", filename);
+        return NULL;
+    }
+
+    memcpy(map, &h, sizeof(h));
+    if (moduli) memcpy((unsigned char*) map + sizeof(h), moduli, (size_t) planes * sizeof(int32_t));
+    return make_handle(map, (size_t) size, 1);
+}
+
+void* matrix_file_plane_writable(MatrixFile* file, int plane) {
+    if (!file->writable) return NULL;
+    return (unsigned char*) file->map + ((const MatrixFileHeader*) file->map)->payload_offset
+           + (size_t) plane * file->plane_stride;
+}
+
+int matrix_file_finish(MatrixFile* file) {
+    if (!file->writable) return -1;
+    MatrixFileHeader* h = (MatrixFileHeader*) file->map;
+    h->checksum = matrix_file_checksum(file->data, file->map_bytes - h->payload_offset);
+    file->checksum = h->checksum;
+    return msync(file->map, file->map_bytes, MS_SYNC) == 0 ? 0 : -1;
+}
+
+void matrix_file_close(MatrixFile* file) {
+    if (!file) return;
+    munmap(file->map, file->map_bytes);
+    free(file);
+}
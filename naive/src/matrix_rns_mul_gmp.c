@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/random.h>
+#include <gmp.h>
+#include "matrix_rns_mul_gmp.h"
+#include "rns_conversion_gmp.h"
+#include "matrix_utils_gmp.h"
+#include "rns_residue_product.h"
+#include "rns_basis.h"
+#include "crt_reconstruct_gmp.h"
+#include "mixed_radix_gmp.h"
+#include "residue_planes.h"
+#include "xalloc.h"
+
+typedef struct {
+    int*** Cres;
+    int k;
+    int p;
+    const CRTBasisMpz* basis;
+    const MRBasis* mr;      // used instead of basis when not NULL
+    mpz_t** C;
+} CrtJob;
+
+// Task i reconstructs row i of C into the centered range (-M/2, M/2]
+static void crt_row_task(void* arg, int i, int worker_idx) {
+    CrtJob* job = (CrtJob*) arg;
+    (void) worker_idx;
+
+    const int** rows = xmalloc(job->k * sizeof(int*));
+    for (int idx = 0; idx < job->k; idx++) rows[idx] = job->Cres[idx][i];
+    if (job->mr) {
+        mixed_radix_reconstruct_centered_mpz(job->mr, rows, job->p, job->C[i]);
+    } else {
+        crt_reconstruct_centered_mpz(job->basis, rows, job->p, job->C[i]);
+    }
+    free(rows);
+}
+
+long mpz_matrix_max_bits(mpz_t** A, int n, int m) {
+    long bits = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            if (mpz_sgn(A[i][j]) == 0) continue;
+            long b = (long) mpz_sizeinbase(A[i][j], 2);
+            if (b > bits) bits = b;
+        }
+    }
+    return bits;
+}
+
+mpz_t** multiply_matrix_rns_mpz(mpz_t** A, mpz_t** B, int n, int m, int p) {
+    return multiply_matrix_rns_mpz_pool(A, B, n, m, p, thread_pool_get_default());
+}
+
+// Centered reconstruction of the k residue planes of an n × p product, one row per task
+static mpz_t** reconstruct_mpz(int*** Cres, const int* moduli, int k, int n, int p, ThreadPool* pool) {
+    CrtJob job;
+    job.Cres = Cres;
+    job.k = k;
+    job.p = p;
+    CRTBasisMpz* basis = NULL;
+    MRBasis* mr = NULL;
+    if (rns_reconstruction_default() == RNS_RECONSTRUCT_MIXED_RADIX) {
+        mr = mr_basis_create(moduli, k);
+    } else {
+        basis = crt_basis_mpz_create(moduli, k);
+    }
+    job.basis = basis;
+    job.mr = mr;
+
+    // Entries are below M/2 in magnitude; the CRT sum before its reduction
+    // carries up to two limbs more
+    long bits = 2 * GMP_NUMB_BITS;
+    for (int idx = 0; idx < k; idx++) bits += 32 - __builtin_clz((unsigned) moduli[idx]);
+    job.C = allocate_mpz_matrix_arena(n, p, bits);
+    thread_pool_run(pool, n, crt_row_task, &job);
+
+    crt_basis_mpz_free(basis);
+    mr_basis_free(mr);
+    return job.C;
+}
+
+mpz_t** multiply_matrix_rns_mpz_pool(mpz_t** A, mpz_t** B, int n, int m, int p, ThreadPool* pool) {
+    // Pick the basis from the actual entry sizes, and the residue GEMM backend from the basis
+    long bound_bits = rns_product_bound_bits(mpz_matrix_max_bits(A, n, m),
+                                             mpz_matrix_max_bits(B, m, p), m);
+    RNSProductBackend backend = rns_product_backend_choose(bound_bits);
+    int k;
+    int* moduli = rns_product_basis(bound_bits, backend, &k);
+
+    // Convert A and B to RNS
+    RNSMatrix* Arns = mpz_matrix_to_rns_pool(A, n, m, moduli, k, RNS_MPZ_CONVERT_AUTO, pool);
+    RNSMatrix* Brns = mpz_matrix_to_rns_pool(B, m, p, moduli, k, RNS_MPZ_CONVERT_AUTO, pool);
+
+    // Residue products, one contiguous n × p plane per modulus
+    int*** Cres = allocate_residue_planes(k, n, p, sizeof(int));
+    rns_residue_product(Arns->residues, Brns->residues, Cres, moduli, k, n, m, p, backend, pool);
+    free_rns_matrix(Arns);
+    free_rns_matrix(Brns);
+
+    mpz_t** C = reconstruct_mpz(Cres, moduli, k, n, p, pool);
+    free_residue_planes(Cres, k);
+    free(moduli);
+
+    return C;
+}
+
+int rns_early_confirmations(int confidence_bits, RNSEarlyCheck check) {
+    // A modulus whose digits merely look stable passes the test with probability
+    // at most 2/m_j < 2^-(RNS_MPZ_MODULUS_BITS - 2). The projection spends half
+    // of the budget on its weights (rns_projection_weight_bits), the
+    // confirmations get the other half.
+    int per_modulus = RNS_MPZ_MODULUS_BITS - 2;
+    int bits = check == RNS_EARLY_CHECK_PROJECTION ? confidence_bits + 1 : confidence_bits;
+    int c = (bits + per_modulus - 1) / per_modulus;
+    return c < 1 ? 1 : c;
+}
+
+int rns_projection_weight_bits(int confidence_bits) {
+    // An error that is not zero cancels in sum_e w_e·C_e for at most one value
+    // of any one of its weights: probability 2^-bits, kept below half the budget
+    return confidence_bits + 1 > 31 ? confidence_bits + 1 : 31;
+}
+
+typedef struct {
+    uint64_t seed;
+    int bits;
+} Projection;
+
+// Fresh seed for the weights of one call
+static uint64_t projection_seed(void) {
+    uint64_t seed;
+    if (getrandom(&seed, sizeof(seed), 0) == (ssize_t) sizeof(seed)) return seed;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_nsec * 0x9e3779b97f4a7c15ULL ^ (uint64_t) ts.tv_sec ^ (uint64_t) (uintptr_t) &ts;
+}
+
+// 32 random bits (splitmix64 of the seeded index)
+static uint64_t projection_word(uint64_t seed, uint64_t index) {
+    uint64_t z = seed + index * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (z ^ (z >> 31)) >> 32;
+}
+
+// Weight of entry e in the random projection, a proj->bits-bit integer, mod mod
+static uint64_t projection_weight(const Projection* proj, uint64_t e, uint64_t mod) {
+    int words = (proj->bits + 31) / 32;
+    uint64_t r = 0;
+    for (int t = words - 1; t >= 0; t--) {
+        uint64_t w = projection_word(proj->seed, e * words + t);
+        if (t == words - 1 && proj->bits % 32) w &= (1ULL << (proj->bits % 32)) - 1;
+        r = ((r << 32) | w) % mod;
+    }
+    return r;
+}
+
+// sum_e w_e · plane[e] mod mod over the n × p plane
+static int projection_residue(const Projection* proj, const int* plane, long count, int mod) {
+    uint64_t acc = 0;
+    for (long e = 0; e < count; e++) {
+        acc += projection_weight(proj, (uint64_t) e, (uint64_t) mod) * (uint64_t) plane[e];
+        if ((e & 127) == 127) acc %= (uint64_t) mod;
+    }
+    return (int) (acc % (uint64_t) mod);
+}
+
+mpz_t** multiply_matrix_rns_mpz_adaptive(mpz_t** A, mpz_t** B, int n, int m, int p, int confidence_bits,
+                                         RNSEarlyCheck check, int* out_k, ThreadPool* pool) {
+    // The worst-case bound caps the number of moduli
+    long bound_bits = rns_product_bound_bits(mpz_matrix_max_bits(A, n, m),
+                                             mpz_matrix_max_bits(B, m, p), m);
+    Projection proj = { 0, rns_projection_weight_bits(confidence_bits) };
+    if (check == RNS_EARLY_CHECK_PROJECTION) {
+        // A few more moduli so that the projection itself stays exact up to the cap
+        proj.seed = projection_seed();
+        bound_bits += proj.bits + 64 - __builtin_clzll((unsigned long long) n * p + 1);
+    }
+    int k_max;
+    int* moduli = rns_product_basis(bound_bits, RNS_PRODUCT_FP64, &k_max);
+    MRBasis* mr = mr_basis_create(moduli, k_max);
+    int confirmations = rns_early_confirmations(confidence_bits, check);
+    long count = (long) n * p;
+
+    int*** Cres = xmalloc(k_max * sizeof(int**));
+    uint32_t** digits = NULL;       // per-entry digits, RNS_EARLY_CHECK_ALL
+    uint32_t* proj_digits = NULL;   // digits of the projection, RNS_EARLY_CHECK_PROJECTION
+    if (check == RNS_EARLY_CHECK_ALL) {
+        digits = xcalloc(k_max, sizeof(uint32_t*));
+    } else {
+        proj_digits = xmalloc(k_max * sizeof(uint32_t));
+    }
+
+    // Add moduli one at a time until `confirmations` consecutive ones leave
+    // the centered values unchanged, i.e. every new digit is 0 or m_j - 1
+    int k = 0, stable = 0;
+    while (k < k_max && stable < confirmations) {
+        int mod = moduli[k];
+        RNSMatrix* Arns = mpz_matrix_to_rns(A, n, m, moduli + k, 1);
+        RNSMatrix* Brns = mpz_matrix_to_rns(B, m, p, moduli + k, 1);
+        Cres[k] = allocate_residue_plane(n, p, sizeof(int));
+        rns_residue_product(Arns->residues, Brns->residues, Cres + k, moduli + k, 1, n, m, p, RNS_PRODUCT_FP64, pool);
+        free_rns_matrix(Arns);
+        free_rns_matrix(Brns);
+
+        int unchanged = 1;
+        if (count > 0 && check == RNS_EARLY_CHECK_ALL) {
+            digits[k] = xmalloc(count * sizeof(uint32_t));
+            mixed_radix_next_digit(mr, k, Cres[k][0], (const uint32_t* const*) digits, count, digits[k]);
+            for (long e = 0; e < count && unchanged; e++) {
+                unchanged = digits[k][e] == 0 || digits[k][e] == (uint32_t) mod - 1;
+            }
+        } else if (count > 0) {
+            int y = projection_residue(&proj, Cres[k][0], count, mod);
+            const uint32_t** prev = xmalloc(k * sizeof(uint32_t*));
+            for (int j = 0; j < k; j++) prev[j] = proj_digits + j;
+            mixed_radix_next_digit(mr, k, &y, prev, 1, proj_digits + k);
+            free(prev);
+            unchanged = proj_digits[k] == 0 || proj_digits[k] == (uint32_t) mod - 1;
+        }
+        stable = (k > 0 && unchanged) ? stable + 1 : 0;
+        k++;
+    }
+
+    mpz_t** C = reconstruct_mpz(Cres, moduli, k, n, p, pool);
+    if (out_k) *out_k = k;
+
+    if (digits) {
+        for (int idx = 0; idx < k; idx++) free(digits[idx]);
+        free(digits);
+    }
+    free(proj_digits);
+    free_residue_planes(Cres, k);
+    mr_basis_free(mr);
+    free(moduli);
+    return C;
+}
+
+mpz_t** multiply_matrix_mpz_classical(mpz_t** A, mpz_t** B, int n, int m, int p) {
+    mpz_t** C = allocate_mpz_matrix(n, p);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            for (int r = 0; r < m; r++) {
+                mpz_addmul(C[i][j], A[i][r], B[r][j]);
+            }
+        }
+    }
+    return C;
+}
@@ -1,84 +1,280 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include "matrix_rns_mul_int8.h"
 #include "rns_conversion_int8.h"
 #include "matrix_utils_int8.h"
+#include "residue_gemm.h"
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+#include "crt_reconstruct.h"
+#include "mixed_radix.h"
+#include "residue_planes.h"
 
-// Modular inverse using extended Euclidean algorithm
-int64_t modinv(int64_t a, int64_t m) {
-    int64_t m0 = m, t, q;
-    int64_t x0 = 0, x1 = 1;
-    if (m == 1) return 0;
-    while (a > 1) {
-        q = a / m;
-        t = m;
-        m = a % m;
-        a = t;
-        t = x0;
-        x0 = x1 - q * x0;
-        x1 = t;
-    }
-    return (x1 + m0) % m0;
+typedef struct {
+    int*** Cres;
+    int k;
+    int p;
+    const CRTBasis* basis;
+    const MRBasis* mr;      // used instead of basis when not NULL
+    int64_t** C;
+    long out_of_range;
+} CrtInt64Job;
+
+// Task i reconstructs row i of C into the centered range (-M/2, M/2]
+static void crt_int64_row_task(void* arg, int i, int worker_idx) {
+    CrtInt64Job* job = (CrtInt64Job*) arg;
+    (void) worker_idx;
+
+    const int** rows = malloc(job->k * sizeof(int*));
+    for (int idx = 0; idx < job->k; idx++) rows[idx] = job->Cres[idx][i];
+    long bad = job->mr ? mixed_radix_reconstruct_centered_int64(job->mr, rows, job->p, job->C[i])
+                       : crt_reconstruct_centered_int64(job->basis, rows, job->p, job->C[i]);
+    if (bad > 0) __atomic_fetch_add(&job->out_of_range, bad, __ATOMIC_RELAXED);
+    free(rows);
 }
 
-// Main multiplication + CRT reconstruction function
 int64_t** multiply_matrix_rns_int8(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k) {
-    // Convert A and B to RNS
-    RNSMatrix* Arns = int8_matrix_to_rns(A, n, m, moduli, k);
-    RNSMatrix* Brns = int8_matrix_to_rns(B, m, p, moduli, k);
+    return multiply_matrix_rns_int8_pool(A, B, n, m, p, moduli, k, thread_pool_get_default());
+}
+
+int64_t** multiply_matrix_rns_int8_pool(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                        ThreadPool* pool) {
+    return multiply_matrix_rns_int8_repr(A, B, n, m, p, moduli, k, RNS_RESIDUES_UNSIGNED, pool);
+}
+
+// Main multiplication + CRT reconstruction function
+int64_t** multiply_matrix_rns_int8_repr(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                        RNSResidueRepr repr, ThreadPool* pool) {
+    if (repr == RNS_RESIDUES_CENTERED) {
+        for (int idx = 0; idx < k; idx++) {
+            if (moduli[idx] < 3 || moduli[idx] > 255) return NULL;
+        }
+    }
+
+    // Prepare space for C residues: one contiguous n × p plane per modulus
+    int*** Cres = allocate_residue_planes(k, n, p, sizeof(int));
+
+    // Convert A and B to RNS and multiply in each modulus space, one modulus per worker
+    if (repr == RNS_RESIDUES_CENTERED) {
+        RNSMatrixCentered* Arns = int8_matrix_to_rns_centered(A, n, m, moduli, k);
+        RNSMatrixCentered* Brns = int8_matrix_to_rns_centered(B, m, p, moduli, k);
+        residue_gemm_int8_rns(Arns->residues, Brns->residues, Cres, moduli, k, n, m, p,
+                              residue_gemm_int8_default_kernel(), pool);
+        free_rns_matrix_centered(Arns);
+        free_rns_matrix_centered(Brns);
+    } else {
+        RNSMatrix* Arns = int8_matrix_to_rns(A, n, m, moduli, k);
+        RNSMatrix* Brns = int8_matrix_to_rns(B, m, p, moduli, k);
+        residue_gemm_rns(Arns->residues, Brns->residues, Cres, moduli, k, n, m, p, pool);
+        free_rns_matrix(Arns);
+        free_rns_matrix(Brns);
+    }
+
+    // Centered reconstruction, one row per task
+    CRTBasis* basis = NULL;
+    MRBasis* mr = NULL;
+    if (rns_reconstruction_default() == RNS_RECONSTRUCT_MIXED_RADIX) {
+        mr = mr_basis_create(moduli, k);
+    } else {
+        basis = crt_basis_create(moduli, k);
+    }
+    if (basis == NULL && mr == NULL) {
+        fprintf(stderr, "Error: RNS moduli are not pairwise coprime.\n");
+        exit(EXIT_FAILURE);
+    }
+    int64_t** C = malloc(n * sizeof(int64_t*));
+    for (int i = 0; i < n; i++) C[i] = malloc(p * sizeof(int64_t));
+
+    CrtInt64Job job = { Cres, k, p, basis, mr, C, 0 };
+    thread_pool_run(pool, n, crt_int64_row_task, &job);
+    if (job.out_of_range > 0) {
+        fprintf(stderr, "Warning: %ld entries exceed the range of the RNS basis or of int64_t.\n",
+                job.out_of_range);
+    }
+    crt_basis_free(basis);
+    mr_basis_free(mr);
+
+    // Free temporary residue matrices
+    free_residue_planes(Cres, k);
 
-    // Prepare space for C residues
-    int*** Cres = malloc(k * sizeof(int**));
+    return C;
+}
+
+// ==== Streaming reconstruction ====
+
+#define STREAM_BLOCK_ROWS 16
+
+// Incremental CRT step for one modulus: with x the value known modulo the
+// product M of the previous moduli, x += M·((r - x)·M^{-1} mod m)
+typedef struct {
+    int mod;
+    unsigned __int128 M;   // product of the previous moduli
+    uint64_t inv;          // M^{-1} mod m
+    uint64_t two64;        // 2^64 mod m
+    uint64_t barrett;      // floor((2^64 - 1) / m)
+} StreamFold;
+
+typedef struct {
+    const int* A;          // n × m residues of A for the current modulus
+    const int* B;          // m × p residues of B for the current modulus
+    const int* plane;      // n × p residue product, or NULL to compute it per block
+    int** scratch;         // one STREAM_BLOCK_ROWS × p buffer per worker
+    int n, m, p;
+    StreamFold fold;
+    int64_t** C;           // low 64 bits of the running value
+    uint64_t* hi;          // high 64 bits of the running value, n × p
+} StreamJob;
+
+// x mod m from the Barrett quotient, which is at most 2 below the true one
+static inline uint64_t reduce64(uint64_t x, uint64_t mod, uint64_t barrett) {
+    uint64_t r = x - (uint64_t) (((unsigned __int128) x * barrett) >> 64) * mod;
+    if (r >= mod) r -= mod;
+    if (r >= mod) r -= mod;
+    return r;
+}
+
+static void fold_rows(const StreamJob* job, const int* res, int ldres, int row_begin, int row_end) {
+    const StreamFold* f = &job->fold;
+    uint64_t mod = (uint64_t) f->mod, bar = f->barrett;
+    for (int i = row_begin; i < row_end; i++) {
+        const int* r = res + (size_t) (i - row_begin) * ldres;
+        uint64_t* lo = (uint64_t*) job->C[i];
+        uint64_t* hi = job->hi + (size_t) i * job->p;
+        for (int j = 0; j < job->p; j++) {
+            uint64_t xm = reduce64(reduce64(hi[j], mod, bar) * f->two64 + reduce64(lo[j], mod, bar), mod, bar);
+            uint64_t d = (uint64_t) r[j] + mod - xm;
+            if (d >= mod) d -= mod;
+            uint64_t t = reduce64(d * f->inv, mod, bar);
+            unsigned __int128 x = ((unsigned __int128) hi[j] << 64 | lo[j]) + f->M * t;
+            lo[j] = (uint64_t) x;
+            hi[j] = (uint64_t) (x >> 64);
+        }
+    }
+}
+
+// Task b computes rows [b·STREAM_BLOCK_ROWS, ...) of the residue product (unless
+// the plane is given) and folds them while they are still in cache
+static void stream_block_task(void* arg, int b, int worker_idx) {
+    StreamJob* job = (StreamJob*) arg;
+    int row_begin = b * STREAM_BLOCK_ROWS;
+    int row_end = row_begin + STREAM_BLOCK_ROWS < job->n ? row_begin + STREAM_BLOCK_ROWS : job->n;
+
+    if (job->plane) {
+        fold_rows(job, job->plane + (size_t) row_begin * job->p, job->p, row_begin, row_end);
+        return;
+    }
+    int* buf = job->scratch[worker_idx];
+    residue_gemm_rows(job->A + (size_t) row_begin * job->m, job->m, job->B, job->p, buf, job->p,
+                      job->m, job->p, job->fold.mod, 0, row_end - row_begin);
+    fold_rows(job, buf, job->p, row_begin, row_end);
+}
+
+static void run_stream_job(StreamJob* job, ThreadPool* pool) {
+    int blocks = (job->n + STREAM_BLOCK_ROWS - 1) / STREAM_BLOCK_ROWS;
+    thread_pool_run(pool, blocks, stream_block_task, job);
+}
+
+int64_t** multiply_matrix_rns_int8_streaming(int8_t** A, int8_t** B, int n, int m, int p, int* moduli, int k,
+                                             RNSResidueRepr repr, ThreadPool* pool) {
+    if (repr == RNS_RESIDUES_CENTERED) {
+        for (int idx = 0; idx < k; idx++) {
+            if (moduli[idx] < 3 || moduli[idx] > 255) return NULL;
+        }
+    }
+
+    // The running value is kept in 128 bits; larger bases use the stored planes
+    unsigned __int128 M = 1;
     for (int idx = 0; idx < k; idx++) {
-        Cres[idx] = malloc(n * sizeof(int*));
-        for (int i = 0; i < n; i++) {
-            Cres[idx][i] = calloc(p, sizeof(int));
+        if (M > ~(unsigned __int128) 0 / (unsigned) moduli[idx]) {
+            return multiply_matrix_rns_int8_repr(A, B, n, m, p, moduli, k, repr, pool);
         }
+        M *= (unsigned) moduli[idx];
     }
 
-    // Multiply in each modulus space
+    int64_t** C = malloc(n * sizeof(int64_t*));
+    for (int i = 0; i < n; i++) C[i] = calloc(p, sizeof(int64_t));
+    uint64_t* hi = calloc((size_t) n * p, sizeof(uint64_t));
+
+    int workers = thread_pool_size(pool);
+    int** scratch = NULL;
+    int* plane = NULL;
+    int*** Cres = NULL;
+    if (repr == RNS_RESIDUES_CENTERED) {
+        // The int8 kernels produce a whole plane per modulus; the fold is a second pass over it
+        plane = malloc((size_t) n * p * sizeof(int));
+        Cres = malloc(sizeof(int**));
+        Cres[0] = malloc(n * sizeof(int*));
+        for (int i = 0; i < n; i++) Cres[0][i] = plane + (size_t) i * p;
+    } else {
+        scratch = malloc(workers * sizeof(int*));
+        for (int w = 0; w < workers; w++) scratch[w] = malloc((size_t) STREAM_BLOCK_ROWS * p * sizeof(int));
+    }
+
+    unsigned __int128 Mprev = 1;
     for (int idx = 0; idx < k; idx++) {
         int mod = moduli[idx];
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < p; j++) {
-                for (int r = 0; r < m; r++) {
-                    Cres[idx][i][j] = (Cres[idx][i][j] + 
-                        Arns->residues[idx][i][r] * Brns->residues[idx][r][j]) % mod;
-                }
-            }
+        uint32_t inv = crt_modinv((uint64_t) (Mprev % (unsigned) mod), (uint64_t) mod);
+        if (inv == 0) {
+            fprintf(stderr, "Error: RNS moduli are not pairwise coprime.\n");
+            exit(EXIT_FAILURE);
         }
-    }
+        StreamJob job = { NULL, NULL, NULL, scratch, n, m, p,
+                          { mod, Mprev, (uint64_t) inv,
+                            (uint64_t) (((unsigned __int128) 1 << 64) % (unsigned) mod),
+                            UINT64_MAX / (unsigned) mod },
+                          C, hi };
 
-    // Reconstruct with CRT
-    int64_t M = 1;
-    for (int i = 0; i < k; i++) M *= moduli[i];
+        if (repr == RNS_RESIDUES_CENTERED) {
+            RNSMatrixCentered* Arns = int8_matrix_to_rns_centered(A, n, m, moduli + idx, 1);
+            RNSMatrixCentered* Brns = int8_matrix_to_rns_centered(B, m, p, moduli + idx, 1);
+            residue_gemm_int8_rns(Arns->residues, Brns->residues, Cres, moduli + idx, 1, n, m, p,
+                                  residue_gemm_int8_default_kernel(), pool);
+            free_rns_matrix_centered(Arns);
+            free_rns_matrix_centered(Brns);
+            job.plane = plane;
+            run_stream_job(&job, pool);
+        } else {
+            RNSMatrix* Arns = int8_matrix_to_rns(A, n, m, moduli + idx, 1);
+            RNSMatrix* Brns = int8_matrix_to_rns(B, m, p, moduli + idx, 1);
+            job.A = n > 0 ? Arns->residues[0][0] : NULL;
+            job.B = m > 0 ? Brns->residues[0][0] : NULL;
+            run_stream_job(&job, pool);
+            free_rns_matrix(Arns);
+            free_rns_matrix(Brns);
+        }
+        Mprev *= (unsigned) mod;
+    }
 
-    int64_t** C = malloc(n * sizeof(int64_t*));
+    // Center into (-M/2, M/2] and narrow to int64_t
+    unsigned __int128 half = M / 2;
+    long out_of_range = 0;
     for (int i = 0; i < n; i++) {
-        C[i] = malloc(p * sizeof(int64_t));
         for (int j = 0; j < p; j++) {
-            int64_t x = 0;
-            for (int idx = 0; idx < k; idx++) {
-                int64_t mi = moduli[idx];
-                int64_t ai = Cres[idx][i][j];
-                int64_t Mi = M / mi;
-                int64_t yi = modinv(Mi, mi);
-                x += ai * Mi * yi;
+            unsigned __int128 x = (unsigned __int128) hi[(size_t) i * p + j] << 64 | (uint64_t) C[i][j];
+            if (x <= half) {
+                if (x > (unsigned __int128) INT64_MAX) out_of_range++;
+                C[i][j] = (int64_t) x;
+            } else {
+                unsigned __int128 d = M - x;
+                if (d > (unsigned __int128) 1 << 63) out_of_range++;
+                C[i][j] = (int64_t) (0 - (uint64_t) d);
             }
-            C[i][j] = x % M;
         }
     }
-
-    // Free temporary residue matrices
-    for (int idx = 0; idx < k; idx++) {
-        for (int i = 0; i < n; i++) {
-            free(Cres[idx][i]);
-        }
-        free(Cres[idx]);
+    if (out_of_range > 0) {
+        fprintf(stderr, "Warning: %ld entries exceed the range of int64_t.\n", out_of_range);
     }
-    free(Cres);
-    free_rns_matrix(Arns);
-    free_rns_matrix(Brns);
 
+    free(hi);
+    if (scratch) {
+        for (int w = 0; w < workers; w++) free(scratch[w]);
+        free(scratch);
+    }
+    if (Cres) {
+        free(Cres[0]);
+        free(Cres);
+        free(plane);
+    }
     return C;
 }
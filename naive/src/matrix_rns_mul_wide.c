@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "matrix_rns_mul_wide.h"
+#include "rns_conversion_wide.h"
+#include "crt_reconstruct.h"
+#include "rns_residue_product.h"
+#include "rns_basis.h"
+#include "residue_planes.h"
+#include "xalloc.h"
+
+// Plane start pointers, the layout the wide conversions take
+static int** plane_starts(int*** X, int k) {
+    int** starts = xmalloc(k * sizeof(int*));
+    for (int idx = 0; idx < k; idx++) starts[idx] = X[idx][0];
+    return starts;
+}
+
+WideMatrix* multiply_matrix_rns_wide(const WideMatrix* A, const WideMatrix* B, ThreadPool* pool) {
+    if (A->m != B->n) return NULL;
+    int n = A->n, m = A->m, p = B->m;
+
+    long bound_bits = rns_product_bound_bits(wide_matrix_max_bits(A), wide_matrix_max_bits(B), m);
+    RNSProductBackend backend = rns_product_backend_choose(bound_bits);
+    int k;
+    int* moduli = rns_product_basis(bound_bits, backend, &k);
+
+    int*** Ares = allocate_residue_planes(k, n, m, sizeof(int));
+    int*** Bres = allocate_residue_planes(k, m, p, sizeof(int));
+    int*** Cres = allocate_residue_planes(k, n, p, sizeof(int));
+    int** starts = plane_starts(Ares, k);
+    wide_matrix_to_rns_planes(A, moduli, k, starts, pool);
+    free(starts);
+    starts = plane_starts(Bres, k);
+    wide_matrix_to_rns_planes(B, moduli, k, starts, pool);
+    free(starts);
+
+    rns_residue_product(Ares, Bres, Cres, moduli, k, n, m, p, backend, pool);
+    free_residue_planes(Ares, k);
+    free_residue_planes(Bres, k);
+
+    // The bound covers the sign, so every entry fits and nothing is out of range
+    WideMatrix* C = allocate_wide_matrix(n, p, bound_bits);
+    CRTBasis* basis = crt_basis_create(moduli, k);
+    starts = plane_starts(Cres, k);
+    wide_matrix_from_rns_planes(C, basis, (const int* const*) starts, pool);
+    free(starts);
+    crt_basis_free(basis);
+    free_residue_planes(Cres, k);
+    free(moduli);
+
+    return C;
+}
@@ -1,25 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "xalloc.h"
 
 /**
  * Allocates a dynamic 2D integer matrix of size n × m.
  * Returns a pointer to the matrix.
  */
 int** allocate_matrix(int n, int m) {
-    int** mat = (int**) malloc(n * sizeof(int*));
-    if (mat == NULL) {
-        fprintf(stderr, "Error: failed to allocate matrix rows.\n");
-        exit(EXIT_FAILURE);
-    }
+    int** mat = xmalloc(n * sizeof(int*));
 
     for (int i = 0; i < n; i++) {
-        mat[i] = (int*) malloc(m * sizeof(int));
-        if (mat[i] == NULL) {
-            fprintf(stderr, "Error: failed to allocate row %d.\n", i);
-            for (int k = 0; k < i; k++) free(mat[k]);
-            free(mat);
-            exit(EXIT_FAILURE);
-        }
+        mat[i] = xmalloc(m * sizeof(int));
     }
 
     return mat;
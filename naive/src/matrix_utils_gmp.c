@@ -1,26 +1,134 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include <gmp.h>
+#include "matrix_utils_gmp.h"
+#include "xalloc.h"
+
+/////////////////////////////
+//      Arena registry     //
+/////////////////////////////
+
+typedef struct {
+    mpz_t** rows;        // row pointers handed out to the caller
+    mpz_t* entries;      // n·m entries, row-major
+    mp_limb_t* limbs;    // n·m slots of `slot` limbs
+    size_t count;
+    size_t slot;
+} MpzArena;
+
+static pthread_rwlock_t arena_lock = PTHREAD_RWLOCK_INITIALIZER;
+static MpzArena* arenas = NULL;
+static int num_arenas = 0, cap_arenas = 0;
+
+// GMP memory functions in place before the wrappers were installed
+static void* (*prev_alloc)(size_t);
+static void* (*prev_realloc)(void*, size_t, size_t);
+static void (*prev_free)(void*, size_t);
+static pthread_once_t wrappers_once = PTHREAD_ONCE_INIT;
+
+// Slot ranges of the live arenas for the wrappers, read without the lock:
+// a seqlock (odd while the registry changes) around up to
+// ARENA_SNAPSHOT_MAX ranges; snap_count is -1 when there are more arenas,
+// and the wrappers fall back to the registry
+#define ARENA_SNAPSHOT_MAX 16
+static atomic_uint snap_seq;
+static atomic_int snap_count;
+static atomic_uintptr_t snap_lo[ARENA_SNAPSHOT_MAX], snap_hi[ARENA_SNAPSHOT_MAX];
+
+static int in_slots(const MpzArena* arena, const void* ptr) {
+    const mp_limb_t* p = (const mp_limb_t*) ptr;
+    return p >= arena->limbs && p < arena->limbs + arena->count * arena->slot;
+}
+
+// Caller holds the lock
+static int in_registered_slots(const void* ptr) {
+    for (int a = 0; a < num_arenas; a++) {
+        if (in_slots(&arenas[a], ptr)) return 1;
+    }
+    return 0;
+}
+
+// Republishes the snapshot after a change of the registry (caller holds the write lock)
+static void publish_snapshot(void) {
+    unsigned seq = atomic_load_explicit(&snap_seq, memory_order_relaxed);
+    atomic_store_explicit(&snap_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    int count = num_arenas <= ARENA_SNAPSHOT_MAX ? num_arenas : -1;
+    for (int a = 0; a < count; a++) {
+        atomic_store_explicit(&snap_lo[a], (uintptr_t) arenas[a].limbs, memory_order_relaxed);
+        atomic_store_explicit(&snap_hi[a], (uintptr_t) (arenas[a].limbs + arenas[a].count * arenas[a].slot),
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&snap_count, count, memory_order_relaxed);
+    atomic_store_explicit(&snap_seq, seq + 2, memory_order_release);
+}
+
+// Slots of an arena are registered before any of their entries reaches GMP
+// and unregistered before their limbs are freed, so a snapshot taken after
+// ptr was obtained classifies it correctly
+static int in_any_arena(const void* ptr) {
+    uintptr_t p = (uintptr_t) ptr;
+    for (;;) {
+        unsigned seq = atomic_load_explicit(&snap_seq, memory_order_acquire);
+        if (seq & 1) continue;
+        int count = atomic_load_explicit(&snap_count, memory_order_relaxed);
+        int found = 0;
+        for (int a = 0; a < count && !found; a++) {
+            found = p >= atomic_load_explicit(&snap_lo[a], memory_order_relaxed)
+                 && p < atomic_load_explicit(&snap_hi[a], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&snap_seq, memory_order_relaxed) != seq) continue;
+        if (count >= 0) return found;
+        break;
+    }
+    pthread_rwlock_rdlock(&arena_lock);
+    int found = in_registered_slots(ptr);
+    pthread_rwlock_unlock(&arena_lock);
+    return found;
+}
+
+// A slot that has to grow is copied to the heap and left in place
+static void* arena_realloc(void* ptr, size_t old_size, size_t new_size) {
+    if (!in_any_arena(ptr)) return prev_realloc(ptr, old_size, new_size);
+    void* fresh = prev_alloc(new_size);
+    memcpy(fresh, ptr, old_size < new_size ? old_size : new_size);
+    return fresh;
+}
+
+static void arena_free(void* ptr, size_t size) {
+    if (!in_any_arena(ptr)) prev_free(ptr, size);
+}
+
+// Wraps GMP's functions once for the lifetime of the process: swapping them
+// back and forth as arenas come and go would race with GMP calls on other
+// threads, and the wrappers forward everything but a slot
+static void install_wrappers(void) {
+    mp_get_memory_functions(&prev_alloc, &prev_realloc, &prev_free);
+    mp_set_memory_functions(prev_alloc, arena_realloc, arena_free);
+}
+
+// Index of the arena whose row pointers are mat, or -1 (caller holds the lock)
+static int find_arena(mpz_t** mat) {
+    for (int a = 0; a < num_arenas; a++) {
+        if (arenas[a].rows == mat) return a;
+    }
+    return -1;
+}
 
 /**
  * Allocates a 2D matrix of mpz_t (multi-precision integers) of size n × m.
  * Initializes each element with mpz_init.
  */
 mpz_t** allocate_mpz_matrix(int n, int m) {
-    mpz_t** mat = (mpz_t**) malloc(n * sizeof(mpz_t*));
-    if (mat == NULL) {
-        fprintf(stderr, "Error: failed to allocate mpz_t matrix rows.\n");
-        exit(EXIT_FAILURE);
-    }
+    mpz_t** mat = xmalloc(n * sizeof(mpz_t*));
 
     for (int i = 0; i < n; i++) {
-        mat[i] = (mpz_t*) malloc(m * sizeof(mpz_t));
-        if (mat[i] == NULL) {
-            fprintf(stderr, "Error: failed to allocate row %d for mpz_t.\n", i);
-            for (int k = 0; k < i; k++) free(mat[k]);
-            free(mat);
-            exit(EXIT_FAILURE);
-        }
+        mat[i] = xmalloc(m * sizeof(mpz_t));
         for (int j = 0; j < m; j++) {
             mpz_init(mat[i][j]);
         }
@@ -30,11 +138,92 @@ mpz_t** allocate_mpz_matrix(int n, int m) {
 }
 
 /**
- * Frees a 2D mpz_t matrix (calls mpz_clear on each element).
+ * Allocates an n × m mpz_t matrix whose entries live in one arena of limbs.
+ */
+mpz_t** allocate_mpz_matrix_arena(int n, int m, long bits) {
+    MpzArena arena;
+    arena.count = (size_t) n * m;
+    arena.slot = bits > 0 ? (size_t) (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS : 1;
+    arena.rows = xmalloc(n * sizeof(mpz_t*));
+    arena.entries = xmalloc(arena.count * sizeof(mpz_t));
+    arena.limbs = xcalloc(arena.count * arena.slot, sizeof(mp_limb_t));
+
+    for (size_t e = 0; e < arena.count; e++) {
+        arena.entries[e]->_mp_alloc = (int) arena.slot;
+        arena.entries[e]->_mp_size = 0;
+        arena.entries[e]->_mp_d = arena.limbs + e * arena.slot;
+    }
+    for (int i = 0; i < n; i++) arena.rows[i] = arena.entries + (size_t) i * m;
+
+    pthread_once(&wrappers_once, install_wrappers);
+    pthread_rwlock_wrlock(&arena_lock);
+    if (num_arenas == cap_arenas) {
+        cap_arenas = cap_arenas ? 2 * cap_arenas : 8;
+        arenas = xrealloc(arenas, cap_arenas * sizeof(MpzArena));
+    }
+    arenas[num_arenas++] = arena;
+    publish_snapshot();
+    pthread_rwlock_unlock(&arena_lock);
+
+    return arena.rows;
+}
+
+/**
+ * Non-zero if mat is a live arena matrix.
+ */
+int mpz_matrix_is_arena(mpz_t** mat) {
+    pthread_rwlock_rdlock(&arena_lock);
+    int found = mat != NULL && find_arena(mat) >= 0;
+    pthread_rwlock_unlock(&arena_lock);
+    return found;
+}
+
+/**
+ * Number of spilled entries of an arena matrix.
+ */
+long mpz_matrix_arena_spills(mpz_t** mat) {
+    long spills = 0;
+    pthread_rwlock_rdlock(&arena_lock);
+    int a = mat != NULL ? find_arena(mat) : -1;
+    if (a >= 0) {
+        for (size_t e = 0; e < arenas[a].count; e++) {
+            if (!in_slots(&arenas[a], arenas[a].entries[e]->_mp_d)) spills++;
+        }
+    }
+    pthread_rwlock_unlock(&arena_lock);
+    return spills;
+}
+
+/**
+ * Frees a 2D mpz_t matrix (calls mpz_clear on each element, or releases the
+ * arena of an arena matrix).
  */
 void free_mpz_matrix(mpz_t** mat, int n, int m) {
     if (mat == NULL) return;
 
+    pthread_rwlock_wrlock(&arena_lock);
+    int a = find_arena(mat);
+    if (a >= 0) {
+        MpzArena arena = arenas[a];
+        arenas[a] = arenas[--num_arenas];
+        publish_snapshot();
+
+        // Spilled limbs came from prev_alloc; slots go with their arena
+        for (size_t e = 0; e < arena.count; e++) {
+            const void* d = arena.entries[e]->_mp_d;
+            if (!in_slots(&arena, d) && !in_registered_slots(d)) {
+                prev_free(arena.entries[e]->_mp_d, (size_t) arena.entries[e]->_mp_alloc * sizeof(mp_limb_t));
+            }
+        }
+        pthread_rwlock_unlock(&arena_lock);
+
+        free(arena.limbs);
+        free(arena.entries);
+        free(arena.rows);
+        return;
+    }
+    pthread_rwlock_unlock(&arena_lock);
+
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < m; j++) {
             mpz_clear(mat[i][j]);
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "matrix_utils_wide.h"
+#include "xalloc.h"
+
+WideMatrix* allocate_wide_matrix(int n, int m, long bits) {
+    WideMatrix* W = xmalloc(sizeof(WideMatrix));
+    W->n = n;
+    W->m = m;
+    W->limbs = (int) ((bits > 0 ? bits : 0) / 64 + 1);
+    size_t words = (size_t) W->limbs * n * m;
+    W->data = xcalloc(words, sizeof(uint64_t));
+    return W;
+}
+
+void free_wide_matrix(WideMatrix* W) {
+    if (!W) return;
+    free(W->data);
+    free(W);
+}
+
+void wide_matrix_set_int64(WideMatrix* W, int i, int j, int64_t v) {
+    size_t count = (size_t) W->n * W->m, e = (size_t) i * W->m + j;
+    W->data[e] = (uint64_t) v;
+    for (int l = 1; l < W->limbs; l++) W->data[l * count + e] = v < 0 ? UINT64_MAX : 0;
+}
+
+int wide_matrix_get_int64(const WideMatrix* W, int i, int j, int64_t* v) {
+    size_t count = (size_t) W->n * W->m, e = (size_t) i * W->m + j;
+    *v = (int64_t) W->data[e];
+    uint64_t ext = *v < 0 ? UINT64_MAX : 0;
+    for (int l = 1; l < W->limbs; l++) {
+        if (W->data[l * count + e] != ext) return 0;
+    }
+    return 1;
+}
+
+// Limb l of |x| for entry e: for x < 0, |x| = ~x + 1 and the +1 only
+// carries through the limbs below the lowest non-zero limb z of x
+static inline uint64_t magnitude_limb(const WideMatrix* W, size_t e, int l, int neg, int z) {
+    uint64_t w = W->data[l * (size_t) W->n * W->m + e];
+    if (!neg) return w;
+    return l < z ? 0 : (l == z ? 0 - w : ~w);
+}
+
+double wide_matrix_get_double(const WideMatrix* W, int i, int j) {
+    size_t count = (size_t) W->n * W->m, e = (size_t) i * W->m + j;
+    int neg = (int64_t) W->data[(W->limbs - 1) * count + e] < 0;
+    int z = 0;
+    while (z < W->limbs - 1 && W->data[z * count + e] == 0) z++;
+
+    int top = W->limbs - 1;
+    while (top >= 0 && magnitude_limb(W, e, top, neg, z) == 0) top--;
+    if (top < 0) return 0.0;
+
+    // Top 64 bits of |x| with everything below folded into a sticky bit 0:
+    // the uint64 -> double conversion then rounds correctly, since bit 0
+    // lies far below the rounding position
+    uint64_t hi = magnitude_limb(W, e, top, neg, z);
+    int lead = __builtin_clzll(hi);
+    uint64_t head = hi << lead;
+    int sticky = 0;
+    if (top > 0) {
+        uint64_t below = magnitude_limb(W, e, top - 1, neg, z);
+        if (lead > 0) head |= below >> (64 - lead);
+        sticky = (lead > 0 ? below << lead : below) != 0;
+        for (int l = 0; l < top - 1; l++) sticky |= magnitude_limb(W, e, l, neg, z) != 0;
+    }
+    double v = ldexp((double) (head | (uint64_t) sticky), 64 * top - lead);
+    return neg ? -v : v;
+}
+
+long wide_matrix_max_bits(const WideMatrix* W) {
+    size_t count = (size_t) W->n * W->m;
+    long bits = 0;
+    for (size_t e = 0; e < count; e++) {
+        int neg = (int64_t) W->data[(W->limbs - 1) * count + e] < 0;
+        // |x| limb by limb: x itself, or ~x + 1 for negative entries
+        uint64_t carry = neg;
+        long top = 0;
+        for (int l = 0; l < W->limbs; l++) {
+            uint64_t w = W->data[l * count + e];
+            if (neg) {
+                w = ~w + carry;
+                carry = carry && w == 0;
+            }
+            if (w) top = 64L * l + 64 - __builtin_clzll(w);
+        }
+        if (top > bits) bits = top;
+    }
+    return bits;
+}
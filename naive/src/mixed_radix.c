@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mixed_radix.h"
+#include "crt_reconstruct.h"
+#include "xalloc.h"
+
+// Entries processed together; the per-digit loops run over one chunk
+#define MR_CHUNK 256
+
+// x * y mod m for x < 2^32, y < m < 2^31, with y_shoup = floor(y * 2^32 / m).
+// x*y - q*m < 2m fits in 32 bits, so it is evaluated modulo 2^32 (one
+// 32×32→64 multiply and two low multiplies, all of which vectorize)
+static inline uint32_t shoup_mulmod(uint32_t x, uint32_t y, uint32_t y_shoup, uint32_t m) {
+    uint32_t q = (uint32_t) (((uint64_t) x * y_shoup) >> 32);
+    uint32_t t = x * y - q * m;
+    return t >= m ? t - m : t;
+}
+
+RNSReconstruction rns_reconstruction_default(void) {
+    const char* env = getenv("RNS_RECONSTRUCT");
+    if (env && strcmp(env, "mixed_radix") == 0) return RNS_RECONSTRUCT_MIXED_RADIX;
+    return RNS_RECONSTRUCT_CRT;
+}
+
+/*
+ * Digit i of len entries into a[0 .. len), from their residues r modulo m_i
+ * and their digits d[j][0 .. len), j < i. Step j computes (a + off_{j,i} - d_j)·c_{j,i} mod m_i, where off_{j,i} is a
+ * multiple of m_i not below m_j, so the difference is non-negative and stays
+ * below 2^32 for Shoup's multiplication without reducing d_j first. Pairs of
+ * steps are fused so that a makes one trip through memory per two digits.
+ * When m_i + off_{j,i} would not fit in 32 bits (off_{j,i} == 0), d_j is
+ * reduced modulo m_i first.
+ */
+static void mr_digit_chunk(const MRBasis* b, int i, const int* r, int len, const uint32_t* const* d,
+                           uint32_t* a) {
+    int k = b->k;
+    uint32_t m = (uint32_t) b->moduli[i];
+    const uint32_t* c = b->inv + (size_t) i * k;
+    const uint32_t* c_shoup = b->inv_shoup + (size_t) i * k;
+    const uint32_t* off = b->offset + (size_t) i * k;
+    for (int e = 0; e < len; e++) a[e] = (uint32_t) r[e];
+
+    int j = 0;
+    while (j < i) {
+        if (j + 1 < i && off[j] && off[j + 1]) {
+            const uint32_t* d0 = d[j];
+            const uint32_t* d1 = d[j + 1];
+            uint32_t c0 = c[j], s0 = c_shoup[j], o0 = off[j];
+            uint32_t c1 = c[j + 1], s1 = c_shoup[j + 1], o1 = off[j + 1];
+            for (int e = 0; e < len; e++) {
+                uint32_t x = shoup_mulmod(a[e] + o0 - d0[e], c0, s0, m);
+                a[e] = shoup_mulmod(x + o1 - d1[e], c1, s1, m);
+            }
+            j += 2;
+        } else if (off[j]) {
+            const uint32_t* dj = d[j];
+            uint32_t cj = c[j], sj = c_shoup[j], oj = off[j];
+            for (int e = 0; e < len; e++) a[e] = shoup_mulmod(a[e] + oj - dj[e], cj, sj, m);
+            j++;
+        } else {
+            const uint32_t* dj = d[j];
+            uint32_t cj = c[j], sj = c_shoup[j], red = b->red_shoup[i];
+            for (int e = 0; e < len; e++) {
+                uint32_t q = (uint32_t) (((uint64_t) dj[e] * red) >> 32);
+                uint32_t t = dj[e] - q * m;
+                t = t >= m ? t - m : t;
+                a[e] = shoup_mulmod(a[e] + m - t, cj, sj, m);
+            }
+            j++;
+        }
+    }
+}
+
+static void mr_chunk(const MRBasis* b, const int* const* residues, long base, int len, uint32_t* const* d) {
+    for (int i = 0; i < b->k; i++) {
+        mr_digit_chunk(b, i, residues[i] + base, len, (const uint32_t* const*) d, d[i]);
+    }
+}
+
+// cmp[e] = sign of (digits of e) - ref, compared from the top digit down
+static void mr_compare(int k, const uint32_t* const* d, long base, int len, const uint32_t* ref, int8_t* cmp) {
+    for (int e = 0; e < len; e++) cmp[e] = 0;
+    for (int i = k - 1; i >= 0; i--) {
+        const uint32_t* di = d[i] + base;
+        uint32_t h = ref[i];
+        for (int e = 0; e < len; e++) {
+            int8_t c = (int8_t) ((di[e] > h) - (di[e] < h));
+            cmp[e] = cmp[e] ? cmp[e] : c;
+        }
+    }
+}
+
+// Digits of a single value given by its residues
+static void mr_digits_of(const MRBasis* b, const int* r, uint32_t* out) {
+    const int** residues = malloc(b->k * sizeof(int*));
+    uint32_t** d = malloc(b->k * sizeof(uint32_t*));
+    for (int i = 0; i < b->k; i++) {
+        residues[i] = r + i;
+        d[i] = out + i;
+    }
+    mr_chunk(b, residues, 0, 1, d);
+    free(residues);
+    free(d);
+}
+
+MRBasis* mr_basis_create(const int* moduli, int k) {
+    MRBasis* b = malloc(sizeof(MRBasis));
+    b->k = k;
+    b->moduli = malloc(k * sizeof(int));
+    b->inv = calloc((size_t) k * k, sizeof(uint32_t));
+    b->inv_shoup = calloc((size_t) k * k, sizeof(uint32_t));
+    b->offset = calloc((size_t) k * k, sizeof(uint32_t));
+    b->red_shoup = malloc(k * sizeof(uint32_t));
+    b->half = malloc(k * sizeof(uint32_t));
+    b->pos_limit = malloc(k * sizeof(uint32_t));
+    b->neg_limit = malloc(k * sizeof(uint32_t));
+    b->M_lo = 1;
+
+    // M > 2^63 decided on a saturating 128-bit product
+    unsigned __int128 M = 1;
+    int even = -1;
+    for (int i = 0; i < k; i++) {
+        uint64_t mi = (uint64_t) moduli[i];
+        b->moduli[i] = moduli[i];
+        b->red_shoup[i] = (uint32_t) ((1ULL << 32) / mi);
+        b->M_lo *= mi;
+        M = (M > ((unsigned __int128) 1 << 64)) ? M : M * mi;
+        if (mi % 2 == 0) even = i;
+
+        for (int j = 0; j < i; j++) {
+            uint32_t c = crt_modinv((uint64_t) moduli[j], mi);
+            if (c == 0 && mi > 1) {
+                mr_basis_free(b);
+                return NULL;
+            }
+            b->inv[i * k + j] = c;
+            b->inv_shoup[i * k + j] = (uint32_t) (((uint64_t) c << 32) / mi);
+            uint64_t off = ((uint64_t) moduli[j] + mi - 1) / mi * mi;
+            b->offset[i * k + j] = (off + mi <= (1ULL << 32)) ? (uint32_t) off : 0;
+        }
+    }
+    b->check_int64 = M > ((unsigned __int128) 1 << 63);
+
+    // Residues of floor(M/2): with M odd 2h ≡ -1, so h ≡ (m_i - 1)/2; with M
+    // even (a single even modulus m_e) h ≡ 0 modulo the odd moduli and
+    // h ≡ (m_e/2)·(M/m_e) modulo m_e
+    int* r = calloc(k, sizeof(int));
+    for (int i = 0; i < k; i++) {
+        if (even < 0) {
+            r[i] = (moduli[i] - 1) / 2;
+        } else if (i != even) {
+            r[i] = 0;
+        } else {
+            uint64_t me = (uint64_t) moduli[i], Me = 1 % me;
+            for (int j = 0; j < k; j++) {
+                if (j != i) Me = Me * ((uint64_t) moduli[j] % me) % me;
+            }
+            r[i] = (int) (me / 2 * Me % me);
+        }
+    }
+    mr_digits_of(b, r, b->half);
+
+    // 2^63 - 1 and M - 2^63
+    for (int i = 0; i < k; i++) {
+        uint64_t mi = (uint64_t) moduli[i];
+        r[i] = (int) ((((1ULL << 63) % mi) + mi - 1 % mi) % mi);
+    }
+    mr_digits_of(b, r, b->pos_limit);
+    for (int i = 0; i < k; i++) {
+        uint64_t mi = (uint64_t) moduli[i];
+        r[i] = (int) ((mi - (1ULL << 63) % mi) % mi);
+    }
+    mr_digits_of(b, r, b->neg_limit);
+    free(r);
+    return b;
+}
+
+void mr_basis_free(MRBasis* basis) {
+    if (basis == NULL) return;
+    free(basis->moduli);
+    free(basis->inv);
+    free(basis->inv_shoup);
+    free(basis->offset);
+    free(basis->red_shoup);
+    free(basis->half);
+    free(basis->pos_limit);
+    free(basis->neg_limit);
+    free(basis);
+}
+
+void mixed_radix_digits(const MRBasis* basis, const int* const* residues, long count,
+                        uint32_t* const* digits) {
+    uint32_t** d = malloc(basis->k * sizeof(uint32_t*));
+    for (long base = 0; base < count; base += MR_CHUNK) {
+        int len = (int) (count - base < MR_CHUNK ? count - base : MR_CHUNK);
+        for (int i = 0; i < basis->k; i++) d[i] = digits[i] + base;
+        mr_chunk(basis, residues, base, len, d);
+    }
+    free(d);
+}
+
+void mixed_radix_next_digit(const MRBasis* basis, int i, const int* residues, const uint32_t* const* digits,
+                            long count, uint32_t* out) {
+    const uint32_t** d = malloc((i > 0 ? i : 1) * sizeof(uint32_t*));
+    for (long base = 0; base < count; base += MR_CHUNK) {
+        int len = (int) (count - base < MR_CHUNK ? count - base : MR_CHUNK);
+        for (int j = 0; j < i; j++) d[j] = digits[j] + base;
+        mr_digit_chunk(basis, i, residues + base, len, d, out + base);
+    }
+    free(d);
+}
+
+void mixed_radix_signs(const MRBasis* basis, const uint32_t* const* digits, long count, uint8_t* negative) {
+    int8_t cmp[MR_CHUNK];
+    for (long base = 0; base < count; base += MR_CHUNK) {
+        int len = (int) (count - base < MR_CHUNK ? count - base : MR_CHUNK);
+        mr_compare(basis->k, digits, base, len, basis->half, cmp);
+        for (int e = 0; e < len; e++) negative[base + e] = cmp[e] > 0;
+    }
+}
+
+long mixed_radix_reconstruct_centered_int64(const MRBasis* basis, const int* const* residues, long count,
+                                            int64_t* out) {
+    int k = basis->k;
+    uint32_t* d_data = xmalloc((size_t) k * MR_CHUNK * sizeof(uint32_t));
+    uint32_t** d = xmalloc(k * sizeof(uint32_t*));
+    for (int i = 0; i < k; i++) d[i] = d_data + (size_t) i * MR_CHUNK;
+
+    int8_t neg[MR_CHUNK], pos_cmp[MR_CHUNK], neg_cmp[MR_CHUNK];
+    uint64_t v[MR_CHUNK];
+    long out_of_range = 0;
+
+    for (long base = 0; base < count; base += MR_CHUNK) {
+        int len = (int) (count - base < MR_CHUNK ? count - base : MR_CHUNK);
+        mr_chunk(basis, residues, base, len, d);
+        mr_compare(k, (const uint32_t* const*) d, 0, len, basis->half, neg);
+
+        // Horner from the top digit, modulo 2^64
+        for (int e = 0; e < len; e++) v[e] = d[k - 1][e];
+        for (int i = k - 2; i >= 0; i--) {
+            uint64_t mi = (uint64_t) basis->moduli[i];
+            const uint32_t* di = d[i];
+            for (int e = 0; e < len; e++) v[e] = v[e] * mi + di[e];
+        }
+        for (int e = 0; e < len; e++) {
+            out[base + e] = (int64_t) (v[e] - (neg[e] > 0 ? basis->M_lo : 0));
+        }
+
+        if (basis->check_int64) {
+            mr_compare(k, (const uint32_t* const*) d, 0, len, basis->pos_limit, pos_cmp);
+            mr_compare(k, (const uint32_t* const*) d, 0, len, basis->neg_limit, neg_cmp);
+            for (int e = 0; e < len; e++) {
+                out_of_range += (neg[e] > 0) ? (neg_cmp[e] < 0) : (pos_cmp[e] > 0);
+            }
+        }
+    }
+
+    free(d);
+    free(d_data);
+    return out_of_range;
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include "mixed_radix_gmp.h"
+#include "xalloc.h"
+
+// Digit i of entry e, complemented (m_i - 1 - d_i) for negative entries
+static inline unsigned long mr_digit(const MRBasis* b, uint32_t* const* d, int i, long e, int flip) {
+    return flip ? (unsigned long) b->moduli[i] - 1 - d[i][e] : (unsigned long) d[i][e];
+}
+
+void mixed_radix_reconstruct_centered_mpz(const MRBasis* basis, const int* const* residues, long count,
+                                          mpz_t* out) {
+    int k = basis->k;
+    if (count <= 0) return;
+
+    uint32_t** d = xmalloc(k * sizeof(uint32_t*));
+    uint32_t* d_data = xmalloc((size_t) k * count * sizeof(uint32_t));
+    uint8_t* negative = xmalloc(count * sizeof(uint8_t));
+    for (int i = 0; i < k; i++) d[i] = d_data + (size_t) i * count;
+
+    mixed_radix_digits(basis, residues, count, d);
+    mixed_radix_signs(basis, (const uint32_t* const*) d, count, negative);
+
+    for (long e = 0; e < count; e++) {
+        int flip = negative[e];
+        int i = k - 1;
+        mpz_set_ui(out[e], mr_digit(basis, d, i, e, flip));
+        for (i = k - 2; i >= 1; i -= 2) {
+            unsigned long mi = (unsigned long) basis->moduli[i], mj = (unsigned long) basis->moduli[i - 1];
+            mpz_mul_ui(out[e], out[e], mi * mj);
+            mpz_add_ui(out[e], out[e], mr_digit(basis, d, i, e, flip) * mj + mr_digit(basis, d, i - 1, e, flip));
+        }
+        if (i == 0) {
+            mpz_mul_ui(out[e], out[e], (unsigned long) basis->moduli[0]);
+            mpz_add_ui(out[e], out[e], mr_digit(basis, d, 0, e, flip));
+        }
+
+        // -(M - 1 - x) - 1 = x - M
+        if (flip) {
+            mpz_add_ui(out[e], out[e], 1);
+            mpz_neg(out[e], out[e]);
+        }
+    }
+
+    free(d_data);
+    free(d);
+    free(negative);
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "residue_gemm.h"
+#include "xalloc.h"
+
+long residue_gemm_reduction_window(int mod) {
+    uint64_t max_prod = (uint64_t) (mod - 1) * (uint64_t) (mod - 1);
+    if (max_prod == 0) return 1L << 30;
+    uint64_t window = (UINT64_MAX - (uint64_t) (mod - 1)) / max_prod;
+    if (window > (1UL << 30)) window = 1UL << 30;
+    return (long) window;
+}
+
+void residue_gemm_rows(const int* A, int lda, const int* B, int ldb, int* C, int ldc,
+                       int m, int p, int mod, int row_begin, int row_end) {
+    uint64_t* acc = xmalloc(p * sizeof(uint64_t));
+    long window = residue_gemm_reduction_window(mod);
+
+    for (int i = row_begin; i < row_end; i++) {
+        const int* a_row = A + (long) i * lda;
+        for (int j = 0; j < p; j++) acc[j] = 0;
+
+        // i-r-j order: the inner loop streams one row of B into the accumulators
+        long since_reduce = 0;
+        for (int r = 0; r < m; r++) {
+            uint64_t a = (uint64_t) a_row[r];
+            const int* b_row = B + (long) r * ldb;
+            for (int j = 0; j < p; j++) {
+                acc[j] += a * (uint64_t) b_row[j];
+            }
+            if (++since_reduce == window) {
+                for (int j = 0; j < p; j++) acc[j] %= (uint64_t) mod;
+                since_reduce = 0;
+            }
+        }
+
+        int* c_row = C + (long) i * ldc;
+        for (int j = 0; j < p; j++) {
+            c_row[j] = (int) (acc[j] % (uint64_t) mod);
+        }
+    }
+
+    free(acc);
+}
+
+typedef struct {
+    int*** Ares;
+    int*** Bres;
+    int*** Cres;
+    const int* moduli;
+    int n, m, p;
+    int blocks;      // row blocks per modulus
+} ResidueGemmJob;
+
+// Task t computes row block (t % blocks) of the product modulo moduli[t / blocks]
+static void residue_gemm_task(void* arg, int t, int worker_idx) {
+    ResidueGemmJob* job = (ResidueGemmJob*) arg;
+    int idx = t / job->blocks;
+    int b = t % job->blocks;
+    int row_begin = (int) ((long) b * job->n / job->blocks);
+    int row_end = (int) ((long) (b + 1) * job->n / job->blocks);
+    (void) worker_idx;
+
+    residue_gemm_rows(job->Ares[idx][0], job->m, job->Bres[idx][0], job->p,
+                      job->Cres[idx][0], job->p, job->m, job->p, job->moduli[idx],
+                      row_begin, row_end);
+}
+
+void residue_gemm_rns(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                      int n, int m, int p, ThreadPool* pool) {
+    if (k <= 0 || n <= 0 || p <= 0) return;
+
+    int T = thread_pool_size(pool);
+    int blocks = (k >= T) ? 1 : (T + k - 1) / k;
+    if (blocks > n) blocks = n;
+
+    ResidueGemmJob job = { Ares, Bres, Cres, moduli, n, m, p, blocks };
+    thread_pool_run(pool, k * blocks, residue_gemm_task, &job);
+}
@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include "residue_gemm_fp64.h"
+#include "xalloc.h"
+
+// B is packed in column panels of FP64_NB doubles, A row blocks are padded to FP64_ROW_ALIGN rows
+#define FP64_NB 16
+#define FP64_ROW_ALIGN 8
+
+static const char* kernel_names[RESIDUE_FP64_NUM_KERNELS] = {"scalar", "avx2", "avx512"};
+
+const char* residue_gemm_fp64_kernel_name(ResidueFp64Kernel kernel) {
+    if (kernel < 0 || kernel >= RESIDUE_FP64_NUM_KERNELS) return "unknown";
+    return kernel_names[kernel];
+}
+
+int residue_gemm_fp64_kernel_available(ResidueFp64Kernel kernel) {
+    switch (kernel) {
+        case RESIDUE_FP64_SCALAR:
+            return 1;
+        case RESIDUE_FP64_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case RESIDUE_FP64_AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return 0;
+    }
+}
+
+ResidueFp64Kernel residue_gemm_fp64_default_kernel(void) {
+    const char* env = getenv("RNS_FP64_KERNEL");
+    if (env) {
+        for (int kr = 0; kr < RESIDUE_FP64_NUM_KERNELS; kr++) {
+            if (strcmp(env, kernel_names[kr]) == 0 && residue_gemm_fp64_kernel_available(kr)) {
+                return (ResidueFp64Kernel) kr;
+            }
+        }
+    }
+    for (int kr = RESIDUE_FP64_NUM_KERNELS - 1; kr > 0; kr--) {
+        if (residue_gemm_fp64_kernel_available(kr)) return (ResidueFp64Kernel) kr;
+    }
+    return RESIDUE_FP64_SCALAR;
+}
+
+long residue_gemm_fp64_window(int mod) {
+    // A reduced accumulator may be off by one multiple of mod (the quotient
+    // comes from a rounded c·(1/mod)), so it is bounded by 2·mod
+    double half = (double) (mod / 2);
+    double max_prod = half * half > 1.0 ? half * half : 1.0;
+    long window = (long) ((0x1p53 - 2.0 * mod) / max_prod);
+    return window < 1 ? 1 : window;
+}
+
+/////////////////////////////
+//         Kernels         //
+/////////////////////////////
+
+// All kernels compute part[i][j] ≡ sum_r A[i][r] * B[r][j] (mod mod), |part| <= 2·mod,
+// for the packed A (rows_pad / FP64_ROW_ALIGN panels of m × FP64_ROW_ALIGN, so
+// the rows broadcast at one step of K share a cache line) and the packed B
+// (p_pad / FP64_NB panels of m × FP64_NB), reducing every `window` steps of K.
+
+static void kernel_scalar(const double* Ap, const double* Bp, int m, int p_pad, double* part, int ldp,
+                          int rows_pad, double mod, double minv, long window) {
+    for (int j0 = 0; j0 < p_pad; j0 += FP64_NB) {
+        const double* panel = Bp + (size_t) j0 * m;
+        for (int i = 0; i < rows_pad; i++) {
+            double acc[FP64_NB] = {0};
+            const double* a = Ap + (size_t) (i / FP64_ROW_ALIGN) * FP64_ROW_ALIGN * m + i % FP64_ROW_ALIGN;
+            for (long r0 = 0; r0 < m; r0 += window) {
+                long r1 = r0 + window < m ? r0 + window : m;
+                for (long r = r0; r < r1; r++) {
+                    double ar = a[(size_t) r * FP64_ROW_ALIGN];
+                    for (int jj = 0; jj < FP64_NB; jj++) acc[jj] += ar * panel[(size_t) r * FP64_NB + jj];
+                }
+                for (int jj = 0; jj < FP64_NB; jj++) acc[jj] -= mod * nearbyint(acc[jj] * minv);
+            }
+            memcpy(part + (size_t) i * ldp + j0, acc, sizeof(acc));
+        }
+    }
+}
+
+// 4 × 8 register tile: 8 ymm accumulators, two B loads and one broadcast per step
+__attribute__((target("avx2,fma")))
+static void kernel_avx2(const double* Ap, const double* Bp, int m, int p_pad, double* part, int ldp,
+                        int rows_pad, double mod, double minv, long window) {
+    const __m256d vmod = _mm256_set1_pd(mod), vinv = _mm256_set1_pd(minv);
+
+    for (int j0 = 0; j0 < p_pad; j0 += FP64_NB) {
+        for (int jh = 0; jh < FP64_NB; jh += 8) {
+            const double* panel = Bp + (size_t) j0 * m + jh;
+            for (int i = 0; i < rows_pad; i += 4) {
+                __m256d acc[4][2];
+                for (int t = 0; t < 4; t++) acc[t][0] = acc[t][1] = _mm256_setzero_pd();
+                const double* a = Ap + (size_t) (i / FP64_ROW_ALIGN) * FP64_ROW_ALIGN * m + i % FP64_ROW_ALIGN;
+
+                for (long r0 = 0; r0 < m; r0 += window) {
+                    long r1 = r0 + window < m ? r0 + window : m;
+                    for (long r = r0; r < r1; r++) {
+                        __m256d b0 = _mm256_loadu_pd(panel + (size_t) r * FP64_NB);
+                        __m256d b1 = _mm256_loadu_pd(panel + (size_t) r * FP64_NB + 4);
+                        for (int t = 0; t < 4; t++) {
+                            __m256d av = _mm256_broadcast_sd(a + (size_t) r * FP64_ROW_ALIGN + t);
+                            acc[t][0] = _mm256_fmadd_pd(av, b0, acc[t][0]);
+                            acc[t][1] = _mm256_fmadd_pd(av, b1, acc[t][1]);
+                        }
+                    }
+                    for (int t = 0; t < 4; t++) {
+                        for (int h = 0; h < 2; h++) {
+                            __m256d q = _mm256_round_pd(_mm256_mul_pd(acc[t][h], vinv),
+                                                        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                            acc[t][h] = _mm256_fnmadd_pd(q, vmod, acc[t][h]);
+                        }
+                    }
+                }
+
+                for (int t = 0; t < 4; t++) {
+                    double* c = part + (size_t) (i + t) * ldp + j0 + jh;
+                    _mm256_storeu_pd(c, acc[t][0]);
+                    _mm256_storeu_pd(c + 4, acc[t][1]);
+                }
+            }
+        }
+    }
+}
+
+// 8 × 16 register tile: 16 zmm accumulators, two B loads and one broadcast per step
+__attribute__((target("avx512f")))
+static void kernel_avx512(const double* Ap, const double* Bp, int m, int p_pad, double* part, int ldp,
+                          int rows_pad, double mod, double minv, long window) {
+    const __m512d vmod = _mm512_set1_pd(mod), vinv = _mm512_set1_pd(minv);
+
+    for (int j0 = 0; j0 < p_pad; j0 += FP64_NB) {
+        const double* panel = Bp + (size_t) j0 * m;
+        for (int i = 0; i < rows_pad; i += 8) {
+            __m512d acc[8][2];
+            for (int t = 0; t < 8; t++) acc[t][0] = acc[t][1] = _mm512_setzero_pd();
+            const double* a = Ap + (size_t) i * m;
+
+            for (long r0 = 0; r0 < m; r0 += window) {
+                long r1 = r0 + window < m ? r0 + window : m;
+                for (long r = r0; r < r1; r++) {
+                    __m512d b0 = _mm512_loadu_pd(panel + (size_t) r * FP64_NB);
+                    __m512d b1 = _mm512_loadu_pd(panel + (size_t) r * FP64_NB + 8);
+                    for (int t = 0; t < 8; t++) {
+                        __m512d av = _mm512_set1_pd(a[(size_t) r * FP64_ROW_ALIGN + t]);
+                        acc[t][0] = _mm512_fmadd_pd(av, b0, acc[t][0]);
+                        acc[t][1] = _mm512_fmadd_pd(av, b1, acc[t][1]);
+                    }
+                }
+                for (int t = 0; t < 8; t++) {
+                    for (int h = 0; h < 2; h++) {
+                        __m512d q = _mm512_roundscale_pd(_mm512_mul_pd(acc[t][h], vinv),
+                                                         _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                        acc[t][h] = _mm512_fnmadd_pd(q, vmod, acc[t][h]);
+                    }
+                }
+            }
+
+            for (int t = 0; t < 8; t++) {
+                double* c = part + (size_t) (i + t) * ldp + j0;
+                _mm512_storeu_pd(c, acc[t][0]);
+                _mm512_storeu_pd(c + 8, acc[t][1]);
+            }
+        }
+    }
+}
+
+/////////////////////////////
+//     Plane scheduling    //
+/////////////////////////////
+
+typedef struct {
+    int*** Ares;
+    int*** Bres;
+    int*** Cres;
+    const int* moduli;
+    double** packed;  // per-modulus packed B
+    int n, m, p;
+    int p_pad;
+    int blocks;       // row blocks per modulus
+    ResidueFp64Kernel kernel;
+} Fp64GemmJob;
+
+// Residue in [0, mod) as a centered double in (-mod/2, mod/2]
+static inline double centered(int r, int mod) {
+    return (double) (r > mod / 2 ? r - mod : r);
+}
+
+// Task idx packs the B plane of modulus idx into centered column panels
+static void pack_b_task(void* arg, int idx, int worker_idx) {
+    Fp64GemmJob* job = (Fp64GemmJob*) arg;
+    const int* B = job->Bres[idx][0];
+    int mod = job->moduli[idx];
+    (void) worker_idx;
+
+    double* bp = xcalloc((size_t) job->m * job->p_pad, sizeof(double));
+    for (int r = 0; r < job->m; r++) {
+        for (int j = 0; j < job->p; j++) {
+            bp[(size_t) (j / FP64_NB) * FP64_NB * job->m + (size_t) r * FP64_NB + j % FP64_NB] =
+                centered(B[(size_t) r * job->p + j], mod);
+        }
+    }
+    job->packed[idx] = bp;
+}
+
+// Task t computes row block (t % blocks) of the product modulo moduli[t / blocks]
+static void fp64_gemm_task(void* arg, int t, int worker_idx) {
+    Fp64GemmJob* job = (Fp64GemmJob*) arg;
+    int idx = t / job->blocks;
+    int b = t % job->blocks;
+    int row_begin = (int) ((long) b * job->n / job->blocks);
+    int row_end = (int) ((long) (b + 1) * job->n / job->blocks);
+    int rows = row_end - row_begin;
+    int mod = job->moduli[idx];
+    (void) worker_idx;
+    if (rows <= 0) return;
+
+    int rows_pad = (rows + FP64_ROW_ALIGN - 1) / FP64_ROW_ALIGN * FP64_ROW_ALIGN;
+    int m = job->m;
+
+    // Zero-padded centered copy of the A row block in FP64_ROW_ALIGN-row panels
+    double* panel = xcalloc((size_t) rows_pad * m, sizeof(double));
+    for (int i = 0; i < rows; i++) {
+        const int* a = job->Ares[idx][row_begin + i];
+        double* dst = panel + (size_t) (i / FP64_ROW_ALIGN) * FP64_ROW_ALIGN * m + i % FP64_ROW_ALIGN;
+        for (int r = 0; r < m; r++) dst[(size_t) r * FP64_ROW_ALIGN] = centered(a[r], mod);
+    }
+
+    double* part = xcalloc((size_t) rows_pad * job->p_pad, sizeof(double));
+    long window = residue_gemm_fp64_window(mod);
+    double dmod = (double) mod, minv = 1.0 / dmod;
+
+    switch (job->kernel) {
+        case RESIDUE_FP64_AVX2:
+            kernel_avx2(panel, job->packed[idx], m, job->p_pad, part, job->p_pad, rows_pad,
+                        dmod, minv, window);
+            break;
+        case RESIDUE_FP64_AVX512:
+            kernel_avx512(panel, job->packed[idx], m, job->p_pad, part, job->p_pad, rows_pad,
+                          dmod, minv, window);
+            break;
+        default:
+            kernel_scalar(panel, job->packed[idx], m, job->p_pad, part, job->p_pad, rows_pad,
+                          dmod, minv, window);
+            break;
+    }
+
+    // Reduced accumulators are small integers: bring them into [0, mod)
+    for (int i = 0; i < rows; i++) {
+        int* c = job->Cres[idx][row_begin + i];
+        const double* s = part + (size_t) i * job->p_pad;
+        for (int j = 0; j < job->p; j++) {
+            long v = (long) s[j] % mod;
+            c[j] = (int) (v < 0 ? v + mod : v);
+        }
+    }
+
+    free(part);
+    free(panel);
+}
+
+void residue_gemm_fp64_rns(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                           int n, int m, int p, ResidueFp64Kernel kernel, ThreadPool* pool) {
+    if (k <= 0 || n <= 0 || p <= 0) return;
+    if (!residue_gemm_fp64_kernel_available(kernel)) kernel = RESIDUE_FP64_SCALAR;
+
+    Fp64GemmJob job;
+    job.Ares = Ares;
+    job.Bres = Bres;
+    job.Cres = Cres;
+    job.moduli = moduli;
+    job.n = n;
+    job.m = m;
+    job.p = p;
+    job.p_pad = (p + FP64_NB - 1) / FP64_NB * FP64_NB;
+    job.kernel = kernel;
+    job.packed = xcalloc(k, sizeof(double*));
+
+    int T = thread_pool_size(pool);
+    job.blocks = (k >= T) ? 1 : (T + k - 1) / k;
+    if (job.blocks > n) job.blocks = n;
+
+    thread_pool_run(pool, k, pack_b_task, &job);
+    thread_pool_run(pool, k * job.blocks, fp64_gemm_task, &job);
+
+    for (int idx = 0; idx < k; idx++) free(job.packed[idx]);
+    free(job.packed);
+}
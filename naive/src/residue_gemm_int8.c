@@ -0,0 +1,545 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cpuid.h>
+#include <immintrin.h>
+#include "residue_gemm_int8.h"
+#include "xalloc.h"
+
+#ifndef ARCH_REQ_XCOMP_PERM
+#define ARCH_REQ_XCOMP_PERM 0x1023
+#endif
+#define XFEATURE_XTILEDATA 18
+
+// K is padded to a whole number of AMX tile rows, N to a whole 16-column block
+#define INT8_K_ALIGN 64
+#define INT8_N_ALIGN 16
+#define INT8_ROW_ALIGN 16
+
+static const char* kernel_names[RESIDUE_INT8_NUM_KERNELS] = {"scalar", "avx2", "avx512", "amx"};
+
+typedef struct {
+    uint8_t palette_id;
+    uint8_t start_row;
+    uint8_t reserved_0[14];
+    uint16_t colsb[16];
+    uint8_t rows[16];
+} AmxTileConfig;
+
+static int amx_ready = 0;
+static pthread_once_t amx_once = PTHREAD_ONCE_INIT;
+
+// AMX needs CPU support and a one-time permission request for tile data
+static void amx_request_permission(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return;
+    if (!((edx >> 24) & 1) || !((edx >> 25) & 1)) return;   // AMX-TILE, AMX-INT8
+    if (syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) != 0) return;
+    amx_ready = 1;
+}
+
+const char* residue_gemm_int8_kernel_name(ResidueInt8Kernel kernel) {
+    if (kernel < 0 || kernel >= RESIDUE_INT8_NUM_KERNELS) return "unknown";
+    return kernel_names[kernel];
+}
+
+int residue_gemm_int8_kernel_available(ResidueInt8Kernel kernel) {
+    switch (kernel) {
+        case RESIDUE_INT8_SCALAR:
+            return 1;
+        case RESIDUE_INT8_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case RESIDUE_INT8_AVX512:
+            return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni");
+        case RESIDUE_INT8_AMX:
+            pthread_once(&amx_once, amx_request_permission);
+            return amx_ready;
+        default:
+            return 0;
+    }
+}
+
+ResidueInt8Kernel residue_gemm_int8_default_kernel(void) {
+    const char* env = getenv("RNS_INT8_KERNEL");
+    if (env) {
+        for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+            if (strcmp(env, kernel_names[kr]) == 0 && residue_gemm_int8_kernel_available(kr)) {
+                return (ResidueInt8Kernel) kr;
+            }
+        }
+    }
+    for (int kr = RESIDUE_INT8_NUM_KERNELS - 1; kr > 0; kr--) {
+        if (residue_gemm_int8_kernel_available(kr)) return (ResidueInt8Kernel) kr;
+    }
+    return RESIDUE_INT8_SCALAR;
+}
+
+// Steps of K that stay inside int32 for operands bounded by |a|, |b| <= half
+static long int8_window(long half, ResidueInt8Kernel kernel) {
+    // vpdpbusd multiplies the biased left operand a + 128 in [1, 255]
+    long max_prod = (kernel == RESIDUE_INT8_AVX512) ? 255L * half : half * half;
+    if (max_prod == 0) max_prod = 1;
+    long window = (INT32_MAX / max_prod) / INT8_K_ALIGN * INT8_K_ALIGN;
+    return window < INT8_K_ALIGN ? INT8_K_ALIGN : window;
+}
+
+long residue_gemm_int8_window(int mod, ResidueInt8Kernel kernel) {
+    return int8_window(mod / 2, kernel);
+}
+
+/////////////////////////////
+//         Kernels         //
+/////////////////////////////
+
+// All kernels compute part[i][j] = sum_{k0 <= r < k1} A[i][r] * B[r][j] in int32
+// for the zero-padded A panel (rows_pad × k_pad, stride lda) and write a
+// rows_pad × p_pad block with stride ldp.
+
+static void kernel_scalar(const int8_t* Ap, int lda, const int8_t* B, int ldb, int32_t* part, int ldp,
+                          int rows, int p, int k0, int k1) {
+    for (int i = 0; i < rows; i++) {
+        int32_t* c = part + (size_t) i * ldp;
+        for (int j = 0; j < p; j++) c[j] = 0;
+        for (int r = k0; r < k1; r++) {
+            int32_t a = Ap[(size_t) i * lda + r];
+            if (a == 0) continue;
+            const int8_t* b = B + (size_t) r * ldb;
+            for (int j = 0; j < p; j++) c[j] += a * b[j];
+        }
+    }
+}
+
+// B is packed as sign-extended k-pairs: pairs[(r/2)][2j + (r&1)]
+__attribute__((target("avx2")))
+static void kernel_avx2(const int8_t* Ap, int lda, const int16_t* pairs, int p_pad, int32_t* part, int ldp,
+                        int rows_pad, int k0, int k1) {
+    for (int j0 = 0; j0 < p_pad; j0 += 16) {
+        for (int i = 0; i < rows_pad; i += 4) {
+            __m256i acc[4][2];
+            for (int t = 0; t < 4; t++) acc[t][0] = acc[t][1] = _mm256_setzero_si256();
+
+            for (int r = k0; r < k1; r += 2) {
+                const int16_t* b = pairs + (size_t) (r / 2) * 2 * p_pad + 2 * j0;
+                __m256i b0 = _mm256_loadu_si256((const __m256i*) b);
+                __m256i b1 = _mm256_loadu_si256((const __m256i*) (b + 16));
+                for (int t = 0; t < 4; t++) {
+                    const int8_t* a = Ap + (size_t) (i + t) * lda + r;
+                    uint32_t pair = (uint16_t) (int16_t) a[0] | ((uint32_t) (uint16_t) (int16_t) a[1] << 16);
+                    __m256i av = _mm256_set1_epi32((int) pair);
+                    acc[t][0] = _mm256_add_epi32(acc[t][0], _mm256_madd_epi16(av, b0));
+                    acc[t][1] = _mm256_add_epi32(acc[t][1], _mm256_madd_epi16(av, b1));
+                }
+            }
+
+            for (int t = 0; t < 4; t++) {
+                int32_t* c = part + (size_t) (i + t) * ldp + j0;
+                _mm256_storeu_si256((__m256i*) c, acc[t][0]);
+                _mm256_storeu_si256((__m256i*) (c + 8), acc[t][1]);
+            }
+        }
+    }
+}
+
+// B is packed in VNNI k-quads: quads[(r/4)][4j + (r&3)]. A holds a + 128 as
+// uint8, so sum (a+128)·b is corrected by 128·sum b, itself computed by vpdpbusd.
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static void kernel_avx512(const uint8_t* Ap, int lda, const int8_t* quads, int p_pad, int32_t* part, int ldp,
+                          int rows_pad, int k0, int k1) {
+    const __m512i bias = _mm512_set1_epi8((char) 0x80);
+
+    for (int j0 = 0; j0 < p_pad; j0 += 16) {
+        __m512i corr = _mm512_setzero_si512();
+        for (int r = k0; r < k1; r += 4) {
+            __m512i b = _mm512_loadu_si512((const void*) (quads + (size_t) (r / 4) * 4 * p_pad + 4 * j0));
+            corr = _mm512_dpbusd_epi32(corr, bias, b);
+        }
+
+        for (int i = 0; i < rows_pad; i += 4) {
+            __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+            __m512i acc2 = _mm512_setzero_si512(), acc3 = _mm512_setzero_si512();
+            const uint8_t* a0 = Ap + (size_t) i * lda;
+            const uint8_t* a1 = a0 + lda;
+            const uint8_t* a2 = a1 + lda;
+            const uint8_t* a3 = a2 + lda;
+
+            for (int r = k0; r < k1; r += 4) {
+                __m512i b = _mm512_loadu_si512((const void*) (quads + (size_t) (r / 4) * 4 * p_pad + 4 * j0));
+                int32_t q0, q1, q2, q3;
+                memcpy(&q0, a0 + r, 4);
+                memcpy(&q1, a1 + r, 4);
+                memcpy(&q2, a2 + r, 4);
+                memcpy(&q3, a3 + r, 4);
+                acc0 = _mm512_dpbusd_epi32(acc0, _mm512_set1_epi32(q0), b);
+                acc1 = _mm512_dpbusd_epi32(acc1, _mm512_set1_epi32(q1), b);
+                acc2 = _mm512_dpbusd_epi32(acc2, _mm512_set1_epi32(q2), b);
+                acc3 = _mm512_dpbusd_epi32(acc3, _mm512_set1_epi32(q3), b);
+            }
+
+            int32_t* c = part + (size_t) i * ldp + j0;
+            _mm512_storeu_si512((void*) c, _mm512_sub_epi32(acc0, corr));
+            _mm512_storeu_si512((void*) (c + ldp), _mm512_sub_epi32(acc1, corr));
+            _mm512_storeu_si512((void*) (c + 2 * (size_t) ldp), _mm512_sub_epi32(acc2, corr));
+            _mm512_storeu_si512((void*) (c + 3 * (size_t) ldp), _mm512_sub_epi32(acc3, corr));
+        }
+    }
+}
+
+// Same VNNI k-quad layout as the AVX-512 kernel; one 16×16 C tile at a time
+__attribute__((target("amx-tile,amx-int8")))
+static void kernel_amx(const int8_t* Ap, int lda, const int8_t* quads, int p_pad, int32_t* part, int ldp,
+                       int rows_pad, int k0, int k1) {
+    AmxTileConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.palette_id = 1;
+    for (int t = 0; t < 3; t++) {
+        cfg.colsb[t] = 64;   // C: 16 int32, A: 64 int8, B: 16 columns × 4 int8
+        cfg.rows[t] = 16;    // C: 16 rows, A: 16 rows, B: 16 k-quads
+    }
+    _tile_loadconfig(&cfg);
+
+    for (int i0 = 0; i0 < rows_pad; i0 += 16) {
+        for (int j0 = 0; j0 < p_pad; j0 += 16) {
+            _tile_zero(0);
+            for (int r = k0; r < k1; r += 64) {
+                _tile_loadd(1, Ap + (size_t) i0 * lda + r, lda);
+                _tile_loadd(2, quads + (size_t) (r / 4) * 4 * p_pad + 4 * j0, 4 * p_pad);
+                _tile_dpbssd(0, 1, 2);
+            }
+            _tile_stored(0, part + (size_t) i0 * ldp + j0, ldp * (int) sizeof(int32_t));
+        }
+    }
+
+    _tile_release();
+}
+
+/////////////////////////////
+//     Plane scheduling    //
+/////////////////////////////
+
+typedef struct {
+    int8_t*** Ares;
+    int8_t*** Bres;
+    ResidueInt8RowSource a_src;   // used instead of Ares / Bres when set
+    ResidueInt8RowSource b_src;
+    const void* a_arg;
+    const void* b_arg;
+    int*** Cres;
+    const int* moduli;
+    void** packed;    // per-modulus packed B (layout depends on the kernel)
+    int n, m, p;
+    int k_pad, p_pad;
+    int blocks;       // row blocks per modulus
+    ResidueInt8Kernel kernel;
+} Int8GemmJob;
+
+// Rows [0, m) of B (stride ldb) into rows [row0, row0 + m) of the packed
+// layout of the kernel: k-pairs for AVX2, k-quads for AVX-512 and AMX, plain
+// rows of stride p_pad for the scalar loop
+static void pack_b_rows(void* packed, const int8_t* B, int ldb, int m, int p, int p_pad, int row0,
+                        ResidueInt8Kernel kernel) {
+    for (int r = 0; r < m; r++) {
+        int rr = row0 + r;
+        const int8_t* b = B + (size_t) r * ldb;
+        if (kernel == RESIDUE_INT8_AVX2) {
+            int16_t* pairs = packed;
+            for (int j = 0; j < p; j++) pairs[(size_t) (rr / 2) * 2 * p_pad + 2 * j + (rr & 1)] = b[j];
+        } else if (kernel == RESIDUE_INT8_SCALAR) {
+            memcpy((int8_t*) packed + (size_t) rr * p_pad, b, p);
+        } else {
+            int8_t* quads = packed;
+            for (int j = 0; j < p; j++) quads[(size_t) (rr / 4) * 4 * p_pad + 4 * j + (rr & 3)] = b[j];
+        }
+    }
+}
+
+static void* alloc_packed_b(long rows, int p_pad, ResidueInt8Kernel kernel) {
+    return xcalloc((size_t) rows * p_pad, kernel == RESIDUE_INT8_AVX2 ? sizeof(int16_t) : sizeof(int8_t));
+}
+
+// part = A panel · packed B over packed rows [k0, k1); the A panel is read at
+// column r + a_shift for packed row r
+static void run_kernel(const int8_t* panel, long a_shift, int lda, const void* packed, int p_pad,
+                       int32_t* part, int rows_pad, int p, int k0, int k1, ResidueInt8Kernel kernel) {
+    const int8_t* Ap = panel + a_shift;
+    switch (kernel) {
+        case RESIDUE_INT8_AVX2:
+            kernel_avx2(Ap, lda, packed, p_pad, part, p_pad, rows_pad, k0, k1);
+            break;
+        case RESIDUE_INT8_AVX512:
+            kernel_avx512((const uint8_t*) Ap, lda, packed, p_pad, part, p_pad, rows_pad, k0, k1);
+            break;
+        case RESIDUE_INT8_AMX:
+            kernel_amx(Ap, lda, packed, p_pad, part, p_pad, rows_pad, k0, k1);
+            break;
+        default:
+            kernel_scalar(Ap, lda, packed, p_pad, part, p_pad, rows_pad, p, k0, k1);
+            break;
+    }
+}
+
+// Rows of B fetched from a row source per repacking step
+#define SOURCE_B_ROWS 64
+
+// Task idx repacks the B plane of modulus idx for the SIMD kernels
+static void pack_b_task(void* arg, int idx, int worker_idx) {
+    Int8GemmJob* job = (Int8GemmJob*) arg;
+    (void) worker_idx;
+    job->packed[idx] = alloc_packed_b(job->k_pad, job->p_pad, job->kernel);
+    if (job->b_src == NULL) {
+        pack_b_rows(job->packed[idx], job->Bres[idx][0], job->p, job->m, job->p, job->p_pad, 0, job->kernel);
+        return;
+    }
+    int8_t* rows = xcalloc((size_t) SOURCE_B_ROWS * job->p, sizeof(int8_t));
+    for (int r0 = 0; r0 < job->m; r0 += SOURCE_B_ROWS) {
+        int count = (job->m - r0 < SOURCE_B_ROWS) ? job->m - r0 : SOURCE_B_ROWS;
+        job->b_src(job->b_arg, idx, r0, count, rows, job->p);
+        pack_b_rows(job->packed[idx], rows, job->p, count, job->p, job->p_pad, r0, job->kernel);
+    }
+    free(rows);
+}
+
+// Task t computes row block (t % blocks) of the product modulo moduli[t / blocks]
+static void int8_gemm_task(void* arg, int t, int worker_idx) {
+    Int8GemmJob* job = (Int8GemmJob*) arg;
+    int idx = t / job->blocks;
+    int b = t % job->blocks;
+    int row_begin = (int) ((long) b * job->n / job->blocks);
+    int row_end = (int) ((long) (b + 1) * job->n / job->blocks);
+    int rows = row_end - row_begin;
+    int mod = job->moduli[idx];
+    (void) worker_idx;
+    if (rows <= 0) return;
+
+    int rows_pad = (rows + INT8_ROW_ALIGN - 1) / INT8_ROW_ALIGN * INT8_ROW_ALIGN;
+    int lda = job->k_pad;
+
+    // Zero-padded copy of the A row block (biased by 128 for vpdpbusd)
+    int8_t* panel = xcalloc((size_t) rows_pad * lda, sizeof(int8_t));
+    if (job->a_src) {
+        job->a_src(job->a_arg, idx, row_begin, rows, panel, lda);
+        for (int i = 0; i < rows && job->kernel == RESIDUE_INT8_AVX512; i++) {
+            int8_t* dst = panel + (size_t) i * lda;
+            for (int r = 0; r < job->m; r++) dst[r] = (int8_t) (uint8_t) (dst[r] + 128);
+        }
+    }
+    for (int i = 0; i < rows && job->a_src == NULL; i++) {
+        const int8_t* a = job->Ares[idx][row_begin + i];
+        int8_t* dst = panel + (size_t) i * lda;
+        if (job->kernel == RESIDUE_INT8_AVX512) {
+            for (int r = 0; r < job->m; r++) dst[r] = (int8_t) (uint8_t) (a[r] + 128);
+        } else {
+            memcpy(dst, a, job->m);
+        }
+    }
+
+    int32_t* part = xcalloc((size_t) rows_pad * job->p_pad, sizeof(int32_t));
+    for (int i = 0; i < rows; i++) {
+        memset(job->Cres[idx][row_begin + i], 0, job->p * sizeof(int));
+    }
+
+    long window = residue_gemm_int8_window(mod, job->kernel);
+    for (long k0 = 0; k0 < job->m; k0 += window) {
+        int k1 = (int) ((k0 + window < job->k_pad) ? k0 + window : job->k_pad);
+
+        run_kernel(panel, 0, lda, job->packed[idx], job->p_pad, part, rows_pad, job->p, (int) k0, k1,
+                   job->kernel);
+
+        // Fold the int32 partial sums into the residues
+        for (int i = 0; i < rows; i++) {
+            int* c = job->Cres[idx][row_begin + i];
+            const int32_t* s = part + (size_t) i * job->p_pad;
+            for (int j = 0; j < job->p; j++) {
+                int v = (c[j] + s[j] % mod) % mod;
+                c[j] = v < 0 ? v + mod : v;
+            }
+        }
+    }
+
+    free(part);
+    free(panel);
+}
+
+static void run_rns_job(Int8GemmJob* job, int k, int n, int m, int p, ResidueInt8Kernel kernel,
+                        ThreadPool* pool) {
+    if (!residue_gemm_int8_kernel_available(kernel)) kernel = RESIDUE_INT8_SCALAR;
+    job->n = n;
+    job->m = m;
+    job->p = p;
+    job->k_pad = (m + INT8_K_ALIGN - 1) / INT8_K_ALIGN * INT8_K_ALIGN;
+    job->p_pad = (p + INT8_N_ALIGN - 1) / INT8_N_ALIGN * INT8_N_ALIGN;
+    job->kernel = kernel;
+    job->packed = xcalloc(k, sizeof(void*));
+
+    int T = thread_pool_size(pool);
+    job->blocks = (k >= T) ? 1 : (T + k - 1) / k;
+    if (job->blocks > n) job->blocks = n;
+
+    thread_pool_run(pool, k, pack_b_task, job);
+    thread_pool_run(pool, k * job->blocks, int8_gemm_task, job);
+
+    for (int idx = 0; idx < k; idx++) free(job->packed[idx]);
+    free(job->packed);
+}
+
+void residue_gemm_int8_rns(int8_t*** Ares, int8_t*** Bres, int*** Cres, const int* moduli, int k,
+                           int n, int m, int p, ResidueInt8Kernel kernel, ThreadPool* pool) {
+    if (k <= 0 || n <= 0 || p <= 0) return;
+
+    Int8GemmJob job;
+    memset(&job, 0, sizeof(job));
+    job.Ares = Ares;
+    job.Bres = Bres;
+    job.Cres = Cres;
+    job.moduli = moduli;
+    run_rns_job(&job, k, n, m, p, kernel, pool);
+}
+
+void residue_gemm_int8_rns_source(ResidueInt8RowSource a_rows, const void* a_arg, ResidueInt8RowSource b_rows,
+                                  const void* b_arg, int*** Cres, const int* moduli, int k, int n, int m, int p,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool) {
+    if (k <= 0 || n <= 0 || p <= 0) return;
+
+    Int8GemmJob job;
+    memset(&job, 0, sizeof(job));
+    job.a_src = a_rows;
+    job.a_arg = a_arg;
+    job.b_src = b_rows;
+    job.b_arg = b_arg;
+    job.Cres = Cres;
+    job.moduli = moduli;
+    run_rns_job(&job, k, n, m, p, kernel, pool);
+}
+
+/////////////////////////////
+//     Digit products      //
+/////////////////////////////
+
+// Steps of K per kernel call, so that the A and B slices of a call stay in L2
+#define DIGIT_K_BLOCK 2048
+
+typedef struct {
+    const int8_t* A;
+    const void* packed;   // plane t of B at packed rows [(db-1-t)·k_pad, (db-t)·k_pad)
+    uint64_t* C;
+    int da, db;
+    int n, m, p;
+    int k_pad, p_pad;
+    int limbs;
+    int blocks;
+    ResidueInt8Kernel kernel;
+} Int8DigitJob;
+
+// Task b computes row block b of every diagonal and carries it into C
+static void int8_digits_task(void* arg, int b, int worker_idx) {
+    Int8DigitJob* job = (Int8DigitJob*) arg;
+    int row_begin = (int) ((long) b * job->n / job->blocks);
+    int row_end = (int) ((long) (b + 1) * job->n / job->blocks);
+    int rows = row_end - row_begin;
+    int m = job->m, p = job->p, da = job->da, db = job->db;
+    (void) worker_idx;
+    if (rows <= 0) return;
+
+    int rows_pad = (rows + INT8_ROW_ALIGN - 1) / INT8_ROW_ALIGN * INT8_ROW_ALIGN;
+    int lda = da * job->k_pad;
+
+    // Digit planes of the row block side by side, each padded to k_pad
+    int8_t* panel = xcalloc((size_t) rows_pad * lda, sizeof(int8_t));
+    for (int i = 0; i < rows; i++) {
+        for (int s = 0; s < da; s++) {
+            const int8_t* a = job->A + ((size_t) (row_begin + i) * da + s) * m;
+            int8_t* dst = panel + (size_t) i * lda + (size_t) s * job->k_pad;
+            if (job->kernel == RESIDUE_INT8_AVX512) {
+                for (int r = 0; r < m; r++) dst[r] = (int8_t) (uint8_t) (a[r] + 128);
+            } else {
+                memcpy(dst, a, m);
+            }
+        }
+    }
+
+    int32_t* part = xcalloc((size_t) rows_pad * job->p_pad, sizeof(int32_t));
+    int64_t* sum = xcalloc((size_t) rows * p, sizeof(int64_t));
+    int64_t* carry = xcalloc((size_t) rows * p, sizeof(int64_t));
+    size_t count = (size_t) job->n * p;
+    for (int l = 0; l < job->limbs; l++) {
+        memset(job->C + l * count + (size_t) row_begin * p, 0, (size_t) rows * p * sizeof(uint64_t));
+    }
+
+    long window = int8_window(128, job->kernel);
+    if (window > DIGIT_K_BLOCK) window = DIGIT_K_BLOCK;
+    int diagonals = da + db - 1;
+    // Diagonals past the last byte of C cannot reach it, those past the last
+    // diagonal only carry
+    for (int g = 0; g < 8 * job->limbs; g++) {
+        for (size_t x = 0; x < (size_t) rows * p; x++) sum[x] = 0;
+        if (g < diagonals) {
+            int s_lo = g - db + 1 > 0 ? g - db + 1 : 0;
+            int s_hi = g < da - 1 ? g : da - 1;
+            long b_begin = (long) (db - 1 - g + s_lo) * job->k_pad;
+            long b_end = b_begin + (long) (s_hi - s_lo + 1) * job->k_pad;
+            long a_shift = (long) s_lo * job->k_pad - b_begin;
+
+            for (long k0 = b_begin; k0 < b_end; k0 += window) {
+                long k1 = k0 + window < b_end ? k0 + window : b_end;
+                run_kernel(panel, a_shift, lda, job->packed, job->p_pad, part, rows_pad, p, (int) k0, (int) k1,
+                           job->kernel);
+                for (int i = 0; i < rows; i++) {
+                    const int32_t* src = part + (size_t) i * job->p_pad;
+                    int64_t* dst = sum + (size_t) i * p;
+                    for (int j = 0; j < p; j++) dst[j] += src[j];
+                }
+            }
+        }
+
+        // Byte g of the result; the carry keeps the sign of what is left
+        uint64_t* limb = job->C + (size_t) (g / 8) * count + (size_t) row_begin * p;
+        int shift = 8 * (g % 8);
+        for (size_t x = 0; x < (size_t) rows * p; x++) {
+            int64_t acc = carry[x] + sum[x];
+            limb[x] |= (uint64_t) (acc & 0xff) << shift;
+            carry[x] = acc >> 8;
+        }
+    }
+
+    free(carry);
+    free(sum);
+    free(part);
+    free(panel);
+}
+
+void residue_gemm_int8_digits(const int8_t* A, const int8_t* B, int da, int db, int n, int m, int p,
+                              uint64_t* C, int limbs, ResidueInt8Kernel kernel, ThreadPool* pool) {
+    if (n <= 0 || p <= 0 || limbs <= 0) return;
+    if (!residue_gemm_int8_kernel_available(kernel)) kernel = RESIDUE_INT8_SCALAR;
+
+    Int8DigitJob job;
+    job.A = A;
+    job.C = C;
+    job.da = da;
+    job.db = db;
+    job.n = n;
+    job.m = m;
+    job.p = p;
+    job.k_pad = (m + INT8_K_ALIGN - 1) / INT8_K_ALIGN * INT8_K_ALIGN;
+    job.p_pad = (p + INT8_N_ALIGN - 1) / INT8_N_ALIGN * INT8_N_ALIGN;
+    job.limbs = limbs;
+    job.kernel = kernel;
+
+    // One packed B for every diagonal, planes in reverse order
+    void* packed = alloc_packed_b((long) db * job.k_pad, job.p_pad, kernel);
+    for (int t = 0; t < db; t++) {
+        pack_b_rows(packed, B + (size_t) t * m * p, p, m, p, job.p_pad, (db - 1 - t) * job.k_pad, kernel);
+    }
+    job.packed = packed;
+
+    // Row blocks of at least one tile height
+    int T = thread_pool_size(pool);
+    int max_blocks = (n + INT8_ROW_ALIGN - 1) / INT8_ROW_ALIGN;
+    job.blocks = T < max_blocks ? T : max_blocks;
+
+    thread_pool_run(pool, job.blocks, int8_digits_task, &job);
+    free(packed);
+}
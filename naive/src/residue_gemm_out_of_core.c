@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "residue_gemm_out_of_core.h"
+#include "matrix_file.h"
+#include "rns_conversion_int8.h"
+#include "xalloc.h"
+
+#define DEFAULT_TILE_N 512
+#define DEFAULT_TILE_M 4096
+#define DEFAULT_TILE_P 512
+
+// Operand tiles of one step, in the layout of residue_gemm_int8_rns
+typedef struct {
+    int i0, j0, k0;        // origin of the C block and offset along the inner dimension
+    int rows, cols, depth;
+    int8_t** a_planes;     // k contiguous rows × depth planes
+    int8_t** b_planes;     // k contiguous depth × cols planes
+    int8_t*** a_rows;      // row pointers into a_planes
+    int8_t*** b_rows;      // row pointers into b_planes
+    int full;              // filled by the loader and not yet consumed
+} TileSlot;
+
+typedef struct {
+    const MatrixFile* A;
+    const MatrixFile* B;
+    const int* moduli;
+    int k;
+    int n, m, p;
+    int tile_n, tile_m, tile_p;
+    int blocks_p, steps_m;
+    long steps;
+    RNSConvertKernel convert;
+    int8_t** src_rows;     // tile rows inside a plain int8 mapping, for the conversion
+    TileSlot slots[2];
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} OutOfCoreJob;
+
+static void step_origin(const OutOfCoreJob* job, long s, TileSlot* slot) {
+    int kb = (int) (s % job->steps_m);
+    long t = s / job->steps_m;
+    int jb = (int) (t % job->blocks_p);
+    int ib = (int) (t / job->blocks_p);
+    slot->i0 = ib * job->tile_n;
+    slot->j0 = jb * job->tile_p;
+    slot->k0 = kb * job->tile_m;
+    slot->rows = (job->n - slot->i0 < job->tile_n) ? job->n - slot->i0 : job->tile_n;
+    slot->cols = (job->p - slot->j0 < job->tile_p) ? job->p - slot->j0 : job->tile_p;
+    slot->depth = (job->m - slot->k0 < job->tile_m) ? job->m - slot->k0 : job->tile_m;
+}
+
+// Copies (or converts) the rows × cols window at (r0, c0) of an operand into k contiguous planes
+static void load_tile(OutOfCoreJob* job, const MatrixFile* X, int r0, int c0, int rows, int cols,
+                      int8_t** planes) {
+    if (X->moduli == NULL) {
+        const int8_t* base = (const int8_t*) matrix_file_plane(X, 0);
+        for (int i = 0; i < rows; i++) job->src_rows[i] = (int8_t*) base + (size_t) (r0 + i) * X->row_stride + c0;
+        int8_matrix_to_rns_centered_planes(job->src_rows, rows, cols, job->moduli, job->k, planes, job->convert);
+        return;
+    }
+    for (int l = 0; l < job->k; l++) {
+        const int8_t* base = (const int8_t*) matrix_file_plane(X, l);
+        for (int i = 0; i < rows; i++) {
+            memcpy(planes[l] + (size_t) i * cols, base + (size_t) (r0 + i) * X->row_stride + c0, cols);
+        }
+    }
+}
+
+// Loader thread: fills the slots in step order, one step ahead of the compute
+static void* loader_main(void* arg) {
+    OutOfCoreJob* job = (OutOfCoreJob*) arg;
+    for (long s = 0; s < job->steps; s++) {
+        TileSlot* slot = &job->slots[s & 1];
+        pthread_mutex_lock(&job->lock);
+        while (slot->full) pthread_cond_wait(&job->changed, &job->lock);
+        pthread_mutex_unlock(&job->lock);
+
+        step_origin(job, s, slot);
+        load_tile(job, job->A, slot->i0, slot->k0, slot->rows, slot->depth, slot->a_planes);
+        load_tile(job, job->B, slot->k0, slot->j0, slot->depth, slot->cols, slot->b_planes);
+        for (int l = 0; l < job->k; l++) {
+            for (int i = 0; i < slot->rows; i++) slot->a_rows[l][i] = slot->a_planes[l] + (size_t) i * slot->depth;
+            for (int r = 0; r < slot->depth; r++) slot->b_rows[l][r] = slot->b_planes[l] + (size_t) r * slot->cols;
+        }
+
+        pthread_mutex_lock(&job->lock);
+        slot->full = 1;
+        pthread_cond_broadcast(&job->changed);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return NULL;
+}
+
+// Reason an operand cannot be used with the basis, or NULL
+static const char* operand_error(const MatrixFile* X, const int* moduli, int k) {
+    if (X->type != MATRIX_FILE_INT8) return "not an int8 matrix";
+    if (X->moduli == NULL) return X->planes == 1 ? NULL : "several planes without a basis";
+    if (X->planes != k) return "basis size differs from the moduli";
+    for (int l = 0; l < k; l++) {
+        if (X->moduli[l] != moduli[l]) return "basis differs from the moduli";
+    }
+    return NULL;
+}
+
+int residue_gemm_int8_out_of_core(const char* a_path, const char* b_path, const char* c_path,
+                                  const int* moduli, int k, const OutOfCoreTiles* tiles,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool) {
+    if (k <= 0) return -1;
+    for (int l = 0; l < k; l++) {
+        if (moduli[l] < 3 || moduli[l] > 255) {
+            fprintf(stderr, "Error: modulus %d is outside [3, 255].\n", moduli[l]);
+            return -1;
+        }
+    }
+
+    MatrixFile* A = matrix_file_open(a_path, 0);
+    MatrixFile* B = A ? matrix_file_open(b_path, 0) : NULL;
+    if (B == NULL) {
+        matrix_file_close(A);
+        return -1;
+    }
+    const char* reason = operand_error(A, moduli, k);
+    const char* path = a_path;
+    if (reason == NULL) {
+        reason = operand_error(B, moduli, k);
+        path = b_path;
+    }
+    if (reason == NULL && A->cols != B->rows) reason = "inner dimensions differ";
+    if (reason) {
+        fprintf(stderr, "Error: '%s': %s.\n", path, reason);
+        matrix_file_close(A);
+        matrix_file_close(B);
+        return -1;
+    }
+
+    MatrixFile* C = matrix_file_create(c_path, MATRIX_FILE_INT32, A->rows, B->cols, k, moduli);
+    if (C == NULL) {
+        matrix_file_close(A);
+        matrix_file_close(B);
+        return -1;
+    }
+
+    OutOfCoreJob job;
+    memset(&job, 0, sizeof(job));
+    job.A = A;
+    job.B = B;
+    job.moduli = moduli;
+    job.k = k;
+    job.n = A->rows;
+    job.m = A->cols;
+    job.p = B->cols;
+    job.tile_n = (tiles && tiles->tile_n > 0) ? tiles->tile_n : DEFAULT_TILE_N;
+    job.tile_m = (tiles && tiles->tile_m > 0) ? tiles->tile_m : DEFAULT_TILE_M;
+    job.tile_p = (tiles && tiles->tile_p > 0) ? tiles->tile_p : DEFAULT_TILE_P;
+    if (job.tile_n > job.n) job.tile_n = job.n;
+    if (job.tile_m > job.m) job.tile_m = job.m;
+    if (job.tile_p > job.p) job.tile_p = job.p;
+    job.convert = rns_convert_default_kernel();
+
+    // An empty product leaves the zero payload of the new file as it is
+    if (job.n > 0 && job.m > 0 && job.p > 0) {
+        int blocks_n = (job.n + job.tile_n - 1) / job.tile_n;
+        job.blocks_p = (job.p + job.tile_p - 1) / job.tile_p;
+        job.steps_m = (job.m + job.tile_m - 1) / job.tile_m;
+        job.steps = (long) blocks_n * job.blocks_p * job.steps_m;
+    }
+
+    int tile_n = job.tile_n, tile_m = job.tile_m, tile_p = job.tile_p;
+    job.src_rows = xcalloc((tile_n > tile_m ? tile_n : tile_m) + 1, sizeof(int8_t*));
+    for (int b = 0; b < 2; b++) {
+        TileSlot* slot = &job.slots[b];
+        slot->a_planes = xcalloc(k, sizeof(int8_t*));
+        slot->b_planes = xcalloc(k, sizeof(int8_t*));
+        slot->a_rows = xcalloc(k, sizeof(int8_t**));
+        slot->b_rows = xcalloc(k, sizeof(int8_t**));
+        for (int l = 0; l < k && job.steps > 0; l++) {
+            slot->a_planes[l] = xcalloc((size_t) tile_n * tile_m, sizeof(int8_t));
+            slot->b_planes[l] = xcalloc((size_t) tile_m * tile_p, sizeof(int8_t));
+            slot->a_rows[l] = xcalloc(tile_n, sizeof(int8_t*));
+            slot->b_rows[l] = xcalloc(tile_m, sizeof(int8_t*));
+        }
+    }
+
+    // Step 0 of a block writes the accumulator, later steps a partial product folded into it
+    int*** acc = xcalloc(k, sizeof(int**));
+    int*** part = xcalloc(k, sizeof(int**));
+    for (int l = 0; l < k && job.steps > 0; l++) {
+        acc[l] = xcalloc(tile_n, sizeof(int*));
+        part[l] = xcalloc(tile_n, sizeof(int*));
+        acc[l][0] = xcalloc((size_t) tile_n * tile_p, sizeof(int));
+        part[l][0] = xcalloc((size_t) tile_n * tile_p, sizeof(int));
+    }
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+    pthread_t loader;
+    if (pthread_create(&loader, NULL, loader_main, &job) != 0) {
+        fprintf(stderr, "Error: failed to create the tile loader thread.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (long s = 0; s < job.steps; s++) {
+        TileSlot* slot = &job.slots[s & 1];
+        pthread_mutex_lock(&job.lock);
+        while (!slot->full) pthread_cond_wait(&job.changed, &job.lock);
+        pthread_mutex_unlock(&job.lock);
+
+        int rows = slot->rows, cols = slot->cols;
+        int i0 = slot->i0, j0 = slot->j0;
+        int first = slot->k0 == 0;
+        int last = slot->k0 + slot->depth == job.m;
+        int*** out = first ? acc : part;
+        for (int l = 0; l < k; l++) {
+            for (int i = 1; i < rows; i++) out[l][i] = out[l][0] + (size_t) i * cols;
+        }
+        residue_gemm_int8_rns(slot->a_rows, slot->b_rows, out, moduli, k, rows, slot->depth, cols, kernel, pool);
+
+        // The slot can be refilled while the product is folded and stored
+        pthread_mutex_lock(&job.lock);
+        slot->full = 0;
+        pthread_cond_broadcast(&job.changed);
+        pthread_mutex_unlock(&job.lock);
+
+        for (int l = 0; l < k && !first; l++) {
+            int mod = moduli[l];
+            int* a = acc[l][0];
+            const int* q = part[l][0];
+            for (size_t e = 0; e < (size_t) rows * cols; e++) {
+                int v = a[e] + q[e];
+                a[e] = v >= mod ? v - mod : v;
+            }
+        }
+        for (int l = 0; l < k && last; l++) {
+            int32_t* plane = (int32_t*) matrix_file_plane_writable(C, l);
+            for (int i = 0; i < rows; i++) {
+                memcpy(plane + (size_t) (i0 + i) * C->row_stride + j0, acc[l][0] + (size_t) i * cols, cols * sizeof(int32_t));
+            }
+        }
+    }
+
+    pthread_join(loader, NULL);
+    pthread_cond_destroy(&job.changed);
+    pthread_mutex_destroy(&job.lock);
+
+    for (int l = 0; l < k && job.steps > 0; l++) {
+        free(acc[l][0]);
+        free(part[l][0]);
+        free(acc[l]);
+        free(part[l]);
+    }
+    free(acc);
+    free(part);
+    for (int b = 0; b < 2; b++) {
+        TileSlot* slot = &job.slots[b];
+        for (int l = 0; l < k && job.steps > 0; l++) {
+            free(slot->a_planes[l]);
+            free(slot->b_planes[l]);
+            free(slot->a_rows[l]);
+            free(slot->b_rows[l]);
+        }
+        free(slot->a_planes);
+        free(slot->b_planes);
+        free(slot->a_rows);
+        free(slot->b_rows);
+    }
+    free(job.src_rows);
+
+    int status = matrix_file_finish(C);
+    if (status != 0) fprintf(stderr, "Error: could not flush '%s'.\n", c_path);
+    matrix_file_close(C);
+    matrix_file_close(A);
+    matrix_file_close(B);
+    return status;
+}
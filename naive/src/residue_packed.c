@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "residue_packed.h"
+#include "xalloc.h"
+
+static const char* kernel_names[RESIDUE_PACK_NUM_KERNELS] = {"scalar", "avx2", "avx512"};
+
+const char* residue_pack_kernel_name(ResiduePackKernel kernel) {
+    if (kernel < 0 || kernel >= RESIDUE_PACK_NUM_KERNELS) return "unknown";
+    return kernel_names[kernel];
+}
+
+int residue_pack_kernel_available(ResiduePackKernel kernel) {
+    switch (kernel) {
+        case RESIDUE_PACK_SCALAR:
+            return 1;
+        case RESIDUE_PACK_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case RESIDUE_PACK_AVX512:
+            return __builtin_cpu_supports("avx512bw");
+        default:
+            return 0;
+    }
+}
+
+ResiduePackKernel residue_pack_default_kernel(void) {
+    const char* env = getenv("RESIDUE_PACK_KERNEL");
+    if (env) {
+        for (int kr = 0; kr < RESIDUE_PACK_NUM_KERNELS; kr++) {
+            if (strcmp(env, kernel_names[kr]) == 0 && residue_pack_kernel_available(kr)) {
+                return (ResiduePackKernel) kr;
+            }
+        }
+    }
+    for (int kr = RESIDUE_PACK_NUM_KERNELS - 1; kr > 0; kr--) {
+        if (residue_pack_kernel_available(kr)) return (ResiduePackKernel) kr;
+    }
+    return RESIDUE_PACK_SCALAR;
+}
+
+int residue_packed_bits(int mod) {
+    if (mod < 2 || mod > 256) return 0;
+    int bits = 1;
+    while ((1 << bits) < mod) bits++;
+    return bits;
+}
+
+/////////////////////////////
+//         Kernels         //
+/////////////////////////////
+
+// Each kernel handles one block of 64 residues: src holds 64 bytes (the
+// tail of a row is staged through a zero-padded copy) and dst bits words.
+
+static void pack_block_scalar(const uint8_t* src, int bits, uint64_t* dst) {
+    for (int t = 0; t < bits; t++) {
+        uint64_t w = 0;
+        for (int e = 0; e < 64; e++) w |= (uint64_t) ((src[e] >> t) & 1) << e;
+        dst[t] = w;
+    }
+}
+
+// Centering: r > mod/2 becomes r - mod, computed modulo 256 in the byte
+static void unpack_block_scalar(const uint64_t* src, int bits, int mod, uint8_t* dst) {
+    for (int e = 0; e < 64; e++) {
+        int r = 0;
+        for (int t = 0; t < bits; t++) r |= (int) ((src[t] >> e) & 1) << t;
+        if (mod > 0 && r > mod / 2) r -= mod;
+        dst[e] = (uint8_t) r;
+    }
+}
+
+// vpmovmskb takes the top bit of each byte; a 16-bit shift by 7 - t brings
+// bit t of both bytes of a word there without mixing them.
+__attribute__((target("avx2")))
+static void pack_block_avx2(const uint8_t* src, int bits, uint64_t* dst) {
+    __m256i lo = _mm256_loadu_si256((const __m256i*) src);
+    __m256i hi = _mm256_loadu_si256((const __m256i*) (src + 32));
+    for (int t = 0; t < bits; t++) {
+        __m128i shift = _mm_cvtsi32_si128(7 - t);
+        uint32_t l = (uint32_t) _mm256_movemask_epi8(_mm256_sll_epi16(lo, shift));
+        uint32_t h = (uint32_t) _mm256_movemask_epi8(_mm256_sll_epi16(hi, shift));
+        dst[t] = (uint64_t) l | ((uint64_t) h << 32);
+    }
+}
+
+// Expands a 32-bit mask to 32 bytes of 0xFF / 0x00: byte e gets mask byte
+// e / 8 and is tested against bit e % 8.
+__attribute__((target("avx2")))
+static inline __m256i expand_mask_avx2(uint32_t mask) {
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_set1_epi64x((long long) 0x8040201008040201ULL);
+    __m256i x = _mm256_shuffle_epi8(_mm256_set1_epi32((int) mask), spread);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(x, select), select);
+}
+
+__attribute__((target("avx2")))
+static void unpack_block_avx2(const uint64_t* src, int bits, int mod, uint8_t* dst) {
+    __m256i lo = _mm256_setzero_si256();
+    __m256i hi = _mm256_setzero_si256();
+    for (int t = 0; t < bits; t++) {
+        const __m256i bit = _mm256_set1_epi8((char) (1 << t));
+        lo = _mm256_or_si256(lo, _mm256_and_si256(expand_mask_avx2((uint32_t) src[t]), bit));
+        hi = _mm256_or_si256(hi, _mm256_and_si256(expand_mask_avx2((uint32_t) (src[t] >> 32)), bit));
+    }
+    if (mod > 0) {
+        // r > mod/2 exactly when max(r, mod/2 + 1) == r (unsigned bytes)
+        const __m256i above = _mm256_set1_epi8((char) (mod / 2 + 1));
+        const __m256i vmod = _mm256_set1_epi8((char) mod);
+        __m256i glo = _mm256_cmpeq_epi8(_mm256_max_epu8(lo, above), lo);
+        __m256i ghi = _mm256_cmpeq_epi8(_mm256_max_epu8(hi, above), hi);
+        lo = _mm256_sub_epi8(lo, _mm256_and_si256(glo, vmod));
+        hi = _mm256_sub_epi8(hi, _mm256_and_si256(ghi, vmod));
+    }
+    _mm256_storeu_si256((__m256i*) dst, lo);
+    _mm256_storeu_si256((__m256i*) (dst + 32), hi);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void pack_block_avx512(const uint8_t* src, int bits, uint64_t* dst) {
+    __m512i v = _mm512_loadu_si512((const void*) src);
+    for (int t = 0; t < bits; t++) {
+        dst[t] = (uint64_t) _mm512_test_epi8_mask(v, _mm512_set1_epi8((char) (1 << t)));
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void unpack_block_avx512(const uint64_t* src, int bits, int mod, uint8_t* dst) {
+    __m512i v = _mm512_setzero_si512();
+    for (int t = 0; t < bits; t++) {
+        v = _mm512_or_si512(v, _mm512_maskz_set1_epi8((__mmask64) src[t], (char) (1 << t)));
+    }
+    if (mod > 0) {
+        __mmask64 above = _mm512_cmpgt_epu8_mask(v, _mm512_set1_epi8((char) (mod / 2)));
+        v = _mm512_mask_sub_epi8(v, above, v, _mm512_set1_epi8((char) mod));
+    }
+    _mm512_storeu_si512((void*) dst, v);
+}
+
+static void pack_block(const uint8_t* src, int bits, uint64_t* dst, ResiduePackKernel kernel) {
+    switch (kernel) {
+        case RESIDUE_PACK_AVX2:
+            pack_block_avx2(src, bits, dst);
+            break;
+        case RESIDUE_PACK_AVX512:
+            pack_block_avx512(src, bits, dst);
+            break;
+        default:
+            pack_block_scalar(src, bits, dst);
+            break;
+    }
+}
+
+static void unpack_block(const uint64_t* src, int bits, int mod, uint8_t* dst, ResiduePackKernel kernel) {
+    switch (kernel) {
+        case RESIDUE_PACK_AVX2:
+            unpack_block_avx2(src, bits, mod, dst);
+            break;
+        case RESIDUE_PACK_AVX512:
+            unpack_block_avx512(src, bits, mod, dst);
+            break;
+        default:
+            unpack_block_scalar(src, bits, mod, dst);
+            break;
+    }
+}
+
+void residue_pack_row(const uint8_t* src, int count, int bits, uint64_t* dst, ResiduePackKernel kernel) {
+    if (!residue_pack_kernel_available(kernel)) kernel = RESIDUE_PACK_SCALAR;
+    int e = 0;
+    for (; e + 64 <= count; e += 64, dst += bits) pack_block(src + e, bits, dst, kernel);
+    if (e < count) {
+        uint8_t tail[64] = {0};
+        memcpy(tail, src + e, count - e);
+        pack_block(tail, bits, dst, kernel);
+    }
+}
+
+void residue_unpack_row(const uint64_t* src, int count, int bits, int mod, uint8_t* dst, ResiduePackKernel kernel) {
+    if (!residue_pack_kernel_available(kernel)) kernel = RESIDUE_PACK_SCALAR;
+    int e = 0;
+    for (; e + 64 <= count; e += 64, src += bits) unpack_block(src, bits, mod, dst + e, kernel);
+    if (e < count) {
+        uint8_t tail[64];
+        unpack_block(src, bits, mod, tail, kernel);
+        memcpy(dst + e, tail, count - e);
+    }
+}
+
+/////////////////////////////
+//     Packed matrices     //
+/////////////////////////////
+
+PackedResidueMatrix* allocate_packed_residues(int n, int m, const int* moduli, int k) {
+    for (int l = 0; l < k; l++) {
+        if (residue_packed_bits(moduli[l]) == 0) return NULL;
+    }
+
+    PackedResidueMatrix* P = xcalloc(1, sizeof(PackedResidueMatrix));
+    P->k = k;
+    P->n = n;
+    P->m = m;
+    P->moduli = xcalloc(k, sizeof(int));
+    P->bits = xcalloc(k, sizeof(int));
+    P->row_words = xcalloc(k, sizeof(long));
+    P->planes = xcalloc(k, sizeof(uint64_t*));
+    long blocks = (m + 63) / 64;
+    for (int l = 0; l < k; l++) {
+        P->moduli[l] = moduli[l];
+        P->bits[l] = residue_packed_bits(moduli[l]);
+        P->row_words[l] = P->bits[l] * blocks;
+        P->planes[l] = xcalloc((size_t) n * P->row_words[l] + 1, sizeof(uint64_t));
+    }
+    return P;
+}
+
+// Packs plane l from int residues in [0, mod) or from centered int8 residues
+static void pack_plane(PackedResidueMatrix* P, int l, const int* plane, const int8_t* centered,
+                       ResiduePackKernel kernel) {
+    int m = P->m, mod = P->moduli[l];
+    uint8_t* row = xcalloc(m + 1, sizeof(uint8_t));
+    for (int i = 0; i < P->n; i++) {
+        if (plane) {
+            const int* src = plane + (size_t) i * m;
+            for (int j = 0; j < m; j++) row[j] = (uint8_t) src[j];
+        } else {
+            const int8_t* src = centered + (size_t) i * m;
+            for (int j = 0; j < m; j++) row[j] = (uint8_t) (src[j] < 0 ? src[j] + mod : src[j]);
+        }
+        residue_pack_row(row, m, P->bits[l], P->planes[l] + (size_t) i * P->row_words[l], kernel);
+    }
+    free(row);
+}
+
+PackedResidueMatrix* pack_residues(int*** residues, int n, int m, const int* moduli, int k) {
+    PackedResidueMatrix* P = allocate_packed_residues(n, m, moduli, k);
+    if (P == NULL) return NULL;
+    ResiduePackKernel kernel = residue_pack_default_kernel();
+    for (int l = 0; l < k && n > 0; l++) pack_plane(P, l, residues[l][0], NULL, kernel);
+    return P;
+}
+
+PackedResidueMatrix* pack_residues_centered(int8_t*** residues, int n, int m, const int* moduli, int k) {
+    PackedResidueMatrix* P = allocate_packed_residues(n, m, moduli, k);
+    if (P == NULL) return NULL;
+    ResiduePackKernel kernel = residue_pack_default_kernel();
+    for (int l = 0; l < k && n > 0; l++) pack_plane(P, l, NULL, residues[l][0], kernel);
+    return P;
+}
+
+void unpack_residues(const PackedResidueMatrix* P, int l, int row_begin, int rows, int* dst, long ld) {
+    ResiduePackKernel kernel = residue_pack_default_kernel();
+    uint8_t* row = xcalloc(P->m + 1, sizeof(uint8_t));
+    for (int i = 0; i < rows; i++) {
+        residue_unpack_row(P->planes[l] + (size_t) (row_begin + i) * P->row_words[l], P->m, P->bits[l], 0, row,
+                           kernel);
+        int* out = dst + (size_t) i * ld;
+        for (int j = 0; j < P->m; j++) out[j] = row[j];
+    }
+    free(row);
+}
+
+void unpack_residues_centered(const PackedResidueMatrix* P, int l, int row_begin, int rows, int8_t* dst, long ld) {
+    ResiduePackKernel kernel = residue_pack_default_kernel();
+    for (int i = 0; i < rows; i++) {
+        residue_unpack_row(P->planes[l] + (size_t) (row_begin + i) * P->row_words[l], P->m, P->bits[l],
+                           P->moduli[l], (uint8_t*) dst + (size_t) i * ld, kernel);
+    }
+}
+
+void free_packed_residues(PackedResidueMatrix* P) {
+    if (!P) return;
+    for (int l = 0; l < P->k; l++) free(P->planes[l]);
+    free(P->planes);
+    free(P->row_words);
+    free(P->bits);
+    free(P->moduli);
+    free(P);
+}
+
+/////////////////////////////
+//          GEMM           //
+/////////////////////////////
+
+static void packed_row_source(const void* arg, int plane, int row_begin, int rows, int8_t* dst, long ld) {
+    unpack_residues_centered((const PackedResidueMatrix*) arg, plane, row_begin, rows, dst, ld);
+}
+
+void residue_gemm_int8_rns_packed(const PackedResidueMatrix* A, const PackedResidueMatrix* B, int*** Cres,
+                                  ResidueInt8Kernel kernel, ThreadPool* pool) {
+    residue_gemm_int8_rns_source(packed_row_source, A, packed_row_source, B, Cres, A->moduli, A->k, A->n, A->m,
+                                 B->m, kernel, pool);
+}
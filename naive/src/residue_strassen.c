@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "residue_strassen.h"
+#include "residue_gemm.h"
+#include "xalloc.h"
+
+#define DEFAULT_CROSSOVER 256
+
+int residue_strassen_default_crossover(void) {
+    const char* env = getenv("RNS_STRASSEN_CROSSOVER");
+    if (env != NULL) {
+        int c = atoi(env);
+        if (c >= 2) return c;
+    }
+    return DEFAULT_CROSSOVER;
+}
+
+// Z = X + Y mod mod on a rows × cols view; Z may alias X or Y
+static void plane_add(const int* X, int ldx, const int* Y, int ldy, int* Z, int ldz,
+                      int rows, int cols, int mod) {
+    for (int i = 0; i < rows; i++) {
+        const int* x = X + (size_t) i * ldx;
+        const int* y = Y + (size_t) i * ldy;
+        int* z = Z + (size_t) i * ldz;
+        for (int j = 0; j < cols; j++) {
+            int s = x[j] - (mod - y[j]);   // x + y - mod without overflowing int
+            z[j] = s < 0 ? s + mod : s;
+        }
+    }
+}
+
+// Z = X - Y mod mod on a rows × cols view; Z may alias X or Y
+static void plane_sub(const int* X, int ldx, const int* Y, int ldy, int* Z, int ldz,
+                      int rows, int cols, int mod) {
+    for (int i = 0; i < rows; i++) {
+        const int* x = X + (size_t) i * ldx;
+        const int* y = Y + (size_t) i * ldy;
+        int* z = Z + (size_t) i * ldz;
+        for (int j = 0; j < cols; j++) {
+            int s = x[j] - y[j];
+            z[j] = s < 0 ? s + mod : s;
+        }
+    }
+}
+
+static int* allocate_temp(int rows, int cols) {
+    return xmalloc((size_t) rows * cols * sizeof(int));
+}
+
+// One Winograd level on even n, m, p
+static void winograd_level(const int* A, int lda, const int* B, int ldb, int* C, int ldc,
+                           int n, int m, int p, int mod, int crossover) {
+    int hn = n / 2, hm = m / 2, hp = p / 2;
+    const int* A11 = A;
+    const int* A12 = A + hm;
+    const int* A21 = A + (size_t) hn * lda;
+    const int* A22 = A21 + hm;
+    const int* B11 = B;
+    const int* B12 = B + hp;
+    const int* B21 = B + (size_t) hm * ldb;
+    const int* B22 = B21 + hp;
+    int* C11 = C;
+    int* C12 = C + hp;
+    int* C21 = C + (size_t) hn * ldc;
+    int* C22 = C21 + hp;
+
+    int* X = allocate_temp(hn, hm);
+    int* Y = allocate_temp(hm, hp);
+    int* Z = allocate_temp(hn, hp);
+
+    // P7 = (A11 - A21)(B22 - B12) -> C21
+    plane_sub(A11, lda, A21, lda, X, hm, hn, hm, mod);
+    plane_sub(B22, ldb, B12, ldb, Y, hp, hm, hp, mod);
+    residue_gemm_strassen(X, hm, Y, hp, C21, ldc, hn, hm, hp, mod, crossover);
+
+    // S1 = A21 + A22, T1 = B12 - B11, P5 = S1 T1 -> C22
+    plane_add(A21, lda, A22, lda, X, hm, hn, hm, mod);
+    plane_sub(B12, ldb, B11, ldb, Y, hp, hm, hp, mod);
+    residue_gemm_strassen(X, hm, Y, hp, C22, ldc, hn, hm, hp, mod, crossover);
+
+    // S2 = S1 - A11, T2 = B22 - T1, P6 = S2 T2 -> C12
+    plane_sub(X, hm, A11, lda, X, hm, hn, hm, mod);
+    plane_sub(B22, ldb, Y, hp, Y, hp, hm, hp, mod);
+    residue_gemm_strassen(X, hm, Y, hp, C12, ldc, hn, hm, hp, mod, crossover);
+
+    // S4 = A12 - S2, P3 = S4 B22 -> C11
+    plane_sub(A12, lda, X, hm, X, hm, hn, hm, mod);
+    residue_gemm_strassen(X, hm, B22, ldb, C11, ldc, hn, hm, hp, mod, crossover);
+
+    // P1 = A11 B11 -> Z
+    residue_gemm_strassen(A11, lda, B11, ldb, Z, hp, hn, hm, hp, mod, crossover);
+
+    plane_add(Z, hp, C12, ldc, C12, ldc, hn, hp, mod);       // U2 = P1 + P6
+    plane_add(C12, ldc, C21, ldc, C21, ldc, hn, hp, mod);    // U3 = U2 + P7
+    plane_add(C12, ldc, C22, ldc, C12, ldc, hn, hp, mod);    // U4 = U2 + P5
+    plane_add(C21, ldc, C22, ldc, C22, ldc, hn, hp, mod);    // C22 = U3 + P5
+    plane_add(C12, ldc, C11, ldc, C12, ldc, hn, hp, mod);    // C12 = U4 + P3
+
+    // T4 = T2 - B21, P4 = A22 T4 -> C11, C21 = U3 - P4
+    plane_sub(Y, hp, B21, ldb, Y, hp, hm, hp, mod);
+    residue_gemm_strassen(A22, lda, Y, hp, C11, ldc, hn, hm, hp, mod, crossover);
+    plane_sub(C21, ldc, C11, ldc, C21, ldc, hn, hp, mod);
+
+    // P2 = A12 B21 -> C11, C11 = P1 + P2
+    residue_gemm_strassen(A12, lda, B21, ldb, C11, ldc, hn, hm, hp, mod, crossover);
+    plane_add(Z, hp, C11, ldc, C11, ldc, hn, hp, mod);
+
+    free(X);
+    free(Y);
+    free(Z);
+}
+
+void residue_gemm_strassen(const int* A, int lda, const int* B, int ldb, int* C, int ldc,
+                           int n, int m, int p, int mod, int crossover) {
+    if (crossover < 2) crossover = 2;
+    if (n < crossover || m < crossover || p < crossover) {
+        residue_gemm_rows(A, lda, B, ldb, C, ldc, m, p, mod, 0, n);
+        return;
+    }
+
+    // Even part by Winograd, odd row / column / inner index peeled off as views
+    int n2 = n & ~1, m2 = m & ~1, p2 = p & ~1;
+    winograd_level(A, lda, B, ldb, C, ldc, n2, m2, p2, mod, crossover);
+
+    if (m2 < m) {
+        const int* b_row = B + (size_t) m2 * ldb;
+        for (int i = 0; i < n2; i++) {
+            uint64_t a = (uint64_t) A[(size_t) i * lda + m2];
+            int* c_row = C + (size_t) i * ldc;
+            for (int j = 0; j < p2; j++) {
+                c_row[j] = (int) (((uint64_t) c_row[j] + a * (uint64_t) b_row[j]) % (uint64_t) mod);
+            }
+        }
+    }
+    if (p2 < p) residue_gemm_rows(A, lda, B + p2, ldb, C + p2, ldc, m, 1, mod, 0, n2);
+    if (n2 < n) residue_gemm_rows(A, lda, B, ldb, C, ldc, m, p, mod, n2, n);
+}
+
+typedef struct {
+    int*** Ares;
+    int*** Bres;
+    int*** Cres;
+    const int* moduli;
+    int n, m, p;
+    int crossover;
+} StrassenJob;
+
+static void strassen_task(void* arg, int idx, int worker_idx) {
+    StrassenJob* job = (StrassenJob*) arg;
+    (void) worker_idx;
+    residue_gemm_strassen(job->Ares[idx][0], job->m, job->Bres[idx][0], job->p, job->Cres[idx][0], job->p,
+                          job->n, job->m, job->p, job->moduli[idx], job->crossover);
+}
+
+void residue_gemm_rns_strassen(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                               int n, int m, int p, int crossover, ThreadPool* pool) {
+    if (k <= 0 || n <= 0 || p <= 0) return;
+
+    StrassenJob job = { Ares, Bres, Cres, moduli, n, m, p,
+                        crossover > 0 ? crossover : residue_strassen_default_crossover() };
+    thread_pool_run(pool, k, strassen_task, &job);
+}
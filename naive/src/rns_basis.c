@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "rns_basis.h"
+#include "xalloc.h"
+
+static int is_prime(int x) {
+    if (x < 2) return 0;
+    if (x % 2 == 0) return x == 2;
+    for (int d = 3; (long) d * d <= x; d += 2) {
+        if (x % d == 0) return 0;
+    }
+    return 1;
+}
+
+int* rns_basis_primes(int modulus_bits, int count) {
+    if (modulus_bits < 3 || modulus_bits > 31 || count <= 0) return NULL;
+
+    int* moduli = xmalloc(count * sizeof(int));
+
+    long lower = 1L << (modulus_bits - 1);
+    long candidate = (1L << modulus_bits) - 1;
+    int found = 0;
+    while (found < count && candidate > lower) {
+        if (is_prime((int) candidate)) moduli[found++] = (int) candidate;
+        candidate -= 2;
+    }
+
+    if (found < count) {
+        free(moduli);
+        return NULL;
+    }
+    return moduli;
+}
+
+int* rns_basis_select(long bound_bits, int modulus_bits, int* out_k) {
+    if (bound_bits < 1) bound_bits = 1;
+    long k = (bound_bits + modulus_bits - 2) / (modulus_bits - 1);
+    int* moduli = rns_basis_primes(modulus_bits, (int) k);
+    if (moduli == NULL) {
+        fprintf(stderr, "Error: not enough %d-bit primes for a %ld-bit RNS basis.\n",
+                modulus_bits, bound_bits);
+        exit(EXIT_FAILURE);
+    }
+    *out_k = (int) k;
+    return moduli;
+}
+
+long rns_product_bound_bits(long bits_a, long bits_b, int inner_dim) {
+    long bits_k = 0;
+    while ((1L << bits_k) < inner_dim) bits_k++;
+    return bits_k + bits_a + bits_b + 1;
+}
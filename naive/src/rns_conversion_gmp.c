@@ -1,8 +1,151 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <gmp.h>
 #include "rns_conversion_gmp.h"
 
+// Moduli per leaf of the remainder tree; a leaf remainder is a few limbs
+// and its residues come from mpz_fdiv_ui
+#define TREE_LEAF_MODULI 8
+
+// The tree pays off once k · limbs per entry reaches TREE_MIN_WORK, for at
+// least TREE_MIN_MODULI moduli (measured crossover: about 0.8x the direct
+// time at 133 moduli and 32768-bit entries, 0.4-0.5x at 500+ moduli and
+// 131072 bits, slower below a few thousand bits)
+#define TREE_MIN_WORK 32768
+#define TREE_MIN_MODULI 128
+
+typedef struct {
+    int levels;
+    int* width;      // nodes per level; level 0 holds the leaves, level levels-1 the root
+    mpz_t** node;    // node[l][i] = product of the moduli below it
+} RemainderTree;
+
+static RemainderTree* remainder_tree_create(const int* moduli, int k) {
+    RemainderTree* tree = malloc(sizeof(RemainderTree));
+    int leaves = (k + TREE_LEAF_MODULI - 1) / TREE_LEAF_MODULI;
+    tree->levels = 1;
+    for (int w = leaves; w > 1; w = (w + 1) / 2) tree->levels++;
+    tree->width = malloc(tree->levels * sizeof(int));
+    tree->node = malloc(tree->levels * sizeof(mpz_t*));
+
+    tree->width[0] = leaves;
+    tree->node[0] = malloc(leaves * sizeof(mpz_t));
+    for (int g = 0; g < leaves; g++) {
+        mpz_init_set_ui(tree->node[0][g], 1);
+        for (int idx = g * TREE_LEAF_MODULI; idx < k && idx < (g + 1) * TREE_LEAF_MODULI; idx++) {
+            mpz_mul_ui(tree->node[0][g], tree->node[0][g], (unsigned long) moduli[idx]);
+        }
+    }
+    for (int l = 1; l < tree->levels; l++) {
+        int w = (tree->width[l - 1] + 1) / 2;
+        tree->width[l] = w;
+        tree->node[l] = malloc(w * sizeof(mpz_t));
+        for (int i = 0; i < w; i++) {
+            mpz_init_set(tree->node[l][i], tree->node[l - 1][2 * i]);
+            if (2 * i + 1 < tree->width[l - 1]) {
+                mpz_mul(tree->node[l][i], tree->node[l][i], tree->node[l - 1][2 * i + 1]);
+            }
+        }
+    }
+    return tree;
+}
+
+static void remainder_tree_free(RemainderTree* tree) {
+    if (!tree) return;
+    for (int l = 0; l < tree->levels; l++) {
+        for (int i = 0; i < tree->width[l]; i++) mpz_clear(tree->node[l][i]);
+        free(tree->node[l]);
+    }
+    free(tree->node);
+    free(tree->width);
+    free(tree);
+}
+
+int rns_remainder_tree_profitable(int k, long bits) {
+    long limbs = (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    return k >= TREE_MIN_MODULI && (long) k * limbs >= TREE_MIN_WORK;
+}
+
+/////////////////////////////
+//     Row conversion      //
+/////////////////////////////
+
+typedef struct {
+    mpz_t** A;
+    int m;
+    const int* moduli;
+    int k;
+    const RemainderTree* tree;   // NULL for the direct loop
+    int*** residues;
+} ConvertJob;
+
+// Task i converts row i of A for every modulus
+static void convert_row_task(void* arg, int i, int worker_idx) {
+    ConvertJob* job = (ConvertJob*) arg;
+    (void) worker_idx;
+
+    if (job->tree == NULL) {
+        for (int idx = 0; idx < job->k; idx++) {
+            unsigned long mod = (unsigned long) job->moduli[idx];
+            int* out = job->residues[idx][i];
+            for (int j = 0; j < job->m; j++) out[j] = (int) mpz_fdiv_ui(job->A[i][j], mod);
+        }
+        return;
+    }
+
+    // One remainder per node, reused across the row. at[l][v] is the value
+    // reduced at node (l, v): its own remainder, or the parent's value when
+    // that is already smaller than the node.
+    const RemainderTree* tree = job->tree;
+    mpz_t** rem = malloc(tree->levels * sizeof(mpz_t*));
+    mpz_srcptr** at = malloc(tree->levels * sizeof(mpz_srcptr*));
+    for (int l = 0; l < tree->levels; l++) {
+        rem[l] = malloc(tree->width[l] * sizeof(mpz_t));
+        at[l] = malloc(tree->width[l] * sizeof(mpz_srcptr));
+        for (int v = 0; v < tree->width[l]; v++) mpz_init(rem[l][v]);
+    }
+
+    int top = tree->levels - 1;
+    for (int j = 0; j < job->m; j++) {
+        mpz_srcptr x = job->A[i][j];
+        if (mpz_sgn(x) >= 0 && mpz_cmp(x, tree->node[top][0]) < 0) {
+            at[top][0] = x;
+        } else {
+            mpz_fdiv_r(rem[top][0], x, tree->node[top][0]);
+            at[top][0] = rem[top][0];
+        }
+        for (int l = top - 1; l >= 0; l--) {
+            for (int v = 0; v < tree->width[l]; v++) {
+                mpz_srcptr parent = at[l + 1][v / 2];
+                if (mpz_cmp(parent, tree->node[l][v]) < 0) {
+                    at[l][v] = parent;
+                } else {
+                    mpz_tdiv_r(rem[l][v], parent, tree->node[l][v]);
+                    at[l][v] = rem[l][v];
+                }
+            }
+        }
+        for (int idx = 0; idx < job->k; idx++) {
+            job->residues[idx][i][j] = (int) mpz_tdiv_ui(at[0][idx / TREE_LEAF_MODULI],
+                                                        (unsigned long) job->moduli[idx]);
+        }
+    }
+
+    for (int l = 0; l < tree->levels; l++) {
+        for (int v = 0; v < tree->width[l]; v++) mpz_clear(rem[l][v]);
+        free(rem[l]);
+        free(at[l]);
+    }
+    free(rem);
+    free(at);
+}
+
 RNSMatrix* mpz_matrix_to_rns(mpz_t** A, int n, int m, int* moduli, int k) {
+    return mpz_matrix_to_rns_pool(A, n, m, moduli, k, RNS_MPZ_CONVERT_AUTO, NULL);
+}
+
+RNSMatrix* mpz_matrix_to_rns_pool(mpz_t** A, int n, int m, int* moduli, int k, RNSMpzConversion mode,
+                                  ThreadPool* pool) {
     RNSMatrix* rns = malloc(sizeof(RNSMatrix));
     rns->k = k;
     rns->n = n;
@@ -15,25 +158,38 @@ RNSMatrix* mpz_matrix_to_rns(mpz_t** A, int n, int m, int* moduli, int k) {
 
     rns->residues = malloc(k * sizeof(int**));
     for (int mod_idx = 0; mod_idx < k; mod_idx++) {
+        // One contiguous n × m plane per modulus; mat[i] points into it
         int** mat = malloc(n * sizeof(int*));
+        int* plane = malloc((size_t) n * m * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            mat[i] = plane + (size_t) i * m;
+        }
+        rns->residues[mod_idx] = mat;
+    }
+
+    if (mode == RNS_MPZ_CONVERT_AUTO) {
+        long bits = 0;
         for (int i = 0; i < n; i++) {
-            mat[i] = malloc(m * sizeof(int));
             for (int j = 0; j < m; j++) {
-                mat[i][j] = mpz_fdiv_ui(A[i][j], moduli[mod_idx]);
+                long b = (long) mpz_sizeinbase(A[i][j], 2);
+                if (b > bits) bits = b;
             }
         }
-        rns->residues[mod_idx] = mat;
+        mode = rns_remainder_tree_profitable(k, bits) ? RNS_MPZ_CONVERT_TREE : RNS_MPZ_CONVERT_DIRECT;
     }
 
+    RemainderTree* tree = (mode == RNS_MPZ_CONVERT_TREE && k > 0) ? remainder_tree_create(moduli, k) : NULL;
+    ConvertJob job = { A, m, moduli, k, tree, rns->residues };
+    thread_pool_run(pool, n, convert_row_task, &job);
+    remainder_tree_free(tree);
+
     return rns;
 }
 
 void free_rns_matrix(RNSMatrix* rns) {
     if (!rns) return;
     for (int mod_idx = 0; mod_idx < rns->k; mod_idx++) {
-        for (int i = 0; i < rns->n; i++) {
-            free(rns->residues[mod_idx][i]);
-        }
+        if (rns->n > 0) free(rns->residues[mod_idx][0]);
         free(rns->residues[mod_idx]);
     }
     free(rns->residues);
@@ -1,7 +1,53 @@
 #include <stdlib.h>
 #include <stdint.h>
+#include <immintrin.h>
 #include "rns_conversion_int16.h"
 
+static void row_scalar(const int16_t* a, int m, int mod, int* out) {
+    for (int j = 0; j < m; j++) {
+        int r = a[j] % mod;
+        out[j] = r < 0 ? r + mod : r;
+    }
+}
+
+// q = floor(x · (1/mod)) in single precision is off by at most one for
+// |x| <= 2^15, so r = x - q·mod needs one correction on each side
+__attribute__((target("avx2")))
+static void row_avx2(const int16_t* a, int m, int mod, int* out) {
+    const __m256 vinv = _mm256_set1_ps(1.0f / (float) mod);
+    const __m256i vmod = _mm256_set1_epi32(mod);
+    const __m256i vmod_minus_one = _mm256_set1_epi32(mod - 1);
+
+    int j = 0;
+    for (; j + 8 <= m; j += 8) {
+        __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) (a + j)));
+        __m256 qf = _mm256_floor_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(x), vinv));
+        __m256i r = _mm256_sub_epi32(x, _mm256_mullo_epi32(_mm256_cvtps_epi32(qf), vmod));
+        r = _mm256_add_epi32(r, _mm256_and_si256(_mm256_srai_epi32(r, 31), vmod));
+        r = _mm256_sub_epi32(r, _mm256_and_si256(_mm256_cmpgt_epi32(r, vmod_minus_one), vmod));
+        _mm256_storeu_si256((__m256i*) (out + j), r);
+    }
+    row_scalar(a + j, m - j, mod, out + j);
+}
+
+void int16_matrix_to_rns_planes(int16_t** A, int n, int m, const int* moduli, int k, int* const* planes,
+                                RNSConvertKernel kernel) {
+    // No AVX-512 kernel: it runs as AVX2
+    int simd = kernel != RNS_CONVERT_SCALAR && rns_convert_kernel_available(RNS_CONVERT_AVX2);
+
+    // One pass over A: row i is converted for every modulus before moving on
+    for (int i = 0; i < n; i++) {
+        for (int mod_idx = 0; mod_idx < k; mod_idx++) {
+            int* out = planes[mod_idx] + (size_t) i * m;
+            if (simd) {
+                row_avx2(A[i], m, moduli[mod_idx], out);
+            } else {
+                row_scalar(A[i], m, moduli[mod_idx], out);
+            }
+        }
+    }
+}
+
 RNSMatrix* int16_matrix_to_rns(int16_t** A, int n, int m, int* moduli, int k) {
     RNSMatrix* rns = malloc(sizeof(RNSMatrix));
     rns->k = k;
@@ -13,28 +59,29 @@ RNSMatrix* int16_matrix_to_rns(int16_t** A, int n, int m, int* moduli, int k) {
         rns->moduli[i] = moduli[i];
     }
 
+    // One contiguous n × m plane per modulus; mat[i] points into it
     rns->residues = malloc(k * sizeof(int**));
+    int** planes = malloc(k * sizeof(int*));
     for (int mod_idx = 0; mod_idx < k; mod_idx++) {
         int** mat = malloc(n * sizeof(int*));
+        int* plane = malloc((size_t) n * m * sizeof(int));
         for (int i = 0; i < n; i++) {
-            mat[i] = malloc(m * sizeof(int));
-            for (int j = 0; j < m; j++) {
-                mat[i][j] = A[i][j] % moduli[mod_idx];
-                if (mat[i][j] < 0) mat[i][j] += moduli[mod_idx];
-            }
+            mat[i] = plane + (size_t) i * m;
         }
         rns->residues[mod_idx] = mat;
+        planes[mod_idx] = plane;
     }
 
+    int16_matrix_to_rns_planes(A, n, m, moduli, k, planes, rns_convert_default_kernel());
+    free(planes);
+
     return rns;
 }
 
 void free_rns_matrix(RNSMatrix* rns) {
     if (!rns) return;
     for (int mod_idx = 0; mod_idx < rns->k; mod_idx++) {
-        for (int i = 0; i < rns->n; i++) {
-            free(rns->residues[mod_idx][i]);
-        }
+        if (rns->n > 0) free(rns->residues[mod_idx][0]);
         free(rns->residues[mod_idx]);
     }
     free(rns->residues);
@@ -1,6 +1,158 @@
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
+#include <immintrin.h>
 #include "rns_conversion_int8.h"
+#include "xalloc.h"
+
+/////////////////////////////
+//         Kernels         //
+/////////////////////////////
+
+// Every kernel maps a row of m entries to their representatives modulo mod:
+// the centered residue in (-mod/2, mod/2] for mod <= 255, the entry itself
+// for larger moduli (|x| <= 128 < mod already). The unsigned variants then
+// add mod to negative representatives. table[(uint8_t) x] is the
+// representative of x.
+
+static void residue_table(int mod, int8_t* table) {
+    for (int u = 0; u < 256; u++) {
+        int x = (int8_t) u;
+        int r = x;
+        if (mod <= 255) {
+            r = x % mod;
+            if (r < 0) r += mod;
+            if (r > mod / 2) r -= mod;
+        }
+        table[u] = (int8_t) r;
+    }
+}
+
+static void row_scalar(const int8_t* a, int m, const int8_t* table, int mod, int* out, int8_t* centered) {
+    if (centered) {
+        for (int j = 0; j < m; j++) centered[j] = table[(uint8_t) a[j]];
+    } else {
+        for (int j = 0; j < m; j++) {
+            int r = table[(uint8_t) a[j]];
+            out[j] = r < 0 ? r + mod : r;
+        }
+    }
+}
+
+// r = x - mod·round(x/mod), with the quotient from vpmulhrsw by round(2^15/mod);
+// it is off by at most one, so one correction on each side makes r centered.
+__attribute__((target("avx2")))
+static void row_avx2(const int8_t* a, int m, const int8_t* table, int mod, int* out, int8_t* centered) {
+    int small = mod <= 255;
+    int c = mod == 1 ? 32767 : (32768 + mod / 2) / mod;
+    const __m256i vc = _mm256_set1_epi16((short) (small ? c : 0));
+    const __m256i vmod16 = _mm256_set1_epi16((short) (small ? mod : 0));
+    const __m256i vhalf = _mm256_set1_epi16((short) (small ? mod / 2 : 127));
+    const __m256i vlow = _mm256_set1_epi16((short) (small ? -((mod + 1) / 2) + 1 : -128));
+    const __m256i vmod32 = _mm256_set1_epi32(mod);
+
+    int j = 0;
+    for (; j + 16 <= m; j += 16) {
+        __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + j)));
+        __m256i q = _mm256_mulhrs_epi16(x, vc);
+        __m256i r = _mm256_sub_epi16(x, _mm256_mullo_epi16(q, vmod16));
+        r = _mm256_sub_epi16(r, _mm256_and_si256(_mm256_cmpgt_epi16(r, vhalf), vmod16));
+        r = _mm256_add_epi16(r, _mm256_and_si256(_mm256_cmpgt_epi16(vlow, r), vmod16));
+
+        if (centered) {
+            __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+            _mm_storeu_si128((__m128i*) (centered + j), packed);
+        } else {
+            __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(r));
+            __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(r, 1));
+            lo = _mm256_add_epi32(lo, _mm256_and_si256(_mm256_srai_epi32(lo, 31), vmod32));
+            hi = _mm256_add_epi32(hi, _mm256_and_si256(_mm256_srai_epi32(hi, 31), vmod32));
+            _mm256_storeu_si256((__m256i*) (out + j), lo);
+            _mm256_storeu_si256((__m256i*) (out + j + 8), hi);
+        }
+    }
+    row_scalar(a + j, m - j, table, mod, out ? out + j : NULL, centered ? centered + j : NULL);
+}
+
+// The 256-entry table sits in four zmm registers; vpermi2b looks up the low
+// seven bits in the two halves and the sign bit of x picks the half.
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static void row_avx512(const int8_t* a, int m, const int8_t* table, int mod, int* out, int8_t* centered) {
+    const __m512i t0 = _mm512_loadu_si512((const void*) table);
+    const __m512i t1 = _mm512_loadu_si512((const void*) (table + 64));
+    const __m512i t2 = _mm512_loadu_si512((const void*) (table + 128));
+    const __m512i t3 = _mm512_loadu_si512((const void*) (table + 192));
+    const __m512i vmod = _mm512_set1_epi32(mod);
+
+    for (int j = 0; j < m; j += 64) {
+        __mmask64 mask = (m - j >= 64) ? ~(__mmask64) 0 : (((__mmask64) 1 << (m - j)) - 1);
+        __m512i x = _mm512_maskz_loadu_epi8(mask, a + j);
+        __m512i pos = _mm512_permutex2var_epi8(t0, x, t1);
+        __m512i neg = _mm512_permutex2var_epi8(t2, x, t3);
+        __m512i r = _mm512_mask_blend_epi8(_mm512_movepi8_mask(x), pos, neg);
+
+        if (centered) {
+            _mm512_mask_storeu_epi8(centered + j, mask, r);
+        } else {
+            for (int q = 0; q < 4 && j + 16 * q < m; q++) {
+                __m512i v;
+                switch (q) {
+                    case 0: v = _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(r, 0)); break;
+                    case 1: v = _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(r, 1)); break;
+                    case 2: v = _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(r, 2)); break;
+                    default: v = _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(r, 3)); break;
+                }
+                v = _mm512_add_epi32(v, _mm512_and_si512(_mm512_srai_epi32(v, 31), vmod));
+                _mm512_mask_storeu_epi32(out + j + 16 * q, (__mmask16) (mask >> (16 * q)), v);
+            }
+        }
+    }
+}
+
+// One pass over A: row i is converted for every modulus before moving on
+static void convert_rows(int8_t** A, int n, int m, const int* moduli, int k, int* const* planes,
+                         int8_t* const* centered, RNSConvertKernel kernel) {
+    if (!rns_convert_kernel_available(kernel)) kernel = RNS_CONVERT_SCALAR;
+
+    int8_t* tables = xmalloc((size_t) k * 256);
+    for (int idx = 0; idx < k; idx++) residue_table(moduli[idx], tables + (size_t) idx * 256);
+
+    for (int i = 0; i < n; i++) {
+        for (int idx = 0; idx < k; idx++) {
+            const int8_t* table = tables + (size_t) idx * 256;
+            int* out = planes ? planes[idx] + (size_t) i * m : NULL;
+            int8_t* cout = centered ? centered[idx] + (size_t) i * m : NULL;
+            switch (kernel) {
+                case RNS_CONVERT_AVX2:
+                    row_avx2(A[i], m, table, moduli[idx], out, cout);
+                    break;
+                case RNS_CONVERT_AVX512:
+                    row_avx512(A[i], m, table, moduli[idx], out, cout);
+                    break;
+                default:
+                    row_scalar(A[i], m, table, moduli[idx], out, cout);
+                    break;
+            }
+        }
+    }
+
+    free(tables);
+}
+
+void int8_matrix_to_rns_planes(int8_t** A, int n, int m, const int* moduli, int k, int* const* planes,
+                               RNSConvertKernel kernel) {
+    convert_rows(A, n, m, moduli, k, planes, NULL, kernel);
+}
+
+void int8_matrix_to_rns_centered_planes(int8_t** A, int n, int m, const int* moduli, int k,
+                                        int8_t* const* planes, RNSConvertKernel kernel) {
+    convert_rows(A, n, m, moduli, k, NULL, planes, kernel);
+}
+
+/////////////////////////////
+//       RNS matrices      //
+/////////////////////////////
 
 RNSMatrix* int8_matrix_to_rns(int8_t** A, int n, int m, int* moduli, int k) {
     RNSMatrix* rns = malloc(sizeof(RNSMatrix));
@@ -13,18 +165,20 @@ RNSMatrix* int8_matrix_to_rns(int8_t** A, int n, int m, int* moduli, int k) {
         rns->moduli[i] = moduli[i];
     }
 
+    // One contiguous n × m plane per modulus; mat[i] points into it
     rns->residues = malloc(k * sizeof(int**));
+    int** planes = malloc(k * sizeof(int*));
     for (int mod_idx = 0; mod_idx < k; mod_idx++) {
         int** mat = malloc(n * sizeof(int*));
+        int* plane = malloc((size_t) n * m * sizeof(int));
         for (int i = 0; i < n; i++) {
-            mat[i] = malloc(m * sizeof(int));
-            for (int j = 0; j < m; j++) {
-                mat[i][j] = A[i][j] % moduli[mod_idx];
-                if (mat[i][j] < 0) mat[i][j] += moduli[mod_idx];
-            }
+            mat[i] = plane + (size_t) i * m;
         }
         rns->residues[mod_idx] = mat;
+        planes[mod_idx] = plane;
     }
+    int8_matrix_to_rns_planes(A, n, m, moduli, k, planes, rns_convert_default_kernel());
+    free(planes);
 
     return rns;
 }
@@ -32,9 +186,53 @@ RNSMatrix* int8_matrix_to_rns(int8_t** A, int n, int m, int* moduli, int k) {
 void free_rns_matrix(RNSMatrix* rns) {
     if (!rns) return;
     for (int mod_idx = 0; mod_idx < rns->k; mod_idx++) {
-        for (int i = 0; i < rns->n; i++) {
-            free(rns->residues[mod_idx][i]);
+        if (rns->n > 0) free(rns->residues[mod_idx][0]);
+        free(rns->residues[mod_idx]);
+    }
+    free(rns->residues);
+    free(rns->moduli);
+    free(rns);
+}
+
+RNSMatrixCentered* int8_matrix_to_rns_centered(int8_t** A, int n, int m, int* moduli, int k) {
+    for (int i = 0; i < k; i++) {
+        if (moduli[i] < 3 || moduli[i] > 255) {
+            fprintf(stderr, "Error: modulus %d does not fit centered int8 residues.\n", moduli[i]);
+            return NULL;
         }
+    }
+
+    RNSMatrixCentered* rns = malloc(sizeof(RNSMatrixCentered));
+    rns->k = k;
+    rns->n = n;
+    rns->m = m;
+    rns->moduli = malloc(k * sizeof(int));
+
+    for (int i = 0; i < k; i++) {
+        rns->moduli[i] = moduli[i];
+    }
+
+    rns->residues = malloc(k * sizeof(int8_t**));
+    int8_t** planes = malloc(k * sizeof(int8_t*));
+    for (int mod_idx = 0; mod_idx < k; mod_idx++) {
+        int8_t** mat = malloc(n * sizeof(int8_t*));
+        int8_t* plane = malloc((size_t) n * m * sizeof(int8_t));
+        for (int i = 0; i < n; i++) {
+            mat[i] = plane + (size_t) i * m;
+        }
+        rns->residues[mod_idx] = mat;
+        planes[mod_idx] = plane;
+    }
+    int8_matrix_to_rns_centered_planes(A, n, m, moduli, k, planes, rns_convert_default_kernel());
+    free(planes);
+
+    return rns;
+}
+
+void free_rns_matrix_centered(RNSMatrixCentered* rns) {
+    if (!rns) return;
+    for (int mod_idx = 0; mod_idx < rns->k; mod_idx++) {
+        if (rns->n > 0) free(rns->residues[mod_idx][0]);
         free(rns->residues[mod_idx]);
     }
     free(rns->residues);
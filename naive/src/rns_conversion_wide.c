@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "rns_conversion_wide.h"
+#include "xalloc.h"
+
+// Entries processed together; the per-limb loops run over one chunk
+#define WIDE_CHUNK 256
+// Entries per pool task
+#define WIDE_TASK_ENTRIES 4096
+// Limbs summed between two reductions: 16 pieces of 16 bits times a power
+// below m < 2^31, plus a residue, stays below 2^51
+#define WIDE_REDUCE_LIMBS 4
+
+static int wide_tasks(long count) {
+    return (int) ((count + WIDE_TASK_ENTRIES - 1) / WIDE_TASK_ENTRIES);
+}
+
+// acc mod m for acc < 2^51: the double quotient is off by at most one
+static inline uint64_t wide_reduce(uint64_t acc, uint64_t m, double inv) {
+    int64_t q = (int64_t) ((double) (int64_t) acc * inv);
+    int64_t r = (int64_t) acc - q * (int64_t) m;
+    r += r < 0 ? (int64_t) m : 0;
+    r -= r >= (int64_t) m ? (int64_t) m : 0;
+    return (uint64_t) r;
+}
+
+/////////////////////////////
+//   Wide -> residues      //
+/////////////////////////////
+
+typedef struct {
+    const WideMatrix* W;
+    int k;
+    const int* moduli;
+    const uint32_t* pw;        // pw[i·4·limbs + p] = 2^(16p) mod m_i
+    const uint32_t* sign_fix;  // m_i - (2^(64·limbs) mod m_i), added for negative entries
+    int* const* planes;
+} ToRNSJob;
+
+static void to_rns_chunk(const ToRNSJob* job, size_t base, int len) {
+    const WideMatrix* W = job->W;
+    size_t count = (size_t) W->n * W->m;
+    const uint64_t* top = W->data + (size_t) (W->limbs - 1) * count + base;
+    uint64_t acc[WIDE_CHUNK];
+
+    for (int i = 0; i < job->k; i++) {
+        uint64_t m = (uint64_t) job->moduli[i];
+        double inv = 1.0 / (double) m;
+        const uint32_t* pw = job->pw + (size_t) i * 4 * W->limbs;
+
+        for (int e = 0; e < len; e++) acc[e] = 0;
+        for (int l = 0; l < W->limbs; l++) {
+            const uint64_t* src = W->data + (size_t) l * count + base;
+            for (int p = 0; p < 4; p++) {
+                uint64_t c = pw[4 * l + p];
+                for (int e = 0; e < len; e++) {
+                    acc[e] += (uint64_t) (uint32_t) ((src[e] >> (16 * p)) & 0xffff) * c;
+                }
+            }
+            if ((l + 1) % WIDE_REDUCE_LIMBS == 0 || l + 1 == W->limbs) {
+                for (int e = 0; e < len; e++) acc[e] = wide_reduce(acc[e], m, inv);
+            }
+        }
+
+        // Two's complement: x = unsigned value - 2^(64·limbs) for negative entries
+        uint64_t fix = job->sign_fix[i];
+        int* out = job->planes[i] + base;
+        for (int e = 0; e < len; e++) {
+            uint64_t r = acc[e] + ((top[e] >> 63) ? fix : 0);
+            out[e] = (int) (r >= m ? r - m : r);
+        }
+    }
+}
+
+static void to_rns_task(void* arg, int t, int worker_idx) {
+    const ToRNSJob* job = (const ToRNSJob*) arg;
+    (void) worker_idx;
+    size_t count = (size_t) job->W->n * job->W->m;
+    size_t end = (size_t) (t + 1) * WIDE_TASK_ENTRIES;
+    if (end > count) end = count;
+    for (size_t base = (size_t) t * WIDE_TASK_ENTRIES; base < end; base += WIDE_CHUNK) {
+        to_rns_chunk(job, base, (int) (end - base < WIDE_CHUNK ? end - base : WIDE_CHUNK));
+    }
+}
+
+void wide_matrix_to_rns_planes(const WideMatrix* W, const int* moduli, int k, int* const* planes,
+                               ThreadPool* pool) {
+    int pieces = 4 * W->limbs;
+    uint32_t* pw = xmalloc((size_t) k * pieces * sizeof(uint32_t));
+    uint32_t* sign_fix = xmalloc(k * sizeof(uint32_t));
+    for (int i = 0; i < k; i++) {
+        uint64_t m = (uint64_t) moduli[i], p = 1 % m;
+        for (int j = 0; j < pieces; j++) {
+            pw[(size_t) i * pieces + j] = (uint32_t) p;
+            p = (p << 16) % m;
+        }
+        sign_fix[i] = (uint32_t) (p == 0 ? 0 : m - p);
+    }
+
+    ToRNSJob job = { W, k, moduli, pw, sign_fix, planes };
+    int tasks = wide_tasks((long) W->n * W->m);
+    thread_pool_run(pool, tasks, to_rns_task, &job);
+    free(pw);
+    free(sign_fix);
+}
+
+/////////////////////////////
+//   Residues -> wide      //
+/////////////////////////////
+
+typedef struct {
+    WideMatrix* W;
+    const CRTBasis* basis;
+    const int* const* residues;
+    int digits;                // 32-bit digits per entry, 2·limbs
+    const uint32_t* Mi;        // Mi[i·digits + c] = digit c of (M/m_i) mod 2^(64·limbs)
+    const uint32_t* M_pos;     // digits of M mod 2^(64·limbs)
+    const uint32_t* M_neg;     // digits of -M mod 2^(64·limbs)
+    long* out_of_range;        // one counter per task
+} FromRNSJob;
+
+static void from_rns_task(void* arg, int task, int worker_idx) {
+    const FromRNSJob* job = (const FromRNSJob*) arg;
+    (void) worker_idx;
+    const CRTBasis* b = job->basis;
+    WideMatrix* W = job->W;
+    size_t count = (size_t) W->n * W->m;
+    size_t end = (size_t) (task + 1) * WIDE_TASK_ENTRIES;
+    if (end > count) end = count;
+    int D = job->digits, k = b->k;
+
+    const int** res = xmalloc(k * sizeof(int*));
+    uint32_t** t = xmalloc(k * sizeof(uint32_t*));
+    uint32_t* t_data = xmalloc((size_t) k * WIDE_CHUNK * sizeof(uint32_t));
+    for (int i = 0; i < k; i++) t[i] = t_data + (size_t) i * WIDE_CHUNK;
+    uint64_t* col = xmalloc((size_t) D * WIDE_CHUNK * sizeof(uint64_t));
+    int32_t q[WIDE_CHUNK];
+    uint8_t flags[WIDE_CHUNK];
+    uint64_t carry[WIDE_CHUNK], qabs[WIDE_CHUNK];
+    long bad = 0;
+
+    for (size_t base = (size_t) task * WIDE_TASK_ENTRIES; base < end; base += WIDE_CHUNK) {
+        int len = (int) (end - base < WIDE_CHUNK ? end - base : WIDE_CHUNK);
+        for (int i = 0; i < k; i++) res[i] = job->residues[i] + base;
+        crt_centered_quotients(b, res, len, t, q, flags);
+
+        // Column c collects the low halves of the digit-c products and the
+        // high halves of the digit-(c-1) products, each below 2^32
+        for (size_t x = 0; x < (size_t) D * WIDE_CHUNK; x++) col[x] = 0;
+        for (int i = 0; i < k; i++) {
+            const uint32_t* d = job->Mi + (size_t) i * D;
+            const uint32_t* ti = t[i];
+            for (int c = 0; c < D; c++) {
+                uint64_t dc = d[c];
+                uint64_t* lo = col + (size_t) c * WIDE_CHUNK;
+                for (int e = 0; e < len; e++) lo[e] += ((uint64_t) ti[e] * dc) & 0xffffffffULL;
+                if (c + 1 < D) {
+                    uint64_t* hi = lo + WIDE_CHUNK;
+                    for (int e = 0; e < len; e++) hi[e] += ((uint64_t) ti[e] * dc) >> 32;
+                }
+            }
+        }
+        // - q·M, as |q|·M for q < 0 and q·(-M) otherwise
+        for (int e = 0; e < len; e++) qabs[e] = (uint64_t) (q[e] < 0 ? -(int64_t) q[e] : q[e]);
+        for (int c = 0; c < D; c++) {
+            uint64_t dp = job->M_pos[c], dn = job->M_neg[c];
+            uint64_t* lo = col + (size_t) c * WIDE_CHUNK;
+            for (int e = 0; e < len; e++) lo[e] += (qabs[e] * (q[e] < 0 ? dp : dn)) & 0xffffffffULL;
+            if (c + 1 < D) {
+                uint64_t* hi = lo + WIDE_CHUNK;
+                for (int e = 0; e < len; e++) hi[e] += (qabs[e] * (q[e] < 0 ? dp : dn)) >> 32;
+            }
+        }
+
+        // Carry propagation, two digits per limb
+        for (int e = 0; e < len; e++) carry[e] = 0;
+        for (int l = 0; l < W->limbs; l++) {
+            const uint64_t* c0 = col + (size_t) (2 * l) * WIDE_CHUNK;
+            const uint64_t* c1 = c0 + WIDE_CHUNK;
+            uint64_t* dst = W->data + (size_t) l * count + base;
+            for (int e = 0; e < len; e++) {
+                uint64_t x0 = c0[e] + carry[e];
+                uint64_t x1 = c1[e] + (x0 >> 32);
+                carry[e] = x1 >> 32;
+                dst[e] = (x1 << 32) | (x0 & 0xffffffffULL);
+            }
+        }
+
+        // A wrapped value shows up as a sign that disagrees with the fixed-point sign
+        const uint64_t* top = W->data + (size_t) (W->limbs - 1) * count + base;
+        for (int e = 0; e < len; e++) {
+            int neg = (flags[e] & CRT_NEGATIVE) != 0;
+            int sign_known = !(flags[e] & CRT_NEAR_ZERO);
+            if ((flags[e] & CRT_AMBIGUOUS) || (sign_known && neg != (int) (top[e] >> 63))) bad++;
+        }
+    }
+
+    job->out_of_range[task] = bad;
+    free(res);
+    free(t);
+    free(t_data);
+    free(col);
+}
+
+// x *= f modulo 2^(32·D), on D little-endian 32-bit digits
+static void digits_mul_small(uint32_t* x, int D, uint32_t f) {
+    uint64_t carry = 0;
+    for (int c = 0; c < D; c++) {
+        uint64_t p = (uint64_t) x[c] * f + carry;
+        x[c] = (uint32_t) p;
+        carry = p >> 32;
+    }
+}
+
+long wide_matrix_from_rns_planes(WideMatrix* W, const CRTBasis* basis, const int* const* residues,
+                                 ThreadPool* pool) {
+    int k = basis->k, D = 2 * W->limbs;
+    uint32_t* Mi = xmalloc((size_t) k * D * sizeof(uint32_t));
+    uint32_t* M_pos = xmalloc(D * sizeof(uint32_t));
+    uint32_t* M_neg = xmalloc(D * sizeof(uint32_t));
+
+    for (int c = 0; c < D; c++) M_pos[c] = c == 0;
+    for (int i = 0; i < k; i++) digits_mul_small(M_pos, D, (uint32_t) basis->moduli[i]);
+    for (int i = 0; i < k; i++) {
+        uint32_t* d = Mi + (size_t) i * D;
+        for (int c = 0; c < D; c++) d[c] = c == 0;
+        for (int j = 0; j < k; j++) {
+            if (j != i) digits_mul_small(d, D, (uint32_t) basis->moduli[j]);
+        }
+    }
+    // -M = ~M + 1
+    uint64_t carry = 1;
+    for (int c = 0; c < D; c++) {
+        uint64_t x = (uint64_t) (uint32_t) ~M_pos[c] + carry;
+        M_neg[c] = (uint32_t) x;
+        carry = x >> 32;
+    }
+
+    int tasks = wide_tasks((long) W->n * W->m);
+    long* counts = xmalloc(tasks * sizeof(long));
+    FromRNSJob job = { W, basis, residues, D, Mi, M_pos, M_neg, counts };
+    thread_pool_run(pool, tasks, from_rns_task, &job);
+
+    long out_of_range = 0;
+    for (int t = 0; t < tasks; t++) out_of_range += counts[t];
+    free(counts);
+    free(Mi);
+    free(M_pos);
+    free(M_neg);
+    return out_of_range;
+}
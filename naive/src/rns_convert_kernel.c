@@ -0,0 +1,38 @@
+#include <stdlib.h>
+#include <string.h>
+#include "rns_convert_kernel.h"
+
+static const char* kernel_names[RNS_CONVERT_NUM_KERNELS] = {"scalar", "avx2", "avx512"};
+
+const char* rns_convert_kernel_name(RNSConvertKernel kernel) {
+    if (kernel < 0 || kernel >= RNS_CONVERT_NUM_KERNELS) return "unknown";
+    return kernel_names[kernel];
+}
+
+int rns_convert_kernel_available(RNSConvertKernel kernel) {
+    switch (kernel) {
+        case RNS_CONVERT_SCALAR:
+            return 1;
+        case RNS_CONVERT_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case RNS_CONVERT_AVX512:
+            return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi");
+        default:
+            return 0;
+    }
+}
+
+RNSConvertKernel rns_convert_default_kernel(void) {
+    const char* env = getenv("RNS_CONVERT_KERNEL");
+    if (env) {
+        for (int kr = 0; kr < RNS_CONVERT_NUM_KERNELS; kr++) {
+            if (strcmp(env, kernel_names[kr]) == 0 && rns_convert_kernel_available(kr)) {
+                return (RNSConvertKernel) kr;
+            }
+        }
+    }
+    for (int kr = RNS_CONVERT_NUM_KERNELS - 1; kr > 0; kr--) {
+        if (rns_convert_kernel_available(kr)) return (RNSConvertKernel) kr;
+    }
+    return RNS_CONVERT_SCALAR;
+}
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "rns_expr.h"
+#include "rns_basis.h"
+#include "residue_gemm.h"
+#include "thread_pool.h"
+
+typedef enum {
+    EXPR_LEAF,
+    EXPR_MUL,
+    EXPR_ADD,
+    EXPR_SUB,
+    EXPR_SCALE
+} ExprOp;
+
+struct RNSExpr {
+    ExprOp op;
+    RNSExpr* a;
+    RNSExpr* b;
+    RNSHandle* leaf;   // EXPR_LEAF
+    int64_t s;         // EXPR_SCALE
+    int n, m;
+    long bound_bits;
+    int id;            // creation order, children always have smaller ids
+};
+
+struct RNSExprGraph {
+    RNSExpr** nodes;
+    int count, capacity;
+};
+
+// One term coef · a (b == NULL) or coef · a·b of a fused linear combination
+typedef struct {
+    uint32_t* coef;    // coefficient modulo each of the k moduli
+    RNSExpr* a;
+    RNSExpr* b;
+} ExprTerm;
+
+// A materialized node and the terms it is computed from
+typedef struct {
+    RNSExpr* node;
+    ExprTerm* terms;
+    int num_terms, capacity;
+} ExprStep;
+
+typedef struct {
+    RNSExprGraph* g;
+    ExprStep* steps;   // in increasing node id, the root last
+    int num_steps;
+    int* materialized; // per node id
+    int k;
+    const int* moduli;
+    RNSHandle* out;
+} ExprPlan;
+
+static long bits_of(uint64_t x) {
+    long bits = 0;
+    while (x) {
+        bits++;
+        x >>= 1;
+    }
+    return bits;
+}
+
+RNSExprGraph* rns_expr_graph_create(void) {
+    RNSExprGraph* g = malloc(sizeof(RNSExprGraph));
+    g->count = 0;
+    g->capacity = 16;
+    g->nodes = malloc(g->capacity * sizeof(RNSExpr*));
+    return g;
+}
+
+void rns_expr_graph_free(RNSExprGraph* g) {
+    if (g == NULL) return;
+    for (int i = 0; i < g->count; i++) free(g->nodes[i]);
+    free(g->nodes);
+    free(g);
+}
+
+static RNSExpr* new_node(RNSExprGraph* g, ExprOp op, RNSExpr* a, RNSExpr* b, int n, int m, long bound_bits) {
+    if (g->count == g->capacity) {
+        g->capacity *= 2;
+        g->nodes = realloc(g->nodes, g->capacity * sizeof(RNSExpr*));
+    }
+    RNSExpr* e = malloc(sizeof(RNSExpr));
+    e->op = op;
+    e->a = a;
+    e->b = b;
+    e->leaf = NULL;
+    e->s = 0;
+    e->n = n;
+    e->m = m;
+    e->bound_bits = bound_bits;
+    e->id = g->count;
+    g->nodes[g->count++] = e;
+    return e;
+}
+
+RNSExpr* rns_expr_leaf(RNSExprGraph* g, RNSHandle* H) {
+    if (H == NULL) return NULL;
+    RNSExpr* e = new_node(g, EXPR_LEAF, NULL, NULL, H->n, H->m, H->bound_bits);
+    e->leaf = H;
+    return e;
+}
+
+RNSExpr* rns_expr_mul(RNSExprGraph* g, RNSExpr* a, RNSExpr* b) {
+    if (a == NULL || b == NULL || a->m != b->n) return NULL;
+    long bits_k = bits_of((uint64_t) (a->m > 1 ? a->m - 1 : 0));
+    return new_node(g, EXPR_MUL, a, b, a->n, b->m, a->bound_bits + b->bound_bits + bits_k);
+}
+
+static RNSExpr* add_node(RNSExprGraph* g, ExprOp op, RNSExpr* a, RNSExpr* b) {
+    if (a == NULL || b == NULL || a->n != b->n || a->m != b->m) return NULL;
+    long bound_bits = (a->bound_bits > b->bound_bits ? a->bound_bits : b->bound_bits) + 1;
+    return new_node(g, op, a, b, a->n, a->m, bound_bits);
+}
+
+RNSExpr* rns_expr_add(RNSExprGraph* g, RNSExpr* a, RNSExpr* b) {
+    return add_node(g, EXPR_ADD, a, b);
+}
+
+RNSExpr* rns_expr_sub(RNSExprGraph* g, RNSExpr* a, RNSExpr* b) {
+    return add_node(g, EXPR_SUB, a, b);
+}
+
+RNSExpr* rns_expr_scale(RNSExprGraph* g, RNSExpr* a, int64_t s) {
+    if (a == NULL) return NULL;
+    uint64_t abs_s = s < 0 ? 0 - (uint64_t) s : (uint64_t) s;
+    RNSExpr* e = new_node(g, EXPR_SCALE, a, NULL, a->n, a->m, a->bound_bits + bits_of(abs_s));
+    e->s = s;
+    return e;
+}
+
+long rns_expr_bound_bits(const RNSExpr* e) {
+    return e->bound_bits;
+}
+
+int rns_expr_moduli_needed(const RNSExpr* e) {
+    return rns_handle_moduli_needed(e->bound_bits);
+}
+
+// Count the parents of every node reachable from e, visiting each node once
+static void count_uses(RNSExpr* e, int* uses, int* visited) {
+    if (visited[e->id]) return;
+    visited[e->id] = 1;
+    if (e->a) {
+        uses[e->a->id]++;
+        count_uses(e->a, uses, visited);
+    }
+    if (e->b) {
+        uses[e->b->id]++;
+        count_uses(e->b, uses, visited);
+    }
+}
+
+static void mark_gemm_operands(RNSExpr* e, int* materialized, int* visited) {
+    if (visited[e->id]) return;
+    visited[e->id] = 1;
+    if (e->op == EXPR_MUL) {
+        if (e->a->op != EXPR_LEAF) materialized[e->a->id] = 1;
+        if (e->b->op != EXPR_LEAF) materialized[e->b->id] = 1;
+    }
+    if (e->a) mark_gemm_operands(e->a, materialized, visited);
+    if (e->b) mark_gemm_operands(e->b, materialized, visited);
+}
+
+static void add_term(ExprStep* step, const uint32_t* coef, int k, RNSExpr* a, RNSExpr* b) {
+    if (step->num_terms == step->capacity) {
+        step->capacity = step->capacity ? 2 * step->capacity : 4;
+        step->terms = realloc(step->terms, step->capacity * sizeof(ExprTerm));
+    }
+    ExprTerm* t = &step->terms[step->num_terms++];
+    t->coef = malloc(k * sizeof(uint32_t));
+    for (int idx = 0; idx < k; idx++) t->coef[idx] = coef[idx];
+    t->a = a;
+    t->b = b;
+}
+
+// Flatten the add / sub / scale tree under e into terms of step, with coefficient coef
+static void flatten(ExprPlan* plan, ExprStep* step, RNSExpr* e, const uint32_t* coef) {
+    int k = plan->k;
+    if (e != step->node && (e->op == EXPR_LEAF || plan->materialized[e->id])) {
+        add_term(step, coef, k, e, NULL);
+        return;
+    }
+
+    uint32_t* c = malloc(k * sizeof(uint32_t));
+    switch (e->op) {
+    case EXPR_LEAF:
+        add_term(step, coef, k, e, NULL);
+        break;
+    case EXPR_MUL:
+        add_term(step, coef, k, e->a, e->b);
+        break;
+    case EXPR_ADD:
+        flatten(plan, step, e->a, coef);
+        flatten(plan, step, e->b, coef);
+        break;
+    case EXPR_SUB:
+        flatten(plan, step, e->a, coef);
+        for (int idx = 0; idx < k; idx++) c[idx] = coef[idx] ? (uint32_t) plan->moduli[idx] - coef[idx] : 0;
+        flatten(plan, step, e->b, c);
+        break;
+    case EXPR_SCALE:
+        for (int idx = 0; idx < k; idx++) {
+            int64_t mod = plan->moduli[idx];
+            uint64_t s = (uint64_t) ((e->s % mod + mod) % mod);
+            c[idx] = (uint32_t) (s * coef[idx] % (uint64_t) mod);
+        }
+        flatten(plan, step, e->a, c);
+        break;
+    }
+    free(c);
+}
+
+/*
+ * Compute one materialized node modulo mod. Every product and plain term of
+ * the linear combination goes into the same uint64 accumulators, which are
+ * reduced lazily and written once per row.
+ */
+static void run_step(const ExprStep* step, int idx, int mod, const int* const* data, int* dest) {
+    int n = step->node->n, p = step->node->m;
+    long window = residue_gemm_reduction_window(mod);
+    uint64_t* acc = malloc(p * sizeof(uint64_t));
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) acc[j] = 0;
+        long since_reduce = 0;
+
+        for (int t = 0; t < step->num_terms; t++) {
+            const ExprTerm* term = &step->terms[t];
+            uint64_t c = term->coef[idx];
+            if (c == 0) continue;
+
+            if (term->b) {
+                int inner = term->a->m;
+                const int* a_row = data[term->a->id] + (size_t) i * inner;
+                const int* B = data[term->b->id];
+                for (int r = 0; r < inner; r++) {
+                    uint64_t a = (uint64_t) a_row[r] * c % (uint64_t) mod;
+                    const int* b_row = B + (size_t) r * p;
+                    for (int j = 0; j < p; j++) acc[j] += a * (uint64_t) b_row[j];
+                    if (++since_reduce == window) {
+                        for (int j = 0; j < p; j++) acc[j] %= (uint64_t) mod;
+                        since_reduce = 0;
+                    }
+                }
+            } else {
+                const int* x_row = data[term->a->id] + (size_t) i * p;
+                for (int j = 0; j < p; j++) acc[j] += c * (uint64_t) x_row[j];
+                if (++since_reduce == window) {
+                    for (int j = 0; j < p; j++) acc[j] %= (uint64_t) mod;
+                    since_reduce = 0;
+                }
+            }
+        }
+
+        int* c_row = dest + (size_t) i * p;
+        for (int j = 0; j < p; j++) c_row[j] = (int) (acc[j] % (uint64_t) mod);
+    }
+    free(acc);
+}
+
+// Task idx evaluates the whole plan modulo moduli[idx]
+static void expr_modulus_task(void* arg, int idx, int worker_idx) {
+    ExprPlan* plan = (ExprPlan*) arg;
+    int mod = plan->moduli[idx];
+    (void) worker_idx;
+
+    const int** data = calloc(plan->g->count, sizeof(int*));
+    int** temps = calloc(plan->num_steps, sizeof(int*));
+    for (int i = 0; i < plan->g->count; i++) {
+        RNSExpr* e = plan->g->nodes[i];
+        // Leaves outside the evaluated subgraph may have fewer moduli
+        if (e->op == EXPR_LEAF && e->n > 0 && e->leaf->k > idx) data[i] = e->leaf->residues[idx][0];
+    }
+
+    for (int s = 0; s < plan->num_steps; s++) {
+        const ExprStep* step = &plan->steps[s];
+        int* dest;
+        if (s == plan->num_steps - 1) {
+            dest = plan->out->n > 0 ? plan->out->residues[idx][0] : NULL;
+        } else {
+            temps[s] = malloc((size_t) step->node->n * step->node->m * sizeof(int));
+            dest = temps[s];
+        }
+        run_step(step, idx, mod, data, dest);
+        data[step->node->id] = dest;
+    }
+
+    for (int s = 0; s < plan->num_steps; s++) free(temps[s]);
+    free(temps);
+    free(data);
+}
+
+RNSHandle* rns_expr_eval(RNSExprGraph* g, RNSExpr* e) {
+    if (e == NULL) return NULL;
+
+    // Static checks: the bound of the root fixes the basis of the whole evaluation
+    int k = rns_expr_moduli_needed(e);
+    int* moduli = rns_basis_primes(RNS_HANDLE_MODULUS_BITS, k);
+    if (moduli == NULL) {
+        fprintf(stderr, "Error: a %ld-bit expression needs more than the available %d-bit primes.\n",
+                e->bound_bits, RNS_HANDLE_MODULUS_BITS);
+        return NULL;
+    }
+    free(moduli);
+
+    ExprPlan plan;
+    plan.g = g;
+    plan.k = k;
+    plan.materialized = calloc(g->count, sizeof(int));
+    int* uses = calloc(g->count, sizeof(int));
+    int* visited = calloc(g->count, sizeof(int));
+    count_uses(e, uses, visited);
+
+    // Reachable leaves are extended before anything runs
+    for (int i = 0; i <= e->id; i++) {
+        RNSExpr* x = g->nodes[i];
+        if (!visited[x->id]) continue;
+        if (x->op == EXPR_LEAF) rns_handle_extend(x->leaf, k);
+        else if (uses[x->id] > 1) plan.materialized[x->id] = 1;
+    }
+    for (int i = 0; i < g->count; i++) visited[i] = 0;
+    mark_gemm_operands(e, plan.materialized, visited);
+    plan.materialized[e->id] = 1;
+
+    plan.out = allocate_rns_handle(e->n, e->m, k, e->bound_bits);
+    plan.moduli = plan.out->moduli;
+
+    plan.num_steps = 0;
+    plan.steps = malloc((e->id + 1) * sizeof(ExprStep));
+    uint32_t* one = malloc(k * sizeof(uint32_t));
+    for (int idx = 0; idx < k; idx++) one[idx] = 1;
+    for (int i = 0; i <= e->id; i++) {
+        if (!plan.materialized[i]) continue;
+        ExprStep* step = &plan.steps[plan.num_steps++];
+        step->node = g->nodes[i];
+        step->terms = NULL;
+        step->num_terms = 0;
+        step->capacity = 0;
+        flatten(&plan, step, step->node, one);
+    }
+    free(one);
+
+    thread_pool_run(thread_pool_get_default(), k, expr_modulus_task, &plan);
+
+    RNSHandle* out = plan.out;
+    for (int s = 0; s < plan.num_steps; s++) {
+        for (int t = 0; t < plan.steps[s].num_terms; t++) free(plan.steps[s].terms[t].coef);
+        free(plan.steps[s].terms);
+    }
+    free(plan.steps);
+    free(plan.materialized);
+    free(uses);
+    free(visited);
+    return out;
+}
@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "rns_handle.h"
+#include "rns_basis.h"
+#include "crt_reconstruct.h"
+#include "rns_residue_product.h"
+#include "thread_pool.h"
+#include "residue_planes.h"
+#include "xalloc.h"
+
+// Products t_i * (M/m_i mod p) summed before reducing: 128 * 2^56 < 2^64
+#define EXTEND_REDUCE_EVERY 128
+
+static long bits_of(uint64_t x) {
+    long bits = 0;
+    while (x) {
+        bits++;
+        x >>= 1;
+    }
+    return bits;
+}
+
+int rns_handle_moduli_needed(long bound_bits) {
+    // Sign bit plus one spare bit keep |x| far from M/2 for the fixed-point CRT
+    long needed = bound_bits + 2;
+    return (int) ((needed + RNS_HANDLE_MODULUS_BITS - 2) / (RNS_HANDLE_MODULUS_BITS - 1));
+}
+
+static int* handle_moduli(int k) {
+    int* moduli = rns_basis_primes(RNS_HANDLE_MODULUS_BITS, k);
+    if (moduli == NULL) {
+        fprintf(stderr, "Error: not enough %d-bit primes for %d RNS moduli.\n", RNS_HANDLE_MODULUS_BITS, k);
+        exit(EXIT_FAILURE);
+    }
+    return moduli;
+}
+
+RNSHandle* allocate_rns_handle(int n, int m, int k, long bound_bits) {
+    RNSHandle* H = xmalloc(sizeof(RNSHandle));
+    H->n = n;
+    H->m = m;
+    H->k = k;
+    H->bound_bits = bound_bits;
+    H->moduli = handle_moduli(k);
+    H->residues = xmalloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) H->residues[idx] = allocate_residue_plane(n, m, sizeof(int));
+    return H;
+}
+
+void free_rns_handle(RNSHandle* H) {
+    if (H == NULL) return;
+    for (int idx = 0; idx < H->k; idx++) free_residue_plane(H->residues[idx]);
+    free(H->residues);
+    free(H->moduli);
+    free(H);
+}
+
+RNSHandle* int64_matrix_to_rns_handle(int64_t** A, int n, int m) {
+    uint64_t max_abs = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            uint64_t a = A[i][j] < 0 ? 0 - (uint64_t) A[i][j] : (uint64_t) A[i][j];
+            if (a > max_abs) max_abs = a;
+        }
+    }
+    long bound_bits = bits_of(max_abs);
+    RNSHandle* H = allocate_rns_handle(n, m, rns_handle_moduli_needed(bound_bits), bound_bits);
+    for (int idx = 0; idx < H->k; idx++) {
+        int64_t mod = H->moduli[idx];
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                int64_t r = A[i][j] % mod;
+                H->residues[idx][i][j] = (int) (r < 0 ? r + mod : r);
+            }
+        }
+    }
+    return H;
+}
+
+RNSHandle* int8_matrix_to_rns_handle(int8_t** A, int n, int m) {
+    // |x| <= 128 fits in a single modulus
+    RNSHandle* H = allocate_rns_handle(n, m, 1, 8);
+    int mod = H->moduli[0];
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            int r = A[i][j];
+            H->residues[0][i][j] = r < 0 ? r + mod : r;
+        }
+    }
+    return H;
+}
+
+typedef struct {
+    const RNSHandle* H;
+    const CRTBasis* basis;
+    int64_t** C;
+} ToInt64Job;
+
+static void to_int64_row_task(void* arg, int i, int worker_idx) {
+    ToInt64Job* job = (ToInt64Job*) arg;
+    (void) worker_idx;
+
+    const int** rows = xmalloc(job->H->k * sizeof(int*));
+    for (int idx = 0; idx < job->H->k; idx++) rows[idx] = job->H->residues[idx][i];
+    crt_reconstruct_centered_int64(job->basis, rows, job->H->m, job->C[i]);
+    free(rows);
+}
+
+int64_t** rns_handle_to_int64_matrix(const RNSHandle* H) {
+    if (H->bound_bits > 63) return NULL;
+
+    CRTBasis* basis = crt_basis_create(H->moduli, H->k);
+    int64_t** C = xmalloc(H->n * sizeof(int64_t*));
+    for (int i = 0; i < H->n; i++) C[i] = xmalloc(H->m * sizeof(int64_t));
+
+    ToInt64Job job = { H, basis, C };
+    thread_pool_run(thread_pool_get_default(), H->n, to_int64_row_task, &job);
+    crt_basis_free(basis);
+    return C;
+}
+
+typedef struct {
+    int*** src;              // residues over basis
+    const CRTBasis* basis;   // basis of the k_src source moduli
+    int k_src;
+    int*** dst;              // residues modulo dst_moduli, written
+    const int* dst_moduli;
+    int k_dst;
+    int m;
+    uint64_t** Mi_mod;       // Mi_mod[j][i] = (M/m_i) mod p_j for each destination modulus p_j
+    uint64_t* M_mod;         // M mod p_j
+} ExtendJob;
+
+/*
+ * Residues of row i modulo the destination moduli. With t_i and
+ * q = round(sum t_i/m_i) from the fixed-point CRT, the centered value is
+ * sum_i t_i*(M/m_i) - q*M, which can be reduced modulo p_j term by term.
+ */
+static void extend_row_task(void* arg, int i, int worker_idx) {
+    ExtendJob* job = (ExtendJob*) arg;
+    int m = job->m, k_src = job->k_src;
+    (void) worker_idx;
+
+    const int** rows = xmalloc(k_src * sizeof(int*));
+    uint32_t** t = xmalloc(k_src * sizeof(uint32_t*));
+    uint32_t* t_data = xmalloc((size_t) k_src * m * sizeof(uint32_t));
+    int32_t* q = xmalloc(m * sizeof(int32_t));
+    uint8_t* flags = xmalloc(m * sizeof(uint8_t));
+    uint64_t* acc = xmalloc(m * sizeof(uint64_t));
+    for (int idx = 0; idx < k_src; idx++) {
+        rows[idx] = job->src[idx][i];
+        t[idx] = t_data + (size_t) idx * m;
+    }
+
+    crt_centered_quotients(job->basis, rows, m, t, q, flags);
+
+    for (int j = 0; j < job->k_dst; j++) {
+        uint64_t p = (uint64_t) job->dst_moduli[j];
+        const uint64_t* c = job->Mi_mod[j];
+        for (int e = 0; e < m; e++) acc[e] = 0;
+        for (int idx = 0; idx < k_src; idx++) {
+            const uint32_t* ti = t[idx];
+            uint64_t ci = c[idx];
+            for (int e = 0; e < m; e++) acc[e] += (uint64_t) ti[e] * ci;
+            if (idx % EXTEND_REDUCE_EVERY == EXTEND_REDUCE_EVERY - 1) {
+                for (int e = 0; e < m; e++) acc[e] %= p;
+            }
+        }
+        int* out = job->dst[j][i];
+        uint64_t M_mod = job->M_mod[j];
+        for (int e = 0; e < m; e++) {
+            uint64_t qm = (uint64_t) q[e] * M_mod % p;
+            out[e] = (int) ((acc[e] % p + p - qm) % p);
+        }
+    }
+
+    free(rows);
+    free(t);
+    free(t_data);
+    free(q);
+    free(flags);
+    free(acc);
+}
+
+// Residues modulo dst_moduli of the n × m values held by k_src residue planes
+static void extend_planes(int*** src, const int* src_moduli, int k_src, int*** dst, const int* dst_moduli,
+                          int k_dst, int n, int m) {
+    ExtendJob job = { src, NULL, k_src, dst, dst_moduli, k_dst, m, NULL, NULL };
+    job.Mi_mod = xmalloc(k_dst * sizeof(uint64_t*));
+    job.M_mod = xmalloc(k_dst * sizeof(uint64_t));
+    for (int j = 0; j < k_dst; j++) {
+        uint64_t p = (uint64_t) dst_moduli[j];
+        uint64_t* c = xmalloc(k_src * sizeof(uint64_t));
+        uint64_t M_mod = 1;
+        for (int idx = 0; idx < k_src; idx++) {
+            c[idx] = 1;
+            for (int l = 0; l < k_src; l++) {
+                if (l != idx) c[idx] = c[idx] * (uint64_t) src_moduli[l] % p;
+            }
+            M_mod = M_mod * (uint64_t) src_moduli[idx] % p;
+        }
+        job.Mi_mod[j] = c;
+        job.M_mod[j] = M_mod;
+    }
+    CRTBasis* basis = crt_basis_create(src_moduli, k_src);
+    job.basis = basis;
+
+    thread_pool_run(thread_pool_get_default(), n, extend_row_task, &job);
+
+    crt_basis_free(basis);
+    for (int j = 0; j < k_dst; j++) free(job.Mi_mod[j]);
+    free(job.Mi_mod);
+    free(job.M_mod);
+}
+
+void rns_handle_extend(RNSHandle* H, int k) {
+    if (k <= H->k) return;
+    int k_old = H->k;
+
+    free(H->moduli);
+    H->moduli = handle_moduli(k);
+    H->residues = xrealloc(H->residues, k * sizeof(int**));
+    for (int j = k_old; j < k; j++) H->residues[j] = allocate_residue_plane(H->n, H->m, sizeof(int));
+
+    extend_planes(H->residues, H->moduli, k_old, H->residues + k_old, H->moduli + k_old, k - k_old, H->n, H->m);
+    H->k = k;
+}
+
+RNSHandle* rns_handle_mul(RNSHandle* A, RNSHandle* B) {
+    if (A->m != B->n) return NULL;
+
+    long bits_k = bits_of((uint64_t) (A->m > 1 ? A->m - 1 : 0));
+    long bound_bits = A->bound_bits + B->bound_bits + bits_k;
+    int k = rns_handle_moduli_needed(bound_bits);
+    rns_handle_extend(A, k);
+    rns_handle_extend(B, k);
+
+    // Only the first k planes of A and B take part in the product. The handle
+    // primes are the fp64 product basis; the int8 one gets the operands by
+    // basis extension and hands the result back the same way.
+    RNSHandle* C = allocate_rns_handle(A->n, B->m, k, bound_bits);
+    ThreadPool* pool = thread_pool_get_default();
+    RNSProductBackend backend = rns_product_backend_choose(bound_bits + 2);
+    if (backend == RNS_PRODUCT_FP64) {
+        rns_residue_product(A->residues, B->residues, C->residues, C->moduli, k, A->n, A->m, B->m, backend, pool);
+        return C;
+    }
+
+    int kp;
+    int* moduli = rns_product_basis(bound_bits + 2, backend, &kp);
+    int*** Ares = allocate_residue_planes(kp, A->n, A->m, sizeof(int));
+    int*** Bres = allocate_residue_planes(kp, B->n, B->m, sizeof(int));
+    int*** Cres = allocate_residue_planes(kp, C->n, C->m, sizeof(int));
+    extend_planes(A->residues, A->moduli, k, Ares, moduli, kp, A->n, A->m);
+    extend_planes(B->residues, B->moduli, k, Bres, moduli, kp, B->n, B->m);
+    rns_residue_product(Ares, Bres, Cres, moduli, kp, A->n, A->m, B->m, backend, pool);
+    extend_planes(Cres, moduli, kp, C->residues, C->moduli, k, C->n, C->m);
+
+    free_residue_planes(Ares, kp);
+    free_residue_planes(Bres, kp);
+    free_residue_planes(Cres, kp);
+    free(moduli);
+    return C;
+}
+
+// C = A + sign * B plane by plane
+static RNSHandle* add_signed(RNSHandle* A, RNSHandle* B, int sign) {
+    if (A->n != B->n || A->m != B->m) return NULL;
+
+    long bound_bits = (A->bound_bits > B->bound_bits ? A->bound_bits : B->bound_bits) + 1;
+    int k = rns_handle_moduli_needed(bound_bits);
+    rns_handle_extend(A, k);
+    rns_handle_extend(B, k);
+
+    RNSHandle* C = allocate_rns_handle(A->n, A->m, k, bound_bits);
+    size_t size = (size_t) A->n * A->m;
+    for (int idx = 0; idx < k; idx++) {
+        int mod = C->moduli[idx];
+        const int* a = A->n > 0 ? A->residues[idx][0] : NULL;
+        const int* b = A->n > 0 ? B->residues[idx][0] : NULL;
+        int* c = C->n > 0 ? C->residues[idx][0] : NULL;
+        if (sign > 0) {
+            for (size_t e = 0; e < size; e++) {
+                int s = a[e] + b[e];
+                c[e] = s >= mod ? s - mod : s;
+            }
+        } else {
+            for (size_t e = 0; e < size; e++) {
+                int s = a[e] - b[e];
+                c[e] = s < 0 ? s + mod : s;
+            }
+        }
+    }
+    return C;
+}
+
+RNSHandle* rns_handle_add(RNSHandle* A, RNSHandle* B) {
+    return add_signed(A, B, 1);
+}
+
+RNSHandle* rns_handle_sub(RNSHandle* A, RNSHandle* B) {
+    return add_signed(A, B, -1);
+}
+
+RNSHandle* rns_handle_scale(RNSHandle* A, int64_t s) {
+    uint64_t abs_s = s < 0 ? 0 - (uint64_t) s : (uint64_t) s;
+    long bound_bits = A->bound_bits + bits_of(abs_s);
+    int k = rns_handle_moduli_needed(bound_bits);
+    rns_handle_extend(A, k);
+
+    RNSHandle* C = allocate_rns_handle(A->n, A->m, k, bound_bits);
+    size_t size = (size_t) A->n * A->m;
+    for (int idx = 0; idx < k; idx++) {
+        int64_t mod = C->moduli[idx];
+        uint64_t sr = (uint64_t) ((s % mod + mod) % mod);
+        const int* a = A->n > 0 ? A->residues[idx][0] : NULL;
+        int* c = C->n > 0 ? C->residues[idx][0] : NULL;
+        for (size_t e = 0; e < size; e++) {
+            c[e] = (int) ((uint64_t) a[e] * sr % (uint64_t) mod);
+        }
+    }
+    return C;
+}
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "rns_handle_gmp.h"
+#include "crt_reconstruct_gmp.h"
+#include "matrix_utils_gmp.h"
+#include "thread_pool.h"
+
+RNSHandle* mpz_matrix_to_rns_handle(mpz_t** A, int n, int m) {
+    long bound_bits = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            if (mpz_sgn(A[i][j]) == 0) continue;
+            long b = (long) mpz_sizeinbase(A[i][j], 2);
+            if (b > bound_bits) bound_bits = b;
+        }
+    }
+
+    RNSHandle* H = allocate_rns_handle(n, m, rns_handle_moduli_needed(bound_bits), bound_bits);
+    for (int idx = 0; idx < H->k; idx++) {
+        unsigned long mod = (unsigned long) H->moduli[idx];
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                H->residues[idx][i][j] = (int) mpz_fdiv_ui(A[i][j], mod);
+            }
+        }
+    }
+    return H;
+}
+
+typedef struct {
+    const RNSHandle* H;
+    const CRTBasisMpz* basis;
+    mpz_t** C;
+} ToMpzJob;
+
+static void to_mpz_row_task(void* arg, int i, int worker_idx) {
+    ToMpzJob* job = (ToMpzJob*) arg;
+    (void) worker_idx;
+
+    const int** rows = malloc(job->H->k * sizeof(int*));
+    for (int idx = 0; idx < job->H->k; idx++) rows[idx] = job->H->residues[idx][i];
+    crt_reconstruct_centered_mpz(job->basis, rows, job->H->m, job->C[i]);
+    free(rows);
+}
+
+mpz_t** rns_handle_to_mpz_matrix(const RNSHandle* H) {
+    CRTBasisMpz* basis = crt_basis_mpz_create(H->moduli, H->k);
+    // Room for the CRT sum of the basis before its reduction
+    long bits = 2 * GMP_NUMB_BITS;
+    for (int idx = 0; idx < H->k; idx++) bits += 32 - __builtin_clz((unsigned) H->moduli[idx]);
+    ToMpzJob job = { H, basis, allocate_mpz_matrix_arena(H->n, H->m, bits) };
+    thread_pool_run(thread_pool_get_default(), H->n, to_mpz_row_task, &job);
+    crt_basis_mpz_free(basis);
+    return job.C;
+}
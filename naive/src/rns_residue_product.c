@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "rns_residue_product.h"
+#include "residue_gemm_int8.h"
+#include "residue_gemm_fp64.h"
+#include "rns_basis.h"
+
+static const char* backend_names[RNS_PRODUCT_NUM_BACKENDS] = {"int8", "fp64"};
+
+const char* rns_product_backend_name(RNSProductBackend backend) {
+    if (backend < 0 || backend >= RNS_PRODUCT_NUM_BACKENDS) return "unknown";
+    return backend_names[backend];
+}
+
+int rns_product_modulus_bits(RNSProductBackend backend) {
+    return backend == RNS_PRODUCT_INT8 ? RNS_PRODUCT_INT8_MODULUS_BITS : RNS_PRODUCT_FP64_MODULUS_BITS;
+}
+
+RNSProductBackend rns_product_backend_choose(long bound_bits) {
+    int int8_fits = bound_bits <= RNS_PRODUCT_INT8_MAX_BITS;
+    const char* env = getenv("RNS_PRODUCT_BACKEND");
+    if (env && strcmp(env, "fp64") == 0) return RNS_PRODUCT_FP64;
+    if (env && strcmp(env, "int8") == 0 && int8_fits) return RNS_PRODUCT_INT8;
+    return RNS_PRODUCT_FP64;
+}
+
+int* rns_product_basis(long bound_bits, RNSProductBackend backend, int* out_k) {
+    return rns_basis_select(bound_bits, rns_product_modulus_bits(backend), out_k);
+}
+
+typedef struct {
+    int*** planes;
+    const int* moduli;
+    int cols;
+} CenterSource;
+
+// Rows of an int residue plane as centered int8 residues
+static void center_rows(const void* arg, int plane, int row_begin, int rows, int8_t* dst, long ld) {
+    const CenterSource* src = (const CenterSource*) arg;
+    int mod = src->moduli[plane], half = mod / 2;
+    for (int i = 0; i < rows; i++) {
+        const int* row = src->planes[plane][row_begin + i];
+        int8_t* out = dst + (size_t) i * ld;
+        for (int j = 0; j < src->cols; j++) out[j] = (int8_t) (row[j] > half ? row[j] - mod : row[j]);
+    }
+}
+
+void rns_residue_product(int*** Ares, int*** Bres, int*** Cres, const int* moduli, int k,
+                         int n, int m, int p, RNSProductBackend backend, ThreadPool* pool) {
+    if (backend == RNS_PRODUCT_INT8) {
+        CenterSource a = { Ares, moduli, m };
+        CenterSource b = { Bres, moduli, p };
+        residue_gemm_int8_rns_source(center_rows, &a, center_rows, &b, Cres, moduli, k, n, m, p,
+                                     residue_gemm_int8_default_kernel(), pool);
+    } else {
+        residue_gemm_fp64_rns(Ares, Bres, Cres, moduli, k, n, m, p, residue_gemm_fp64_default_kernel(), pool);
+    }
+}
@@ -0,0 +1,228 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "thread_pool.h"
+#include "xalloc.h"
+
+struct ThreadPool {
+    int num_threads;
+    pthread_t* threads;
+    int* cpus;                // CPUs of the process affinity mask, NULL if unpinned
+    int num_cpus;
+
+    pthread_mutex_t run_lock; // held for a whole thread_pool_run
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+
+    // Current job, published to the workers by incrementing generation
+    thread_pool_task_fn fn;
+    void* arg;
+    int num_tasks;
+    unsigned long generation;
+    int pending;              // workers that have not finished the current job
+    int shutdown;
+};
+
+typedef struct {
+    ThreadPool* pool;
+    int worker_idx;
+} WorkerArgs;
+
+// Pool whose tasks the current thread is executing, so a task that runs the same pool again
+// executes sequentially instead of waiting on itself
+static __thread ThreadPool* current_pool = NULL;
+
+// Worker w runs on the w-th CPU (modulo their number) the process is allowed to use
+static void pin_to_cpu(ThreadPool* pool, int worker_idx) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(pool->cpus[worker_idx % pool->num_cpus], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+}
+
+// CPUs of the process affinity mask (taskset, cgroups), or NULL if it cannot be read
+static int* allowed_cpus(int* count) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set) != 0 || CPU_COUNT(&set) == 0) return NULL;
+    int* cpus = malloc(CPU_COUNT(&set) * sizeof(int));
+    if (cpus == NULL) return NULL;
+    int n = 0;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) cpus[n++] = c;
+    }
+    *count = n;
+    return cpus;
+}
+
+// Execute the static share of tasks that belongs to worker w
+static void run_share(ThreadPool* pool, int w) {
+    int T = pool->num_threads;
+    int begin = (int) ((long) w * pool->num_tasks / T);
+    int end = (int) ((long) (w + 1) * pool->num_tasks / T);
+    for (int t = begin; t < end; t++) {
+        pool->fn(pool->arg, t, w);
+    }
+}
+
+static void* worker_main(void* p) {
+    WorkerArgs* wa = (WorkerArgs*) p;
+    ThreadPool* pool = wa->pool;
+    int w = wa->worker_idx;
+    if (pool->cpus) pin_to_cpu(pool, w);
+    free(wa);
+    current_pool = pool;
+
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_share(pool, w);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->work_done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+int thread_pool_default_threads(void) {
+    const char* env = getenv("RNS_NUM_THREADS");
+    if (env) {
+        int t = atoi(env);
+        if (t > 0) return t;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0 && CPU_COUNT(&set) > 0) return CPU_COUNT(&set);
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    return ncpu > 0 ? (int) ncpu : 1;
+}
+
+ThreadPool* thread_pool_create(int num_threads, int pin_threads) {
+    if (num_threads <= 0) num_threads = thread_pool_default_threads();
+
+    ThreadPool* pool = xmalloc(sizeof(ThreadPool));
+    pool->num_threads = num_threads;
+    pool->fn = NULL;
+    pool->arg = NULL;
+    pool->num_tasks = 0;
+    pool->generation = 0;
+    pool->pending = 0;
+    pool->shutdown = 0;
+    pool->num_cpus = 0;
+    pool->cpus = pin_threads ? allowed_cpus(&pool->num_cpus) : NULL;
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    // Worker 0 is the calling thread, pinned to the first CPU while it runs tasks
+    pool->threads = xcalloc(num_threads, sizeof(pthread_t));
+    for (int w = 1; w < num_threads; w++) {
+        WorkerArgs* wa = xmalloc(sizeof(WorkerArgs));
+        wa->pool = pool;
+        wa->worker_idx = w;
+        if (pthread_create(&pool->threads[w], NULL, worker_main, wa) != 0) {
+            fprintf(stderr, "Error: failed to create worker thread %d.\n", w);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return pool;
+}
+
+void thread_pool_run(ThreadPool* pool, int num_tasks, thread_pool_task_fn fn, void* arg) {
+    if (num_tasks <= 0) return;
+
+    if (pool == NULL || pool->num_threads == 1 || num_tasks == 1 || current_pool == pool) {
+        for (int t = 0; t < num_tasks; t++) fn(arg, t, 0);
+        return;
+    }
+
+    // One job at a time: concurrent callers wait here for the pool
+    pthread_mutex_lock(&pool->run_lock);
+    cpu_set_t saved_mask;
+    int restore_mask = pool->cpus && pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_mask) == 0;
+    if (restore_mask) pin_to_cpu(pool, 0);
+    ThreadPool* outer_pool = current_pool;
+    current_pool = pool;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->num_tasks = num_tasks;
+    pool->pending = pool->num_threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_share(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    current_pool = outer_pool;
+    if (restore_mask) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_mask);
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+int thread_pool_size(const ThreadPool* pool) {
+    return pool ? pool->num_threads : 1;
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int w = 1; w < pool->num_threads; w++) {
+        pthread_join(pool->threads[w], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->run_lock);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->threads);
+    free(pool->cpus);
+    free(pool);
+}
+
+static ThreadPool* default_pool = NULL;
+static pthread_once_t default_pool_once = PTHREAD_ONCE_INIT;
+
+static void destroy_default_pool(void) {
+    thread_pool_destroy(default_pool);
+    default_pool = NULL;
+}
+
+static void create_default_pool(void) {
+    default_pool = thread_pool_create(thread_pool_default_threads(), 1);
+    atexit(destroy_default_pool);
+}
+
+ThreadPool* thread_pool_get_default(void) {
+    pthread_once(&default_pool_once, create_default_pool);
+    return default_pool;
+}
@@ -0,0 +1,189 @@
+// Converts text matrices ("rows cols" followed by the entries, as in the
+// .ssv trees under amx/new_version/matrices/) to binary matrix files.
+//
+//   ssv_to_matfile [-t int8|uint8|int16|int32] [-f] PATH...
+//
+// Each PATH is a file or a directory searched recursively for *.ssv; X.ssv
+// is written to X.mat next to it (existing files are kept unless -f). Without
+// -t the type is the narrowest of int8, uint8, int16, int32 holding all values.
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include "matrix_file.h"
+#include "xalloc.h"
+
+static MatrixFileType forced_type = 0;
+static int overwrite = 0;
+static int failures = 0;
+static int converted = 0;
+
+static const char* type_name(MatrixFileType type) {
+    switch (type) {
+        case MATRIX_FILE_INT8: return "int8";
+        case MATRIX_FILE_UINT8: return "uint8";
+        case MATRIX_FILE_INT16: return "int16";
+        case MATRIX_FILE_INT32: return "int32";
+        default: return "?";
+    }
+}
+
+static int fits(MatrixFileType type, long lo, long hi) {
+    switch (type) {
+        case MATRIX_FILE_INT8: return lo >= INT8_MIN && hi <= INT8_MAX;
+        case MATRIX_FILE_UINT8: return lo >= 0 && hi <= UINT8_MAX;
+        case MATRIX_FILE_INT16: return lo >= INT16_MIN && hi <= INT16_MAX;
+        case MATRIX_FILE_INT32: return lo >= INT32_MIN && hi <= INT32_MAX;
+        default: return 0;
+    }
+}
+
+static char* read_all(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = xmalloc(size + 1);
+    size_t got = fread(text, 1, size, f);
+    fclose(f);
+    text[got] = '\0';
+    return text;
+}
+
+static int convert(const char* path) {
+    char* text = read_all(path);
+    if (text == NULL) {
+        fprintf(stderr, "%s: could not read\n", path);
+        return -1;
+    }
+
+    char* p = text;
+    char* end;
+    long rows = strtol(p, &end, 10);
+    long cols = (end != p) ? strtol(p = end, &end, 10) : -1;
+    if (end == p || rows < 0 || cols < 0 || rows > INT32_MAX || cols > INT32_MAX) {
+        fprintf(stderr, "%s: bad header\n", path);
+        free(text);
+        return -1;
+    }
+    long count = rows * cols;
+    long* values = malloc((count > 0 ? count : 1) * sizeof(long));
+    long lo = 0, hi = 0;
+    for (long e = 0; e < count; e++) {
+        p = end;
+        errno = 0;
+        values[e] = strtol(p, &end, 10);
+        if (end == p || errno == ERANGE) {
+            fprintf(stderr, "%s: bad or missing entry at (%ld, %ld)\n", path, e / cols, e % cols);
+            free(values);
+            free(text);
+            return -1;
+        }
+        if (values[e] < lo) lo = values[e];
+        if (values[e] > hi) hi = values[e];
+    }
+    free(text);
+
+    MatrixFileType type = forced_type;
+    if (type == 0) {
+        const MatrixFileType order[] = { MATRIX_FILE_INT8, MATRIX_FILE_UINT8, MATRIX_FILE_INT16, MATRIX_FILE_INT32 };
+        for (int t = 0; t < 4 && type == 0; t++) {
+            if (fits(order[t], lo, hi)) type = order[t];
+        }
+    }
+    if (type == 0 || !fits(type, lo, hi)) {
+        fprintf(stderr, "%s: values in [%ld, %ld] do not fit %s\n", path, lo, hi, type ? type_name(type) : "int32");
+        free(values);
+        return -1;
+    }
+
+    size_t elem = matrix_file_elem_size(type);
+    unsigned char* packed = malloc(count > 0 ? count * elem : 1);
+    for (long e = 0; e < count; e++) {
+        switch (type) {
+            case MATRIX_FILE_INT8: ((int8_t*) packed)[e] = (int8_t) values[e]; break;
+            case MATRIX_FILE_UINT8: ((uint8_t*) packed)[e] = (uint8_t) values[e]; break;
+            case MATRIX_FILE_INT16: ((int16_t*) packed)[e] = (int16_t) values[e]; break;
+            default: ((int32_t*) packed)[e] = (int32_t) values[e]; break;
+        }
+    }
+    free(values);
+
+    size_t len = strlen(path);
+    char* out = malloc(len + 5);
+    memcpy(out, path, len + 1);
+    if (len > 4 && strcmp(out + len - 4, ".ssv") == 0) out[len - 4] = '\0';
+    strcat(out, ".mat");
+
+    struct stat sb;
+    int status = 0;
+    if (!overwrite && stat(out, &sb) == 0) {
+        printf("%s: exists, skipped\n", out);
+    } else {
+        const void* planes[1] = { packed };
+        status = matrix_file_write(out, type, (int) rows, (int) cols, 1, planes, cols, NULL);
+        if (status != 0) {
+            fprintf(stderr, "%s: write failed\n", out);
+        } else {
+            printf("%s: %ld x %ld %s\n", out, rows, cols, type_name(type));
+            converted++;
+        }
+    }
+    free(out);
+    free(packed);
+    return status;
+}
+
+static int visit(const char* path, const struct stat* sb, int kind, struct FTW* ftw) {
+    (void) sb;
+    (void) ftw;
+    size_t len = strlen(path);
+    if (kind == FTW_F && len > 4 && strcmp(path + len - 4, ".ssv") == 0) {
+        if (convert(path) != 0) failures++;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int first = 1;
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "-f") == 0) {
+            overwrite = 1;
+            first++;
+        } else if (strcmp(argv[first], "-t") == 0 && first + 1 < argc) {
+            const char* t = argv[first + 1];
+            forced_type = !strcmp(t, "int8") ? MATRIX_FILE_INT8 : !strcmp(t, "uint8") ? MATRIX_FILE_UINT8
+                        : !strcmp(t, "int16") ? MATRIX_FILE_INT16 : !strcmp(t, "int32") ? MATRIX_FILE_INT32 : 0;
+            if (forced_type == 0) {
+                fprintf(stderr, "Unknown type '%s'\n", t);
+                return EXIT_FAILURE;
+            }
+            first += 2;
+        } else {
+            break;
+        }
+    }
+    if (first >= argc) {
+        fprintf(stderr, "Usage: %s [-t int8|uint8|int16|int32] [-f] PATH...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int a = first; a < argc; a++) {
+        struct stat sb;
+        if (stat(argv[a], &sb) != 0) {
+            fprintf(stderr, "%s: not found\n", argv[a]);
+            failures++;
+        } else if (S_ISDIR(sb.st_mode)) {
+            nftw(argv[a], visit, 16, FTW_PHYS);
+        } else if (convert(argv[a]) != 0) {
+            failures++;
+        }
+    }
+    printf("%d converted, %d failed\n", converted, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
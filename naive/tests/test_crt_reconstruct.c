@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include <assert.h>
+#include "crt_reconstruct.h"
+#include "crt_reconstruct_gmp.h"
+#include "rns_basis.h"
+
+// Residues of count values modulo each modulus, as contiguous planes
+static int** residues_of(mpz_t* values, long count, const int* moduli, int k) {
+    int** res = malloc(k * sizeof(int*));
+    for (int i = 0; i < k; i++) {
+        res[i] = malloc(count * sizeof(int));
+        for (long e = 0; e < count; e++) {
+            res[i][e] = (int) mpz_fdiv_ui(values[e], (unsigned long) moduli[i]);
+        }
+    }
+    return res;
+}
+
+static void free_residues(int** res, int k) {
+    for (int i = 0; i < k; i++) free(res[i]);
+    free(res);
+}
+
+// Reconstruct count values drawn within ±2^bits (and ±(M-1)/2 at the ends) through both outputs
+static void check_basis(const int* moduli, int k, long count, int bits, gmp_randstate_t state) {
+    CRTBasisMpz* basis = crt_basis_mpz_create(moduli, k);
+    assert(basis != NULL);
+
+    mpz_t* values = malloc(count * sizeof(mpz_t));
+    mpz_t* out = malloc(count * sizeof(mpz_t));
+    for (long e = 0; e < count; e++) {
+        mpz_init(values[e]);
+        mpz_init(out[e]);
+        mpz_urandomb(values[e], state, (mp_bitcnt_t) bits);
+        if (e % 2 == 1) mpz_neg(values[e], values[e]);
+    }
+    mpz_set_ui(values[0], 0);
+    mpz_sub_ui(values[1], basis->M, 1);
+    mpz_fdiv_q_2exp(values[1], values[1], 1);       // (M-1)/2, the largest value
+    mpz_neg(values[2], values[1]);                  // -(M-1)/2, the smallest value
+    mpz_set_si(values[3], -1);
+
+    int** res = residues_of(values, count, moduli, k);
+    long fallbacks = crt_reconstruct_centered_mpz(basis, (const int* const*) res, count, out);
+    for (long e = 0; e < count; e++) assert(mpz_cmp(out[e], values[e]) == 0);
+    assert(fallbacks <= 2);
+
+    // int64 output: exact wherever the value fits, flagged otherwise when M is small enough
+    int64_t* out64 = malloc(count * sizeof(int64_t));
+    long bad = crt_reconstruct_centered_int64(basis->basis, (const int* const*) res, count, out64);
+    long expected_bad = 0;
+    for (long e = 0; e < count; e++) {
+        if (mpz_fits_slong_p(values[e]) && mpz_sizeinbase(values[e], 2) < 62) {
+            assert(out64[e] == mpz_get_si(values[e]));
+        } else if (mpz_sizeinbase(values[e], 2) > 64) {
+            expected_bad++;
+        }
+    }
+    if (k <= 3) assert(bad >= expected_bad);     // M < 2^127 / E: every overflow is detected
+
+    free(out64);
+    free_residues(res, k);
+    for (long e = 0; e < count; e++) {
+        mpz_clear(values[e]);
+        mpz_clear(out[e]);
+    }
+    free(values);
+    free(out);
+    crt_basis_mpz_free(basis);
+}
+
+int main() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 7);
+
+    // 8-bit moduli as used by the int8 kernels (M ~ 2^23)
+    int small[] = {251, 241, 239};
+    check_basis(small, 3, 1000, 21, state);
+
+    // 28-bit primes, M ~ 2^84: int64 outputs are exact up to 2^62, larger ones are flagged
+    int* primes = rns_basis_primes(28, 24);
+    check_basis(primes, 3, 600, 60, state);
+    check_basis(primes, 3, 600, 80, state);
+
+    // Large basis, M ~ 2^670, values well inside the range
+    check_basis(primes, 24, 700, 600, state);
+    free(primes);
+
+    // A zero residue vector and a residue vector of -1 on the int64 path
+    CRTBasis* b = crt_basis_create(small, 3);
+    int zeros[3] = {0, 0, 0}, minus_one[3] = {250, 240, 238};
+    const int* r0[3] = {&zeros[0], &zeros[1], &zeros[2]};
+    const int* r1[3] = {&minus_one[0], &minus_one[1], &minus_one[2]};
+    int64_t v;
+    assert(crt_reconstruct_centered_int64(b, r0, 1, &v) == 0 && v == 0);
+    assert(crt_reconstruct_centered_int64(b, r1, 1, &v) == 0 && v == -1);
+    crt_basis_free(b);
+
+    // Moduli that are not pairwise coprime
+    int not_coprime[] = {15, 7, 21};
+    assert(crt_basis_create(not_coprime, 3) == NULL);
+    assert(crt_basis_mpz_create(not_coprime, 3) == NULL);
+
+    gmp_randclear(state);
+    printf("test_crt_reconstruct: passed\n");
+    return 0;
+}
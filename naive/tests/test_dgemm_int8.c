@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+#include "dgemm_int8.h"
+#include "matrix_utils_wide.h"
+#include "thread_pool.h"
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Uniform in [1, 2) with a full 53-bit mantissa, random sign
+static double random_binade(uint64_t* state) {
+    double x = 1.0 + (double) (next_random(state) >> 12) * 0x1p-52;
+    return (next_random(state) & 1) ? -x : x;
+}
+
+static void naive_dgemm(const double* A, const double* B, double* C, int n, int m, int p) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            double s = 0.0;
+            for (int r = 0; r < m; r++) s += A[(size_t) i * m + r] * B[(size_t) r * p + j];
+            C[(size_t) i * p + j] = s;
+        }
+    }
+}
+
+// Entries of A and B in [1, 2) times one power of two per row / column: the
+// scaling is lossless, so the result must be the correctly rounded product,
+// here computed exactly in 128-bit integers (m <= 64)
+static void check_correctly_rounded(int n, int m, int p, ResidueInt8Kernel kernel, ThreadPool* pool,
+                                    uint64_t* state) {
+    double* A = malloc((size_t) n * m * sizeof(double));
+    double* B = malloc((size_t) m * p * sizeof(double));
+    double* C = malloc((size_t) n * p * sizeof(double));
+    int* ea = malloc(n * sizeof(int));
+    int* eb = malloc(p * sizeof(int));
+    for (int i = 0; i < n; i++) ea[i] = (int) (next_random(state) % 200) - 100;
+    for (int j = 0; j < p; j++) eb[j] = (int) (next_random(state) % 200) - 100;
+    for (int i = 0; i < n; i++)
+        for (int r = 0; r < m; r++) A[(size_t) i * m + r] = ldexp(random_binade(state), ea[i]);
+    for (int r = 0; r < m; r++)
+        for (int j = 0; j < p; j++) B[(size_t) r * p + j] = ldexp(random_binade(state), eb[j]);
+
+    int k = dgemm_int8_moduli_for_bits(53, m);
+    assert(k > 0 && dgemm_int8_bits(k, m) >= 53);
+    assert(dgemm_int8(A, m, B, p, C, p, n, m, p, k, kernel, pool) == 0);
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            __int128 sum = 0;
+            for (int r = 0; r < m; r++) {
+                int64_t a = (int64_t) ldexp(A[(size_t) i * m + r], 52 - ea[i]);
+                int64_t b = (int64_t) ldexp(B[(size_t) r * p + j], 52 - eb[j]);
+                sum += (__int128) a * b;
+            }
+            double ref = ldexp((double) sum, ea[i] + eb[j] - 104);
+            assert(C[(size_t) i * p + j] == ref);
+        }
+    }
+    free(A);
+    free(B);
+    free(C);
+    free(ea);
+    free(eb);
+}
+
+// Entries spread over many binades: the error is bounded by the rounding of
+// the scaled operands, 2^-bits of each row / column maximum per product
+static void check_error_bound(int n, int m, int p, int moduli, ThreadPool* pool, uint64_t* state) {
+    double* A = malloc((size_t) n * m * sizeof(double));
+    double* B = malloc((size_t) m * p * sizeof(double));
+    double* C = malloc((size_t) n * p * sizeof(double));
+    double* ref = malloc((size_t) n * p * sizeof(double));
+    for (size_t e = 0; e < (size_t) n * m; e++) A[e] = ldexp(random_binade(state), (int) (next_random(state) % 40) - 20);
+    for (size_t e = 0; e < (size_t) m * p; e++) B[e] = ldexp(random_binade(state), (int) (next_random(state) % 40) - 20);
+    A[0] = 0.0;
+
+    int bits = dgemm_int8_bits(moduli, m);
+    assert(bits >= 1);
+    assert(dgemm_int8(A, m, B, p, C, p, n, m, p, moduli, residue_gemm_int8_default_kernel(), pool) == 0);
+    naive_dgemm(A, B, ref, n, m, p);
+
+    for (int i = 0; i < n; i++) {
+        double amax = 0.0;
+        for (int r = 0; r < m; r++) amax = fmax(amax, fabs(A[(size_t) i * m + r]));
+        for (int j = 0; j < p; j++) {
+            double bmax = 0.0, abs_sum = 0.0;
+            for (int r = 0; r < m; r++) {
+                bmax = fmax(bmax, fabs(B[(size_t) r * p + j]));
+                abs_sum += fabs(A[(size_t) i * m + r] * B[(size_t) r * p + j]);
+            }
+            // Scaled operands are rounded to within 2^(e - bits - 1) <= max·2^-bits
+            double bound = m * amax * bmax * (2 * ldexp(1.0, -bits) + ldexp(1.0, -2 * bits))
+                           + 2 * m * abs_sum * 0x1p-53;
+            assert(fabs(C[(size_t) i * p + j] - ref[(size_t) i * p + j]) <= bound);
+        }
+    }
+    free(A);
+    free(B);
+    free(C);
+    free(ref);
+}
+
+int main() {
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    ThreadPool* pool = thread_pool_create(3, 0);
+
+    int max = dgemm_int8_max_moduli();
+    assert(max == 23);
+    assert(dgemm_int8_bits(0, 10) < 1 && dgemm_int8_bits(max + 1, 10) < 1);
+    assert(dgemm_int8_bits(max, 1) == 62);
+    for (int k = 2; k <= max; k++) assert(dgemm_int8_bits(k, 100) >= dgemm_int8_bits(k - 1, 100));
+
+    // Wide matrix rounding to double: ties to even and sticky bits below the top limb
+    WideMatrix* W = allocate_wide_matrix(1, 4, 200);
+    W->data[0] = 1; W->data[4] = 1ULL << 53;              // 2^117 + 1
+    W->data[1] = 0; W->data[5] = (1ULL << 53) | 1;        // 2^117 + 2^64
+    W->data[2] = 1ULL << 63; W->data[6] = (1ULL << 52) | 1;  // halfway, odd: rounds up
+    wide_matrix_set_int64(W, 0, 3, -3);
+    assert(wide_matrix_get_double(W, 0, 0) == 0x1p117);
+    assert(wide_matrix_get_double(W, 0, 1) == 0x1p117);
+    assert(wide_matrix_get_double(W, 0, 2) == ldexp((double) ((1ULL << 52) | 2), 64));
+    assert(wide_matrix_get_double(W, 0, 3) == -3.0);
+    free_wide_matrix(W);
+
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        if (!residue_gemm_int8_kernel_available(kr)) {
+            printf("  kernel %s not available, skipped\n", residue_gemm_int8_kernel_name(kr));
+            continue;
+        }
+        check_correctly_rounded(1, 1, 1, kr, NULL, &state);
+        check_correctly_rounded(9, 17, 5, kr, NULL, &state);
+        check_correctly_rounded(33, 64, 20, kr, pool, &state);
+        printf("  kernel %s: ok\n", residue_gemm_int8_kernel_name(kr));
+    }
+
+    // Fewer moduli trade accuracy for speed
+    check_error_bound(20, 50, 30, dgemm_int8_moduli_for_bits(53, 50), pool, &state);
+    check_error_bound(20, 50, 30, 8, pool, &state);
+    check_error_bound(20, 50, 30, 4, NULL, &state);
+
+    // Integers stay exact, with leading dimensions larger than the rows
+    double A[2 * 4] = {1, -2, 3, 99, 4, 5, -6, 99};
+    double B[3 * 3] = {7, 8, 99, -9, 10, 99, 11, -12, 99};
+    double C[2 * 3] = {0, 0, -1, 0, 0, -1};
+    assert(dgemm_int8(A, 4, B, 3, C, 3, 2, 3, 2, 6, RESIDUE_INT8_SCALAR, NULL) == 0);
+    assert(C[0] == 7 - 2 * -9 + 3 * 11 && C[1] == 8 - 20 - 36 && C[2] == -1);
+    assert(C[3] == 28 - 45 - 66 && C[4] == 32 + 50 + 72 && C[5] == -1);
+
+    // Not finite inputs and too small bases are rejected without touching C
+    A[1] = NAN;
+    assert(dgemm_int8(A, 4, B, 3, C, 3, 2, 3, 2, 6, RESIDUE_INT8_SCALAR, NULL) == -1);
+    A[1] = INFINITY;
+    assert(dgemm_int8(A, 4, B, 3, C, 3, 2, 3, 2, 6, RESIDUE_INT8_SCALAR, NULL) == -1);
+    A[1] = -2;
+    assert(dgemm_int8(A, 4, B, 3, C, 3, 2, 3, 2, 0, RESIDUE_INT8_SCALAR, NULL) == -1);
+    assert(C[0] == 7 - 2 * -9 + 3 * 11);
+
+    thread_pool_destroy(pool);
+    printf("All int8 DGEMM tests passed.\n");
+    return 0;
+}
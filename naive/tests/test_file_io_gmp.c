@@ -48,9 +48,20 @@ int main() {
         printf("test_file_io_gmp FAILED: matrices differ.\n");
     }
 
-    // Step 6: Cleanup
+    // Step 6: Arena slots follow the entries, not the first one
+    mpz_t** wide = allocate_mpz_matrix(1, 4);
+    mpz_set_ui(wide[0][0], 7);
+    for (int j = 1; j < 4; j++) mpz_ui_pow_ui(wide[0][j], 10, 80 + j);
+    write_mpz_matrix_to_file(TMP_FILE, wide, 1, 4);
+    mpz_t** wide_read = read_mpz_matrix_from_file(TMP_FILE, &read_n, &read_m);
+    assert(mpz_matrix_arena_spills(wide_read) == 0);
+    for (int j = 0; j < 4; j++) assert(mpz_cmp(wide[0][j], wide_read[0][j]) == 0);
+    free_mpz_matrix(wide, 1, 4);
+    free_mpz_matrix(wide_read, 1, 4);
+
+    // Step 7: Cleanup
     free_mpz_matrix(original, n, m);
-    free_mpz_matrix(recovered, read_n, read_m);
+    free_mpz_matrix(recovered, n, m);
 
     return success ? 0 : 1;
 }
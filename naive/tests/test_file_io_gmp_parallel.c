@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <gmp.h>
+#include "file_io_gmp.h"
+#include "matrix_utils_gmp.h"
+#include "thread_pool.h"
+
+#define TMP_FILE "results/test_file_io_gmp_parallel.txt"
+#define REF_FILE "results/test_file_io_gmp_parallel_ref.txt"
+
+static char* slurp(const char* filename, long* size) {
+    FILE* f = fopen(filename, "rb");
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* data = malloc(*size + 1);
+    assert(fread(data, 1, *size, f) == (size_t) *size);
+    fclose(f);
+    return data;
+}
+
+static void write_text(const char* filename, const char* text) {
+    FILE* f = fopen(filename, "w");
+    fputs(text, f);
+    fclose(f);
+}
+
+static int same(mpz_t** A, mpz_t** B, int n, int m) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            if (mpz_cmp(A[i][j], B[i][j]) != 0) return 0;
+    return 1;
+}
+
+static void expect_rejected(const char* text, MpzFileFormat format) {
+    write_text(TMP_FILE, text);
+    int n = -1, m = -1;
+    assert(read_mpz_matrix_from_file_pool(TMP_FILE, &n, &m, format, NULL) == NULL);
+    assert(n == -1 && m == -1);
+}
+
+int main() {
+    ThreadPool* pool = thread_pool_create(3, 0);
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 2024);
+
+    // Signed entries from 0 to a few thousand bits, one far larger
+    int n = 37, m = 23;
+    mpz_t** A = allocate_mpz_matrix(n, m);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            mpz_urandomb(A[i][j], state, (i * 131 + j * 17) % 3000);
+            if ((i + j) % 3 == 0) mpz_neg(A[i][j], A[i][j]);
+        }
+    }
+    mpz_set_ui(A[0][0], 0);
+    mpz_urandomb(A[5][7], state, 200000);
+    mpz_neg(A[5][7], A[5][7]);
+
+    const MpzFileFormat formats[] = { MPZ_FILE_DECIMAL, MPZ_FILE_HEX, MPZ_FILE_RAW_LIMBS };
+    for (int f = 0; f < 3; f++) {
+        for (int with_pool = 0; with_pool < 2; with_pool++) {
+            ThreadPool* p = with_pool ? pool : NULL;
+            assert(write_mpz_matrix_to_file_pool(TMP_FILE, A, n, m, formats[f], p) == 0);
+            int rn, rm;
+            mpz_t** B = read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, formats[f], p);
+            assert(B && rn == n && rm == m && same(A, B, n, m));
+            free_mpz_matrix(B, rn, rm);
+        }
+    }
+
+    // Decimal output is byte for byte that of write_mpz_matrix_to_file, and
+    // reads back with the sequential reader
+    write_mpz_matrix_to_file(REF_FILE, A, n, m);
+    assert(write_mpz_matrix_to_file_pool(TMP_FILE, A, n, m, MPZ_FILE_DECIMAL, pool) == 0);
+    long ref_size, out_size;
+    char* ref = slurp(REF_FILE, &ref_size);
+    char* out = slurp(TMP_FILE, &out_size);
+    assert(ref_size == out_size && memcmp(ref, out, ref_size) == 0);
+    free(ref);
+    free(out);
+    int rn, rm;
+    mpz_t** B = read_mpz_matrix_from_file(TMP_FILE, &rn, &rm);
+    assert(same(A, B, n, m));
+    free_mpz_matrix(B, rn, rm);
+
+    // Hex digits in either case, leading zeros, separators of any kind
+    write_text(TMP_FILE, "2 2\n  -0Ff\tabcDEF\r\n0000 -0\n");
+    B = read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, MPZ_FILE_HEX, pool);
+    assert(B && rn == 2 && rm == 2);
+    assert(mpz_cmp_si(B[0][0], -255) == 0 && mpz_cmp_ui(B[0][1], 0xabcdef) == 0);
+    assert(mpz_sgn(B[1][0]) == 0 && mpz_sgn(B[1][1]) == 0);
+    free_mpz_matrix(B, rn, rm);
+
+    // Malformed text
+    expect_rejected("2 2\n1 2\n3 4 5\n", MPZ_FILE_DECIMAL);
+    expect_rejected("2 2\n1 2\n3\n", MPZ_FILE_DECIMAL);
+    expect_rejected("2 2\n1 2\n3 ff\n", MPZ_FILE_DECIMAL);
+    expect_rejected("2 2\n1 2\n3 fg\n", MPZ_FILE_HEX);
+    expect_rejected("2 2\n1 - 3 4\n", MPZ_FILE_DECIMAL);
+    expect_rejected("2 2\n1 2.0 3 4\n", MPZ_FILE_DECIMAL);
+    expect_rejected("2x 2\n1 2 3 4\n", MPZ_FILE_DECIMAL);
+    expect_rejected("", MPZ_FILE_DECIMAL);
+    expect_rejected("100000 100000\n1 2 3\n", MPZ_FILE_DECIMAL);   // rejected before allocating
+
+    // Malformed raw files: bad magic, truncated entry, trailing bytes
+    assert(write_mpz_matrix_to_file_pool(TMP_FILE, A, n, m, MPZ_FILE_RAW_LIMBS, pool) == 0);
+    long raw_size;
+    char* raw = slurp(TMP_FILE, &raw_size);
+    FILE* f = fopen(TMP_FILE, "wb");
+    fwrite(raw, 1, raw_size - 8, f);
+    fclose(f);
+    assert(read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, MPZ_FILE_RAW_LIMBS, pool) == NULL);
+    f = fopen(TMP_FILE, "wb");
+    fwrite(raw, 1, raw_size, f);
+    fputc(0, f);
+    fclose(f);
+    assert(read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, MPZ_FILE_RAW_LIMBS, pool) == NULL);
+    raw[0] = 'X';
+    f = fopen(TMP_FILE, "wb");
+    fwrite(raw, 1, raw_size, f);
+    fclose(f);
+    assert(read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, MPZ_FILE_RAW_LIMBS, pool) == NULL);
+    free(raw);
+    assert(read_mpz_matrix_from_file_pool("results/no_such_file", &rn, &rm, MPZ_FILE_DECIMAL, pool) == NULL);
+
+    // Empty matrices
+    assert(write_mpz_matrix_to_file_pool(TMP_FILE, A, 0, 4, MPZ_FILE_RAW_LIMBS, pool) == 0);
+    B = read_mpz_matrix_from_file_pool(TMP_FILE, &rn, &rm, MPZ_FILE_RAW_LIMBS, pool);
+    assert(B && rn == 0 && rm == 4);
+    free_mpz_matrix(B, rn, rm);
+
+    remove(TMP_FILE);
+    remove(REF_FILE);
+    free_mpz_matrix(A, n, m);
+    gmp_randclear(state);
+    thread_pool_destroy(pool);
+    printf("All parallel mpz file I/O tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "file_io_text.h"
+#include "file_io_int8.h"
+#include "matrix_utils_int8.h"
+
+#define TMP_FILE "test_file_io_text.txt"
+
+static void write_text(const char* text) {
+    FILE* f = fopen(TMP_FILE, "w");
+    fputs(text, f);
+    fclose(f);
+}
+
+// Expects load_text_matrix to fail at line:column with a message containing what
+static void expect_error(const char* text, MatrixFileType type, ThreadPool* pool, long line, long column,
+                         const char* what) {
+    write_text(text);
+    int n = -1, m = -1;
+    TextMatrixError err;
+    void* mat = load_text_matrix(TMP_FILE, type, &n, &m, pool, &err);
+    if (mat != NULL || err.line != line || err.column != column || strstr(err.message, what) == NULL) {
+        fprintf(stderr, "expected %ld:%ld '%s', got %ld:%ld '%s'\n", line, column, what, err.line, err.column,
+                err.message);
+        assert(0);
+    }
+    assert(n == -1 && m == -1);
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+int main() {
+    ThreadPool* pool = thread_pool_create(4, 0);
+
+    // Same values as the stdio loader on a file written by save_matrix_int8
+    int8_t** a = allocate_matrix_int8(3, 4);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++) a[i][j] = (int8_t) (i * 70 - j * 45);
+    save_matrix_int8(TMP_FILE, a, 3, 4);
+    int n, m;
+    int8_t* fast = load_text_matrix(TMP_FILE, MATRIX_FILE_INT8, &n, &m, NULL, NULL);
+    assert(fast && n == 3 && m == 4 && (uintptr_t) fast % MATRIX_FILE_ALIGN == 0);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++) assert(fast[i * 4 + j] == a[i][j]);
+    free(fast);
+    free_matrix_int8(a, 3);
+
+    // A body of several chunks with mixed separators, signs and line lengths
+    int rows = 400, cols = 300;
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    int16_t* expect = malloc((size_t) rows * cols * sizeof(int16_t));
+    FILE* f = fopen(TMP_FILE, "w");
+    fprintf(f, "  %d\t%d\r\n", rows, cols);
+    for (int e = 0; e < rows * cols; e++) {
+        expect[e] = (int16_t) next_random(&state);
+        if (e % 7 == 3) expect[e] = (e & 1) ? INT16_MIN : INT16_MAX;
+        int r = (int) (next_random(&state) % 16);
+        fprintf(f, (r == 0 && expect[e] >= 0) ? "+%d" : "%d", expect[e]);
+        fputs(r == 1 ? "\t" : r == 2 ? "   " : r == 3 ? "\r\n" : r == 4 ? "\n\n" : " ", f);
+    }
+    fclose(f);
+    for (int with_pool = 0; with_pool < 2; with_pool++) {
+        int16_t* b = load_text_matrix(TMP_FILE, MATRIX_FILE_INT16, &n, &m, with_pool ? pool : NULL, NULL);
+        assert(b && n == rows && m == cols);
+        assert(memcmp(b, expect, (size_t) rows * cols * sizeof(int16_t)) == 0);
+        free(b);
+    }
+    // Too narrow for the values
+    TextMatrixError err;
+    assert(load_text_matrix(TMP_FILE, MATRIX_FILE_INT8, &n, &m, pool, &err) == NULL);
+    assert(strstr(err.message, "out of range for int8") && err.line >= 2);
+    free(expect);
+
+    // Other element types
+    write_text("2 2\n255 0\n7 128\n");
+    uint8_t* u = load_text_matrix(TMP_FILE, MATRIX_FILE_UINT8, &n, &m, pool, NULL);
+    assert(u && u[0] == 255 && u[3] == 128);
+    free(u);
+    write_text("1 3\n-9223372036854775808 9223372036854775807 -1");
+    int64_t* w = load_text_matrix(TMP_FILE, MATRIX_FILE_INT64, &n, &m, pool, NULL);
+    assert(w && w[0] == INT64_MIN && w[1] == INT64_MAX && w[2] == -1);
+    free(w);
+    write_text("0 5\n");
+    int32_t* z = load_text_matrix(TMP_FILE, MATRIX_FILE_INT32, &n, &m, pool, NULL);
+    assert(z && n == 0 && m == 5);
+    free(z);
+
+    // Strict errors, located by line and column
+    expect_error("2 2\n1 2\n3 x\n", MATRIX_FILE_INT8, NULL, 3, 3, "unexpected character");
+    expect_error("2 2\n1 2\n3 4x\n", MATRIX_FILE_INT8, NULL, 3, 4, "unexpected character");
+    expect_error("2 2\n1 2.5\n3 4\n", MATRIX_FILE_INT8, NULL, 2, 4, "unexpected character");
+    expect_error("2 2\n1 -\n3 4\n", MATRIX_FILE_INT8, NULL, 2, 3, "sign without digits");
+    expect_error("2 2\n1 2\n3 4 5\n", MATRIX_FILE_INT8, NULL, 3, 5, "more than 4 values");
+    expect_error("2 2\n1 2\n3\n", MATRIX_FILE_INT8, NULL, 4, 1, "expected 4 values, found 3");
+    expect_error("2 2\n1 -129\n3 4\n", MATRIX_FILE_INT8, NULL, 2, 3, "out of range for int8");
+    expect_error("1 1\n-1\n", MATRIX_FILE_UINT8, NULL, 2, 1, "out of range for uint8");
+    expect_error("1 1\n99999999999999999999\n", MATRIX_FILE_INT64, NULL, 2, 1, "out of range");
+    expect_error("2\n", MATRIX_FILE_INT8, NULL, 2, 1, "dimensions");
+    expect_error("", MATRIX_FILE_INT8, NULL, 1, 1, "dimensions");
+    expect_error("-2 2\n", MATRIX_FILE_INT8, NULL, 1, 1, "dimensions");
+    expect_error("1 1\n1\n", MATRIX_FILE_FLOAT64, NULL, 0, 0, "unsupported");
+
+    // With several chunks the first error in the file is the one reported
+    f = fopen(TMP_FILE, "w");
+    fprintf(f, "1000 100\n");
+    for (int i = 0; i < 1000; i++) {
+        for (int j = 0; j < 100; j++) fputs(i == 600 && j == 2 ? "1e3 " : i == 900 ? "# " : "12 ", f);
+        fputc('\n', f);
+    }
+    fclose(f);
+    assert(load_text_matrix(TMP_FILE, MATRIX_FILE_INT16, &n, &m, pool, &err) == NULL);
+    assert(err.line == 602 && err.column == 8 && strstr(err.message, "unexpected character"));
+
+    assert(load_text_matrix("no_such_file.txt", MATRIX_FILE_INT8, &n, &m, pool, &err) == NULL);
+    assert(err.line == 0 && strstr(err.message, "could not open"));
+
+    remove(TMP_FILE);
+    thread_pool_destroy(pool);
+    printf("All text matrix loader tests passed.\n");
+    return 0;
+}
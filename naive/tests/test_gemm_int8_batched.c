@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "gemm_int8_batched.h"
+#include "thread_pool.h"
+
+static int8_t random_int8(void) {
+    return (int8_t) (rand() % 256 - 128);
+}
+
+// Check every kernel on one shape, as a strided batch and as a pointer-array batch
+static void check_shape(int n, int m, int p, int batch, int mod, ThreadPool* pool) {
+    int lda = m + 3, ldb = p + 1, ldc = p + 2;
+    long sa = (long) n * lda, sb = (long) m * ldb, sc = (long) n * ldc;
+    int8_t* A = malloc((size_t) batch * sa);
+    int8_t* B = malloc((size_t) batch * sb);
+    int32_t* C = malloc((size_t) batch * sc * sizeof(int32_t));
+    int32_t* R = malloc((size_t) batch * sc * sizeof(int32_t));
+    for (long i = 0; i < batch * sa; i++) A[i] = random_int8();
+    for (long i = 0; i < batch * sb; i++) B[i] = random_int8();
+
+    for (int b = 0; b < batch; b++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) {
+                int32_t acc = 0;
+                for (int r = 0; r < m; r++) acc += A[b * sa + i * lda + r] * B[b * sb + r * ldb + j];
+                if (mod > 0) acc = ((acc % mod) + mod) % mod;
+                R[b * sc + i * ldc + j] = acc;
+            }
+        }
+    }
+
+    const int8_t** Ap = malloc(batch * sizeof(int8_t*));
+    const int8_t** Bp = malloc(batch * sizeof(int8_t*));
+    int32_t** Cp = malloc(batch * sizeof(int32_t*));
+    for (int b = 0; b < batch; b++) {
+        // Reversed order so that pointer arrays do not follow the strided layout
+        Ap[b] = A + (batch - 1 - b) * sa;
+        Bp[b] = B + (batch - 1 - b) * sb;
+        Cp[b] = C + (batch - 1 - b) * sc;
+    }
+
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        if (!residue_gemm_int8_kernel_available(kr)) continue;
+
+        for (long i = 0; i < batch * sc; i++) C[i] = -7;
+        gemm_int8_batched_strided(A, lda, sa, B, ldb, sb, C, ldc, sc, n, m, p, batch, mod, kr, pool);
+        for (int b = 0; b < batch; b++)
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < p; j++) assert(C[b * sc + i * ldc + j] == R[b * sc + i * ldc + j]);
+
+        for (long i = 0; i < batch * sc; i++) C[i] = -7;
+        gemm_int8_batched(Ap, lda, Bp, ldb, Cp, ldc, n, m, p, batch, mod, kr, NULL);
+        for (int b = 0; b < batch; b++)
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < p; j++) assert(C[b * sc + i * ldc + j] == R[b * sc + i * ldc + j]);
+    }
+
+    free(Ap); free(Bp); free(Cp);
+    free(A); free(B); free(C); free(R);
+}
+
+// Inner dimension past int32 range: all entries -128, so every product is 2^14
+static void check_long_k(int m, int mod) {
+    int n = 2, p = 3, batch = 2;
+    int8_t* A = malloc((size_t) batch * n * m);
+    int8_t* B = malloc((size_t) batch * m * p);
+    int32_t* C = malloc((size_t) batch * n * p * sizeof(int32_t));
+    for (long i = 0; i < (long) batch * n * m; i++) A[i] = -128;
+    for (long i = 0; i < (long) batch * m * p; i++) B[i] = -128;
+    int32_t expected = (int32_t) (((int64_t) m << 14) % mod);
+
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        // Unavailable kernels fall back to the scalar one
+        for (long i = 0; i < (long) batch * n * p; i++) C[i] = -7;
+        gemm_int8_batched_strided(A, m, (long) n * m, B, p, (long) m * p, C, p, (long) n * p,
+                                  n, m, p, batch, mod, kr, NULL);
+        for (long i = 0; i < (long) batch * n * p; i++) assert(C[i] == expected);
+    }
+
+    free(A); free(B); free(C);
+}
+
+int main() {
+    srand(17);
+    ThreadPool* pool = thread_pool_create(3, 1);
+
+    assert(gemm_int8_batched_group_size(4, 4, 4) == 4);
+    assert(gemm_int8_batched_group_size(8, 8, 8) == 2);
+    assert(gemm_int8_batched_group_size(16, 16, 16) == 1);
+    assert(gemm_int8_batched_group_size(3, 5, 2) == 5);
+    assert(gemm_int8_batched_group_size(17, 4, 4) == 0);
+
+    check_shape(4, 4, 4, 103, 0, pool);
+    check_shape(8, 8, 8, 37, 251, pool);
+    check_shape(16, 16, 16, 9, 0, pool);
+    check_shape(3, 5, 2, 41, 239, pool);
+    check_shape(20, 70, 18, 5, 0, pool);       // full tiles
+    check_shape(1, 1, 1, 2, 0, pool);
+    check_shape(2, 0, 3, 4, 0, pool);          // empty inner dimension
+    check_long_k(140000, 251);                 // three windows of K
+    check_long_k(GEMM_INT8_BATCHED_WINDOW, 65521);
+
+    thread_pool_destroy(pool);
+    printf("test_gemm_int8_batched: passed\n");
+    return 0;
+}
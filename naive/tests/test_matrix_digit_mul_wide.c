@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "matrix_utils_wide.h"
+#include "matrix_digit_mul_wide.h"
+#include "matrix_rns_mul_wide.h"
+#include "thread_pool.h"
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Random entries with |x| < 2^bits, mixed sizes and signs; the first entries
+// are the extremes -2^bits + 1, 2^bits - 1, 0 and -1
+static WideMatrix* random_wide(int n, int m, long bits, uint64_t* state) {
+    WideMatrix* W = allocate_wide_matrix(n, m, bits);
+    size_t count = (size_t) n * m;
+    for (size_t e = 0; e < count; e++) {
+        long b = (e % 5 == 0) ? bits : 1 + (long) (next_random(state) % (uint64_t) bits);
+        int neg = (int) (next_random(state) & 1);
+        if (e < 4) {
+            b = (e < 2) ? bits : 0;
+            neg = (e == 0 || e == 3);
+        }
+        // |x| with b bits, then x = ~|x| + 1 for negative entries
+        uint64_t carry = 1;
+        for (int l = 0; l < W->limbs; l++) {
+            uint64_t w = 0;
+            if (64L * l < b) {
+                w = (e < 2) ? UINT64_MAX : next_random(state);
+                if (b - 64L * l < 64) w &= (1ULL << (b - 64L * l)) - 1;
+            }
+            if (e == 3 && l == 0) w = 1;
+            if (neg) {
+                w = ~w + carry;
+                carry = carry && w == 0;
+            }
+            W->data[l * count + e] = w;
+        }
+    }
+    return W;
+}
+
+// Same values, possibly with different widths
+static void assert_same(const WideMatrix* X, const WideMatrix* Y) {
+    assert(X->n == Y->n && X->m == Y->m);
+    size_t count = (size_t) X->n * X->m;
+    int limbs = X->limbs > Y->limbs ? X->limbs : Y->limbs;
+    for (size_t e = 0; e < count; e++) {
+        uint64_t ext_x = (int64_t) X->data[(X->limbs - 1) * count + e] < 0 ? UINT64_MAX : 0;
+        uint64_t ext_y = (int64_t) Y->data[(Y->limbs - 1) * count + e] < 0 ? UINT64_MAX : 0;
+        for (int l = 0; l < limbs; l++) {
+            uint64_t x = l < X->limbs ? X->data[l * count + e] : ext_x;
+            uint64_t y = l < Y->limbs ? Y->data[l * count + e] : ext_y;
+            assert(x == y);
+        }
+    }
+}
+
+static void check_product(int n, int m, int p, long bits_a, long bits_b, ResidueInt8Kernel kernel,
+                          ThreadPool* pool, uint64_t* state) {
+    WideMatrix* A = random_wide(n, m, bits_a, state);
+    WideMatrix* B = random_wide(m, p, bits_b, state);
+    WideMatrix* ref = multiply_matrix_rns_wide(A, B, NULL);
+    WideMatrix* C = multiply_matrix_digits_wide(A, B, kernel, pool);
+    assert(C != NULL);
+    assert_same(C, ref);
+    free_wide_matrix(A);
+    free_wide_matrix(B);
+    free_wide_matrix(C);
+    free_wide_matrix(ref);
+}
+
+static void test_int64_products(void) {
+    // Small exact case against an int64 reference
+    int n = 3, m = 4, p = 2;
+    WideMatrix* A = allocate_wide_matrix(n, m, 20);
+    WideMatrix* B = allocate_wide_matrix(m, p, 20);
+    int64_t a[3][4] = {{1, -2, 3, -4}, {-128, 127, 128, -129}, {100000, -99999, 255, -256}};
+    int64_t b[4][2] = {{5, -6}, {-7, 8}, {9000, -1}, {0, 65535}};
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++) wide_matrix_set_int64(A, i, j, a[i][j]);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < p; j++) wide_matrix_set_int64(B, i, j, b[i][j]);
+    WideMatrix* C = multiply_matrix_digits_wide(A, B, RESIDUE_INT8_SCALAR, NULL);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            int64_t ref = 0, v;
+            for (int r = 0; r < m; r++) ref += a[i][r] * b[r][j];
+            assert(wide_matrix_get_int64(C, i, j, &v) && v == ref);
+        }
+    }
+    assert(multiply_matrix_digits_wide(A, A, RESIDUE_INT8_SCALAR, NULL) == NULL);
+    free_wide_matrix(A);
+    free_wide_matrix(B);
+    free_wide_matrix(C);
+}
+
+int main() {
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    ThreadPool* pool = thread_pool_create(3, 0);
+
+    assert(wide_digit_count(0) == 1);
+    assert(wide_digit_count(6) == 1);
+    assert(wide_digit_count(7) == 2);
+    assert(wide_digit_count(62) == 8);
+    assert(wide_digit_count(63) == 9);
+
+    test_int64_products();
+
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        if (!residue_gemm_int8_kernel_available(kr)) {
+            printf("  kernel %s not available, skipped\n", residue_gemm_int8_kernel_name(kr));
+            continue;
+        }
+        check_product(1, 1, 1, 1, 1, kr, NULL, &state);
+        check_product(5, 7, 3, 63, 64, kr, NULL, &state);
+        check_product(17, 70, 33, 200, 90, kr, pool, &state);
+        check_product(40, 129, 18, 500, 500, kr, pool, &state);
+        // Diagonals longer than the int32 window of every kernel
+        check_product(2, 1100, 3, 1000, 1000, kr, NULL, &state);
+        printf("  kernel %s: ok\n", residue_gemm_int8_kernel_name(kr));
+    }
+
+    // Through the dispatcher, with either method
+    WideMatrix* A = random_wide(20, 30, 300, &state);
+    WideMatrix* B = random_wide(30, 10, 100, &state);
+    WideMatrix* C_rns = multiply_matrix_wide(A, B, WIDE_PRODUCT_RNS, pool);
+    WideMatrix* C_digits = multiply_matrix_wide(A, B, WIDE_PRODUCT_DIGITS, pool);
+    WideMatrix* C_auto = multiply_matrix_wide(A, B, WIDE_PRODUCT_AUTO, pool);
+    assert_same(C_rns, C_digits);
+    assert_same(C_rns, C_auto);
+    free_wide_matrix(C_rns);
+    free_wide_matrix(C_digits);
+    free_wide_matrix(C_auto);
+    free_wide_matrix(A);
+    free_wide_matrix(B);
+
+    // The model prices the quadratic digit count: digits win narrow, RNS wide
+    ResidueInt8Kernel kernel = residue_gemm_int8_default_kernel();
+    if (kernel == RESIDUE_INT8_AVX512 || kernel == RESIDUE_INT8_AMX) {
+        assert(wide_product_choose(64, 64, 256, 256, 256, kernel) == WIDE_PRODUCT_DIGITS);
+    }
+    assert(wide_product_choose(8192, 8192, 256, 256, 256, kernel) == WIDE_PRODUCT_RNS);
+    assert(wide_product_cost(WIDE_PRODUCT_DIGITS, 1024, 1024, 64, 64, 64, kernel)
+           > wide_product_cost(WIDE_PRODUCT_DIGITS, 512, 512, 64, 64, 64, kernel));
+
+    thread_pool_destroy(pool);
+    printf("All digit-sliced product tests passed.\n");
+    return 0;
+}
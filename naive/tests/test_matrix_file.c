@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <assert.h>
+#include "matrix_file.h"
+#include "matrix_utils_wide.h"
+
+#define TMP_FILE "test_matrix_file.mat"
+
+static void flip_byte(const char* filename, long offset) {
+    FILE* f = fopen(filename, "r+b");
+    fseek(f, offset, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, offset, SEEK_SET);
+    fputc(c ^ 0x40, f);
+    fclose(f);
+}
+
+static long file_size(const char* filename) {
+    FILE* f = fopen(filename, "rb");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+int main() {
+    // int8 with a source leading dimension larger than the row
+    int n = 5, m = 7, ld = 9;
+    int8_t src[5 * 9];
+    for (int e = 0; e < n * ld; e++) src[e] = (int8_t) (e * 37 - 100);
+    const void* planes[3] = { src };
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, n, m, 1, planes, ld, NULL) == 0);
+
+    MatrixFile* f = matrix_file_open(TMP_FILE, 1);
+    assert(f && f->type == MATRIX_FILE_INT8 && f->rows == n && f->cols == m && f->planes == 1);
+    assert(f->moduli == NULL && f->row_stride >= m && f->elem_size == 1);
+    assert((uintptr_t) f->data % MATRIX_FILE_ALIGN == 0);
+    const int8_t* a = (const int8_t*) matrix_file_plane(f, 0);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++) assert(a[i * f->row_stride + j] == src[i * ld + j]);
+    matrix_file_close(f);
+
+    // Residue planes with their basis
+    int32_t r0[4 * 3], r1[4 * 3], r2[4 * 3];
+    for (int e = 0; e < 12; e++) {
+        r0[e] = e;
+        r1[e] = 1000 + e;
+        r2[e] = -e;
+    }
+    int moduli[3] = { 2147483647, 2147483629, 2147483587 };
+    planes[0] = r0;
+    planes[1] = r1;
+    planes[2] = r2;
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT32, 4, 3, 3, planes, 3, moduli) == 0);
+    f = matrix_file_open(TMP_FILE, 1);
+    assert(f && f->planes == 3 && f->moduli);
+    for (int l = 0; l < 3; l++) {
+        assert(f->moduli[l] == moduli[l]);
+        const int32_t* plane = (const int32_t*) matrix_file_plane(f, l);
+        assert((uintptr_t) plane % MATRIX_FILE_ALIGN == 0);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 3; j++) assert(plane[i * f->row_stride + j] == ((const int32_t*) planes[l])[i * 3 + j]);
+    }
+    matrix_file_close(f);
+
+    // Created in place: readable unverified at once, verified after finish
+    MatrixFile* w = matrix_file_create(TMP_FILE, MATRIX_FILE_INT32, 4, 3, 3, moduli);
+    assert(w && w->writable && w->planes == 3 && w->moduli[2] == moduli[2]);
+    for (int l = 0; l < 3; l++) {
+        int32_t* plane = (int32_t*) matrix_file_plane_writable(w, l);
+        assert(plane && (uintptr_t) plane % MATRIX_FILE_ALIGN == 0);
+        for (int i = 0; i < 4; i++) memcpy(plane + i * w->row_stride, (const int32_t*) planes[l] + i * 3, 3 * sizeof(int32_t));
+    }
+    assert(matrix_file_open(TMP_FILE, 1) == NULL);
+    assert(matrix_file_finish(w) == 0);
+    matrix_file_close(w);
+    f = matrix_file_open(TMP_FILE, 1);
+    assert(f && matrix_file_plane_writable(f, 0) == NULL && matrix_file_finish(f) == -1);
+    for (int l = 0; l < 3; l++) assert(memcmp(matrix_file_plane(f, l), planes[l], 12 * sizeof(int32_t)) == 0);
+    matrix_file_close(f);
+    assert(matrix_file_create("no_such_dir/x.mat", MATRIX_FILE_INT8, 2, 2, 1, NULL) == NULL);
+    assert(matrix_file_create(TMP_FILE, MATRIX_FILE_LIMB64, 2, 2, 1, moduli) == NULL);
+
+    // A WideMatrix goes out limb by limb and comes back bit for bit
+    WideMatrix* W = allocate_wide_matrix(3, 2, 100);
+    wide_matrix_set_int64(W, 0, 0, -5);
+    wide_matrix_set_int64(W, 2, 1, INT64_MAX);
+    W->data[W->n * W->m + 3] = 0x1234;
+    const void* limbs[2] = { W->data, W->data + W->n * W->m };
+    assert(W->limbs == 2);
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_LIMB64, 3, 2, 2, limbs, 2, NULL) == 0);
+    f = matrix_file_open(TMP_FILE, 1);
+    assert(f && f->type == MATRIX_FILE_LIMB64 && f->planes == 2);
+    for (int l = 0; l < 2; l++) assert(memcmp(matrix_file_plane(f, l), limbs[l], 6 * sizeof(uint64_t)) == 0);
+    matrix_file_close(f);
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_LIMB64, 3, 2, 2, limbs, 2, moduli) == -1);
+    free_wide_matrix(W);
+
+    // Doubles, and an empty matrix
+    double d[2 * 2] = { 1.5, -0.0, 1e300, -3.25 };
+    planes[0] = d;
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_FLOAT64, 2, 2, 1, planes, 2, NULL) == 0);
+    f = matrix_file_open(TMP_FILE, 0);
+    assert(f && memcmp(matrix_file_plane(f, 0), d, sizeof(d)) == 0);
+    matrix_file_close(f);
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT16, 0, 4, 1, planes, 4, NULL) == 0);
+    f = matrix_file_open(TMP_FILE, 1);
+    assert(f && f->rows == 0 && f->cols == 4);
+    matrix_file_close(f);
+
+    // Invalid arguments
+    assert(matrix_file_write(TMP_FILE, (MatrixFileType) 99, 2, 2, 1, planes, 2, NULL) == -1);
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, 2, 3, 1, planes, 2, NULL) == -1);
+    assert(matrix_file_write("no_such_dir/x.mat", MATRIX_FILE_INT8, 2, 2, 1, planes, 2, NULL) == -1);
+
+    // Payload corruption is caught by the checksum, header corruption by validation
+    planes[0] = src;
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, n, m, 1, planes, ld, NULL) == 0);
+    long size = file_size(TMP_FILE);
+    flip_byte(TMP_FILE, size - MATRIX_FILE_ALIGN + 3);
+    assert(matrix_file_open(TMP_FILE, 1) == NULL);
+    f = matrix_file_open(TMP_FILE, 0);
+    assert(f != NULL);
+    matrix_file_close(f);
+
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, n, m, 1, planes, ld, NULL) == 0);
+    flip_byte(TMP_FILE, 0);
+    assert(matrix_file_open(TMP_FILE, 0) == NULL);
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, n, m, 1, planes, ld, NULL) == 0);
+    flip_byte(TMP_FILE, offsetof(MatrixFileHeader, rows) + 1);
+    assert(matrix_file_open(TMP_FILE, 0) == NULL);
+
+    assert(matrix_file_write(TMP_FILE, MATRIX_FILE_INT8, n, m, 1, planes, ld, NULL) == 0);
+    assert(truncate(TMP_FILE, size - 1) == 0);
+    assert(matrix_file_open(TMP_FILE, 0) == NULL);
+    assert(matrix_file_open("no_such_file.mat", 0) == NULL);
+
+    // Checksum properties the format relies on
+    unsigned char buf[100] = {0};
+    uint64_t c0 = matrix_file_checksum(buf, 100);
+    assert(c0 != matrix_file_checksum(buf, 99));
+    buf[97] = 1;
+    assert(c0 != matrix_file_checksum(buf, 100));
+
+    remove(TMP_FILE);
+    printf("All matrix file tests passed.\n");
+    return 0;
+}
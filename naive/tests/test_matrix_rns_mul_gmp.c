@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <assert.h>
+#include "matrix_utils_gmp.h"
+#include "matrix_rns_mul_gmp.h"
+
+int main() {
+    int n = 5, m = 9, p = 4;
+    mpz_t** A = allocate_mpz_matrix(n, m);
+    mpz_t** B = allocate_mpz_matrix(m, p);
+
+    // Signed entries of a few hundred bits
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            mpz_urandomb(A[i][j], state, 300);
+            if ((i + j) % 3 == 0) mpz_neg(A[i][j], A[i][j]);
+        }
+    }
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < p; j++) {
+            mpz_urandomb(B[i][j], state, 420);
+            if ((i * j) % 2 == 1) mpz_neg(B[i][j], B[i][j]);
+        }
+    }
+    mpz_set_ui(A[0][0], 0);
+
+    mpz_t** C_ref = multiply_matrix_mpz_classical(A, B, n, m, p);
+    mpz_t** C = multiply_matrix_rns_mpz(A, B, n, m, p);
+
+    ThreadPool* pool = thread_pool_create(3, 1);
+    mpz_t** C_pool = multiply_matrix_rns_mpz_pool(A, B, n, m, p, pool);
+    mpz_t** C_seq = multiply_matrix_rns_mpz_pool(A, B, n, m, p, NULL);
+    thread_pool_destroy(pool);
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            assert(mpz_cmp(C[i][j], C_ref[i][j]) == 0);
+            assert(mpz_cmp(C_pool[i][j], C_ref[i][j]) == 0);
+            assert(mpz_cmp(C_seq[i][j], C_ref[i][j]) == 0);
+        }
+    }
+
+    assert(mpz_matrix_max_bits(A, n, m) <= 300);
+
+    // Entries small enough for the 8-bit primes, on both residue GEMM backends
+    mpz_t** SA8 = allocate_mpz_matrix(n, m);
+    mpz_t** SB8 = allocate_mpz_matrix(m, p);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++) mpz_fdiv_q_2exp(SA8[i][j], A[i][j], 250);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < p; j++) mpz_fdiv_q_2exp(SB8[i][j], B[i][j], 370);
+    mpz_t** C8_ref = multiply_matrix_mpz_classical(SA8, SB8, n, m, p);
+    const char* backends[] = { "int8", "fp64" };
+    for (int b = 0; b < 2; b++) {
+        setenv("RNS_PRODUCT_BACKEND", backends[b], 1);
+        mpz_t** S = multiply_matrix_rns_mpz_pool(SA8, SB8, n, m, p, NULL);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < p; j++) assert(mpz_cmp(S[i][j], C8_ref[i][j]) == 0);
+        free_mpz_matrix(S, n, p);
+    }
+    unsetenv("RNS_PRODUCT_BACKEND");
+    free_mpz_matrix(C8_ref, n, p);
+    free_mpz_matrix(SA8, n, m);
+    free_mpz_matrix(SB8, m, p);
+
+    // Adaptive moduli: the full-size product needs (about) every modulus of the bound
+    for (int check = RNS_EARLY_CHECK_ALL; check <= RNS_EARLY_CHECK_PROJECTION; check++) {
+        int k_used;
+        mpz_t** C_ad = multiply_matrix_rns_mpz_adaptive(A, B, n, m, p, 64, (RNSEarlyCheck) check, &k_used, NULL);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < p; j++) assert(mpz_cmp(C_ad[i][j], C_ref[i][j]) == 0);
+        free_mpz_matrix(C_ad, n, p);
+    }
+
+    // A single huge entry that is multiplied by a zero row: the bound asks for
+    // 700+ bits, the product only has ~40
+    int sn = 12, sm = 10, sp = 11;
+    mpz_t** SA = allocate_mpz_matrix(sn, sm);
+    mpz_t** SB = allocate_mpz_matrix(sm, sp);
+    for (int i = 0; i < sn; i++) {
+        for (int j = 0; j < sm; j++) {
+            mpz_urandomb(SA[i][j], state, 20);
+            if ((i + j) % 2) mpz_neg(SA[i][j], SA[i][j]);
+        }
+    }
+    for (int i = 0; i < sm; i++)
+        for (int j = 0; j < sp; j++) mpz_urandomb(SB[i][j], state, 20);
+    mpz_ui_pow_ui(SA[3][0], 2, 350);
+    for (int j = 0; j < sp; j++) mpz_set_ui(SB[0][j], 0);
+    mpz_ui_pow_ui(SB[5][2], 3, 200);
+    for (int i = 0; i < sn; i++) mpz_set_ui(SA[i][5], 0);
+
+    mpz_t** S_ref = multiply_matrix_mpz_classical(SA, SB, sn, sm, sp);
+    pool = thread_pool_create(2, 1);
+    for (int check = RNS_EARLY_CHECK_ALL; check <= RNS_EARLY_CHECK_PROJECTION; check++) {
+        for (int conf = 0; conf <= 100; conf += 50) {
+            int k_used;
+            mpz_t** S = multiply_matrix_rns_mpz_adaptive(SA, SB, sn, sm, sp, conf, (RNSEarlyCheck) check,
+                                                         &k_used, conf == 50 ? pool : NULL);
+            for (int i = 0; i < sn; i++)
+                for (int j = 0; j < sp; j++) assert(mpz_cmp(S[i][j], S_ref[i][j]) == 0);
+            // Two moduli hold the values (more for the weights and the n·p terms of the
+            // projection), then one per confirmation
+            int extra = check == RNS_EARLY_CHECK_PROJECTION
+                      ? (rns_projection_weight_bits(conf) + 8) / (RNS_MPZ_MODULUS_BITS - 1) + 1 : 0;
+            assert(k_used <= 2 + extra + rns_early_confirmations(conf, (RNSEarlyCheck) check));
+            free_mpz_matrix(S, sn, sp);
+        }
+    }
+    thread_pool_destroy(pool);
+    assert(rns_early_confirmations(0, RNS_EARLY_CHECK_ALL) == 1);
+    assert(rns_early_confirmations(72, RNS_EARLY_CHECK_ALL) == 3);
+    assert(rns_early_confirmations(72, RNS_EARLY_CHECK_PROJECTION) == 4);
+    assert(rns_projection_weight_bits(0) == 31 && rns_projection_weight_bits(100) == 101);
+
+    printf("test_matrix_rns_mul_gmp: passed\n");
+
+    gmp_randclear(state);
+    free_mpz_matrix(A, n, m);
+    free_mpz_matrix(B, m, p);
+    free_mpz_matrix(C, n, p);
+    free_mpz_matrix(C_ref, n, p);
+    free_mpz_matrix(C_pool, n, p);
+    free_mpz_matrix(C_seq, n, p);
+    free_mpz_matrix(SA, sn, sm);
+    free_mpz_matrix(SB, sm, sp);
+    free_mpz_matrix(S_ref, sn, sp);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <assert.h>
 #include "matrix_utils_int8.h"
@@ -29,11 +30,49 @@ int main() {
     assert(C[1][0] == 139);
     assert(C[1][1] == 154);
 
+    // Streaming mode on random operands, both representations, with and without a pool
+    srand(7);
+    int sn = 37, sm = 45, sp = 29;
+    int8_t** SA = allocate_matrix_int8(sn, sm);
+    int8_t** SB = allocate_matrix_int8(sm, sp);
+    for (int i = 0; i < sn; i++)
+        for (int j = 0; j < sm; j++) SA[i][j] = (int8_t) (rand() % 256 - 128);
+    for (int i = 0; i < sm; i++)
+        for (int j = 0; j < sp; j++) SB[i][j] = (int8_t) (rand() % 256 - 128);
+
+    int small[] = {251, 241, 239};
+    int wide[] = {2147483647, 2147483629};
+    int many[] = {251, 241, 239, 233, 229, 227, 223, 211, 199, 197, 193, 191, 181, 179, 173, 167, 163};
+    struct { int* moduli; int k; RNSResidueRepr repr; ThreadPool* pool; } cases[] = {
+        { small, 3, RNS_RESIDUES_UNSIGNED, NULL },
+        { small, 3, RNS_RESIDUES_CENTERED, NULL },
+        { small, 3, RNS_RESIDUES_UNSIGNED, thread_pool_get_default() },
+        { small, 3, RNS_RESIDUES_CENTERED, thread_pool_get_default() },
+        { wide, 2, RNS_RESIDUES_UNSIGNED, thread_pool_get_default() },
+        { many, 17, RNS_RESIDUES_CENTERED, thread_pool_get_default() },  // M > 2^128: fallback
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        int64_t** S = multiply_matrix_rns_int8_streaming(SA, SB, sn, sm, sp, cases[c].moduli, cases[c].k,
+                                                         cases[c].repr, cases[c].pool);
+        for (int i = 0; i < sn; i++) {
+            for (int j = 0; j < sp; j++) {
+                int64_t ref = 0;
+                for (int t = 0; t < sm; t++) ref += (int64_t) SA[i][t] * SB[t][j];
+                assert(S[i][j] == ref);
+            }
+        }
+        for (int i = 0; i < sn; i++) free(S[i]);
+        free(S);
+    }
+    assert(multiply_matrix_rns_int8_streaming(SA, SB, sn, sm, sp, wide, 2, RNS_RESIDUES_CENTERED, NULL) == NULL);
+
     printf("test_matrix_rns_mul_int8: passed\n");
 
     // Free memory
     free_matrix_int8(A, n);
     free_matrix_int8(B, m);
+    free_matrix_int8(SA, sn);
+    free_matrix_int8(SB, sm);
     for (int i = 0; i < n; i++) free(C[i]);
     free(C);
 
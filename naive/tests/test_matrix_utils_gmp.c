@@ -1,7 +1,22 @@
 #include <stdio.h>
 #include <assert.h>
+#include <pthread.h>
 #include "matrix_utils_gmp.h"
 
+// Heap mpz_t that grow and shrink while other threads create and free arenas
+static void* churn(void* arg) {
+    (void) arg;
+    for (int round = 0; round < 2000; round++) {
+        mpz_t x;
+        mpz_init(x);
+        mpz_ui_pow_ui(x, 5, 100 + round % 700);
+        mpz_mul(x, x, x);
+        mpz_realloc2(x, 64);
+        mpz_clear(x);
+    }
+    return NULL;
+}
+
 int main() {
     int n = 2, m = 2;
     mpz_t** mat = allocate_mpz_matrix(n, m);
@@ -29,5 +44,79 @@ int main() {
 
     // Free memory
     free_mpz_matrix(mat, n, m);
+    assert(!mpz_matrix_is_arena(mat));
+
+    // Arena matrices: 128-bit slots, two alive at once
+    void* (*alloc_fn)(size_t);
+    void* (*realloc_fn)(void*, size_t, size_t);
+    void (*free_fn)(void*, size_t);
+    mp_get_memory_functions(&alloc_fn, &realloc_fn, &free_fn);
+
+    int an = 3, am = 5;
+    mpz_t** X = allocate_mpz_matrix_arena(an, am, 128);
+    mpz_t** Y = allocate_mpz_matrix_arena(am, an, 128);
+    assert(mpz_matrix_is_arena(X) && mpz_matrix_is_arena(Y));
+    for (int i = 0; i < an; i++) {
+        for (int j = 0; j < am; j++) {
+            assert(mpz_sgn(X[i][j]) == 0);
+            mpz_set_si(X[i][j], (long) (i - j) * 1000003L);
+            mpz_mul(X[i][j], X[i][j], X[i][j]);
+            mpz_set(Y[j][i], X[i][j]);
+        }
+    }
+    assert(mpz_matrix_arena_spills(X) == 0 && mpz_matrix_arena_spills(Y) == 0);
+
+    // Entries that outgrow their slot spill to the heap, in place and through aliasing
+    mpz_ui_pow_ui(X[1][2], 7, 400);
+    mpz_mul(X[2][3], X[1][2], X[1][2]);
+    mpz_mul(Y[1][0], Y[1][0], X[1][2]);
+    assert(mpz_matrix_arena_spills(X) == 2 && mpz_matrix_arena_spills(Y) == 1);
+    mpz_t check;
+    mpz_init(check);
+    mpz_ui_pow_ui(check, 7, 800);
+    assert(mpz_cmp(X[2][3], check) == 0);
+
+    // Swaps inside an arena, and across arenas if swapped back before the free
+    mpz_swap(X[1][2], X[0][0]);
+    mpz_set(check, Y[1][0]);
+    mpz_swap(X[0][1], Y[1][0]);
+    assert(mpz_cmp(X[0][1], check) == 0);
+    mpz_swap(X[0][1], Y[1][0]);
+    mpz_clear(check);
+    mpz_clear(X[2][4]);   // a cleared slot is left to the arena
+
+    free_mpz_matrix(X, an, am);
+    assert(!mpz_matrix_is_arena(X) && mpz_matrix_is_arena(Y));
+    mpz_add_ui(Y[4][2], Y[4][2], 1);
+    free_mpz_matrix(Y, am, an);
+
+    void* (*alloc_after)(size_t);
+    void* (*realloc_after)(void*, size_t, size_t);
+    void (*free_after)(void*, size_t);
+    mp_get_memory_functions(&alloc_after, &realloc_after, &free_after);
+    // The wrappers stay installed and forward every other pointer
+    assert(alloc_after == alloc_fn && realloc_after != realloc_fn && free_after != free_fn);
+    mpz_t big;
+    mpz_init(big);
+    mpz_ui_pow_ui(big, 3, 5000);
+    mpz_clear(big);
+
+    // More live arenas than the wrappers' snapshot holds, with GMP busy on other threads
+    pthread_t threads[2];
+    for (int t = 0; t < 2; t++) pthread_create(&threads[t], NULL, churn, NULL);
+    for (int round = 0; round < 20; round++) {
+        mpz_t** Z[24];
+        for (int a = 0; a < 24; a++) {
+            Z[a] = allocate_mpz_matrix_arena(2, 2, 64);
+            mpz_ui_pow_ui(Z[a][1][1], 3, 200 + a);
+        }
+        for (int a = 0; a < 24; a++) {
+            assert(mpz_matrix_arena_spills(Z[a]) == 1);
+            free_mpz_matrix(Z[a], 2, 2);
+        }
+    }
+    for (int t = 0; t < 2; t++) pthread_join(threads[t], NULL);
+
+    printf("test_matrix_utils_gmp: passed\n");
     return 0;
 }
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include <assert.h>
+#include "mixed_radix.h"
+#include "mixed_radix_gmp.h"
+#include "rns_basis.h"
+
+// Residues of count values modulo each modulus, as contiguous planes
+static int** residues_of(mpz_t* values, long count, const int* moduli, int k) {
+    int** res = malloc(k * sizeof(int*));
+    for (int i = 0; i < k; i++) {
+        res[i] = malloc(count * sizeof(int));
+        for (long e = 0; e < count; e++) {
+            res[i][e] = (int) mpz_fdiv_ui(values[e], (unsigned long) moduli[i]);
+        }
+    }
+    return res;
+}
+
+static void free_residues(int** res, int k) {
+    for (int i = 0; i < k; i++) free(res[i]);
+    free(res);
+}
+
+// Reconstruct count values within ±2^bits (and the extremes ±M/2) through both outputs
+static void check_basis(const int* moduli, int k, long count, int bits, gmp_randstate_t state) {
+    MRBasis* basis = mr_basis_create(moduli, k);
+    assert(basis != NULL);
+
+    mpz_t M, half;
+    mpz_init_set_ui(M, 1);
+    for (int i = 0; i < k; i++) mpz_mul_ui(M, M, (unsigned long) moduli[i]);
+    mpz_init(half);
+    mpz_fdiv_q_2exp(half, M, 1);
+
+    mpz_t* values = malloc(count * sizeof(mpz_t));
+    mpz_t* out = malloc(count * sizeof(mpz_t));
+    for (long e = 0; e < count; e++) {
+        mpz_init(values[e]);
+        mpz_init(out[e]);
+        mpz_urandomb(values[e], state, (mp_bitcnt_t) bits);
+        if (e % 2 == 1) mpz_neg(values[e], values[e]);
+    }
+    mpz_set_ui(values[0], 0);
+    mpz_set(values[1], half);                       // floor(M/2), the largest value
+    mpz_sub(values[2], half, M);                    // floor(M/2) - M
+    mpz_add_ui(values[2], values[2], 1);            // the smallest value
+    mpz_set_si(values[3], -1);
+
+    int** res = residues_of(values, count, moduli, k);
+    mixed_radix_reconstruct_centered_mpz(basis, (const int* const*) res, count, out);
+    for (long e = 0; e < count; e++) assert(mpz_cmp(out[e], values[e]) == 0);
+
+    // Digits: x mod M = sum_i d_i · m_0···m_{i-1}
+    uint32_t** d = malloc(k * sizeof(uint32_t*));
+    for (int i = 0; i < k; i++) d[i] = malloc(count * sizeof(uint32_t));
+    mixed_radix_digits(basis, (const int* const*) res, count, d);
+    mpz_t x, radix, ref;
+    mpz_inits(x, radix, ref, NULL);
+    for (long e = 4; e < count; e += 97) {
+        mpz_set_ui(x, 0);
+        mpz_set_ui(radix, 1);
+        for (int i = 0; i < k; i++) {
+            assert(d[i][e] < (uint32_t) moduli[i]);
+            mpz_addmul_ui(x, radix, d[i][e]);
+            mpz_mul_ui(radix, radix, (unsigned long) moduli[i]);
+        }
+        mpz_mod(ref, values[e], M);
+        assert(mpz_cmp(x, ref) == 0);
+    }
+    mpz_clears(x, radix, ref, NULL);
+
+    // int64 output: exact where the value fits, and the overflow count is exact
+    int64_t* out64 = malloc(count * sizeof(int64_t));
+    long bad = mixed_radix_reconstruct_centered_int64(basis, (const int* const*) res, count, out64);
+    long expected_bad = 0;
+    for (long e = 0; e < count; e++) {
+        if (mpz_fits_slong_p(values[e])) {
+            assert(out64[e] == mpz_get_si(values[e]));
+        } else {
+            expected_bad++;
+        }
+    }
+    assert(bad == expected_bad);
+
+    free(out64);
+    for (int i = 0; i < k; i++) free(d[i]);
+    free(d);
+    free_residues(res, k);
+    for (long e = 0; e < count; e++) {
+        mpz_clear(values[e]);
+        mpz_clear(out[e]);
+    }
+    free(values);
+    free(out);
+    mpz_clears(M, half, NULL);
+    mr_basis_free(basis);
+}
+
+int main() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 11);
+
+    // 8-bit moduli as used by the int8 kernels, in decreasing order
+    int small[] = {251, 241, 239};
+    check_basis(small, 3, 1000, 21, state);
+
+    // An even modulus (M even), increasing sizes
+    int even[] = {3, 7, 256, 65537};
+    check_basis(even, 4, 500, 20, state);
+
+    // 28-bit primes: values around 2^63 exercise the exact int64 range test
+    int* primes = rns_basis_primes(28, 24);
+    check_basis(primes, 3, 600, 60, state);
+    check_basis(primes, 3, 600, 64, state);
+    check_basis(primes, 3, 600, 80, state);
+
+    // Large basis, M ~ 2^670
+    check_basis(primes, 24, 700, 600, state);
+    free(primes);
+
+    // Mixed widths so that m_j > m_i on some steps
+    int mixed[] = {2147483647, 65521, 2147483629, 251, 1073741789};
+    check_basis(mixed, 5, 500, 100, state);
+
+    // The int64 path on -1 and 0
+    MRBasis* b = mr_basis_create(small, 3);
+    int zeros[3] = {0, 0, 0}, minus_one[3] = {250, 240, 238};
+    const int* r0[3] = {&zeros[0], &zeros[1], &zeros[2]};
+    const int* r1[3] = {&minus_one[0], &minus_one[1], &minus_one[2]};
+    int64_t v;
+    assert(mixed_radix_reconstruct_centered_int64(b, r0, 1, &v) == 0 && v == 0);
+    assert(mixed_radix_reconstruct_centered_int64(b, r1, 1, &v) == 0 && v == -1);
+    mr_basis_free(b);
+
+    // Moduli that are not pairwise coprime
+    int not_coprime[] = {15, 7, 21};
+    assert(mr_basis_create(not_coprime, 3) == NULL);
+
+    gmp_randclear(state);
+    printf("test_mixed_radix: passed\n");
+    return 0;
+}
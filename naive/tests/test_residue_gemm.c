@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "residue_gemm.h"
+#include "thread_pool.h"
+#include "matrix_utils_int8.h"
+#include "matrix_rns_mul_int8.h"
+
+int main() {
+    // Kernel against a direct reference, including a modulus close to 2^31
+    int n = 7, m = 45, p = 9;
+    int mods[] = {257, 65521, 2147483647};
+    int* A = malloc(n * m * sizeof(int));
+    int* B = malloc(m * p * sizeof(int));
+    int* C = malloc(n * p * sizeof(int));
+
+    srand(1);
+    for (int t = 0; t < 3; t++) {
+        int mod = mods[t];
+        for (int i = 0; i < n * m; i++) A[i] = (int) (((unsigned) rand() * 2654435761u) % (unsigned) mod);
+        for (int i = 0; i < m * p; i++) B[i] = (int) (((unsigned) rand() * 2246822519u) % (unsigned) mod);
+
+        residue_gemm_rows(A, m, B, p, C, p, m, p, mod, 0, n);
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) {
+                uint64_t ref = 0;
+                for (int r = 0; r < m; r++) {
+                    ref = (ref + (uint64_t) A[i * m + r] * (uint64_t) B[r * p + j]) % (uint64_t) mod;
+                }
+                assert((uint64_t) C[i * p + j] == ref);
+            }
+        }
+    }
+    assert(residue_gemm_reduction_window(2147483647) >= 1);
+    free(A); free(B); free(C);
+
+    // Parallel RNS product with fewer and more moduli than workers
+    int n2 = 13, m2 = 20, p2 = 11;
+    int8_t** A2 = allocate_matrix_int8(n2, m2);
+    int8_t** B2 = allocate_matrix_int8(m2, p2);
+    for (int i = 0; i < n2; i++) for (int j = 0; j < m2; j++) A2[i][j] = (int8_t) ((i * 7 + j * 3) % 50);
+    for (int i = 0; i < m2; i++) for (int j = 0; j < p2; j++) B2[i][j] = (int8_t) ((i * 5 + j * 11) % 60);
+
+    int moduli[] = {251, 241, 239};
+    int threads[] = {1, 2, 5};
+    for (int s = 0; s < 3; s++) {
+        ThreadPool* pool = thread_pool_create(threads[s], 1);
+        int64_t** C2 = multiply_matrix_rns_int8_pool(A2, B2, n2, m2, p2, moduli, 3, pool);
+        for (int i = 0; i < n2; i++) {
+            for (int j = 0; j < p2; j++) {
+                int64_t ref = 0;
+                for (int r = 0; r < m2; r++) ref += A2[i][r] * B2[r][j];
+                assert(C2[i][j] == ref);
+            }
+            free(C2[i]);
+        }
+        free(C2);
+        thread_pool_destroy(pool);
+    }
+
+    free_matrix_int8(A2, n2);
+    free_matrix_int8(B2, m2);
+
+    printf("test_residue_gemm: passed\n");
+    return 0;
+}
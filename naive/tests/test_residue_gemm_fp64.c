@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "residue_gemm_fp64.h"
+#include "thread_pool.h"
+
+// Random residues in [0, mod) in contiguous planes, accessible as X[idx][row][col]
+static int*** random_planes(int k, int rows, int cols, const int* moduli) {
+    int*** planes = malloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) {
+        planes[idx] = malloc(rows * sizeof(int*));
+        int* data = malloc((size_t) rows * cols * sizeof(int));
+        for (int i = 0; i < rows; i++) {
+            planes[idx][i] = data + (size_t) i * cols;
+            for (int j = 0; j < cols; j++) {
+                // Mostly extreme residues, which maximize the products
+                int r = rand();
+                planes[idx][i][j] = (r & 3) ? (moduli[idx] / 2 + (r >> 2) % 2) % moduli[idx]
+                                            : (r >> 2) % moduli[idx];
+            }
+        }
+    }
+    return planes;
+}
+
+static void free_planes(int*** planes, int k) {
+    for (int idx = 0; idx < k; idx++) {
+        free(planes[idx][0]);
+        free(planes[idx]);
+    }
+    free(planes);
+}
+
+static void check_kernel(ResidueFp64Kernel kernel, int n, int m, int p, ThreadPool* pool) {
+    int moduli[] = {RESIDUE_FP64_MAX_MODULUS, 67108859, 1048573, 251, 2};   // 2^26, primes, even
+    int k = 5;
+    int*** A = random_planes(k, n, m, moduli);
+    int*** B = random_planes(k, m, p, moduli);
+    int*** C = random_planes(k, n, p, moduli);
+
+    residue_gemm_fp64_rns(A, B, C, moduli, k, n, m, p, kernel, pool);
+
+    for (int idx = 0; idx < k; idx++) {
+        uint64_t mod = (uint64_t) moduli[idx];
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) {
+                uint64_t ref = 0;
+                for (int r = 0; r < m; r++) ref = (ref + (uint64_t) A[idx][i][r] * B[idx][r][j]) % mod;
+                assert((uint64_t) C[idx][i][j] == ref);
+            }
+        }
+    }
+
+    free_planes(A, k);
+    free_planes(B, k);
+    free_planes(C, k);
+}
+
+int main() {
+    srand(9);
+    ThreadPool* pool = thread_pool_create(3, 1);
+
+    for (int kr = 0; kr < RESIDUE_FP64_NUM_KERNELS; kr++) {
+        if (!residue_gemm_fp64_kernel_available(kr)) {
+            printf("  kernel %s not available, skipped\n", residue_gemm_fp64_kernel_name(kr));
+            continue;
+        }
+        check_kernel(kr, 1, 1, 1, NULL);
+        check_kernel(kr, 5, 3, 7, NULL);
+        check_kernel(kr, 19, 70, 33, pool);
+        check_kernel(kr, 40, 129, 17, pool);
+        printf("  kernel %s: ok\n", residue_gemm_fp64_kernel_name(kr));
+    }
+
+    // Exactness limit of the window
+    assert(residue_gemm_fp64_window(RESIDUE_FP64_MAX_MODULUS) >= 7);
+    assert(residue_gemm_fp64_window(251) > 1000000);
+    for (int mod = 3; mod <= RESIDUE_FP64_MAX_MODULUS; mod = mod * 3 + 1) {
+        double h = mod / 2;
+        assert(residue_gemm_fp64_window(mod) * h * h + 2.0 * mod <= 0x1p53);
+    }
+
+    thread_pool_destroy(pool);
+    printf("test_residue_gemm_fp64: passed\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "residue_gemm_int8.h"
+#include "thread_pool.h"
+#include "matrix_utils_int8.h"
+#include "matrix_rns_mul_int8.h"
+
+// Random centered residues in contiguous planes, accessible as X[idx][row][col]
+static int8_t*** random_planes(int k, int rows, int cols, const int* moduli) {
+    int8_t*** planes = malloc(k * sizeof(int8_t**));
+    for (int idx = 0; idx < k; idx++) {
+        int h = moduli[idx] / 2;
+        planes[idx] = malloc(rows * sizeof(int8_t*));
+        int8_t* data = malloc((size_t) rows * cols);
+        for (int i = 0; i < rows; i++) {
+            planes[idx][i] = data + (size_t) i * cols;
+            for (int j = 0; j < cols; j++) planes[idx][i][j] = (int8_t) (rand() % (2 * h + 1) - h);
+        }
+    }
+    return planes;
+}
+
+static void free_planes(void* planes_ptr, int k) {
+    void*** planes = (void***) planes_ptr;
+    for (int idx = 0; idx < k; idx++) {
+        free(planes[idx][0]);
+        free(planes[idx]);
+    }
+    free(planes);
+}
+
+static void check_kernel(ResidueInt8Kernel kernel, int n, int m, int p, ThreadPool* pool) {
+    int moduli[] = {255, 251, 7};
+    int k = 3;
+    int8_t*** A = random_planes(k, n, m, moduli);
+    int8_t*** B = random_planes(k, m, p, moduli);
+    int*** C = malloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) {
+        C[idx] = malloc(n * sizeof(int*));
+        int* data = malloc((size_t) n * p * sizeof(int));
+        for (int i = 0; i < n; i++) C[idx][i] = data + (size_t) i * p;
+    }
+
+    residue_gemm_int8_rns(A, B, C, moduli, k, n, m, p, kernel, pool);
+
+    for (int idx = 0; idx < k; idx++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) {
+                int64_t ref = 0;
+                for (int r = 0; r < m; r++) ref += A[idx][i][r] * B[idx][r][j];
+                ref %= moduli[idx];
+                if (ref < 0) ref += moduli[idx];
+                assert(C[idx][i][j] == ref);
+            }
+        }
+    }
+
+    free_planes(A, k);
+    free_planes(B, k);
+    free_planes(C, k);
+}
+
+int main() {
+    srand(7);
+    ThreadPool* pool = thread_pool_create(3, 1);
+
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        if (!residue_gemm_int8_kernel_available(kr)) {
+            printf("  kernel %s not available, skipped\n", residue_gemm_int8_kernel_name(kr));
+            continue;
+        }
+        check_kernel(kr, 1, 1, 1, NULL);
+        check_kernel(kr, 5, 3, 7, NULL);
+        check_kernel(kr, 19, 70, 33, pool);
+        check_kernel(kr, 40, 129, 17, pool);
+        // K longer than the int32 window of every kernel
+        check_kernel(kr, 2, 140000, 2, NULL);
+        printf("  kernel %s: ok\n", residue_gemm_int8_kernel_name(kr));
+    }
+    assert(residue_gemm_int8_window(255, RESIDUE_INT8_AMX) > residue_gemm_int8_window(255, RESIDUE_INT8_AVX512));
+
+    // Centered representation through the RNS product
+    int n = 9, m = 31, p = 6;
+    int8_t** A = allocate_matrix_int8(n, m);
+    int8_t** B = allocate_matrix_int8(m, p);
+    for (int i = 0; i < n; i++) for (int j = 0; j < m; j++) A[i][j] = (int8_t) (rand() % 256 - 128);
+    for (int i = 0; i < m; i++) for (int j = 0; j < p; j++) B[i][j] = (int8_t) (rand() % 256 - 128);
+
+    int moduli[] = {251, 241, 239};
+    int64_t** C = multiply_matrix_rns_int8_repr(A, B, n, m, p, moduli, 3, RNS_RESIDUES_CENTERED, pool);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            int64_t ref = 0;
+            for (int r = 0; r < m; r++) ref += A[i][r] * B[r][j];
+            assert(C[i][j] == ref);
+        }
+        free(C[i]);
+    }
+    free(C);
+
+    int bad_moduli[] = {257, 263};
+    assert(multiply_matrix_rns_int8_repr(A, B, n, m, p, bad_moduli, 2, RNS_RESIDUES_CENTERED, pool) == NULL);
+
+    free_matrix_int8(A, n);
+    free_matrix_int8(B, m);
+    thread_pool_destroy(pool);
+
+    printf("test_residue_gemm_int8: passed\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "residue_gemm_out_of_core.h"
+#include "matrix_file.h"
+#include "thread_pool.h"
+
+#define A_FILE "test_ooc_a.mat"
+#define B_FILE "test_ooc_b.mat"
+#define C_FILE "test_ooc_c.mat"
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static int8_t random_int8(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (int8_t) (rng_state >> 24);
+}
+
+static int8_t* random_matrix(int rows, int cols) {
+    int8_t* X = malloc((size_t) rows * cols + 1);
+    for (long e = 0; e < (long) rows * cols; e++) X[e] = random_int8();
+    return X;
+}
+
+static int8_t centered(int v, int mod) {
+    int r = ((v % mod) + mod) % mod;
+    return (int8_t) (r > mod / 2 ? r - mod : r);
+}
+
+// Checks every plane of C_FILE against the exact product reduced modulo each modulus
+static void check_output(const int8_t* A, const int8_t* B, int n, int m, int p, const int* moduli, int k) {
+    MatrixFile* C = matrix_file_open(C_FILE, 1);
+    assert(C && C->type == MATRIX_FILE_INT32 && C->rows == n && C->cols == p && C->planes == k);
+    assert(C->moduli && memcmp(C->moduli, moduli, k * sizeof(int)) == 0);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            long exact = 0;
+            for (int r = 0; r < m; r++) exact += (long) A[(size_t) i * m + r] * B[(size_t) r * p + j];
+            for (int l = 0; l < k; l++) {
+                const int32_t* plane = (const int32_t*) matrix_file_plane(C, l);
+                long want = ((exact % moduli[l]) + moduli[l]) % moduli[l];
+                assert(plane[(size_t) i * C->row_stride + j] == want);
+            }
+        }
+    }
+    matrix_file_close(C);
+}
+
+static void write_plain(const char* path, const int8_t* X, int rows, int cols) {
+    const void* planes[1] = { X };
+    assert(matrix_file_write(path, MATRIX_FILE_INT8, rows, cols, 1, planes, cols, NULL) == 0);
+}
+
+static void write_residues(const char* path, const int8_t* X, int rows, int cols, const int* moduli, int k) {
+    int8_t** res = malloc(k * sizeof(int8_t*));
+    for (int l = 0; l < k; l++) {
+        res[l] = malloc((size_t) rows * cols + 1);
+        for (long e = 0; e < (long) rows * cols; e++) res[l][e] = centered(X[e], moduli[l]);
+    }
+    assert(matrix_file_write(path, MATRIX_FILE_INT8, rows, cols, k, (const void* const*) res, cols, moduli) == 0);
+    for (int l = 0; l < k; l++) free(res[l]);
+    free(res);
+}
+
+int main() {
+    int moduli[4] = { 251, 241, 239, 233 };
+    ThreadPool* pool = thread_pool_create(3, 0);
+
+    // Tiles that divide none of the dimensions, so every edge case of the block walk shows up
+    int n = 45, m = 103, p = 37;
+    int8_t* A = random_matrix(n, m);
+    int8_t* B = random_matrix(m, p);
+    write_plain(A_FILE, A, n, m);
+    write_plain(B_FILE, B, m, p);
+    OutOfCoreTiles tiles = { 16, 24, 10 };
+    for (int kernel = 0; kernel < RESIDUE_INT8_NUM_KERNELS; kernel++) {
+        if (!residue_gemm_int8_kernel_available((ResidueInt8Kernel) kernel)) continue;
+        assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 4, &tiles, (ResidueInt8Kernel) kernel,
+                                             pool) == 0);
+        check_output(A, B, n, m, p, moduli, 4);
+    }
+
+    // Residue planes on one side, sequential run, default tiles (one block)
+    write_residues(B_FILE, B, m, p, moduli, 3);
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 3, NULL, RESIDUE_INT8_SCALAR, NULL) == 0);
+    check_output(A, B, n, m, p, moduli, 3);
+    OutOfCoreTiles deep = { 0, 7, 0 };
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 3, &deep,
+                                         residue_gemm_int8_default_kernel(), pool) == 0);
+    check_output(A, B, n, m, p, moduli, 3);
+
+    // Mismatched basis, shapes and types
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 4, NULL, RESIDUE_INT8_SCALAR, pool) == -1);
+    int other[3] = { 251, 241, 229 };
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, other, 3, NULL, RESIDUE_INT8_SCALAR, pool) == -1);
+    int wide[1] = { 257 };
+    assert(residue_gemm_int8_out_of_core(A_FILE, A_FILE, C_FILE, wide, 1, NULL, RESIDUE_INT8_SCALAR, pool) == -1);
+    assert(residue_gemm_int8_out_of_core(A_FILE, A_FILE, C_FILE, moduli, 1, NULL, RESIDUE_INT8_SCALAR, pool) == -1);
+    assert(residue_gemm_int8_out_of_core(A_FILE, "no_such_file.mat", C_FILE, moduli, 1, NULL, RESIDUE_INT8_SCALAR,
+                                         pool) == -1);
+    int32_t wide_entries[4] = { 1, 2, 3, 4 };
+    const void* planes[1] = { wide_entries };
+    assert(matrix_file_write(B_FILE, MATRIX_FILE_INT32, 2, 2, 1, planes, 2, NULL) == 0);
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 1, NULL, RESIDUE_INT8_SCALAR, pool) == -1);
+
+    // Empty inner dimension: a zero product
+    write_plain(A_FILE, A, 5, 0);
+    write_plain(B_FILE, B, 0, 6);
+    assert(residue_gemm_int8_out_of_core(A_FILE, B_FILE, C_FILE, moduli, 2, &tiles, RESIDUE_INT8_SCALAR, pool) == 0);
+    check_output(A, B, 5, 0, 6, moduli, 2);
+
+    free(A);
+    free(B);
+    thread_pool_destroy(pool);
+    remove(A_FILE);
+    remove(B_FILE);
+    remove(C_FILE);
+    printf("All out-of-core residue GEMM tests passed.\n");
+    return 0;
+}
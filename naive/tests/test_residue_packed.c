@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "residue_packed.h"
+#include "residue_gemm_int8.h"
+#include "rns_conversion_int8.h"
+#include "matrix_utils_int8.h"
+#include "thread_pool.h"
+
+static int*** alloc_planes(int k, int n, int m) {
+    int*** P = malloc(k * sizeof(int**));
+    for (int l = 0; l < k; l++) {
+        P[l] = malloc(n * sizeof(int*));
+        int* plane = calloc((size_t) n * m + 1, sizeof(int));
+        for (int i = 0; i < n; i++) P[l][i] = plane + (size_t) i * m;
+    }
+    return P;
+}
+
+static void free_planes(int*** P, int k) {
+    for (int l = 0; l < k; l++) {
+        free(P[l][0]);
+        free(P[l]);
+    }
+    free(P);
+}
+
+int main() {
+    assert(residue_packed_bits(2) == 1 && residue_packed_bits(3) == 2 && residue_packed_bits(64) == 6);
+    assert(residue_packed_bits(65) == 7 && residue_packed_bits(256) == 8);
+    assert(residue_packed_bits(1) == 0 && residue_packed_bits(257) == 0);
+
+    // Rows of every length around the 64-residue block, every width, every kernel
+    uint8_t src[200], out[200 + 1];
+    uint64_t words[4 * 8 + 1];
+    int mods[] = { 2, 3, 5, 7, 16, 17, 61, 64, 127, 128, 129, 251, 255, 256 };
+    for (int kr = 0; kr < RESIDUE_PACK_NUM_KERNELS; kr++) {
+        if (!residue_pack_kernel_available(kr)) continue;
+        for (int q = 0; q < (int) (sizeof(mods) / sizeof(mods[0])); q++) {
+            int mod = mods[q], bits = residue_packed_bits(mod);
+            for (int count = 0; count <= 200; count += (count < 70 ? 1 : 61)) {
+                for (int e = 0; e < count; e++) src[e] = (uint8_t) ((e * 89 + count * 7 + q) % mod);
+                memset(words, 0xA5, sizeof(words));
+                residue_pack_row(src, count, bits, words, (ResiduePackKernel) kr);
+                out[count] = 0x5A;
+                residue_unpack_row(words, count, bits, 0, out, (ResiduePackKernel) kr);
+                assert(memcmp(src, out, count) == 0 && out[count] == 0x5A);
+                residue_unpack_row(words, count, bits, mod, out, (ResiduePackKernel) kr);
+                for (int e = 0; e < count; e++) {
+                    int r = src[e] > mod / 2 ? src[e] - mod : src[e];
+                    assert((int8_t) out[e] == (int8_t) r);
+                }
+                // The layout is the same for every kernel
+                uint64_t ref[4 * 8];
+                residue_pack_row(src, count, bits, ref, RESIDUE_PACK_SCALAR);
+                assert(memcmp(ref, words, ((count + 63) / 64) * bits * sizeof(uint64_t)) == 0);
+            }
+        }
+    }
+
+    // Packed RNS matrices against the int and centered planes they came from
+    int n = 37, m = 150, p = 29;
+    int8_t** A = allocate_matrix_int8(n, m);
+    int8_t** B = allocate_matrix_int8(m, p);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++) A[i][j] = (int8_t) (i * 31 + j * 17 - 90);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < p; j++) B[i][j] = (int8_t) (i * 13 - j * 29 + 5);
+    int moduli[] = { 251, 127, 61, 31, 13 };
+    int k = 5;
+
+    RNSMatrix* ra = int8_matrix_to_rns(A, n, m, moduli, k);
+    PackedResidueMatrix* Pa = pack_residues(ra->residues, n, m, moduli, k);
+    assert(Pa && Pa->bits[0] == 8 && Pa->bits[2] == 6 && Pa->bits[4] == 4 && Pa->row_words[4] == 4 * 3);
+    int*** back = alloc_planes(k, n, m);
+    for (int l = 0; l < k; l++) {
+        unpack_residues(Pa, l, 0, n, back[l][0], m);
+        assert(memcmp(back[l][0], ra->residues[l][0], (size_t) n * m * sizeof(int)) == 0);
+    }
+    free_planes(back, k);
+
+    RNSMatrixCentered* ca = int8_matrix_to_rns_centered(A, n, m, moduli, k);
+    RNSMatrixCentered* cb = int8_matrix_to_rns_centered(B, m, p, moduli, k);
+    PackedResidueMatrix* Pc = pack_residues_centered(ca->residues, n, m, moduli, k);
+    PackedResidueMatrix* Pb = pack_residues_centered(cb->residues, m, p, moduli, k);
+    int8_t* rows = malloc((size_t) 5 * (m + 3));
+    for (int l = 0; l < k; l++) {
+        assert(memcmp(Pc->planes[l], Pa->planes[l], (size_t) n * Pa->row_words[l] * sizeof(uint64_t)) == 0);
+        unpack_residues_centered(Pc, l, 30, 5, rows, m + 3);
+        for (int i = 0; i < 5; i++) assert(memcmp(rows + (size_t) i * (m + 3), ca->residues[l][30 + i], m) == 0);
+    }
+    free(rows);
+
+    // GEMM from packed operands matches the one on int8 planes, kernel by kernel
+    ThreadPool* pool = thread_pool_create(3, 0);
+    int*** C0 = alloc_planes(k, n, p);
+    int*** C1 = alloc_planes(k, n, p);
+    for (int kr = 0; kr < RESIDUE_INT8_NUM_KERNELS; kr++) {
+        if (!residue_gemm_int8_kernel_available(kr)) continue;
+        residue_gemm_int8_rns(ca->residues, cb->residues, C0, moduli, k, n, m, p, (ResidueInt8Kernel) kr, pool);
+        residue_gemm_int8_rns_packed(Pc, Pb, C1, (ResidueInt8Kernel) kr, kr % 2 ? pool : NULL);
+        for (int l = 0; l < k; l++) assert(memcmp(C0[l][0], C1[l][0], (size_t) n * p * sizeof(int)) == 0);
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            long exact = 0;
+            for (int r = 0; r < m; r++) exact += (long) A[i][r] * B[r][j];
+            for (int l = 0; l < k; l++) assert(C1[l][i][j] == ((exact % moduli[l]) + moduli[l]) % moduli[l]);
+        }
+    }
+    free_planes(C0, k);
+    free_planes(C1, k);
+    thread_pool_destroy(pool);
+
+    int bad[] = { 251, 257 };
+    assert(pack_residues(ra->residues, n, m, bad, 2) == NULL);
+    assert(allocate_packed_residues(3, 3, bad + 1, 1) == NULL);
+
+    free_packed_residues(Pa);
+    free_packed_residues(Pb);
+    free_packed_residues(Pc);
+    free_rns_matrix(ra);
+    free_rns_matrix_centered(ca);
+    free_rns_matrix_centered(cb);
+    free_matrix_int8(A, n);
+    free_matrix_int8(B, m);
+    printf("test_residue_packed: passed\n");
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "residue_gemm.h"
+#include "residue_strassen.h"
+#include "thread_pool.h"
+
+static void fill(int* X, size_t count, int mod) {
+    for (size_t i = 0; i < count; i++) X[i] = (int) (((uint64_t) rand() * 2654435761u) % (uint64_t) mod);
+}
+
+int main() {
+    srand(9);
+
+    // Odd and even shapes, several recursion depths, including a modulus close to 2^31
+    int shapes[][3] = { {16, 16, 16}, {33, 17, 25}, {40, 64, 31}, {7, 50, 9}, {64, 63, 65} };
+    int mods[] = {251, 268435399, 2147483647};
+    int crossovers[] = {2, 4, 16};
+    for (int s = 0; s < 5; s++) {
+        int n = shapes[s][0], m = shapes[s][1], p = shapes[s][2];
+        for (int t = 0; t < 3; t++) {
+            int mod = mods[t];
+            int* A = malloc((size_t) n * m * sizeof(int));
+            int* B = malloc((size_t) m * p * sizeof(int));
+            int* C = malloc((size_t) n * p * sizeof(int));
+            int* R = malloc((size_t) n * p * sizeof(int));
+            fill(A, (size_t) n * m, mod);
+            fill(B, (size_t) m * p, mod);
+            residue_gemm_rows(A, m, B, p, R, p, m, p, mod, 0, n);
+            for (int c = 0; c < 3; c++) {
+                residue_gemm_strassen(A, m, B, p, C, p, n, m, p, mod, crossovers[c]);
+                for (int i = 0; i < n * p; i++) assert(C[i] == R[i]);
+            }
+            free(A); free(B); free(C); free(R);
+        }
+    }
+
+    // Views: multiply a 20 × 24 block of a wider plane into a block of a wider output
+    int lda = 40, ldb = 30, ldc = 50, mod = 65521;
+    int* A = malloc(30 * lda * sizeof(int));
+    int* B = malloc(40 * ldb * sizeof(int));
+    int* C = calloc(30 * ldc, sizeof(int));
+    int* R = calloc(30 * ldc, sizeof(int));
+    fill(A, 30 * lda, mod);
+    fill(B, 40 * ldb, mod);
+    residue_gemm_rows(A + 3, lda, B + 2 * ldb + 1, ldb, R + 5, ldc, 24, 18, mod, 0, 20);
+    residue_gemm_strassen(A + 3, lda, B + 2 * ldb + 1, ldb, C + 5, ldc, 20, 24, 18, mod, 3);
+    for (int i = 0; i < 30 * ldc; i++) assert(C[i] == R[i]);
+    free(A); free(B); free(C); free(R);
+
+    // RNS planes on a pool
+    int n = 37, m = 29, p = 41, k = 3;
+    int moduli[] = {268435399, 268435367, 268435361};
+    int*** Ares = malloc(k * sizeof(int**));
+    int*** Bres = malloc(k * sizeof(int**));
+    int*** Cres = malloc(k * sizeof(int**));
+    int*** Rres = malloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) {
+        Ares[idx] = malloc(sizeof(int*));
+        Bres[idx] = malloc(sizeof(int*));
+        Cres[idx] = malloc(sizeof(int*));
+        Rres[idx] = malloc(sizeof(int*));
+        Ares[idx][0] = malloc((size_t) n * m * sizeof(int));
+        Bres[idx][0] = malloc((size_t) m * p * sizeof(int));
+        Cres[idx][0] = malloc((size_t) n * p * sizeof(int));
+        Rres[idx][0] = malloc((size_t) n * p * sizeof(int));
+        fill(Ares[idx][0], (size_t) n * m, moduli[idx]);
+        fill(Bres[idx][0], (size_t) m * p, moduli[idx]);
+    }
+    ThreadPool* pool = thread_pool_create(2, 1);
+    residue_gemm_rns_strassen(Ares, Bres, Cres, moduli, k, n, m, p, 8, pool);
+    residue_gemm_rns(Ares, Bres, Rres, moduli, k, n, m, p, NULL);
+    for (int idx = 0; idx < k; idx++) {
+        for (int i = 0; i < n * p; i++) assert(Cres[idx][0][i] == Rres[idx][0][i]);
+        free(Ares[idx][0]); free(Bres[idx][0]); free(Cres[idx][0]); free(Rres[idx][0]);
+        free(Ares[idx]); free(Bres[idx]); free(Cres[idx]); free(Rres[idx]);
+    }
+    free(Ares); free(Bres); free(Cres); free(Rres);
+    thread_pool_destroy(pool);
+
+    assert(residue_strassen_default_crossover() >= 2);
+
+    printf("test_residue_strassen: passed\n");
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <assert.h>
 #include "rns_conversion_gmp.h"
 #include "matrix_utils_gmp.h"
+#include "rns_basis.h"
 
 int main() {
     int n = 2, m = 2;
@@ -23,8 +24,44 @@ int main() {
     assert(rns->residues[0][0][0] == mpz_fdiv_ui(A[0][0], 7));
     assert(rns->residues[1][1][1] == mpz_fdiv_ui(A[1][1], 11));
 
+    // Direct loop and remainder tree agree with mpz_fdiv_ui, including
+    // entries below, around and far above the product of the moduli
+    int tn = 3, tm = 7, tk;
+    int* tmod = rns_basis_select(4000, 28, &tk);
+    long sizes[] = {0, 20, 300, 3000, 4100, 9000, 40000};
+    mpz_t** T = allocate_mpz_matrix(tn, tm);
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 7);
+    for (int i = 0; i < tn; i++) {
+        for (int j = 0; j < tm; j++) {
+            mpz_urandomb(T[i][j], state, sizes[j]);
+            if ((i + j) % 2) mpz_neg(T[i][j], T[i][j]);
+        }
+    }
+    mpz_set_ui(T[2][1], 1);
+    for (int idx = 0; idx < tk; idx++) mpz_mul_ui(T[2][1], T[2][1], (unsigned long) tmod[idx]);  // M
+    mpz_sub_ui(T[2][2], T[2][1], 1);                                                       // M - 1
+
+    ThreadPool* pool = thread_pool_create(3, 1);
+    for (int mode = RNS_MPZ_CONVERT_AUTO; mode <= RNS_MPZ_CONVERT_TREE; mode++) {
+        RNSMatrix* R = mpz_matrix_to_rns_pool(T, tn, tm, tmod, tk, (RNSMpzConversion) mode,
+                                              mode == RNS_MPZ_CONVERT_TREE ? pool : NULL);
+        for (int idx = 0; idx < tk; idx++)
+            for (int i = 0; i < tn; i++)
+                for (int j = 0; j < tm; j++)
+                    assert(R->residues[idx][i][j] == (int) mpz_fdiv_ui(T[i][j], tmod[idx]));
+        free_rns_matrix(R);
+    }
+    thread_pool_destroy(pool);
+    assert(!rns_remainder_tree_profitable(tk, 512) && rns_remainder_tree_profitable(1000, 1 << 17));
+
     printf("All GMP RNS conversion tests passed.\n");
 
+    gmp_randclear(state);
+    free_mpz_matrix(T, tn, tm);
+    free(tmod);
+
     free_mpz_matrix(A, n, m);
     free_rns_matrix(rns);
     return 0;
@@ -19,8 +19,49 @@ int main() {
     assert(rns->residues[0][0][0] == (1234 % 13));
     assert(rns->residues[1][0][1] == ((-5678 % 17 + 17) % 17));  // resultado positivo
 
+    // Every int16 value, in rows whose length is not a multiple of the SIMD width
+    int wn = 16, wm = 4097;
+    int16_t** W = allocate_matrix_int16(wn, wm);
+    for (int i = 0; i < wn; i++)
+        for (int j = 0; j < wm; j++) W[i][j] = (int16_t) (i * wm + j);
+    int wide[] = {1, 2, 3, 255, 32749, 32768, 65521, 1000003, 2147483647};
+    int kw = sizeof(wide) / sizeof(wide[0]);
+    RNSMatrix* wrns = int16_matrix_to_rns(W, wn, wm, wide, kw);
+    for (int idx = 0; idx < kw; idx++) {
+        for (int i = 0; i < wn; i++) {
+            for (int j = 0; j < wm; j++) {
+                int r = W[i][j] % wide[idx];
+                assert(wrns->residues[idx][i][j] == (r < 0 ? r + wide[idx] : r));
+            }
+        }
+    }
+
+    // Every kernel, including the ones that fall back, matches the default one
+    int* planes[sizeof(wide) / sizeof(wide[0])];
+    for (int idx = 0; idx < kw; idx++) planes[idx] = malloc((size_t) wn * wm * sizeof(int));
+    for (int kr = 0; kr < RNS_CONVERT_NUM_KERNELS; kr++) {
+        int16_matrix_to_rns_planes(W, wn, wm, wide, kw, planes, (RNSConvertKernel) kr);
+        for (int idx = 0; idx < kw; idx++)
+            for (int i = 0; i < wn; i++)
+                for (int j = 0; j < wm; j++) assert(planes[idx][(size_t) i * wm + j] == wrns->residues[idx][i][j]);
+    }
+    for (int idx = 0; idx < kw; idx++) free(planes[idx]);
+
+    // RNS_CONVERT_KERNEL picks the kernel of int16_matrix_to_rns
+    setenv("RNS_CONVERT_KERNEL", "scalar", 1);
+    assert(rns_convert_default_kernel() == RNS_CONVERT_SCALAR);
+    RNSMatrix* srns = int16_matrix_to_rns(W, wn, wm, wide, kw);
+    unsetenv("RNS_CONVERT_KERNEL");
+    for (int idx = 0; idx < kw; idx++)
+        for (int i = 0; i < wn; i++)
+            for (int j = 0; j < wm; j++) assert(srns->residues[idx][i][j] == wrns->residues[idx][i][j]);
+    free_rns_matrix(srns);
+
     printf("test_rns_conversion_int16: passed\n");
 
+    free_matrix_int16(W, wn);
+    free_rns_matrix(wrns);
+
     free_matrix_int16(A, n);
     free_rns_matrix(rns);
     return 0;
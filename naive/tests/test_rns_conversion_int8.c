@@ -19,8 +19,52 @@ int main() {
     assert(rns->residues[0][0][0] == (12 % 5));
     assert(rns->residues[1][0][1] == ((-9 % 11 + 11) % 11));  // garantir resultado positivo
 
+    // Every int8 value, rows of a length that is not a multiple of the SIMD width
+    int wn = 3, wm = 293;
+    int8_t** W = allocate_matrix_int8(wn, wm);
+    for (int i = 0; i < wn; i++)
+        for (int j = 0; j < wm; j++) W[i][j] = (int8_t) (i * 101 + j);
+    int wide[] = {1, 2, 3, 5, 11, 127, 128, 251, 255, 256, 257, 65537, 2147483647};
+    int kw = sizeof(wide) / sizeof(wide[0]);
+    int kc = 7;  // wide[2 .. 8] are centered-capable (3 <= m <= 255)
+
+    int** planes = malloc(kw * sizeof(int*));
+    int8_t** cplanes = malloc(kc * sizeof(int8_t*));
+    for (int idx = 0; idx < kw; idx++) planes[idx] = malloc((size_t) wn * wm * sizeof(int));
+    for (int idx = 0; idx < kc; idx++) cplanes[idx] = malloc((size_t) wn * wm);
+
+    for (int kr = 0; kr < RNS_CONVERT_NUM_KERNELS; kr++) {
+        if (!rns_convert_kernel_available(kr)) continue;
+        int8_matrix_to_rns_planes(W, wn, wm, wide, kw, planes, (RNSConvertKernel) kr);
+        int8_matrix_to_rns_centered_planes(W, wn, wm, wide + 2, kc, cplanes, (RNSConvertKernel) kr);
+        for (int i = 0; i < wn; i++) {
+            for (int j = 0; j < wm; j++) {
+                for (int idx = 0; idx < kw; idx++) {
+                    int r = W[i][j] % wide[idx];
+                    if (r < 0) r += wide[idx];
+                    assert(planes[idx][(size_t) i * wm + j] == r);
+                    if (idx >= 2 && idx < 2 + kc) {
+                        if (r > wide[idx] / 2) r -= wide[idx];
+                        assert(cplanes[idx - 2][(size_t) i * wm + j] == r);
+                    }
+                }
+            }
+        }
+    }
+
+    RNSMatrixCentered* crns = int8_matrix_to_rns_centered(W, wn, wm, wide + 2, kc);
+    assert(crns->residues[0][1][5] == cplanes[0][wm + 5]);
+    assert(int8_matrix_to_rns_centered(W, wn, wm, wide, kc) == NULL);
+    free_rns_matrix_centered(crns);
+
     printf("test_rns_conversion_int8: passed\n");
 
+    for (int idx = 0; idx < kw; idx++) free(planes[idx]);
+    for (int idx = 0; idx < kc; idx++) free(cplanes[idx]);
+    free(planes);
+    free(cplanes);
+    free_matrix_int8(W, wn);
+
     free_matrix_int8(A, n);
     free_rns_matrix(rns);
     return 0;
@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include <assert.h>
+#include "matrix_utils_wide.h"
+#include "rns_conversion_wide.h"
+#include "matrix_rns_mul_wide.h"
+#include "crt_reconstruct.h"
+#include "rns_basis.h"
+#include "thread_pool.h"
+
+// Entry e of W from x (two's complement, x must fit)
+static void wide_set_mpz(WideMatrix* W, size_t e, const mpz_t x) {
+    size_t count = (size_t) W->n * W->m;
+    mpz_t r;
+    mpz_init(r);
+    mpz_fdiv_r_2exp(r, x, (mp_bitcnt_t) 64 * W->limbs);
+    for (int l = 0; l < W->limbs; l++) {
+        mpz_t limb;
+        mpz_init(limb);
+        mpz_fdiv_q_2exp(limb, r, (mp_bitcnt_t) 64 * l);
+        mpz_fdiv_r_2exp(limb, limb, 64);
+        uint64_t w = 0;
+        mpz_export(&w, NULL, -1, sizeof(uint64_t), 0, 0, limb);
+        W->data[l * count + e] = w;
+        mpz_clear(limb);
+    }
+    mpz_clear(r);
+}
+
+static void wide_get_mpz(const WideMatrix* W, size_t e, mpz_t x) {
+    size_t count = (size_t) W->n * W->m;
+    mpz_set_ui(x, 0);
+    for (int l = W->limbs - 1; l >= 0; l--) {
+        mpz_mul_2exp(x, x, 64);
+        mpz_t limb;
+        mpz_init(limb);
+        uint64_t w = W->data[l * count + e];
+        mpz_import(limb, 1, -1, sizeof(uint64_t), 0, 0, &w);
+        mpz_add(x, x, limb);
+        mpz_clear(limb);
+    }
+    if ((int64_t) W->data[(W->limbs - 1) * count + e] < 0) {
+        mpz_t full;
+        mpz_init_set_ui(full, 1);
+        mpz_mul_2exp(full, full, (mp_bitcnt_t) 64 * W->limbs);
+        mpz_sub(x, x, full);
+        mpz_clear(full);
+    }
+}
+
+static int** alloc_planes(int k, size_t count) {
+    int** planes = malloc(k * sizeof(int*));
+    for (int i = 0; i < k; i++) planes[i] = malloc((count > 0 ? count : 1) * sizeof(int));
+    return planes;
+}
+
+static void free_planes(int** planes, int k) {
+    for (int i = 0; i < k; i++) free(planes[i]);
+    free(planes);
+}
+
+static void test_int64_access(void) {
+    WideMatrix* W = allocate_wide_matrix(2, 3, 130);
+    assert(W->limbs == 3);
+    assert(wide_matrix_max_bits(W) == 0);
+    wide_matrix_set_int64(W, 0, 1, -5);
+    wide_matrix_set_int64(W, 1, 2, INT64_MIN);
+    int64_t v;
+    assert(wide_matrix_get_int64(W, 0, 1, &v) && v == -5);
+    assert(wide_matrix_get_int64(W, 1, 2, &v) && v == INT64_MIN);
+    assert(wide_matrix_get_int64(W, 1, 0, &v) && v == 0);
+    assert(wide_matrix_max_bits(W) == 64);
+
+    // 2^64 does not fit
+    W->data[2 * 3 + 0] = 0;
+    W->data[6 + 0] = 1;
+    assert(!wide_matrix_get_int64(W, 0, 0, &v));
+    assert(wide_matrix_max_bits(W) == 65);
+    free_wide_matrix(W);
+}
+
+// Random n × m matrix of values within ±2^bits in a matrix of the given width
+static WideMatrix* random_wide(int n, int m, long bits, long width_bits, mpz_t* values,
+                               gmp_randstate_t state) {
+    WideMatrix* W = allocate_wide_matrix(n, m, width_bits);
+    size_t count = (size_t) n * m;
+    for (size_t e = 0; e < count; e++) {
+        mpz_urandomb(values[e], state, (mp_bitcnt_t) (e % 7 == 0 ? (size_t) bits : 1 + e % (size_t) bits));
+        if (e % 2 == 1) mpz_neg(values[e], values[e]);
+        wide_set_mpz(W, e, values[e]);
+    }
+    return W;
+}
+
+// Residues against mpz_fdiv_ui, then CRT back into a matrix of the same width
+static void check_round_trip(int n, int m, long bits, const int* moduli, int k, ThreadPool* pool,
+                             gmp_randstate_t state) {
+    size_t count = (size_t) n * m;
+    mpz_t* values = malloc(count * sizeof(mpz_t));
+    for (size_t e = 0; e < count; e++) mpz_init(values[e]);
+    WideMatrix* W = random_wide(n, m, bits, bits, values, state);
+    if (count > 2) {
+        // The extremes of the width
+        mpz_set_ui(values[0], 1);
+        mpz_mul_2exp(values[0], values[0], (mp_bitcnt_t) 64 * W->limbs - 1);
+        mpz_neg(values[1], values[0]);
+        mpz_sub_ui(values[0], values[0], 1);
+        mpz_set_si(values[2], -1);
+        for (int e = 0; e < 3; e++) wide_set_mpz(W, e, values[e]);
+    }
+
+    int** res = alloc_planes(k, count);
+    wide_matrix_to_rns_planes(W, moduli, k, res, pool);
+    for (int i = 0; i < k; i++) {
+        for (size_t e = 0; e < count; e++) {
+            assert(res[i][e] == (int) mpz_fdiv_ui(values[e], (unsigned long) moduli[i]));
+        }
+    }
+
+    // The basis covers the width: every entry comes back exactly
+    CRTBasis* basis = crt_basis_create(moduli, k);
+    WideMatrix* R = allocate_wide_matrix(n, m, bits);
+    long bad = wide_matrix_from_rns_planes(R, basis, (const int* const*) res, pool);
+    assert(bad == 0);
+    mpz_t x;
+    mpz_init(x);
+    for (size_t e = 0; e < count; e++) {
+        wide_get_mpz(R, e, x);
+        assert(mpz_cmp(x, values[e]) == 0);
+    }
+
+    mpz_clear(x);
+    crt_basis_free(basis);
+    free_wide_matrix(R);
+    free_wide_matrix(W);
+    free_planes(res, k);
+    for (size_t e = 0; e < count; e++) mpz_clear(values[e]);
+    free(values);
+}
+
+// 130-bit values reconstructed into one limb: exact where they fit, and the
+// wraps to the other sign are counted once |v| is past the E·M/2^64 window
+static void check_too_narrow(const int* moduli, int k, gmp_randstate_t state) {
+    int n = 30, m = 20;
+    size_t count = (size_t) n * m;
+    mpz_t* values = malloc(count * sizeof(mpz_t));
+    for (size_t e = 0; e < count; e++) mpz_init(values[e]);
+    WideMatrix* W = random_wide(n, m, 130, 130, values, state);
+    int** res = alloc_planes(k, count);
+    wide_matrix_to_rns_planes(W, moduli, k, res, NULL);
+
+    CRTBasis* basis = crt_basis_create(moduli, k);
+    WideMatrix* R = allocate_wide_matrix(n, m, 0);
+    long bad = wide_matrix_from_rns_planes(R, basis, (const int* const*) res, NULL);
+    long fits = 0, sign_wraps = 0;
+    mpz_t x;
+    mpz_init(x);
+    for (size_t e = 0; e < count; e++) {
+        wide_get_mpz(R, e, x);
+        if (mpz_sizeinbase(values[e], 2) < 63) {
+            assert(mpz_cmp(x, values[e]) == 0);
+            fits++;
+        } else if (mpz_sgn(x) != mpz_sgn(values[e])) {
+            sign_wraps++;
+        }
+    }
+    assert(fits > 0 && bad > 0 && bad <= sign_wraps);
+
+    mpz_clear(x);
+    crt_basis_free(basis);
+    free_wide_matrix(R);
+    free_wide_matrix(W);
+    free_planes(res, k);
+    for (size_t e = 0; e < count; e++) mpz_clear(values[e]);
+    free(values);
+}
+
+static void check_product(int n, int m, int p, long bits, ThreadPool* pool, gmp_randstate_t state) {
+    mpz_t* a = malloc((size_t) n * m * sizeof(mpz_t));
+    mpz_t* b = malloc((size_t) m * p * sizeof(mpz_t));
+    for (size_t e = 0; e < (size_t) n * m; e++) mpz_init(a[e]);
+    for (size_t e = 0; e < (size_t) m * p; e++) mpz_init(b[e]);
+    WideMatrix* A = random_wide(n, m, bits, bits, a, state);
+    WideMatrix* B = random_wide(m, p, bits / 2 + 1, bits, b, state);
+
+    WideMatrix* C = multiply_matrix_rns_wide(A, B, pool);
+    assert(C != NULL && C->n == n && C->m == p);
+    mpz_t x, sum;
+    mpz_init(x);
+    mpz_init(sum);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            mpz_set_ui(sum, 0);
+            for (int l = 0; l < m; l++) mpz_addmul(sum, a[(size_t) i * m + l], b[(size_t) l * p + j]);
+            wide_get_mpz(C, (size_t) i * p + j, x);
+            assert(mpz_cmp(x, sum) == 0);
+        }
+    }
+    if (p != m) assert(multiply_matrix_rns_wide(B, B, pool) == NULL);
+
+    mpz_clear(x);
+    mpz_clear(sum);
+    free_wide_matrix(A);
+    free_wide_matrix(B);
+    free_wide_matrix(C);
+    for (size_t e = 0; e < (size_t) n * m; e++) mpz_clear(a[e]);
+    for (size_t e = 0; e < (size_t) m * p; e++) mpz_clear(b[e]);
+    free(a);
+    free(b);
+}
+
+int main() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 11);
+    ThreadPool* pool = thread_pool_create(3, 0);
+
+    test_int64_access();
+
+    // Widths from one limb to ten (three reductions per modulus), small and 31-bit moduli
+    int* primes = rns_basis_primes(28, 30);
+    for (long bits = 40; bits <= 600; bits += 80) {
+        int k = (int) (64 * (bits / 64 + 1) / 27 + 1);
+        check_round_trip(17, 31, bits, primes, k, NULL, state);
+        check_round_trip(70, 90, bits, primes, k, pool, state);
+    }
+    int mixed[] = {3, 5, 7, 251, 65537, 2147483647};
+    int k_mixed = sizeof(mixed) / sizeof(mixed[0]);
+    WideMatrix* W = allocate_wide_matrix(1, 4, 0);
+    wide_matrix_set_int64(W, 0, 0, INT64_MIN);
+    wide_matrix_set_int64(W, 0, 1, INT64_MAX);
+    wide_matrix_set_int64(W, 0, 2, -1);
+    int** res = alloc_planes(k_mixed, 4);
+    wide_matrix_to_rns_planes(W, mixed, k_mixed, res, NULL);
+    for (int i = 0; i < k_mixed; i++) {
+        int64_t mod = mixed[i];
+        assert(res[i][0] == (int) (((INT64_MIN % mod) + mod) % mod));
+        assert(res[i][1] == (int) (INT64_MAX % mod));
+        assert(res[i][2] == mod - 1 && res[i][3] == 0);
+    }
+    free_planes(res, k_mixed);
+    free_wide_matrix(W);
+
+    check_too_narrow(primes, 5, state);
+
+    check_product(9, 13, 11, 100, NULL, state);
+    check_product(40, 33, 25, 300, pool, state);
+    check_product(5, 5, 5, 8, pool, state);
+
+    free(primes);
+    thread_pool_destroy(pool);
+    gmp_randclear(state);
+    printf("All wide RNS conversion tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include <assert.h>
+#include "matrix_utils_gmp.h"
+#include "rns_handle.h"
+#include "rns_handle_gmp.h"
+#include "rns_expr.h"
+
+static int64_t** random_int64(int n, int m, int64_t range) {
+    int64_t** A = malloc(n * sizeof(int64_t*));
+    for (int i = 0; i < n; i++) {
+        A[i] = malloc(m * sizeof(int64_t));
+        for (int j = 0; j < m; j++) A[i][j] = (int64_t) (rand() % (2 * range + 1)) - range;
+    }
+    return A;
+}
+
+static void free_int64(int64_t** A, int n) {
+    for (int i = 0; i < n; i++) free(A[i]);
+    free(A);
+}
+
+// Both handles hold the same values
+static void assert_same(const RNSHandle* X, const RNSHandle* Y) {
+    assert(X->n == Y->n && X->m == Y->m);
+    mpz_t** x = rns_handle_to_mpz_matrix(X);
+    mpz_t** y = rns_handle_to_mpz_matrix(Y);
+    for (int i = 0; i < X->n; i++)
+        for (int j = 0; j < X->m; j++) assert(mpz_cmp(x[i][j], y[i][j]) == 0);
+    free_mpz_matrix(x, X->n, X->m);
+    free_mpz_matrix(y, Y->n, Y->m);
+}
+
+int main() {
+    srand(5);
+    int n = 7, m = 5, p = 6;
+
+    int64_t** A = random_int64(n, m, 1000);
+    int64_t** B = random_int64(m, p, 1000);
+    int64_t** C = random_int64(n, m, 1000);
+    int64_t** D = random_int64(m, p, 1000);
+    int64_t** E = random_int64(n, p, 1000);
+    RNSHandle* hA = int64_matrix_to_rns_handle(A, n, m);
+    RNSHandle* hB = int64_matrix_to_rns_handle(B, m, p);
+    RNSHandle* hC = int64_matrix_to_rns_handle(C, n, m);
+    RNSHandle* hD = int64_matrix_to_rns_handle(D, m, p);
+    RNSHandle* hE = int64_matrix_to_rns_handle(E, n, p);
+
+    // A·B + C·D - 3·E, checked against int64 arithmetic
+    RNSExprGraph* g = rns_expr_graph_create();
+    RNSExpr* a = rns_expr_leaf(g, hA);
+    RNSExpr* b = rns_expr_leaf(g, hB);
+    RNSExpr* c = rns_expr_leaf(g, hC);
+    RNSExpr* d = rns_expr_leaf(g, hD);
+    RNSExpr* e = rns_expr_leaf(g, hE);
+    RNSExpr* expr = rns_expr_sub(g, rns_expr_add(g, rns_expr_mul(g, a, b), rns_expr_mul(g, c, d)),
+                                 rns_expr_scale(g, e, 3));
+    assert(rns_expr_bound_bits(expr) >= 24);
+    RNSHandle* r = rns_expr_eval(g, expr);
+    assert(r->k == rns_expr_moduli_needed(expr));
+    int64_t** R = rns_handle_to_int64_matrix(r);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < p; j++) {
+            int64_t ref = -3 * E[i][j];
+            for (int t = 0; t < m; t++) ref += A[i][t] * B[t][j] + C[i][t] * D[t][j];
+            assert(R[i][j] == ref);
+        }
+    }
+    free_int64(R, n);
+    free_rns_handle(r);
+
+    // Shared subexpressions and a chain that needs several moduli:
+    // G = A·B·F, Y = G·G + 2·G, Z = Y·G + Y
+    int64_t** F = random_int64(p, n, 1000);
+    RNSHandle* hF = int64_matrix_to_rns_handle(F, p, n);
+    RNSExpr* f = rns_expr_leaf(g, hF);
+    RNSExpr* x = rns_expr_mul(g, a, b);          // n × p
+    RNSExpr* xf = rns_expr_mul(g, x, f);         // n × n, used three times
+    RNSExpr* y = rns_expr_sub(g, rns_expr_mul(g, xf, xf), rns_expr_scale(g, xf, -2));
+    RNSExpr* z = rns_expr_add(g, rns_expr_mul(g, y, xf), y);
+    RNSHandle* rz = rns_expr_eval(g, z);
+    assert(rz->k > 1);
+
+    RNSHandle* hx = rns_handle_mul(hA, hB);
+    RNSHandle* hxf = rns_handle_mul(hx, hF);
+    RNSHandle* hxx = rns_handle_mul(hxf, hxf);
+    RNSHandle* hs = rns_handle_scale(hxf, -2);
+    RNSHandle* hy = rns_handle_sub(hxx, hs);
+    RNSHandle* hyx = rns_handle_mul(hy, hxf);
+    RNSHandle* hz = rns_handle_add(hyx, hy);
+    assert_same(rz, hz);
+
+    // Evaluating a leaf copies it, evaluating twice gives the same result
+    RNSHandle* ra = rns_expr_eval(g, a);
+    assert_same(ra, hA);
+    RNSHandle* rz2 = rns_expr_eval(g, z);
+    assert_same(rz, rz2);
+
+    // Shape errors are caught while building the graph
+    assert(rns_expr_mul(g, a, c) == NULL);
+    assert(rns_expr_add(g, a, b) == NULL);
+    assert(rns_expr_scale(g, NULL, 2) == NULL);
+    assert(rns_expr_eval(g, NULL) == NULL);
+
+    printf("test_rns_expr: passed\n");
+
+    rns_expr_graph_free(g);
+    RNSHandle* handles[] = { hA, hB, hC, hD, hE, hF, rz, hx, hxf, hxx, hs, hy, hyx, hz, ra, rz2 };
+    for (size_t h = 0; h < sizeof(handles) / sizeof(handles[0]); h++) free_rns_handle(handles[h]);
+    free_int64(A, n);
+    free_int64(B, m);
+    free_int64(C, n);
+    free_int64(D, m);
+    free_int64(E, n);
+    free_int64(F, p);
+    return 0;
+}
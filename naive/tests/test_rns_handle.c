@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <gmp.h>
+#include <assert.h>
+#include "matrix_utils_gmp.h"
+#include "rns_handle.h"
+#include "rns_handle_gmp.h"
+
+static int64_t** random_int64(int n, int m, int64_t range) {
+    int64_t** A = malloc(n * sizeof(int64_t*));
+    for (int i = 0; i < n; i++) {
+        A[i] = malloc(m * sizeof(int64_t));
+        for (int j = 0; j < m; j++) A[i][j] = (int64_t) (rand() % (2 * range + 1)) - range;
+    }
+    return A;
+}
+
+static void free_int64(int64_t** A, int n) {
+    for (int i = 0; i < n; i++) free(A[i]);
+    free(A);
+}
+
+static mpz_t** to_mpz(int64_t** A, int n, int m) {
+    mpz_t** Z = allocate_mpz_matrix(n, m);
+    for (int i = 0; i < n; i++) for (int j = 0; j < m; j++) mpz_set_si(Z[i][j], A[i][j]);
+    return Z;
+}
+
+static mpz_t** mul_mpz(mpz_t** A, mpz_t** B, int n, int m, int p) {
+    mpz_t** C = allocate_mpz_matrix(n, p);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < p; j++)
+            for (int r = 0; r < m; r++) mpz_addmul(C[i][j], A[i][r], B[r][j]);
+    return C;
+}
+
+static void assert_equal(const RNSHandle* H, mpz_t** ref) {
+    mpz_t** C = rns_handle_to_mpz_matrix(H);
+    for (int i = 0; i < H->n; i++)
+        for (int j = 0; j < H->m; j++) assert(mpz_cmp(C[i][j], ref[i][j]) == 0);
+    free_mpz_matrix(C, H->n, H->m);
+}
+
+int main() {
+    srand(3);
+    int n = 6;
+
+    // Chain A·B·C with int64 inputs: 1 modulus for the inputs, more for the products
+    int64_t** A = random_int64(n, n, 1000000);
+    int64_t** B = random_int64(n, n, 1000000);
+    int64_t** C = random_int64(n, n, 1000000);
+    RNSHandle* hA = int64_matrix_to_rns_handle(A, n, n);
+    RNSHandle* hB = int64_matrix_to_rns_handle(B, n, n);
+    RNSHandle* hC = int64_matrix_to_rns_handle(C, n, n);
+    assert(hA->k == 1);
+
+    RNSHandle* hAB = rns_handle_mul(hA, hB);
+    RNSHandle* hABC = rns_handle_mul(hAB, hC);
+    assert(hABC->k > hA->k);
+
+    mpz_t** zA = to_mpz(A, n, n);
+    mpz_t** zB = to_mpz(B, n, n);
+    mpz_t** zC = to_mpz(C, n, n);
+    mpz_t** zAB = mul_mpz(zA, zB, n, n, n);
+    mpz_t** zABC = mul_mpz(zAB, zC, n, n, n);
+    assert_equal(hABC, zABC);
+
+    // Same chain on the int8 product backend, through basis extensions
+    setenv("RNS_PRODUCT_BACKEND", "int8", 1);
+    RNSHandle* hAB8 = rns_handle_mul(hA, hB);
+    RNSHandle* hABC8 = rns_handle_mul(hAB8, hC);
+    unsetenv("RNS_PRODUCT_BACKEND");
+    assert_equal(hABC8, zABC);
+    free_rns_handle(hAB8);
+    free_rns_handle(hABC8);
+
+    // int64 output while the bound allows it
+    int64_t** AB = rns_handle_to_int64_matrix(hAB);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) assert(AB[i][j] == mpz_get_si(zAB[i][j]));
+    free_int64(AB, n);
+    assert(rns_handle_to_int64_matrix(hABC) == NULL);
+
+    // Repeated powers: A^8 by squaring, the basis grows automatically
+    RNSHandle* hP = int64_matrix_to_rns_handle(A, n, n);
+    mpz_t** zP = to_mpz(A, n, n);
+    for (int s = 0; s < 3; s++) {
+        RNSHandle* next = rns_handle_mul(hP, hP);
+        mpz_t** znext = mul_mpz(zP, zP, n, n, n);
+        free_rns_handle(hP);
+        free_mpz_matrix(zP, n, n);
+        hP = next;
+        zP = znext;
+    }
+    assert_equal(hP, zP);
+
+    // A·B + C·(-7) - A, mixing handles with different numbers of moduli
+    RNSHandle* h7C = rns_handle_scale(hC, -7);
+    RNSHandle* hSum = rns_handle_add(hAB, h7C);
+    RNSHandle* hExpr = rns_handle_sub(hSum, hA);
+    mpz_t** zExpr = allocate_mpz_matrix(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            mpz_set(zExpr[i][j], zAB[i][j]);
+            mpz_submul_ui(zExpr[i][j], zC[i][j], 7);
+            mpz_sub(zExpr[i][j], zExpr[i][j], zA[i][j]);
+        }
+    }
+    assert_equal(hExpr, zExpr);
+
+    // Big integers in and out, and int8 inputs
+    mpz_t** zBig = allocate_mpz_matrix(n, n);
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 11);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            mpz_urandomb(zBig[i][j], state, 200);
+            if ((i + j) % 2) mpz_neg(zBig[i][j], zBig[i][j]);
+        }
+    }
+    RNSHandle* hBig = mpz_matrix_to_rns_handle(zBig, n, n);
+    RNSHandle* hBigA = rns_handle_mul(hBig, hA);
+    mpz_t** zBigA = mul_mpz(zBig, zA, n, n, n);
+    assert_equal(hBigA, zBigA);
+
+    int8_t** A8 = malloc(n * sizeof(int8_t*));
+    for (int i = 0; i < n; i++) {
+        A8[i] = malloc(n * sizeof(int8_t));
+        for (int j = 0; j < n; j++) A8[i][j] = (int8_t) (rand() % 256 - 128);
+    }
+    RNSHandle* h8 = int8_matrix_to_rns_handle(A8, n, n);
+    RNSHandle* h88 = rns_handle_mul(h8, h8);
+    int64_t** P8 = rns_handle_to_int64_matrix(h88);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int64_t ref = 0;
+            for (int r = 0; r < n; r++) ref += A8[i][r] * A8[r][j];
+            assert(P8[i][j] == ref);
+        }
+    }
+    free_int64(P8, n);
+
+    // Dimension mismatch
+    RNSHandle* hRect = int64_matrix_to_rns_handle(A, n, n - 1);
+    assert(rns_handle_mul(hRect, hA) == NULL);
+    assert(rns_handle_add(hRect, hA) == NULL);
+
+    printf("test_rns_handle: passed\n");
+
+    RNSHandle* handles[] = { hA, hB, hC, hAB, hABC, hP, h7C, hSum, hExpr, hBig, hBigA, h8, h88, hRect };
+    for (size_t h = 0; h < sizeof(handles) / sizeof(handles[0]); h++) free_rns_handle(handles[h]);
+    mpz_t** mats[] = { zA, zB, zC, zAB, zABC, zP, zExpr, zBig, zBigA };
+    for (size_t z = 0; z < sizeof(mats) / sizeof(mats[0]); z++) free_mpz_matrix(mats[z], n, n);
+    for (int i = 0; i < n; i++) free(A8[i]);
+    free(A8);
+    free_int64(A, n);
+    free_int64(B, n);
+    free_int64(C, n);
+    gmp_randclear(state);
+    return 0;
+}
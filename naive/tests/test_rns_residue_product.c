@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "rns_residue_product.h"
+#include "residue_gemm.h"
+
+static int*** alloc_planes(int k, int rows, int cols, const int* moduli, int seed) {
+    int*** X = malloc(k * sizeof(int**));
+    for (int idx = 0; idx < k; idx++) {
+        X[idx] = malloc(rows * sizeof(int*));
+        int* plane = malloc((size_t) rows * cols * sizeof(int));
+        for (int i = 0; i < rows; i++) {
+            X[idx][i] = plane + (size_t) i * cols;
+            for (int j = 0; j < cols; j++) X[idx][i][j] = (int) ((i * 131L + j * 71L + seed * 17L + idx) % moduli[idx]);
+        }
+    }
+    return X;
+}
+
+static void free_planes(int*** X, int k) {
+    for (int idx = 0; idx < k; idx++) {
+        free(X[idx][0]);
+        free(X[idx]);
+    }
+    free(X);
+}
+
+int main() {
+    // Both backends agree with the generic residue GEMM on their own bases
+    int n = 19, m = 70, p = 23;
+    for (int b = 0; b < RNS_PRODUCT_NUM_BACKENDS; b++) {
+        int k;
+        int* moduli = rns_product_basis(100, (RNSProductBackend) b, &k);
+        assert(k == (b == RNS_PRODUCT_INT8 ? 15 : 4));
+        int*** A = alloc_planes(k, n, m, moduli, 1);
+        int*** B = alloc_planes(k, m, p, moduli, 2);
+        int*** C = alloc_planes(k, n, p, moduli, 0);
+        int*** R = alloc_planes(k, n, p, moduli, 0);
+        ThreadPool* pool = thread_pool_create(3, 0);
+        rns_residue_product(A, B, C, moduli, k, n, m, p, (RNSProductBackend) b, pool);
+        thread_pool_destroy(pool);
+        residue_gemm_rns(A, B, R, moduli, k, n, m, p, NULL);
+        for (int idx = 0; idx < k; idx++) assert(memcmp(C[idx][0], R[idx][0], (size_t) n * p * sizeof(int)) == 0);
+        free_planes(A, k);
+        free_planes(B, k);
+        free_planes(C, k);
+        free_planes(R, k);
+        free(moduli);
+    }
+
+    // Beyond the 8-bit primes only fp64 remains, whatever the environment asks for
+    setenv("RNS_PRODUCT_BACKEND", "int8", 1);
+    assert(rns_product_backend_choose(RNS_PRODUCT_INT8_MAX_BITS) == RNS_PRODUCT_INT8);
+    assert(rns_product_backend_choose(RNS_PRODUCT_INT8_MAX_BITS + 1) == RNS_PRODUCT_FP64);
+    setenv("RNS_PRODUCT_BACKEND", "fp64", 1);
+    assert(rns_product_backend_choose(64) == RNS_PRODUCT_FP64);
+    unsetenv("RNS_PRODUCT_BACKEND");
+    assert(rns_product_backend_choose(64) == RNS_PRODUCT_FP64);
+    assert(strcmp(rns_product_backend_name(RNS_PRODUCT_FP64), "fp64") == 0);
+
+    printf("test_rns_residue_product: passed\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "thread_pool.h"
+
+typedef struct {
+    int* hits;
+    int* owner;
+} Counters;
+
+static void count_task(void* arg, int task_idx, int worker_idx) {
+    Counters* c = (Counters*) arg;
+    c->hits[task_idx]++;
+    c->owner[task_idx] = worker_idx;
+}
+
+typedef struct {
+    ThreadPool* pool;
+    int* hits;
+} Caller;
+
+static void add_task(void* arg, int task_idx, int worker_idx) {
+    (void) worker_idx;
+    __atomic_fetch_add(&((int*) arg)[task_idx], 1, __ATOMIC_RELAXED);
+}
+
+// Application thread sharing the pool with others
+static void* caller_main(void* p) {
+    Caller* c = (Caller*) p;
+    for (int r = 0; r < 200; r++) thread_pool_run(c->pool, 16, add_task, c->hits);
+    return NULL;
+}
+
+// A task running the same pool again
+static void nested_task(void* arg, int task_idx, int worker_idx) {
+    Caller* c = (Caller*) arg;
+    (void) worker_idx;
+    thread_pool_run(c->pool, 4, add_task, c->hits + 4 * task_idx);
+}
+
+int main() {
+    int sizes[] = {1, 3, 8};
+    int num_tasks = 37;
+
+    for (int s = 0; s < 3; s++) {
+        ThreadPool* pool = thread_pool_create(sizes[s], 1);
+        assert(thread_pool_size(pool) == sizes[s]);
+
+        int* hits = calloc(num_tasks, sizeof(int));
+        int* owner = calloc(num_tasks, sizeof(int));
+        Counters c = { hits, owner };
+
+        // Run twice to check that the pool can be reused
+        thread_pool_run(pool, num_tasks, count_task, &c);
+        thread_pool_run(pool, num_tasks, count_task, &c);
+
+        for (int t = 0; t < num_tasks; t++) {
+            assert(hits[t] == 2);
+            // Static contiguous distribution of tasks over workers
+            if (t > 0) assert(owner[t] >= owner[t - 1]);
+        }
+        assert(owner[0] == 0);
+        assert(owner[num_tasks - 1] == sizes[s] - 1);
+
+        free(hits);
+        free(owner);
+        thread_pool_destroy(pool);
+    }
+
+    // Concurrent callers are serialized, nested runs execute inline, the caller's mask is restored
+    ThreadPool* pool = thread_pool_create(4, 1);
+    cpu_set_t before, after;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &before);
+    pthread_t callers[4];
+    Caller args[4];
+    for (int i = 0; i < 4; i++) {
+        args[i].pool = pool;
+        args[i].hits = calloc(16, sizeof(int));
+        pthread_create(&callers[i], NULL, caller_main, &args[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(callers[i], NULL);
+        for (int t = 0; t < 16; t++) assert(args[i].hits[t] == 200);
+        free(args[i].hits);
+    }
+    Caller nested = { pool, calloc(4 * 8, sizeof(int)) };
+    thread_pool_run(pool, 8, nested_task, &nested);
+    for (int t = 0; t < 4 * 8; t++) assert(nested.hits[t] == 1);
+    free(nested.hits);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &after);
+    assert(CPU_EQUAL(&before, &after));
+    thread_pool_destroy(pool);
+
+    // A NULL pool runs the tasks on the caller
+    int* inline_hits = calloc(5, sizeof(int));
+    thread_pool_run(NULL, 5, add_task, inline_hits);
+    for (int t = 0; t < 5; t++) assert(inline_hits[t] == 1);
+    assert(thread_pool_size(NULL) == 1);
+    free(inline_hits);
+
+    assert(thread_pool_get_default() == thread_pool_get_default());
+
+    printf("test_thread_pool: passed\n");
+    return 0;
+}